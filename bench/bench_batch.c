@@ -0,0 +1,232 @@
+#include "zi_bench.h"
+
+#include "zi_batch.h"
+
+// elements per call, ops count elements so the per-element loops compare directly
+#define BENCH_BATCH_COUNT 4096
+
+typedef struct BenchBatchData {
+	f32     px[BENCH_BATCH_COUNT], py[BENCH_BATCH_COUNT], pz[BENCH_BATCH_COUNT];
+	f32     ox[BENCH_BATCH_COUNT], oy[BENCH_BATCH_COUNT], oz[BENCH_BATCH_COUNT], ow[BENCH_BATCH_COUNT];
+	f32     qx[BENCH_BATCH_COUNT], qy[BENCH_BATCH_COUNT], qz[BENCH_BATCH_COUNT], qw[BENCH_BATCH_COUNT];
+	f32     sx[BENCH_BATCH_COUNT], sy[BENCH_BATCH_COUNT], sz[BENCH_BATCH_COUNT];
+	f32     t[BENCH_BATCH_COUNT];
+	ZiMat4  parents[BENCH_BATCH_COUNT];
+	ZiMat4  locals[BENCH_BATCH_COUNT];
+	ZiMat4  worlds[BENCH_BATCH_COUNT];
+	ZiMat34 composed[BENCH_BATCH_COUNT];
+	ZiMat34 transform;
+	// centers are the points, extents and radii the scales
+	ZiFrustum      view;
+	ZiBatchFrustum frustum;
+	u32            visible_bits[BENCH_BATCH_COUNT / 32];
+	u32            visible[BENCH_BATCH_COUNT];
+} BenchBatchData;
+
+static BenchBatchData data;
+
+static ZiVec3SoA bench_points(void) {
+	return (ZiVec3SoA){data.px, data.py, data.pz};
+}
+
+static ZiVec3SoA bench_out(void) {
+	return (ZiVec3SoA){data.ox, data.oy, data.oz};
+}
+
+static u32 bench_chunk(u64 ops, u64 done) {
+	return ops - done < BENCH_BATCH_COUNT ? (u32)(ops - done) : BENCH_BATCH_COUNT;
+}
+
+static void bench_batch_setup(void) {
+	zi_random_seed(42);
+	for (u32 i = 0; i < BENCH_BATCH_COUNT; ++i) {
+		data.px[i] = zi_random_range_f32(-100.0f, 100.0f);
+		data.py[i] = zi_random_range_f32(-100.0f, 100.0f);
+		data.pz[i] = zi_random_range_f32(-100.0f, 100.0f);
+
+		ZiQuat q = zi_quat_from_axis_angle(zi_vec3_random_on_sphere(), zi_random_range_f32(-ZI_PI, ZI_PI));
+		data.qx[i] = q.x;
+		data.qy[i] = q.y;
+		data.qz[i] = q.z;
+		data.qw[i] = q.w;
+		data.sx[i] = zi_random_range_f32(0.5f, 2.0f);
+		data.sy[i] = zi_random_range_f32(0.5f, 2.0f);
+		data.sz[i] = zi_random_range_f32(0.5f, 2.0f);
+		data.t[i] = zi_random_f32();
+
+		ZiVec3 t = zi_vec3(data.px[i], data.py[i], data.pz[i]);
+		data.parents[i] = zi_mat4_compose(t, q, zi_vec3(data.sx[i], data.sy[i], data.sz[i]));
+		data.locals[i] = zi_mat4_compose(zi_vec3(data.pz[i], data.px[i], data.py[i]), q, zi_vec3_one());
+	}
+	data.transform = zi_mat34_compose(zi_vec3(1.0f, 2.0f, 3.0f), zi_quat_from_euler(0.3f, 0.2f, 0.1f), zi_vec3(1.0f, 2.0f, 0.5f));
+
+	// about a tenth of the boxes end up inside
+	ZiMat4 projection = zi_mat4_perspective(ZI_PI / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+	ZiMat4 view = zi_mat4_look_at(zi_vec3_zero(), zi_vec3(0.0f, 0.0f, -1.0f), zi_vec3_up());
+	ZiMat4 view_projection = zi_mat4_mul(&projection, &view);
+	data.view = zi_frustum_from_mat4(&view_projection);
+	zi_batch_frustum_init(&data.frustum, &data.view);
+}
+
+// ============================================================================
+// Transforms
+// ============================================================================
+
+static void bench_transform_points_loop(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		u32 k = (u32)(i % BENCH_BATCH_COUNT);
+		ZiVec3 p = zi_mat34_transform_point(&data.transform, zi_vec3(data.px[k], data.py[k], data.pz[k]));
+		data.ox[k] = p.x;
+		data.oy[k] = p.y;
+		data.oz[k] = p.z;
+	}
+	zi_bench_use(data.ox);
+}
+
+static void bench_transform_points(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_transform_points(&data.transform, bench_points(), bench_out(), count);
+	}
+	zi_bench_use(data.ox);
+}
+
+static void bench_transform_normals(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_transform_normals(&data.transform, bench_points(), bench_out(), count);
+	}
+	zi_bench_use(data.ox);
+}
+
+// ============================================================================
+// Matrices
+// ============================================================================
+
+static void bench_mat4_mul_loop(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		u32 k = (u32)(i % BENCH_BATCH_COUNT);
+		data.worlds[k] = zi_mat4_mul(&data.parents[k], &data.locals[k]);
+	}
+	zi_bench_use(data.worlds);
+}
+
+static void bench_mat4_mul(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_mat4_mul(data.parents, data.locals, data.worlds, count);
+	}
+	zi_bench_use(data.worlds);
+}
+
+// b is a shifted by one, so a call covers all but the last quaternion
+#define BENCH_SLERP_COUNT (BENCH_BATCH_COUNT - 1)
+
+static void bench_quat_slerp_loop(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		u32    k = (u32)(i % BENCH_SLERP_COUNT);
+		ZiQuat a = zi_quat(data.qx[k], data.qy[k], data.qz[k], data.qw[k]);
+		ZiQuat b = zi_quat(data.qx[k + 1], data.qy[k + 1], data.qz[k + 1], data.qw[k + 1]);
+		ZiQuat q = zi_quat_slerp(a, b, data.t[k]);
+		data.ox[k] = q.x;
+		data.oy[k] = q.y;
+		data.oz[k] = q.z;
+		data.ow[k] = q.w;
+	}
+	zi_bench_use(data.ox);
+}
+
+static void bench_quat_slerp(VoidPtr user_data, u64 ops) {
+	ZiQuatSoA a = {data.qx, data.qy, data.qz, data.qw};
+	ZiQuatSoA b = {data.qx + 1, data.qy + 1, data.qz + 1, data.qw + 1};
+	ZiQuatSoA out = {data.ox, data.oy, data.oz, data.ow};
+	for (u64 done = 0; done < ops; done += BENCH_SLERP_COUNT) {
+		u32 count = ops - done < BENCH_SLERP_COUNT ? (u32)(ops - done) : BENCH_SLERP_COUNT;
+		zi_batch_quat_slerp(a, b, data.t, out, count);
+	}
+	zi_bench_use(data.ox);
+}
+
+static void bench_compose_trs_loop(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		u32 k = (u32)(i % BENCH_BATCH_COUNT);
+		ZiQuat q = zi_quat(data.qx[k], data.qy[k], data.qz[k], data.qw[k]);
+		data.composed[k] = zi_mat34_compose(zi_vec3(data.px[k], data.py[k], data.pz[k]), q, zi_vec3(data.sx[k], data.sy[k], data.sz[k]));
+	}
+	zi_bench_use(data.composed);
+}
+
+static void bench_compose_trs(VoidPtr user_data, u64 ops) {
+	ZiQuatSoA rotations = {data.qx, data.qy, data.qz, data.qw};
+	ZiVec3SoA scales = {data.sx, data.sy, data.sz};
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_compose_trs(bench_points(), rotations, scales, data.composed, count);
+	}
+	zi_bench_use(data.composed);
+}
+
+// ============================================================================
+// Culling
+// ============================================================================
+
+static void bench_cull_aabbs_loop(VoidPtr user_data, u64 ops) {
+	u32 visible = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		u32    k = (u32)(i % BENCH_BATCH_COUNT);
+		ZiVec3 center = zi_vec3(data.px[k], data.py[k], data.pz[k]);
+		ZiVec3 extent = zi_vec3(data.sx[k], data.sy[k], data.sz[k]);
+		ZiAABB box = {zi_vec3_sub(center, extent), zi_vec3_add(center, extent)};
+		if (zi_frustum_contains_aabb(data.view, box)) {
+			data.visible[visible++ % BENCH_BATCH_COUNT] = k;
+		}
+	}
+	zi_bench_use(data.visible);
+}
+
+static void bench_cull_aabbs(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_cull_aabbs(&data.frustum, bench_points(), (ZiVec3SoA){data.sx, data.sy, data.sz}, count, data.visible_bits);
+	}
+	zi_bench_use(data.visible_bits);
+}
+
+static void bench_cull_aabbs_indices(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_cull_aabbs_indices(&data.frustum, bench_points(), (ZiVec3SoA){data.sx, data.sy, data.sz}, count, 0, data.visible);
+	}
+	zi_bench_use(data.visible);
+}
+
+static void bench_cull_spheres(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_BATCH_COUNT) {
+		u32 count = bench_chunk(ops, done);
+		zi_batch_cull_spheres(&data.frustum, bench_points(), data.sx, count, data.visible_bits);
+	}
+	zi_bench_use(data.visible_bits);
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+void run_batch_benchmarks(void) {
+	bench_batch_setup();
+
+	// _loop is the per-element zi_math.h call over the same data
+	ZI_BENCH("batch/transform_points_loop", bench_transform_points_loop);
+	ZI_BENCH("batch/transform_points", bench_transform_points);
+	ZI_BENCH("batch/transform_normals", bench_transform_normals);
+	ZI_BENCH("batch/mat4_mul_loop", bench_mat4_mul_loop);
+	ZI_BENCH("batch/mat4_mul", bench_mat4_mul);
+	ZI_BENCH("batch/compose_trs_loop", bench_compose_trs_loop);
+	ZI_BENCH("batch/compose_trs", bench_compose_trs);
+	ZI_BENCH("batch/quat_slerp_loop", bench_quat_slerp_loop);
+	ZI_BENCH("batch/quat_slerp", bench_quat_slerp);
+	ZI_BENCH("batch/cull_aabbs_loop", bench_cull_aabbs_loop);
+	ZI_BENCH("batch/cull_aabbs", bench_cull_aabbs);
+	ZI_BENCH("batch/cull_aabbs_indices", bench_cull_aabbs_indices);
+	ZI_BENCH("batch/cull_spheres", bench_cull_spheres);
+}
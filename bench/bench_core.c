@@ -0,0 +1,226 @@
+#include "zi_bench.h"
+
+#include "zi_core.h"
+
+#include <string.h>
+
+#define BENCH_MAP_KEYS 65536
+
+ZI_ARRAY(BenchU32Array, u32)
+ZI_HASHMAP(BenchMap, u64, u64)
+
+// spreads sequential indices over the key space like real ids
+static inline u64 bench_key(u64 i) {
+	return i * 0x9e3779b97f4a7c15ull;
+}
+
+// ============================================================================
+// Array
+// ============================================================================
+
+static void bench_array_push(VoidPtr user_data, u64 ops) {
+	BenchU32Array array;
+	BenchU32Array_init(&array, ZI_NULL);
+	for (u64 i = 0; i < ops; ++i) {
+		BenchU32Array_push(&array, (u32)i);
+	}
+	zi_bench_use(array.data);
+	BenchU32Array_free(&array);
+}
+
+static void bench_array_push_reserved(VoidPtr user_data, u64 ops) {
+	BenchU32Array array;
+	BenchU32Array_init_capacity(&array, ZI_NULL, ops);
+	for (u64 i = 0; i < ops; ++i) {
+		BenchU32Array_push(&array, (u32)i);
+	}
+	zi_bench_use(array.data);
+	BenchU32Array_free(&array);
+}
+
+static BenchU32Array bench_array;
+
+static void bench_array_setup(VoidPtr user_data) {
+	BenchU32Array_init_capacity(&bench_array, ZI_NULL, BENCH_MAP_KEYS);
+	for (u32 i = 0; i < BENCH_MAP_KEYS; ++i) {
+		BenchU32Array_push(&bench_array, i);
+	}
+}
+
+static void bench_array_teardown(VoidPtr user_data) {
+	BenchU32Array_free(&bench_array);
+}
+
+static void bench_array_iterate(VoidPtr user_data, u64 ops) {
+	u32 sum = 0;
+	u64 count = bench_array.count;
+	for (u64 i = 0; i < ops; ++i) {
+		sum += bench_array.data[i & (count - 1)];
+	}
+	ZI_BENCH_USE(sum);
+}
+
+static void bench_array_remove_swap(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		if (bench_array.count == 0) {
+			bench_array.count = BENCH_MAP_KEYS;
+		}
+		BenchU32Array_remove_swap(&bench_array, (i * 7919) % bench_array.count);
+	}
+	zi_bench_use(bench_array.data);
+}
+
+// ============================================================================
+// Hashmap
+// ============================================================================
+
+static void bench_hashmap_insert(VoidPtr user_data, u64 ops) {
+	BenchMap map;
+	BenchMap_init(&map, ZI_NULL);
+	for (u64 i = 0; i < ops; ++i) {
+		BenchMap_set(&map, bench_key(i), i);
+	}
+	zi_bench_use(map.entries);
+	BenchMap_free(&map);
+}
+
+static BenchMap bench_map;
+
+static void bench_map_setup(VoidPtr user_data) {
+	BenchMap_init(&bench_map, ZI_NULL);
+	for (u64 i = 0; i < BENCH_MAP_KEYS; ++i) {
+		BenchMap_set(&bench_map, bench_key(i), i);
+	}
+}
+
+static void bench_map_teardown(VoidPtr user_data) {
+	BenchMap_free(&bench_map);
+}
+
+static void bench_hashmap_get_hit(VoidPtr user_data, u64 ops) {
+	u64 sum = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		sum += *BenchMap_get(&bench_map, bench_key(i & (BENCH_MAP_KEYS - 1)));
+	}
+	ZI_BENCH_USE(sum);
+}
+
+static void bench_hashmap_get_miss(VoidPtr user_data, u64 ops) {
+	u64 found = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		found += BenchMap_get(&bench_map, bench_key(BENCH_MAP_KEYS + i)) != ZI_NULL;
+	}
+	ZI_BENCH_USE(found);
+}
+
+// one op is a remove followed by putting the key back
+static void bench_hashmap_remove_set(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		u64 key = bench_key(i & (BENCH_MAP_KEYS - 1));
+		BenchMap_remove(&bench_map, key);
+		BenchMap_set(&bench_map, key, i);
+	}
+	zi_bench_use(bench_map.entries);
+}
+
+// ============================================================================
+// Allocators
+// ============================================================================
+
+typedef struct BenchAllocSize {
+	u64 size;
+} BenchAllocSize;
+
+static void bench_alloc_free(VoidPtr user_data, u64 ops) {
+	u64 size = ((BenchAllocSize*)user_data)->size;
+	for (u64 i = 0; i < ops; ++i) {
+		VoidPtr ptr = zi_mem_alloc(size);
+		zi_bench_use(ptr);
+		zi_mem_free(ptr);
+	}
+}
+
+// allocates a batch before freeing it, the allocator can't just hand back the same block
+#define BENCH_ALLOC_BATCH 256
+
+static void bench_alloc_batch(VoidPtr user_data, u64 ops) {
+	u64     size = ((BenchAllocSize*)user_data)->size;
+	VoidPtr ptrs[BENCH_ALLOC_BATCH];
+
+	for (u64 done = 0; done < ops;) {
+		u64 batch = ops - done < BENCH_ALLOC_BATCH ? ops - done : BENCH_ALLOC_BATCH;
+		for (u64 i = 0; i < batch; ++i) {
+			ptrs[i] = zi_mem_alloc(size);
+		}
+		zi_bench_use(ptrs);
+		for (u64 i = 0; i < batch; ++i) {
+			zi_mem_free(ptrs[batch - 1 - i]);
+		}
+		done += batch;
+	}
+}
+
+// linear allocator behind the ZiAllocator interface, shows what the indirection itself costs
+typedef struct BenchLinearAllocator {
+	u8* memory;
+	u64 capacity;
+	u64 offset;
+} BenchLinearAllocator;
+
+static VoidPtr bench_linear_alloc(u64 size, VoidPtr user_data) {
+	BenchLinearAllocator* linear = user_data;
+	u64 offset = (linear->offset + 15) & ~15ull;
+	if (offset + size > linear->capacity) offset = 0;
+	linear->offset = offset + size;
+	return linear->memory + offset;
+}
+
+static void bench_linear_free(VoidPtr ptr, VoidPtr user_data) {
+}
+
+static void bench_allocator_interface(VoidPtr user_data, u64 ops) {
+	ZiAllocator* allocator = user_data;
+	for (u64 i = 0; i < ops; ++i) {
+		VoidPtr ptr = allocator->alloc(64, allocator->user_data);
+		zi_bench_use(ptr);
+		allocator->free(ptr, allocator->user_data);
+	}
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+void run_core_benchmarks(void) {
+	ZI_BENCH("array/push", bench_array_push);
+	ZI_BENCH("array/push_reserved", bench_array_push_reserved);
+	zi_bench_run(&(ZiBenchDesc){
+		.name = "array/iterate", .fn = bench_array_iterate,
+		.setup = bench_array_setup, .teardown = bench_array_teardown, .bytes_per_op = sizeof(u32)});
+	zi_bench_run(&(ZiBenchDesc){
+		.name = "array/remove_swap", .fn = bench_array_remove_swap,
+		.setup = bench_array_setup, .teardown = bench_array_teardown});
+
+	ZI_BENCH("hashmap/insert", bench_hashmap_insert);
+	zi_bench_run(&(ZiBenchDesc){
+		.name = "hashmap/get_hit", .fn = bench_hashmap_get_hit, .setup = bench_map_setup, .teardown = bench_map_teardown});
+	zi_bench_run(&(ZiBenchDesc){
+		.name = "hashmap/get_miss", .fn = bench_hashmap_get_miss, .setup = bench_map_setup, .teardown = bench_map_teardown});
+	zi_bench_run(&(ZiBenchDesc){
+		.name = "hashmap/remove_set", .fn = bench_hashmap_remove_set, .setup = bench_map_setup, .teardown = bench_map_teardown});
+
+	static BenchAllocSize small = {16};
+	static BenchAllocSize medium = {256};
+	static BenchAllocSize large = {65536};
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/free_16", .fn = bench_alloc_free, .user_data = &small});
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/free_256", .fn = bench_alloc_free, .user_data = &medium});
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/free_64k", .fn = bench_alloc_free, .user_data = &large});
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/batch_16", .fn = bench_alloc_batch, .user_data = &small});
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/batch_256", .fn = bench_alloc_batch, .user_data = &medium});
+
+	static u8                   linear_memory[1 << 16];
+	static BenchLinearAllocator linear = {linear_memory, sizeof(linear_memory), 0};
+	static ZiAllocator          linear_allocator = {bench_linear_alloc, bench_linear_free, &linear};
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/linear_interface", .fn = bench_allocator_interface, .user_data = &linear_allocator});
+	zi_bench_run(&(ZiBenchDesc){.name = "alloc/default_interface", .fn = bench_allocator_interface, .user_data = zi_get_default_allocator()});
+}
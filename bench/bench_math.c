@@ -0,0 +1,414 @@
+#include "zi_bench.h"
+
+#include "zi_math.h"
+
+// inputs cycle through this many random values so nothing folds into a constant, power of two
+#define BENCH_MATH_COUNT 1024
+#define BENCH_MATH_MASK  (BENCH_MATH_COUNT - 1)
+
+typedef struct BenchMathData {
+	ZiMat4     matrices[BENCH_MATH_COUNT];
+	ZiMat4A    aligned[BENCH_MATH_COUNT];
+	ZiQuat     quats[BENCH_MATH_COUNT];
+	ZiVec3     points[BENCH_MATH_COUNT];
+	ZiRay      rays[BENCH_MATH_COUNT];
+	ZiAABB     boxes[BENCH_MATH_COUNT];
+	ZiSphere   spheres[BENCH_MATH_COUNT];
+	ZiTriangle triangles[BENCH_MATH_COUNT];
+	ZiOBB      obbs[BENCH_MATH_COUNT];
+	ZiFrustum  frustum;
+	// [-2 pi, 2 pi] and (0, 100], inputs of the libm / zi_fast_* pairs
+	f32        angles[BENCH_MATH_COUNT];
+	f32        positives[BENCH_MATH_COUNT];
+	f32        results[BENCH_MATH_COUNT];
+	ZiVec3     normals[BENCH_MATH_COUNT];
+} BenchMathData;
+
+static BenchMathData data;
+
+static ZiVec3 bench_random_vec3(f32 range) {
+	return zi_vec3(zi_random_range_f32(-range, range), zi_random_range_f32(-range, range), zi_random_range_f32(-range, range));
+}
+
+static ZiQuat bench_random_quat(void) {
+	return zi_quat_from_axis_angle(zi_vec3_random_on_sphere(), zi_random_range_f32(-ZI_PI, ZI_PI));
+}
+
+static void bench_math_setup(void) {
+	zi_random_seed(1234);
+
+	for (u32 i = 0; i < BENCH_MATH_COUNT; ++i) {
+		ZiMat4 rotation = zi_quat_to_mat4(bench_random_quat());
+		ZiMat4 translation = zi_mat4_translate(bench_random_vec3(100.0f));
+		ZiMat4 scale = zi_mat4_scale(zi_vec3(zi_random_range_f32(0.5f, 2.0f), zi_random_range_f32(0.5f, 2.0f), zi_random_range_f32(0.5f, 2.0f)));
+		ZiMat4 rs = zi_mat4_mul(&rotation, &scale);
+		data.matrices[i] = zi_mat4_mul(&translation, &rs);
+		data.aligned[i] = zi_mat4a_from_mat4(&data.matrices[i]);
+
+		data.quats[i] = bench_random_quat();
+		data.points[i] = bench_random_vec3(100.0f);
+		data.rays[i] = zi_ray(bench_random_vec3(50.0f), zi_vec3_random_on_sphere());
+
+		ZiVec3 center = bench_random_vec3(50.0f);
+		ZiVec3 extents = zi_vec3(zi_random_range_f32(0.5f, 10.0f), zi_random_range_f32(0.5f, 10.0f), zi_random_range_f32(0.5f, 10.0f));
+		data.boxes[i] = zi_aabb(zi_vec3_sub(center, extents), zi_vec3_add(center, extents));
+		data.spheres[i] = zi_sphere(bench_random_vec3(50.0f), zi_random_range_f32(0.5f, 10.0f));
+		data.triangles[i] = zi_triangle(bench_random_vec3(20.0f), bench_random_vec3(20.0f), bench_random_vec3(20.0f));
+		data.obbs[i] = zi_obb(center, extents, bench_random_quat());
+
+		data.angles[i] = zi_random_range_f32(-ZI_TWO_PI, ZI_TWO_PI);
+		data.positives[i] = zi_random_range_f32(1e-3f, 100.0f);
+	}
+
+	ZiMat4 view = zi_mat4_look_at(zi_vec3(0.0f, 0.0f, -60.0f), zi_vec3_zero(), zi_vec3_up());
+	ZiMat4 projection = zi_mat4_perspective(zi_radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+	ZiMat4 view_projection = zi_mat4_mul(&projection, &view);
+	data.frustum = zi_frustum_from_mat4(&view_projection);
+}
+
+// ============================================================================
+// Matrices
+// ============================================================================
+
+static void bench_mat4_mul(VoidPtr user_data, u64 ops) {
+	ZiMat4 result = zi_mat4_identity();
+	for (u64 i = 0; i < ops; ++i) {
+		result = zi_mat4_mul(&data.matrices[i & BENCH_MATH_MASK], &data.matrices[(i + 1) & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_mat4_mul_scalar(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiMat4 result = zi_mat4_mul_scalar(&data.matrices[i & BENCH_MATH_MASK], &data.matrices[(i + 1) & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+// chained like a transform hierarchy, each product feeds the next
+static void bench_mat4a_mul_chain(VoidPtr user_data, u64 ops) {
+	ZiMat4A result = data.aligned[0];
+	for (u64 i = 0; i < ops; ++i) {
+		result = zi_mat4a_mul(&result, &data.aligned[i & BENCH_MATH_MASK]);
+	}
+	ZI_BENCH_USE(result);
+}
+
+static void bench_mat4_inverse(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiMat4 result = zi_mat4_inverse(&data.matrices[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_mat4_inverse_scalar(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiMat4 result = zi_mat4_inverse_scalar(&data.matrices[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_mat4_transform_point(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiVec3 result = zi_mat4_transform_point(&data.matrices[i & BENCH_MATH_MASK], data.points[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+// ============================================================================
+// Quaternions
+// ============================================================================
+
+static void bench_quat_mul(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiQuat result = zi_quat_mul(data.quats[i & BENCH_MATH_MASK], data.quats[(i + 1) & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_mul_scalar(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiQuat result = zi_quat_mul_scalar(data.quats[i & BENCH_MATH_MASK], data.quats[(i + 1) & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_normalize(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiQuat result = zi_quat_normalize(data.quats[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_slerp(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		f32 t = (f32)(i & 255) * (1.0f / 255.0f);
+		ZiQuat result = zi_quat_slerp(data.quats[i & BENCH_MATH_MASK], data.quats[(i + 1) & BENCH_MATH_MASK], t);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_slerp_fast(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		f32 t = (f32)(i & 255) * (1.0f / 255.0f);
+		ZiQuat result = zi_fast_quat_slerp(data.quats[i & BENCH_MATH_MASK], data.quats[(i + 1) & BENCH_MATH_MASK], t);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_rotate_vec3(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiVec3 result = zi_quat_rotate_vec3(data.quats[i & BENCH_MATH_MASK], data.points[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_to_mat4(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiMat4 result = zi_quat_to_mat4(data.quats[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_quat_from_mat4(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiQuat result = zi_quat_from_mat4(&data.matrices[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+// ============================================================================
+// Intersection
+// ============================================================================
+
+static void bench_ray_aabb(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	f32 t;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_ray_aabb_intersect(data.rays[i & BENCH_MATH_MASK], data.boxes[(i * 7) & BENCH_MATH_MASK], &t);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_ray_sphere(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	f32 t;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_ray_sphere_intersect(data.rays[i & BENCH_MATH_MASK], data.spheres[(i * 7) & BENCH_MATH_MASK], &t);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_ray_triangle(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	f32 t, u, v;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_ray_triangle_intersect(data.rays[i & BENCH_MATH_MASK], data.triangles[(i * 7) & BENCH_MATH_MASK], &t, &u, &v);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_ray_obb(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	f32 t;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_ray_obb_intersect(data.rays[i & BENCH_MATH_MASK], data.obbs[(i * 7) & BENCH_MATH_MASK], &t);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_aabb_aabb(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_aabb_aabb_intersect(data.boxes[i & BENCH_MATH_MASK], data.boxes[(i * 7 + 1) & BENCH_MATH_MASK]);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_sphere_sphere(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_sphere_sphere_intersect(data.spheres[i & BENCH_MATH_MASK], data.spheres[(i * 7 + 1) & BENCH_MATH_MASK]);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_obb_obb(VoidPtr user_data, u64 ops) {
+	i32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_obb_obb_intersect(data.obbs[i & BENCH_MATH_MASK], data.obbs[(i * 7 + 1) & BENCH_MATH_MASK]);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_frustum_from_mat4(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiFrustum result = zi_frustum_from_mat4(&data.matrices[i & BENCH_MATH_MASK]);
+		ZI_BENCH_USE(result);
+	}
+}
+
+static void bench_frustum_sphere(VoidPtr user_data, u64 ops) {
+	i32 visible = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		visible += zi_frustum_contains_sphere(data.frustum, data.spheres[i & BENCH_MATH_MASK]);
+	}
+	ZI_BENCH_USE(visible);
+}
+
+static void bench_frustum_aabb(VoidPtr user_data, u64 ops) {
+	i32 visible = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		visible += zi_frustum_contains_aabb(data.frustum, data.boxes[i & BENCH_MATH_MASK]);
+	}
+	ZI_BENCH_USE(visible);
+}
+
+// ============================================================================
+// Fast Approximations
+// ============================================================================
+
+// whole arrays in, whole arrays out, the loop the fast variants vectorize and libm can't
+#define BENCH_UNARY(function_name, inputs, expression)                              \
+	static void function_name(VoidPtr user_data, u64 ops) {                         \
+		for (u64 done = 0; done < ops; done += BENCH_MATH_COUNT) {                  \
+			u64 count = ops - done < BENCH_MATH_COUNT ? ops - done : BENCH_MATH_COUNT; \
+			for (u32 i = 0; i < count; ++i) {                                       \
+				f32 x = data.inputs[i];                                             \
+				data.results[i] = (expression);                                     \
+			}                                                                       \
+		}                                                                           \
+		zi_bench_use(data.results);                                                 \
+	}
+
+BENCH_UNARY(bench_rsqrt_libm, positives, 1.0f / sqrtf(x))
+BENCH_UNARY(bench_rsqrt_fast, positives, zi_fast_rsqrt(x))
+BENCH_UNARY(bench_sin_libm, angles, sinf(x))
+BENCH_UNARY(bench_sin_fast, angles, zi_fast_sin(x))
+BENCH_UNARY(bench_atan2_libm, angles, atan2f(x, data.positives[i] - 50.0f))
+BENCH_UNARY(bench_atan2_fast, angles, zi_fast_atan2(x, data.positives[i] - 50.0f))
+BENCH_UNARY(bench_exp2_libm, angles, exp2f(x))
+BENCH_UNARY(bench_exp2_fast, angles, zi_fast_exp2(x))
+BENCH_UNARY(bench_log2_libm, positives, log2f(x))
+BENCH_UNARY(bench_log2_fast, positives, zi_fast_log2(x))
+BENCH_UNARY(bench_linear_to_srgb_libm, positives, zi_linear_to_srgb(x * 0.01f))
+BENCH_UNARY(bench_linear_to_srgb_fast, positives, zi_fast_linear_to_srgb(x * 0.01f))
+
+static void bench_vec3_normalize_libm(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_MATH_COUNT) {
+		u64 count = ops - done < BENCH_MATH_COUNT ? ops - done : BENCH_MATH_COUNT;
+		for (u32 i = 0; i < count; ++i) {
+			data.normals[i] = zi_vec3_normalize(data.points[i]);
+		}
+	}
+	zi_bench_use(data.normals);
+}
+
+static void bench_vec3_normalize_fast(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_MATH_COUNT) {
+		u64 count = ops - done < BENCH_MATH_COUNT ? ops - done : BENCH_MATH_COUNT;
+		for (u32 i = 0; i < count; ++i) {
+			data.normals[i] = zi_fast_vec3_normalize(data.points[i]);
+		}
+	}
+	zi_bench_use(data.normals);
+}
+
+// ============================================================================
+// Random
+// ============================================================================
+
+static void bench_random_next_u32(VoidPtr user_data, u64 ops) {
+	ZiRandom rng = zi_random_create(1, 0);
+	u32      sum = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		sum += zi_random_next_u32(&rng);
+	}
+	ZI_BENCH_USE(sum);
+}
+
+// the per-thread default stream, what zi_random_f32() costs
+static void bench_random_f32_default(VoidPtr user_data, u64 ops) {
+	for (u64 done = 0; done < ops; done += BENCH_MATH_COUNT) {
+		u64 count = ops - done < BENCH_MATH_COUNT ? ops - done : BENCH_MATH_COUNT;
+		for (u32 i = 0; i < count; ++i) {
+			data.results[i] = zi_random_f32();
+		}
+	}
+	zi_bench_use(data.results);
+}
+
+static void bench_random_fill_u32(VoidPtr user_data, u64 ops) {
+	ZiRandom rng = zi_random_create(1, 0);
+	for (u64 done = 0; done < ops; done += BENCH_MATH_COUNT) {
+		u64 count = ops - done < BENCH_MATH_COUNT ? ops - done : BENCH_MATH_COUNT;
+		zi_random_fill_u32(&rng, (u32*)data.results, (u32)count);
+	}
+	zi_bench_use(data.results);
+}
+
+static void bench_random_fill_f32(VoidPtr user_data, u64 ops) {
+	ZiRandom rng = zi_random_create(1, 0);
+	for (u64 done = 0; done < ops; done += BENCH_MATH_COUNT) {
+		u64 count = ops - done < BENCH_MATH_COUNT ? ops - done : BENCH_MATH_COUNT;
+		zi_random_fill_f32(&rng, data.results, (u32)count, -1.0f, 1.0f);
+	}
+	zi_bench_use(data.results);
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+void run_math_benchmarks(void) {
+	bench_math_setup();
+
+	// plain entry points follow ZI_MATH_SIMD, the _scalar ones are the reference either way
+	ZI_BENCH("mat4/mul", bench_mat4_mul);
+	ZI_BENCH("mat4/mul_scalar", bench_mat4_mul_scalar);
+	ZI_BENCH("mat4/mul_aligned_chain", bench_mat4a_mul_chain);
+	ZI_BENCH("mat4/inverse", bench_mat4_inverse);
+	ZI_BENCH("mat4/inverse_scalar", bench_mat4_inverse_scalar);
+	ZI_BENCH("mat4/transform_point", bench_mat4_transform_point);
+
+	ZI_BENCH("quat/mul", bench_quat_mul);
+	ZI_BENCH("quat/mul_scalar", bench_quat_mul_scalar);
+	ZI_BENCH("quat/normalize", bench_quat_normalize);
+	ZI_BENCH("quat/slerp", bench_quat_slerp);
+	ZI_BENCH("quat/slerp_fast", bench_quat_slerp_fast);
+	ZI_BENCH("quat/rotate_vec3", bench_quat_rotate_vec3);
+	ZI_BENCH("quat/to_mat4", bench_quat_to_mat4);
+	ZI_BENCH("quat/from_mat4", bench_quat_from_mat4);
+
+	ZI_BENCH("intersect/ray_aabb", bench_ray_aabb);
+	ZI_BENCH("intersect/ray_sphere", bench_ray_sphere);
+	ZI_BENCH("intersect/ray_triangle", bench_ray_triangle);
+	ZI_BENCH("intersect/ray_obb", bench_ray_obb);
+	ZI_BENCH("intersect/aabb_aabb", bench_aabb_aabb);
+	ZI_BENCH("intersect/sphere_sphere", bench_sphere_sphere);
+	ZI_BENCH("intersect/obb_obb", bench_obb_obb);
+	ZI_BENCH("frustum/from_mat4", bench_frustum_from_mat4);
+	ZI_BENCH("intersect/frustum_sphere", bench_frustum_sphere);
+	ZI_BENCH("intersect/frustum_aabb", bench_frustum_aabb);
+
+	// _libm is what the zi_math.h functions call today
+	ZI_BENCH("fast/rsqrt_libm", bench_rsqrt_libm);
+	ZI_BENCH("fast/rsqrt", bench_rsqrt_fast);
+	ZI_BENCH("fast/sin_libm", bench_sin_libm);
+	ZI_BENCH("fast/sin", bench_sin_fast);
+	ZI_BENCH("fast/atan2_libm", bench_atan2_libm);
+	ZI_BENCH("fast/atan2", bench_atan2_fast);
+	ZI_BENCH("fast/exp2_libm", bench_exp2_libm);
+	ZI_BENCH("fast/exp2", bench_exp2_fast);
+	ZI_BENCH("fast/log2_libm", bench_log2_libm);
+	ZI_BENCH("fast/log2", bench_log2_fast);
+	ZI_BENCH("fast/linear_to_srgb_libm", bench_linear_to_srgb_libm);
+	ZI_BENCH("fast/linear_to_srgb", bench_linear_to_srgb_fast);
+	ZI_BENCH("fast/vec3_normalize_libm", bench_vec3_normalize_libm);
+	ZI_BENCH("fast/vec3_normalize", bench_vec3_normalize_fast);
+
+	ZI_BENCH("random/next_u32", bench_random_next_u32);
+	ZI_BENCH("random/f32_default", bench_random_f32_default);
+	ZI_BENCH("random/fill_u32", bench_random_fill_u32);
+	ZI_BENCH("random/fill_f32", bench_random_fill_f32);
+}
@@ -0,0 +1,531 @@
+#include "zi_bench.h"
+
+#include "zi_aabb_tree.h"
+#include "zi_batch.h"
+#include "zi_bvh.h"
+#include "zi_core.h"
+#include "zi_ray_packet.h"
+#include "zi_sap.h"
+#include "zi_spatial_hash.h"
+
+#include <stdint.h>
+
+#define BENCH_BVH_TRIANGLES 100000
+#define BENCH_SPATIAL_BOXES 100000
+#define BENCH_SPATIAL_ACTORS 20000
+#define BENCH_SPATIAL_SPRITES 100000
+#define BENCH_SPATIAL_PROBE_RAYS 4096
+#define BENCH_SPATIAL_RAYS  1024
+#define BENCH_SPATIAL_MASK  (BENCH_SPATIAL_RAYS - 1)
+
+typedef struct BenchSpatialData {
+	ZiTriangle* triangles;
+	ZiBvh       bvh;
+	ZiRay       rays[BENCH_SPATIAL_RAYS];
+	// scene objects, the same boxes as SoA centers and extents for the flat cull
+	ZiAABB*        boxes;
+	u32*           proxies;
+	u32*           found;
+	f32*           soa;
+	ZiAabbTree     tree;
+	ZiFrustum      view;
+	ZiBatchFrustum batch_view;
+	// a crowd walking around a 400 m square
+	ZiAABB* actors;
+	ZiVec3* velocities;
+	u32*    actor_handles;
+	ZiSap   sap;
+	// sprites over an 8192 px square map
+	ZiRect*       sprites;
+	ZiVec2*       sprite_velocities;
+	u32*          sprite_handles;
+	ZiSpatialHash sprite_hash;
+	// probes over the terrain, 8 rays per packet in a narrow cone
+	ZiRay*    probe_rays;
+	ZiBvhHit* probe_hits;
+	u32*      probe_bits;
+} BenchSpatialData;
+
+static BenchSpatialData data;
+
+// a bumpy 200 x 200 terrain grid with props scattered over it, rays from above aimed at it
+static void bench_spatial_setup(void) {
+	zi_random_seed(46);
+	data.triangles = (ZiTriangle*)zi_mem_alloc(sizeof(ZiTriangle) * BENCH_BVH_TRIANGLES);
+
+	u32 grid = 200;
+	u32 count = 0;
+	for (u32 z = 0; z < grid; ++z) {
+		for (u32 x = 0; x < grid; ++x) {
+			ZiVec3 p = zi_vec3((f32)x - 100.0f, zi_random_range_f32(-0.5f, 0.5f), (f32)z - 100.0f);
+			data.triangles[count++] = zi_triangle(p, zi_vec3(p.x + 1.0f, p.y, p.z), zi_vec3(p.x, p.y, p.z + 1.0f));
+		}
+	}
+	while (count < BENCH_BVH_TRIANGLES) {
+		ZiVec3 c = zi_vec3(zi_random_range_f32(-100.0f, 100.0f), zi_random_range_f32(0.0f, 20.0f), zi_random_range_f32(-100.0f, 100.0f));
+		ZiVec3 a = zi_vec3_add(c, zi_vec3_scale(zi_vec3_random_on_sphere(), 1.5f));
+		ZiVec3 b = zi_vec3_add(c, zi_vec3_scale(zi_vec3_random_on_sphere(), 1.5f));
+		data.triangles[count++] = zi_triangle(c, a, b);
+	}
+
+	for (u32 i = 0; i < BENCH_SPATIAL_RAYS; ++i) {
+		ZiVec3 origin = zi_vec3(zi_random_range_f32(-100.0f, 100.0f), 30.0f, zi_random_range_f32(-100.0f, 100.0f));
+		ZiVec3 target = zi_vec3(zi_random_range_f32(-100.0f, 100.0f), 0.0f, zi_random_range_f32(-100.0f, 100.0f));
+		data.rays[i] = zi_ray(origin, zi_vec3_sub(target, origin));
+	}
+
+	ZiBvhBuildDesc desc = {data.triangles, BENCH_BVH_TRIANGLES, 0, 1};
+	zi_bvh_build(&data.bvh, &desc);
+
+	// objects over a 2 km square, a camera looking along it sees a few percent
+	data.boxes = (ZiAABB*)zi_mem_alloc(sizeof(ZiAABB) * BENCH_SPATIAL_BOXES);
+	data.proxies = (u32*)zi_mem_alloc(sizeof(u32) * BENCH_SPATIAL_BOXES);
+	data.found = (u32*)zi_mem_alloc(sizeof(u32) * BENCH_SPATIAL_BOXES);
+	data.soa = (f32*)zi_mem_alloc(sizeof(f32) * BENCH_SPATIAL_BOXES * 6);
+	zi_aabb_tree_init(&data.tree, ZI_AABB_TREE_DEFAULT_MARGIN);
+	for (u32 i = 0; i < BENCH_SPATIAL_BOXES; ++i) {
+		ZiVec3 c = zi_vec3(zi_random_range_f32(-1000.0f, 1000.0f), zi_random_range_f32(0.0f, 30.0f), zi_random_range_f32(-1000.0f, 1000.0f));
+		ZiVec3 e = zi_vec3(zi_random_range_f32(0.5f, 3.0f), zi_random_range_f32(0.5f, 3.0f), zi_random_range_f32(0.5f, 3.0f));
+		data.boxes[i] = zi_aabb(zi_vec3_sub(c, e), zi_vec3_add(c, e));
+		data.proxies[i] = zi_aabb_tree_insert(&data.tree, data.boxes[i], (VoidPtr)(uintptr_t)i);
+		for (u32 k = 0; k < 3; ++k) {
+			data.soa[k * BENCH_SPATIAL_BOXES + i] = (&c.x)[k];
+			data.soa[(3 + k) * BENCH_SPATIAL_BOXES + i] = (&e.x)[k];
+		}
+	}
+
+	// 60 degrees both ways from (0, 10, 500) down -z out to 500
+	ZiVec3 eye = zi_vec3(0.0f, 10.0f, 500.0f);
+	ZiMat4 projection = zi_mat4_perspective(zi_radians(60.0f), 1.0f, 0.1f, 500.0f);
+	ZiMat4 view = zi_mat4_look_at(eye, zi_vec3_add(eye, zi_vec3(0.0f, 0.0f, -1.0f)), zi_vec3_up());
+	ZiMat4 view_projection = zi_mat4_mul(&projection, &view);
+	data.view = zi_frustum_from_mat4(&view_projection);
+	zi_batch_frustum_init(&data.batch_view, &data.view);
+
+	data.actors = (ZiAABB*)zi_mem_alloc(sizeof(ZiAABB) * BENCH_SPATIAL_ACTORS);
+	data.velocities = (ZiVec3*)zi_mem_alloc(sizeof(ZiVec3) * BENCH_SPATIAL_ACTORS);
+	data.actor_handles = (u32*)zi_mem_alloc(sizeof(u32) * BENCH_SPATIAL_ACTORS);
+	for (u32 i = 0; i < BENCH_SPATIAL_ACTORS; ++i) {
+		ZiVec3 p = zi_vec3(zi_random_range_f32(-200.0f, 200.0f), 0.0f, zi_random_range_f32(-200.0f, 200.0f));
+		data.actors[i] = zi_aabb(zi_vec3(p.x - 0.4f, 0.0f, p.z - 0.4f), zi_vec3(p.x + 0.4f, 1.8f, p.z + 0.4f));
+		// walking pace at 60 Hz
+		ZiVec3 heading = zi_vec3_normalize(zi_vec3(zi_random_range_f32(-1.0f, 1.0f), 0.0f, zi_random_range_f32(-1.0f, 1.0f)));
+		data.velocities[i] = zi_vec3_scale(heading, zi_random_range_f32(0.5f, 2.0f) / 60.0f);
+	}
+	zi_sap_init(&data.sap);
+	zi_sap_insert_batch(&data.sap, data.actors, ZI_NULL, BENCH_SPATIAL_ACTORS, data.actor_handles);
+
+	data.sprites = (ZiRect*)zi_mem_alloc(sizeof(ZiRect) * BENCH_SPATIAL_SPRITES);
+	data.sprite_velocities = (ZiVec2*)zi_mem_alloc(sizeof(ZiVec2) * BENCH_SPATIAL_SPRITES);
+	data.sprite_handles = (u32*)zi_mem_alloc(sizeof(u32) * BENCH_SPATIAL_SPRITES);
+	// 64 px cells, one bucket for each of the 128 x 128 of them
+	zi_spatial_hash_init(&data.sprite_hash, 64.0f, 128 * 128);
+	for (u32 i = 0; i < BENCH_SPATIAL_SPRITES; ++i) {
+		f32 size = zi_random_range_f32(16.0f, 48.0f);
+		data.sprites[i] = zi_rect(zi_random_range_f32(0.0f, 8192.0f - size), zi_random_range_f32(0.0f, 8192.0f - size), size, size);
+		data.sprite_velocities[i] = zi_vec2(zi_random_range_f32(-2.0f, 2.0f), zi_random_range_f32(-2.0f, 2.0f));
+		data.sprite_handles[i] = zi_spatial_hash_insert(&data.sprite_hash, data.sprites[i], ZI_NULL);
+	}
+
+	data.probe_rays = (ZiRay*)zi_mem_alloc(sizeof(ZiRay) * BENCH_SPATIAL_PROBE_RAYS);
+	data.probe_hits = (ZiBvhHit*)zi_mem_alloc(sizeof(ZiBvhHit) * BENCH_SPATIAL_PROBE_RAYS);
+	data.probe_bits = (u32*)zi_mem_alloc(sizeof(u32) * BENCH_SPATIAL_PROBE_RAYS / 32);
+	for (u32 i = 0; i < BENCH_SPATIAL_PROBE_RAYS; i += 64) {
+		ZiVec3 probe = zi_vec3(zi_random_range_f32(-90.0f, 90.0f), zi_random_range_f32(2.0f, 20.0f), zi_random_range_f32(-90.0f, 90.0f));
+		for (u32 k = i; k < i + 64; k += 8) {
+			ZiVec3 dir = zi_vec3_random_on_sphere();
+			for (u32 lane = 0; lane < 8; ++lane) {
+				ZiVec3 d = zi_vec3_add(dir, zi_vec3_scale(zi_vec3_random_on_sphere(), 0.1f));
+				data.probe_rays[k + lane] = zi_ray(probe, d);
+			}
+		}
+	}
+}
+
+static void bench_spatial_teardown(void) {
+	zi_sap_destroy(&data.sap);
+	zi_spatial_hash_destroy(&data.sprite_hash);
+	zi_mem_free(data.probe_rays);
+	zi_mem_free(data.probe_hits);
+	zi_mem_free(data.probe_bits);
+	zi_mem_free(data.sprites);
+	zi_mem_free(data.sprite_velocities);
+	zi_mem_free(data.sprite_handles);
+	zi_mem_free(data.actors);
+	zi_mem_free(data.velocities);
+	zi_mem_free(data.actor_handles);
+	zi_aabb_tree_destroy(&data.tree);
+	zi_mem_free(data.boxes);
+	zi_mem_free(data.proxies);
+	zi_mem_free(data.found);
+	zi_mem_free(data.soa);
+	zi_bvh_destroy(&data.bvh);
+	zi_mem_free(data.triangles);
+}
+
+// ============================================================================
+// BVH
+// ============================================================================
+
+static void bench_bvh_build(VoidPtr user_data, u64 ops) {
+	ZiBvhBuildDesc desc = {data.triangles, BENCH_BVH_TRIANGLES, 0, (u32)(u64)user_data};
+	for (u64 i = 0; i < ops; ++i) {
+		ZiBvh bvh;
+		zi_bvh_build(&bvh, &desc);
+		zi_bvh_destroy(&bvh);
+	}
+}
+
+static void bench_bvh_raycast(VoidPtr user_data, u64 ops) {
+	f32 sum = 0.0f;
+	for (u64 i = 0; i < ops; ++i) {
+		ZiBvhHit hit;
+		if (zi_bvh_raycast(&data.bvh, data.rays[i & BENCH_SPATIAL_MASK], F32_MAX, &hit)) {
+			sum += hit.t;
+		}
+	}
+	ZI_BENCH_USE(sum);
+}
+
+static void bench_bvh_raycast_any(VoidPtr user_data, u64 ops) {
+	u32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_bvh_raycast_any(&data.bvh, data.rays[i & BENCH_SPATIAL_MASK], F32_MAX);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+// what a raycast costs without the tree
+static void bench_raycast_brute_force(VoidPtr user_data, u64 ops) {
+	f32 sum = 0.0f;
+	for (u64 i = 0; i < ops; ++i) {
+		ZiRay ray = data.rays[i & BENCH_SPATIAL_MASK];
+		f32   best = F32_MAX;
+		for (u32 k = 0; k < BENCH_BVH_TRIANGLES; ++k) {
+			f32 t, u, v;
+			if (zi_ray_triangle_intersect(ray, data.triangles[k], &t, &u, &v) && t < best) {
+				best = t;
+			}
+		}
+		sum += best;
+	}
+	ZI_BENCH_USE(sum);
+}
+
+// ============================================================================
+// AABB tree
+// ============================================================================
+
+static void bench_aabb_tree_insert(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiAabbTree tree;
+		zi_aabb_tree_init(&tree, ZI_AABB_TREE_DEFAULT_MARGIN);
+		for (u32 k = 0; k < BENCH_SPATIAL_BOXES; ++k) {
+			zi_aabb_tree_insert(&tree, data.boxes[k], ZI_NULL);
+		}
+		zi_aabb_tree_destroy(&tree);
+	}
+}
+
+// one object per op stepping a little further than the margin, every move reinserts
+static void bench_aabb_tree_move(VoidPtr user_data, u64 ops) {
+	u32 reinserted = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		u32    k = (u32)(i % BENCH_SPATIAL_BOXES);
+		ZiVec3 d = zi_vec3((i & 1) ? 0.5f : -0.5f, 0.0f, 0.0f);
+		data.boxes[k] = zi_aabb(zi_vec3_add(data.boxes[k].min, d), zi_vec3_add(data.boxes[k].max, d));
+		reinserted += zi_aabb_tree_move(&data.tree, data.proxies[k], data.boxes[k], d);
+	}
+	ZI_BENCH_USE(reinserted);
+}
+
+// one op moves all 100k in place and refits the tree once
+static void bench_aabb_tree_refit(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiVec3 d = zi_vec3(0.0f, (i & 1) ? 0.5f : -0.5f, 0.0f);
+		for (u32 k = 0; k < BENCH_SPATIAL_BOXES; ++k) {
+			data.boxes[k] = zi_aabb(zi_vec3_add(data.boxes[k].min, d), zi_vec3_add(data.boxes[k].max, d));
+			zi_aabb_tree_update(&data.tree, data.proxies[k], data.boxes[k]);
+		}
+		zi_aabb_tree_refit(&data.tree);
+	}
+}
+
+static void bench_aabb_tree_frustum(VoidPtr user_data, u64 ops) {
+	u32 visible = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		visible += zi_aabb_tree_collect_frustum(&data.tree, &data.view, data.found, BENCH_SPATIAL_BOXES);
+	}
+	ZI_BENCH_USE(visible);
+}
+
+// the same cull without a tree, every box through the SIMD plane test
+static void bench_aabb_tree_frustum_flat(VoidPtr user_data, u64 ops) {
+	u32       visible = 0;
+	ZiVec3SoA centers = {data.soa, data.soa + BENCH_SPATIAL_BOXES, data.soa + 2 * BENCH_SPATIAL_BOXES};
+	ZiVec3SoA extents = {data.soa + 3 * BENCH_SPATIAL_BOXES, data.soa + 4 * BENCH_SPATIAL_BOXES, data.soa + 5 * BENCH_SPATIAL_BOXES};
+	for (u64 i = 0; i < ops; ++i) {
+		visible += zi_batch_cull_aabbs_indices(&data.batch_view, centers, extents, BENCH_SPATIAL_BOXES, 0, data.found);
+	}
+	ZI_BENCH_USE(visible);
+}
+
+static void bench_aabb_tree_sphere(VoidPtr user_data, u64 ops) {
+	u32 found = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		ZiAABB box = data.boxes[(i * 7919) % BENCH_SPATIAL_BOXES];
+		found += zi_aabb_tree_collect_sphere(&data.tree, zi_sphere(zi_aabb_center(box), 20.0f), data.found, BENCH_SPATIAL_BOXES);
+	}
+	ZI_BENCH_USE(found);
+}
+
+static f32 bench_aabb_tree_ray_fn(VoidPtr context, u32 proxy, VoidPtr user_data, ZiRay ray, f32 max_t) {
+	f32 t;
+	if (zi_ray_aabb_intersect(ray, data.boxes[(uintptr_t)user_data], &t) && t < max_t) {
+		*(u32*)context += 1;
+		return t;
+	}
+	return max_t;
+}
+
+// nearest object along rays skimming over the ground
+static void bench_aabb_tree_raycast(VoidPtr user_data, u64 ops) {
+	u32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		ZiRay ray = data.rays[i & BENCH_SPATIAL_MASK];
+		ray.origin = zi_vec3(ray.origin.x * 5.0f, 15.0f, ray.origin.z * 5.0f);
+		ray.direction = zi_vec3_normalize(zi_vec3(ray.direction.x, -0.01f, ray.direction.z));
+		zi_aabb_tree_raycast(&data.tree, ray, 1000.0f, bench_aabb_tree_ray_fn, &hits);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+// ============================================================================
+// Sweep and prune
+// ============================================================================
+
+static void bench_actors_step(u32 first, u32 count) {
+	for (u32 i = first; i < first + count; ++i) {
+		ZiVec3 v = data.velocities[i];
+		ZiAABB box = data.actors[i];
+		// turn around at the edge of the square
+		if (box.min.x + v.x < -200.0f || box.max.x + v.x > 200.0f) v.x = -v.x;
+		if (box.min.z + v.z < -200.0f || box.max.z + v.z > 200.0f) v.z = -v.z;
+		data.velocities[i] = v;
+		data.actors[i] = zi_aabb(zi_vec3_add(box.min, v), zi_vec3_add(box.max, v));
+	}
+}
+
+// one op fills the broadphase with the whole crowd
+static void bench_sap_insert(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiSap sap;
+		zi_sap_init(&sap);
+		zi_sap_insert_batch(&sap, data.actors, ZI_NULL, BENCH_SPATIAL_ACTORS, data.actor_handles);
+		zi_sap_destroy(&sap);
+	}
+}
+
+// one op is a frame, all 20k walk a step
+static void bench_sap_frame(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		bench_actors_step(0, BENCH_SPATIAL_ACTORS);
+		zi_sap_move_batch(&data.sap, data.actor_handles, data.actors, BENCH_SPATIAL_ACTORS);
+		zi_sap_clear_events(&data.sap);
+	}
+}
+
+// one actor per op, the rest standing still
+static void bench_sap_move(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		u32 k = (u32)(i % BENCH_SPATIAL_ACTORS);
+		bench_actors_step(k, 1);
+		zi_sap_move(&data.sap, data.actor_handles[k], data.actors[k]);
+		if ((i & 1023) == 0) zi_sap_clear_events(&data.sap);
+	}
+	zi_sap_clear_events(&data.sap);
+}
+
+// what one frame of pairs costs testing everything against everything
+static void bench_pairs_brute_force(VoidPtr user_data, u64 ops) {
+	u32 pairs = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		for (u32 a = 0; a < BENCH_SPATIAL_ACTORS; ++a) {
+			for (u32 b = a + 1; b < BENCH_SPATIAL_ACTORS; ++b) {
+				pairs += zi_aabb_aabb_intersect(data.actors[a], data.actors[b]);
+			}
+		}
+	}
+	ZI_BENCH_USE(pairs);
+}
+
+// ============================================================================
+// Spatial hash
+// ============================================================================
+
+// a random spot on the map for picking and queries
+static ZiVec2 bench_sprite_point(u64 i) {
+	ZiRect r = data.sprites[(i * 7919) % BENCH_SPATIAL_SPRITES];
+	return zi_vec2(r.x + r.width * 0.5f, r.y + r.height * 0.5f);
+}
+
+static void bench_spatial_hash_insert(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiSpatialHash hash;
+		zi_spatial_hash_init(&hash, 64.0f, 128 * 128);
+		for (u32 k = 0; k < BENCH_SPATIAL_SPRITES; ++k) {
+			zi_spatial_hash_insert(&hash, data.sprites[k], ZI_NULL);
+		}
+		zi_spatial_hash_destroy(&hash);
+	}
+}
+
+// one op is a frame, every sprite moves a couple of pixels
+static void bench_spatial_hash_frame(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		for (u32 k = 0; k < BENCH_SPATIAL_SPRITES; ++k) {
+			ZiVec2 v = data.sprite_velocities[k];
+			ZiRect r = data.sprites[k];
+			// bounce off the map edges
+			if (r.x + v.x < 0.0f || r.x + r.width + v.x > 8192.0f) v.x = -v.x;
+			if (r.y + v.y < 0.0f || r.y + r.height + v.y > 8192.0f) v.y = -v.y;
+			data.sprite_velocities[k] = v;
+			data.sprites[k] = zi_rect_translate(r, v);
+			zi_spatial_hash_move(&data.sprite_hash, data.sprite_handles[k], data.sprites[k]);
+		}
+	}
+}
+
+// mouse picking
+static void bench_spatial_hash_point(VoidPtr user_data, u64 ops) {
+	u32 found = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		found += zi_spatial_hash_collect_point(&data.sprite_hash, bench_sprite_point(i), data.found, BENCH_SPATIAL_BOXES);
+	}
+	ZI_BENCH_USE(found);
+}
+
+// the same pick looping over every sprite
+static void bench_spatial_hash_point_brute_force(VoidPtr user_data, u64 ops) {
+	u32 found = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		ZiVec2 p = bench_sprite_point(i);
+		for (u32 k = 0; k < BENCH_SPATIAL_SPRITES; ++k) {
+			found += zi_rect_contains_point(data.sprites[k], p);
+		}
+	}
+	ZI_BENCH_USE(found);
+}
+
+// what a 1280 x 720 view draws
+static void bench_spatial_hash_view(VoidPtr user_data, u64 ops) {
+	u32 found = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		ZiVec2 p = bench_sprite_point(i);
+		found += zi_spatial_hash_collect_rect(&data.sprite_hash, zi_rect(p.x - 640.0f, p.y - 360.0f, 1280.0f, 720.0f), data.found,
+		                                      BENCH_SPATIAL_BOXES);
+	}
+	ZI_BENCH_USE(found);
+}
+
+static f32 bench_spatial_hash_ray_fn(VoidPtr context, u32 handle, VoidPtr user_data, f32 t, f32 max_t) {
+	return t;
+}
+
+// nearest sprite along a 1000 px line of sight
+static void bench_spatial_hash_raycast(VoidPtr user_data, u64 ops) {
+	for (u64 i = 0; i < ops; ++i) {
+		ZiRay  ray = data.rays[i & BENCH_SPATIAL_MASK];
+		ZiVec2 dir = zi_vec2_normalize(zi_vec2(ray.direction.x, ray.direction.z));
+		zi_spatial_hash_raycast(&data.sprite_hash, bench_sprite_point(i), dir, 1000.0f, bench_spatial_hash_ray_fn, ZI_NULL);
+	}
+}
+
+// ============================================================================
+// Ray packets
+// ============================================================================
+
+// one op traces all 4096 probe rays 8 at a time
+static void bench_ray_packet_probes(VoidPtr user_data, u64 ops) {
+	u32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_bvh_raycast_rays(&data.bvh, data.probe_rays, BENCH_SPATIAL_PROBE_RAYS, F32_MAX, data.probe_hits);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+// the same rays one at a time
+static void bench_ray_packet_probes_single(VoidPtr user_data, u64 ops) {
+	u32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		for (u32 k = 0; k < BENCH_SPATIAL_PROBE_RAYS; ++k) {
+			hits += zi_bvh_raycast(&data.bvh, data.probe_rays[k], F32_MAX, &data.probe_hits[k]);
+		}
+	}
+	ZI_BENCH_USE(hits);
+}
+
+// occlusion checks over 30 m, like sound sources to a listener
+static void bench_ray_packet_occlusion(VoidPtr user_data, u64 ops) {
+	u32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		hits += zi_bvh_raycast_rays_any(&data.bvh, data.probe_rays, BENCH_SPATIAL_PROBE_RAYS, 30.0f, data.probe_bits);
+	}
+	ZI_BENCH_USE(hits);
+}
+
+static void bench_ray_packet_occlusion_single(VoidPtr user_data, u64 ops) {
+	u32 hits = 0;
+	for (u64 i = 0; i < ops; ++i) {
+		for (u32 k = 0; k < BENCH_SPATIAL_PROBE_RAYS; ++k) {
+			hits += zi_bvh_raycast_any(&data.bvh, data.probe_rays[k], 30.0f);
+		}
+	}
+	ZI_BENCH_USE(hits);
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+void run_spatial_benchmarks(void) {
+	bench_spatial_setup();
+
+	// one op is a whole 100k triangle build, the argument is the thread count
+	zi_bench_run(&(ZiBenchDesc){.name = "bvh/build_100k", .fn = bench_bvh_build, .user_data = (VoidPtr)1});
+	zi_bench_run(&(ZiBenchDesc){.name = "bvh/build_100k_threads_8", .fn = bench_bvh_build, .user_data = (VoidPtr)8});
+	ZI_BENCH("bvh/raycast", bench_bvh_raycast);
+	ZI_BENCH("bvh/raycast_any", bench_bvh_raycast_any);
+	ZI_BENCH("bvh/raycast_brute_force_100k", bench_raycast_brute_force);
+
+	// builds, refits and culls are whole 100k object passes per op
+	ZI_BENCH("aabb_tree/insert_100k", bench_aabb_tree_insert);
+	ZI_BENCH("aabb_tree/move", bench_aabb_tree_move);
+	ZI_BENCH("aabb_tree/update_refit_100k", bench_aabb_tree_refit);
+	ZI_BENCH("aabb_tree/query_frustum_100k", bench_aabb_tree_frustum);
+	ZI_BENCH("aabb_tree/flat_cull_100k", bench_aabb_tree_frustum_flat);
+	ZI_BENCH("aabb_tree/query_sphere", bench_aabb_tree_sphere);
+	ZI_BENCH("aabb_tree/raycast", bench_aabb_tree_raycast);
+
+	// whole 20k crowd per op except for move
+	ZI_BENCH("sap/insert_batch_20k", bench_sap_insert);
+	ZI_BENCH("sap/frame_20k", bench_sap_frame);
+	ZI_BENCH("sap/move", bench_sap_move);
+	ZI_BENCH("sap/brute_force_pairs_20k", bench_pairs_brute_force);
+
+	// 100k sprites
+	ZI_BENCH("spatial_hash/insert_100k", bench_spatial_hash_insert);
+	ZI_BENCH("spatial_hash/frame_100k", bench_spatial_hash_frame);
+	ZI_BENCH("spatial_hash/query_point", bench_spatial_hash_point);
+	ZI_BENCH("spatial_hash/brute_force_point", bench_spatial_hash_point_brute_force);
+	ZI_BENCH("spatial_hash/query_view", bench_spatial_hash_view);
+	ZI_BENCH("spatial_hash/raycast", bench_spatial_hash_raycast);
+
+	// 4096 rays per op from 64 probes
+	ZI_BENCH("ray_packet/probes_4096", bench_ray_packet_probes);
+	ZI_BENCH("ray_packet/probes_4096_single", bench_ray_packet_probes_single);
+	ZI_BENCH("ray_packet/occlusion_4096", bench_ray_packet_occlusion);
+	ZI_BENCH("ray_packet/occlusion_4096_single", bench_ray_packet_occlusion_single);
+
+	bench_spatial_teardown();
+}
@@ -0,0 +1,195 @@
+#include "zi_bench.h"
+
+#include "zi_core.h"
+#include "zi_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Benchmark runner, every run_*_benchmarks adds its results to one report
+// usage: zi_bench [--filter TEXT] [--reps N] [--warmup N] [--min-time MS] [--json PATH] [--quick]
+
+void run_core_benchmarks(void);
+void run_math_benchmarks(void);
+void run_batch_benchmarks(void);
+void run_spatial_benchmarks(void);
+
+#if !defined(__GNUC__) && !defined(__clang__)
+volatile const void* zi_bench_sink;
+#endif
+
+ZI_ARRAY(ZiBenchResults, ZiBenchResult)
+
+typedef struct ZiBenchOptions {
+	const char* filter;
+	const char* json_path;
+	u32         reps;
+	u32         warmup;
+	u64         min_rep_ns;
+} ZiBenchOptions;
+
+static ZiBenchOptions options = {
+	.reps = 30,
+	.warmup = 3,
+	.min_rep_ns = 2000000,
+};
+
+static ZiBenchResults results;
+static f64            ns_per_tick;
+
+static u64 zi_bench_time(const ZiBenchDesc* desc, u64 ops) {
+	u64 start = zi_platform_get_ticks();
+	desc->fn(desc->user_data, ops);
+	u64 end = zi_platform_get_ticks();
+	return (u64)((f64)(end - start) * ns_per_tick);
+}
+
+static int zi_bench_compare_f64(const void* a, const void* b) {
+	f64 x = *(const f64*)a;
+	f64 y = *(const f64*)b;
+	return (x > y) - (x < y);
+}
+
+void zi_bench_run(const ZiBenchDesc* desc) {
+	if (options.filter && !strstr(desc->name, options.filter)) return;
+
+	if (desc->setup) desc->setup(desc->user_data);
+
+	// grow ops until a single rep is long enough for the clock to resolve it
+	u64 ops = 1;
+	for (;;) {
+		u64 elapsed = zi_bench_time(desc, ops);
+		if (elapsed >= options.min_rep_ns || ops >= (1ull << 40)) break;
+		u64 scale = elapsed > 0 ? (options.min_rep_ns * 12 / 10) / elapsed + 1 : 16;
+		ops *= scale < 2 ? 2 : scale > 16 ? 16 : scale;
+	}
+
+	for (u32 i = 0; i < options.warmup; ++i) {
+		zi_bench_time(desc, ops);
+	}
+
+	f64 samples[ZI_BENCH_MAX_REPS];
+	u32 reps = options.reps;
+	for (u32 i = 0; i < reps; ++i) {
+		samples[i] = (f64)zi_bench_time(desc, ops) / (f64)ops;
+	}
+
+	if (desc->teardown) desc->teardown(desc->user_data);
+
+	qsort(samples, reps, sizeof(f64), zi_bench_compare_f64);
+
+	ZiBenchResult result = {0};
+	result.name = desc->name;
+	result.reps = reps;
+	result.ops_per_rep = ops;
+	result.min_ns = samples[0];
+	result.median_ns = reps % 2 ? samples[reps / 2] : (samples[reps / 2 - 1] + samples[reps / 2]) * 0.5;
+	result.p99_ns = samples[(u32)((f64)(reps - 1) * 0.99 + 0.5)];
+	result.ops_per_sec = result.median_ns > 0.0 ? 1e9 / result.median_ns : 0.0;
+	result.bytes_per_sec = result.ops_per_sec * (f64)desc->bytes_per_op;
+	ZiBenchResults_push(&results, result);
+
+	printf("%-40s %12.2f %12.2f %12.2f %14.0f", result.name, result.min_ns, result.median_ns, result.p99_ns, result.ops_per_sec);
+	if (desc->bytes_per_op) {
+		printf(" %10.2f GB/s", result.bytes_per_sec / 1e9);
+	}
+	printf("\n");
+	fflush(stdout);
+}
+
+static void zi_bench_write_json_string(FILE* fp, const char* str) {
+	fputc('"', fp);
+	for (const char* p = str; *p; ++p) {
+		if (*p == '"' || *p == '\\') fputc('\\', fp);
+		fputc(*p, fp);
+	}
+	fputc('"', fp);
+}
+
+static ZiBool zi_bench_write_json(const char* path) {
+	FILE* fp = fopen(path, "wb");
+	if (!fp) {
+		fprintf(stderr, "failed to open %s\n", path);
+		return ZI_FALSE;
+	}
+
+	char cpu_features[256];
+	zi_platform_format_cpu_features(zi_platform_cpu_features(), cpu_features, sizeof(cpu_features));
+
+	fprintf(fp, "{\n\"context\":{\"cpu_features\":");
+	zi_bench_write_json_string(fp, cpu_features);
+#ifdef __OPTIMIZE__
+	fprintf(fp, ",\"optimized\":true");
+#else
+	fprintf(fp, ",\"optimized\":false");
+#endif
+	fprintf(fp, ",\"reps\":%u,\"warmup\":%u,\"min_rep_ns\":%llu},\n\"benchmarks\":[",
+	        options.reps, options.warmup, (unsigned long long)options.min_rep_ns);
+
+	for (u64 i = 0; i < results.count; ++i) {
+		const ZiBenchResult* result = &results.data[i];
+		fprintf(fp, "%s\n{\"name\":", i > 0 ? "," : "");
+		zi_bench_write_json_string(fp, result->name);
+		fprintf(fp, ",\"reps\":%u,\"ops_per_rep\":%llu,\"min_ns\":%.3f,\"median_ns\":%.3f,\"p99_ns\":%.3f,\"ops_per_sec\":%.1f,\"bytes_per_sec\":%.1f}",
+		        result->reps, (unsigned long long)result->ops_per_rep, result->min_ns, result->median_ns, result->p99_ns,
+		        result->ops_per_sec, result->bytes_per_sec);
+	}
+	fprintf(fp, "\n]\n}\n");
+
+	ZiBool ok = ferror(fp) == 0;
+	fclose(fp);
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		ZiBool      has_value = i + 1 < argc;
+
+		if (strcmp(arg, "--filter") == 0 && has_value) {
+			options.filter = argv[++i];
+		} else if (strcmp(arg, "--reps") == 0 && has_value) {
+			options.reps = (u32)strtoul(argv[++i], ZI_NULL, 10);
+		} else if (strcmp(arg, "--warmup") == 0 && has_value) {
+			options.warmup = (u32)strtoul(argv[++i], ZI_NULL, 10);
+		} else if (strcmp(arg, "--min-time") == 0 && has_value) {
+			options.min_rep_ns = (u64)(strtod(argv[++i], ZI_NULL) * 1e6);
+		} else if (strcmp(arg, "--json") == 0 && has_value) {
+			options.json_path = argv[++i];
+		} else if (strcmp(arg, "--quick") == 0) {
+			// smoke run, checks that every benchmark runs
+			options.reps = 1;
+			options.warmup = 0;
+			options.min_rep_ns = 0;
+		} else {
+			fprintf(stderr, "usage: zi_bench [--filter TEXT] [--reps N] [--warmup N] [--min-time MS] [--json PATH] [--quick]\n");
+			return 1;
+		}
+	}
+
+	if (options.reps == 0) options.reps = 1;
+	if (options.reps > ZI_BENCH_MAX_REPS) options.reps = ZI_BENCH_MAX_REPS;
+
+#ifndef __OPTIMIZE__
+	fprintf(stderr, "warning: zi_bench was built without optimizations\n");
+#endif
+
+	ns_per_tick = 1e9 / (f64)zi_platform_get_tick_frequency();
+	ZiBenchResults_init(&results, ZI_NULL);
+
+	printf("%-40s %12s %12s %12s %14s\n", "benchmark", "min ns/op", "median ns/op", "p99 ns/op", "ops/s");
+
+	run_core_benchmarks();
+	run_math_benchmarks();
+	run_batch_benchmarks();
+	run_spatial_benchmarks();
+
+	int status = 0;
+	if (options.json_path && !zi_bench_write_json(options.json_path)) {
+		status = 1;
+	}
+
+	ZiBenchResults_free(&results);
+	return status;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "zi_common.h"
+
+// ============================================================================
+// Microbenchmark harness
+// ============================================================================
+//
+// A benchmark runs fn(user_data, ops) and reports nanoseconds per op. ops is picked during warmup so
+// one repetition takes at least the minimum rep time, then min/median/p99 are taken over the reps.
+// Build with -DCMAKE_BUILD_TYPE=Release, numbers from unoptimized builds are meaningless.
+
+#define ZI_BENCH_MAX_REPS 1000
+
+typedef void (*ZiBenchFn)(VoidPtr user_data, u64 ops);
+
+typedef struct ZiBenchDesc {
+	const char* name;
+	ZiBenchFn   fn;
+	// outside the timed region, called once before the warmup and after the last rep
+	void        (*setup)(VoidPtr user_data);
+	void        (*teardown)(VoidPtr user_data);
+	VoidPtr     user_data;
+	// reported as throughput when set
+	u64         bytes_per_op;
+} ZiBenchDesc;
+
+typedef struct ZiBenchResult {
+	const char* name;
+	u32         reps;
+	u64         ops_per_rep;
+	f64         min_ns;
+	f64         median_ns;
+	f64         p99_ns;
+	f64         ops_per_sec;
+	f64         bytes_per_sec;
+} ZiBenchResult;
+
+void zi_bench_run(const ZiBenchDesc* desc);
+
+// keeps the compiler from dropping computations whose result is otherwise unused
+#if defined(__GNUC__) || defined(__clang__)
+static inline void zi_bench_use(const void* value) {
+	__asm__ volatile("" : : "g"(value) : "memory");
+}
+#else
+extern volatile const void* zi_bench_sink;
+static inline void zi_bench_use(const void* value) {
+	zi_bench_sink = value;
+}
+#endif
+
+#define ZI_BENCH_USE(value) zi_bench_use(&(value))
+
+// the common case, no setup and no throughput
+#define ZI_BENCH(label, function) zi_bench_run(&(ZiBenchDesc){.name = (label), .fn = (function)})
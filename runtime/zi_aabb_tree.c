@@ -0,0 +1,604 @@
+#include "zi_aabb_tree.h"
+
+#include "zi_core.h"
+#include "zi_log.h"
+
+#include <string.h>
+
+#define ZI_AABB_TREE_INITIAL_CAPACITY 16
+
+// where query results go, the callback when there is one, the array otherwise
+typedef struct ZiAabbTreeSink {
+	ZiAabbTreeQueryFn fn;
+	VoidPtr           context;
+	u32*              proxies;
+	u32               capacity;
+	u32               count;
+} ZiAabbTreeSink;
+
+// ============================================================================
+// Nodes
+// ============================================================================
+
+static inline ZiBool zi_aabb_tree_is_leaf(const ZiAabbTreeNode* node) {
+	return node->child1 == ZI_AABB_TREE_NULL;
+}
+
+static inline ZiBool zi_aabb_tree_contains(ZiAABB outer, ZiAABB inner) {
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z && outer.max.x >= inner.max.x &&
+	       outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+static inline ZiAABB zi_aabb_tree_grow(ZiAABB aabb, f32 amount) {
+	ZiVec3 r = zi_vec3(amount, amount, amount);
+	return (ZiAABB){zi_vec3_sub(aabb.min, r), zi_vec3_add(aabb.max, r)};
+}
+
+// doubles the pool until two nodes are free, an insert never needs more
+static ZiBool zi_aabb_tree_reserve(ZiAabbTree* tree) {
+	if (tree->capacity - tree->node_count >= 2) return ZI_TRUE;
+
+	u32             capacity = tree->capacity ? tree->capacity * 2 : ZI_AABB_TREE_INITIAL_CAPACITY;
+	ZiAabbTreeNode* nodes = (ZiAabbTreeNode*)zi_mem_alloc(sizeof(ZiAabbTreeNode) * (u64)capacity);
+	if (!nodes) {
+		zi_log_error("out of memory growing an AABB tree to %u nodes", capacity);
+		return ZI_FALSE;
+	}
+	if (tree->nodes) {
+		memcpy(nodes, tree->nodes, sizeof(ZiAabbTreeNode) * tree->capacity);
+		zi_mem_free(tree->nodes);
+	}
+
+	// new nodes go in front of the free list, it only ever holds nodes below capacity
+	for (u32 i = tree->capacity; i < capacity; ++i) {
+		nodes[i].parent = i + 1 < capacity ? i + 1 : tree->free_list;
+		nodes[i].height = -1;
+	}
+	tree->free_list = tree->capacity;
+	tree->nodes = nodes;
+	tree->capacity = capacity;
+	return ZI_TRUE;
+}
+
+static u32 zi_aabb_tree_allocate(ZiAabbTree* tree) {
+	u32             index = tree->free_list;
+	ZiAabbTreeNode* node = &tree->nodes[index];
+	tree->free_list = node->parent;
+	node->parent = ZI_AABB_TREE_NULL;
+	node->child1 = ZI_AABB_TREE_NULL;
+	node->child2 = ZI_AABB_TREE_NULL;
+	node->height = 0;
+	node->user_data = ZI_NULL;
+	tree->node_count++;
+	return index;
+}
+
+static void zi_aabb_tree_release(ZiAabbTree* tree, u32 index) {
+	tree->nodes[index].parent = tree->free_list;
+	tree->nodes[index].height = -1;
+	tree->free_list = index;
+	tree->node_count--;
+}
+
+static inline void zi_aabb_tree_replace_child(ZiAabbTree* tree, u32 parent, u32 old_child, u32 new_child) {
+	if (parent == ZI_AABB_TREE_NULL) {
+		tree->root = new_child;
+	} else if (tree->nodes[parent].child1 == old_child) {
+		tree->nodes[parent].child1 = new_child;
+	} else {
+		tree->nodes[parent].child2 = new_child;
+	}
+}
+
+static inline void zi_aabb_tree_fix_node(ZiAabbTree* tree, u32 index) {
+	ZiAabbTreeNode*       node = &tree->nodes[index];
+	const ZiAabbTreeNode* child1 = &tree->nodes[node->child1];
+	const ZiAabbTreeNode* child2 = &tree->nodes[node->child2];
+	node->aabb = zi_aabb_union(child1->aabb, child2->aabb);
+	node->height = 1 + (child1->height > child2->height ? child1->height : child2->height);
+}
+
+// ============================================================================
+// Rotations
+// ============================================================================
+
+// Moves up, the taller child of a, into a's place. a becomes a child of up and takes the
+// shorter of up's children, up keeps the taller one:
+// a(other, up(keep, give)) -> up(a(other, give), keep)
+static u32 zi_aabb_tree_rotate(ZiAabbTree* tree, u32 a, u32 up, u32 other) {
+	ZiAabbTreeNode* nodes = tree->nodes;
+	u32             keep = nodes[up].child1;
+	u32             give = nodes[up].child2;
+	if (nodes[give].height > nodes[keep].height) {
+		u32 swap = keep;
+		keep = give;
+		give = swap;
+	}
+
+	nodes[up].parent = nodes[a].parent;
+	zi_aabb_tree_replace_child(tree, nodes[up].parent, a, up);
+	nodes[up].child1 = a;
+	nodes[up].child2 = keep;
+	nodes[a].parent = up;
+	nodes[a].child1 = other;
+	nodes[a].child2 = give;
+	nodes[give].parent = a;
+
+	zi_aabb_tree_fix_node(tree, a);
+	zi_aabb_tree_fix_node(tree, up);
+	return up;
+}
+
+// AVL style, a subtree two or more levels taller than its sibling gets rotated up. Returns
+// the node now in a's place.
+static u32 zi_aabb_tree_balance(ZiAabbTree* tree, u32 a) {
+	// a's own height is stale here, the children's are up to date
+	const ZiAabbTreeNode* node = &tree->nodes[a];
+	if (zi_aabb_tree_is_leaf(node)) return a;
+
+	u32 b = node->child1;
+	u32 c = node->child2;
+	i32 balance = tree->nodes[c].height - tree->nodes[b].height;
+	if (balance > 1) return zi_aabb_tree_rotate(tree, a, c, b);
+	if (balance < -1) return zi_aabb_tree_rotate(tree, a, b, c);
+	return a;
+}
+
+// rebalances and refits every ancestor of index up to the root
+static void zi_aabb_tree_walk_up(ZiAabbTree* tree, u32 index) {
+	while (index != ZI_AABB_TREE_NULL) {
+		index = zi_aabb_tree_balance(tree, index);
+		zi_aabb_tree_fix_node(tree, index);
+		index = tree->nodes[index].parent;
+	}
+}
+
+// ============================================================================
+// Insert / Remove
+// ============================================================================
+
+// Descends towards the sibling that grows the total surface area least: pairing with the
+// current node costs the new parent's area, going further down costs what every node on the
+// way grows by on top of what the child itself grows by.
+static u32 zi_aabb_tree_find_sibling(const ZiAabbTree* tree, ZiAABB box) {
+	const ZiAabbTreeNode* nodes = tree->nodes;
+	u32                   index = tree->root;
+	while (!zi_aabb_tree_is_leaf(&nodes[index])) {
+		const ZiAabbTreeNode* node = &nodes[index];
+		f32                   area = zi_aabb_surface_area(node->aabb);
+		f32                   combined_area = zi_aabb_surface_area(zi_aabb_union(node->aabb, box));
+		f32                   cost = 2.0f * combined_area;
+		f32                   inheritance = 2.0f * (combined_area - area);
+
+		f32 child_costs[2];
+		u32 children[2] = {node->child1, node->child2};
+		for (u32 i = 0; i < 2; ++i) {
+			const ZiAabbTreeNode* child = &nodes[children[i]];
+			f32                   grown = zi_aabb_surface_area(zi_aabb_union(child->aabb, box));
+			child_costs[i] = inheritance + (zi_aabb_tree_is_leaf(child) ? grown : grown - zi_aabb_surface_area(child->aabb));
+		}
+
+		if (cost < child_costs[0] && cost < child_costs[1]) break;
+		index = child_costs[0] < child_costs[1] ? children[0] : children[1];
+	}
+	return index;
+}
+
+// needs a free node for the new parent
+static void zi_aabb_tree_insert_leaf(ZiAabbTree* tree, u32 leaf) {
+	if (tree->root == ZI_AABB_TREE_NULL) {
+		tree->root = leaf;
+		tree->nodes[leaf].parent = ZI_AABB_TREE_NULL;
+		return;
+	}
+
+	u32 sibling = zi_aabb_tree_find_sibling(tree, tree->nodes[leaf].aabb);
+	u32 old_parent = tree->nodes[sibling].parent;
+	u32 parent = zi_aabb_tree_allocate(tree);
+
+	ZiAabbTreeNode* nodes = tree->nodes;
+	nodes[parent].parent = old_parent;
+	nodes[parent].child1 = sibling;
+	nodes[parent].child2 = leaf;
+	nodes[parent].aabb = zi_aabb_union(nodes[sibling].aabb, nodes[leaf].aabb);
+	nodes[parent].height = nodes[sibling].height + 1;
+	zi_aabb_tree_replace_child(tree, old_parent, sibling, parent);
+	nodes[sibling].parent = parent;
+	nodes[leaf].parent = parent;
+
+	zi_aabb_tree_walk_up(tree, old_parent);
+}
+
+// unlinks the leaf, its sibling takes the parent's place and the parent is freed
+static void zi_aabb_tree_remove_leaf(ZiAabbTree* tree, u32 leaf) {
+	if (leaf == tree->root) {
+		tree->root = ZI_AABB_TREE_NULL;
+		return;
+	}
+
+	ZiAabbTreeNode* nodes = tree->nodes;
+	u32             parent = nodes[leaf].parent;
+	u32             grand_parent = nodes[parent].parent;
+	u32             sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	zi_aabb_tree_replace_child(tree, grand_parent, parent, sibling);
+	nodes[sibling].parent = grand_parent;
+	zi_aabb_tree_release(tree, parent);
+
+	zi_aabb_tree_walk_up(tree, grand_parent);
+}
+
+void zi_aabb_tree_init(ZiAabbTree* tree, f32 margin) {
+	memset(tree, 0, sizeof(*tree));
+	tree->root = ZI_AABB_TREE_NULL;
+	tree->free_list = ZI_AABB_TREE_NULL;
+	tree->margin = margin < 0.0f ? ZI_AABB_TREE_DEFAULT_MARGIN : margin;
+}
+
+void zi_aabb_tree_destroy(ZiAabbTree* tree) {
+	zi_mem_free(tree->nodes);
+	zi_aabb_tree_init(tree, tree->margin);
+}
+
+u32 zi_aabb_tree_insert(ZiAabbTree* tree, ZiAABB aabb, VoidPtr user_data) {
+	if (!zi_aabb_tree_reserve(tree)) return ZI_AABB_TREE_NULL;
+
+	u32 proxy = zi_aabb_tree_allocate(tree);
+	tree->nodes[proxy].aabb = zi_aabb_tree_grow(aabb, tree->margin);
+	tree->nodes[proxy].user_data = user_data;
+	zi_aabb_tree_insert_leaf(tree, proxy);
+	tree->proxy_count++;
+	return proxy;
+}
+
+void zi_aabb_tree_remove(ZiAabbTree* tree, u32 proxy) {
+	zi_aabb_tree_remove_leaf(tree, proxy);
+	zi_aabb_tree_release(tree, proxy);
+	tree->proxy_count--;
+}
+
+ZiBool zi_aabb_tree_move(ZiAabbTree* tree, u32 proxy, ZiAABB aabb, ZiVec3 displacement) {
+	ZiAABB fat = zi_aabb_tree_grow(aabb, tree->margin);
+	ZiVec3 ahead = zi_vec3_scale(displacement, ZI_AABB_TREE_DISPLACEMENT_SCALE);
+	for (u32 axis = 0; axis < 3; ++axis) {
+		f32 d = (&ahead.x)[axis];
+		if (d < 0.0f) {
+			(&fat.min.x)[axis] += d;
+		} else {
+			(&fat.max.x)[axis] += d;
+		}
+	}
+
+	ZiAABB current = tree->nodes[proxy].aabb;
+	if (zi_aabb_tree_contains(current, aabb)) {
+		// still fits, unless the box stretched for a fast move is far too big now
+		ZiAABB huge = zi_aabb_tree_grow(fat, 4.0f * tree->margin);
+		if (zi_aabb_tree_contains(huge, current)) return ZI_FALSE;
+	}
+
+	// the leaf's own node is reused, the proxy stays the same
+	zi_aabb_tree_remove_leaf(tree, proxy);
+	tree->nodes[proxy].aabb = fat;
+	zi_aabb_tree_insert_leaf(tree, proxy);
+	return ZI_TRUE;
+}
+
+// ============================================================================
+// Refit
+// ============================================================================
+
+void zi_aabb_tree_update(ZiAabbTree* tree, u32 proxy, ZiAABB aabb) {
+	ZiAabbTreeNode* node = &tree->nodes[proxy];
+	if (!zi_aabb_tree_contains(node->aabb, aabb)) {
+		node->aabb = zi_aabb_tree_grow(aabb, tree->margin);
+	}
+}
+
+// The walks hold at most one entry per level plus the root, so the root's height bounds their
+// stacks. The rotations keep trees far below ZI_AABB_TREE_MAX_DEPTH, anything deeper gets its
+// stacks from the heap instead of overflowing the local ones.
+static ZiBool zi_aabb_tree_stacks_fit(const ZiAabbTree* tree) {
+	return tree->nodes[tree->root].height + 2 <= ZI_AABB_TREE_MAX_DEPTH;
+}
+
+static VoidPtr zi_aabb_tree_heap_stack(const ZiAabbTree* tree, u64 element_size) {
+	VoidPtr stack = zi_mem_alloc(element_size * (u64)(tree->nodes[tree->root].height + 2));
+	if (!stack) {
+		zi_log_error("out of memory walking an AABB tree of height %d", tree->nodes[tree->root].height);
+	}
+	return stack;
+}
+
+// post order, a node's box is the union of its children's once both are done
+void zi_aabb_tree_refit(ZiAabbTree* tree) {
+	if (tree->root == ZI_AABB_TREE_NULL) return;
+
+	ZiAabbTreeNode* nodes = tree->nodes;
+	u32             local_stack[ZI_AABB_TREE_MAX_DEPTH];
+	u32*            stack = zi_aabb_tree_stacks_fit(tree) ? local_stack : zi_aabb_tree_heap_stack(tree, sizeof(u32));
+	if (!stack) return;
+	u32             top = 0;
+	u32             index = tree->root;
+	u32             last = ZI_AABB_TREE_NULL;
+	for (;;) {
+		// down the left side, the rights come when climbing back
+		while (!zi_aabb_tree_is_leaf(&nodes[index])) {
+			stack[top++] = index;
+			index = nodes[index].child1;
+		}
+		last = index;
+
+		for (;;) {
+			if (top == 0) goto done;
+			u32 parent = stack[top - 1];
+			if (last == nodes[parent].child1) {
+				index = nodes[parent].child2;
+				break;
+			}
+			nodes[parent].aabb = zi_aabb_union(nodes[nodes[parent].child1].aabb, nodes[nodes[parent].child2].aabb);
+			last = parent;
+			--top;
+		}
+	}
+
+done:
+	if (stack != local_stack) zi_mem_free(stack);
+}
+
+VoidPtr zi_aabb_tree_user_data(const ZiAabbTree* tree, u32 proxy) {
+	return tree->nodes[proxy].user_data;
+}
+
+ZiAABB zi_aabb_tree_fat_aabb(const ZiAabbTree* tree, u32 proxy) {
+	return tree->nodes[proxy].aabb;
+}
+
+i32 zi_aabb_tree_height(const ZiAabbTree* tree) {
+	return tree->root == ZI_AABB_TREE_NULL ? 0 : tree->nodes[tree->root].height;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+static inline ZiBool zi_aabb_tree_emit(ZiAabbTreeSink* sink, const ZiAabbTree* tree, u32 proxy) {
+	if (sink->fn) return sink->fn(sink->context, proxy, tree->nodes[proxy].user_data);
+	if (sink->count < sink->capacity) {
+		sink->proxies[sink->count] = proxy;
+	}
+	sink->count++;
+	return ZI_TRUE;
+}
+
+static inline ZiBool zi_aabb_tree_sphere_overlaps(ZiSphere sphere, ZiAABB box) {
+	ZiVec3 closest = zi_vec3(zi_clamp_f32(sphere.center.x, box.min.x, box.max.x), zi_clamp_f32(sphere.center.y, box.min.y, box.max.y),
+	                         zi_clamp_f32(sphere.center.z, box.min.z, box.max.z));
+	return zi_vec3_length_sq(zi_vec3_sub(closest, sphere.center)) <= sphere.radius * sphere.radius;
+}
+
+static void zi_aabb_tree_walk_aabb(const ZiAabbTree* tree, ZiAABB aabb, ZiAabbTreeSink* sink) {
+	if (tree->root == ZI_AABB_TREE_NULL) return;
+
+	u32  local_stack[ZI_AABB_TREE_MAX_DEPTH];
+	u32* stack = zi_aabb_tree_stacks_fit(tree) ? local_stack : zi_aabb_tree_heap_stack(tree, sizeof(u32));
+	if (!stack) return;
+	u32 top = 0;
+	stack[top++] = tree->root;
+	while (top > 0) {
+		const ZiAabbTreeNode* node = &tree->nodes[stack[--top]];
+		if (!zi_aabb_aabb_intersect(node->aabb, aabb)) continue;
+		if (zi_aabb_tree_is_leaf(node)) {
+			if (!zi_aabb_tree_emit(sink, tree, (u32)(node - tree->nodes))) break;
+		} else {
+			stack[top++] = node->child2;
+			stack[top++] = node->child1;
+		}
+	}
+	if (stack != local_stack) zi_mem_free(stack);
+}
+
+static void zi_aabb_tree_walk_sphere(const ZiAabbTree* tree, ZiSphere sphere, ZiAabbTreeSink* sink) {
+	if (tree->root == ZI_AABB_TREE_NULL) return;
+
+	u32  local_stack[ZI_AABB_TREE_MAX_DEPTH];
+	u32* stack = zi_aabb_tree_stacks_fit(tree) ? local_stack : zi_aabb_tree_heap_stack(tree, sizeof(u32));
+	if (!stack) return;
+	u32 top = 0;
+	stack[top++] = tree->root;
+	while (top > 0) {
+		const ZiAabbTreeNode* node = &tree->nodes[stack[--top]];
+		if (!zi_aabb_tree_sphere_overlaps(sphere, node->aabb)) continue;
+		if (zi_aabb_tree_is_leaf(node)) {
+			if (!zi_aabb_tree_emit(sink, tree, (u32)(node - tree->nodes))) break;
+		} else {
+			stack[top++] = node->child2;
+			stack[top++] = node->child1;
+		}
+	}
+	if (stack != local_stack) zi_mem_free(stack);
+}
+
+// Every stack entry carries the planes its box still straddles. Boxes fully inside a plane
+// drop it for the whole subtree, below a box inside all six every leaf is visible untested.
+static void zi_aabb_tree_walk_frustum(const ZiAabbTree* tree, const ZiFrustum* frustum, ZiAabbTreeSink* sink) {
+	if (tree->root == ZI_AABB_TREE_NULL) return;
+
+	u32  local_stack[ZI_AABB_TREE_MAX_DEPTH];
+	u8   local_planes[ZI_AABB_TREE_MAX_DEPTH];
+	u32* stack = local_stack;
+	u8*  stack_planes = local_planes;
+	if (!zi_aabb_tree_stacks_fit(tree)) {
+		stack = zi_aabb_tree_heap_stack(tree, sizeof(u32) + sizeof(u8));
+		if (!stack) return;
+		stack_planes = (u8*)(stack + tree->nodes[tree->root].height + 2);
+	}
+	u32 top = 0;
+	stack[top] = tree->root;
+	stack_planes[top++] = 0x3f;
+	while (top > 0) {
+		--top;
+		const ZiAabbTreeNode* node = &tree->nodes[stack[top]];
+		u8                    planes = stack_planes[top];
+
+		ZiBool outside = ZI_FALSE;
+		for (u32 i = 0; i < 6 && planes; ++i) {
+			if (!(planes & (1u << i))) continue;
+			const ZiPlane* plane = &frustum->planes[i];
+			// corner furthest along the normal, then the one furthest against it
+			ZiVec3 p, n;
+			p.x = plane->normal.x > 0.0f ? node->aabb.max.x : node->aabb.min.x;
+			p.y = plane->normal.y > 0.0f ? node->aabb.max.y : node->aabb.min.y;
+			p.z = plane->normal.z > 0.0f ? node->aabb.max.z : node->aabb.min.z;
+			if (zi_plane_distance_to_point(*plane, p) < 0.0f) {
+				outside = ZI_TRUE;
+				break;
+			}
+			n.x = plane->normal.x > 0.0f ? node->aabb.min.x : node->aabb.max.x;
+			n.y = plane->normal.y > 0.0f ? node->aabb.min.y : node->aabb.max.y;
+			n.z = plane->normal.z > 0.0f ? node->aabb.min.z : node->aabb.max.z;
+			if (zi_plane_distance_to_point(*plane, n) >= 0.0f) {
+				planes &= (u8)~(1u << i);
+			}
+		}
+		if (outside) continue;
+
+		if (zi_aabb_tree_is_leaf(node)) {
+			if (!zi_aabb_tree_emit(sink, tree, (u32)(node - tree->nodes))) break;
+		} else {
+			stack[top] = node->child2;
+			stack_planes[top++] = planes;
+			stack[top] = node->child1;
+			stack_planes[top++] = planes;
+		}
+	}
+	if (stack != local_stack) zi_mem_free(stack);
+}
+
+// axis-parallel rays get a huge finite inverse instead of infinity, see zi_bvh.c
+static inline f32 zi_aabb_tree_safe_inverse(f32 d) {
+	return zi_abs_f32(d) > 1e-30f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+}
+
+// distance where the ray enters the box, F32_MAX when it misses it before t_max
+static inline f32 zi_aabb_tree_ray_box(ZiAABB box, ZiVec3 origin, ZiVec3 inv_dir, f32 t_max) {
+	f32 tx1 = (box.min.x - origin.x) * inv_dir.x;
+	f32 tx2 = (box.max.x - origin.x) * inv_dir.x;
+	f32 ty1 = (box.min.y - origin.y) * inv_dir.y;
+	f32 ty2 = (box.max.y - origin.y) * inv_dir.y;
+	f32 tz1 = (box.min.z - origin.z) * inv_dir.z;
+	f32 tz2 = (box.max.z - origin.z) * inv_dir.z;
+	f32 t_near = zi_max_f32(zi_max_f32(zi_min_f32(tx1, tx2), zi_min_f32(ty1, ty2)), zi_max_f32(zi_min_f32(tz1, tz2), 0.0f));
+	f32 t_far = zi_min_f32(zi_min_f32(zi_max_f32(tx1, tx2), zi_max_f32(ty1, ty2)), zi_min_f32(zi_max_f32(tz1, tz2), t_max));
+	return t_near <= t_far ? t_near : F32_MAX;
+}
+
+// near child first, far ones are skipped once the callback clipped the ray in front of them
+static void zi_aabb_tree_walk_ray(const ZiAabbTree* tree, ZiRay ray, f32 max_t, ZiAabbTreeRayFn fn, VoidPtr context, ZiAabbTreeSink* sink) {
+	if (tree->root == ZI_AABB_TREE_NULL) return;
+
+	ZiVec3 origin = ray.origin;
+	ZiVec3 dir = ray.direction;
+	ZiVec3 inv_dir = zi_vec3(zi_aabb_tree_safe_inverse(dir.x), zi_aabb_tree_safe_inverse(dir.y), zi_aabb_tree_safe_inverse(dir.z));
+
+	f32 t = zi_aabb_tree_ray_box(tree->nodes[tree->root].aabb, origin, inv_dir, max_t);
+	if (t == F32_MAX) return;
+
+	u32  local_stack[ZI_AABB_TREE_MAX_DEPTH];
+	f32  local_t[ZI_AABB_TREE_MAX_DEPTH];
+	u32* stack = local_stack;
+	f32* stack_t = local_t;
+	if (!zi_aabb_tree_stacks_fit(tree)) {
+		stack = zi_aabb_tree_heap_stack(tree, sizeof(u32) + sizeof(f32));
+		if (!stack) return;
+		stack_t = (f32*)(stack + tree->nodes[tree->root].height + 2);
+	}
+	u32 top = 0;
+	stack[top] = tree->root;
+	stack_t[top++] = t;
+
+	while (top > 0) {
+		--top;
+		if (stack_t[top] > max_t) continue;
+		u32                   index = stack[top];
+		const ZiAabbTreeNode* node = &tree->nodes[index];
+
+		if (zi_aabb_tree_is_leaf(node)) {
+			if (fn) {
+				f32 clip = fn(context, index, node->user_data, ray, max_t);
+				if (clip <= 0.0f) break;
+				max_t = zi_min_f32(max_t, clip);
+			} else {
+				zi_aabb_tree_emit(sink, tree, index);
+			}
+			continue;
+		}
+
+		u32 near = node->child1;
+		u32 far = node->child2;
+		f32 t_near = zi_aabb_tree_ray_box(tree->nodes[near].aabb, origin, inv_dir, max_t);
+		f32 t_far = zi_aabb_tree_ray_box(tree->nodes[far].aabb, origin, inv_dir, max_t);
+		if (t_far < t_near) {
+			u32 swap = near;
+			near = far;
+			far = swap;
+			f32 swap_t = t_near;
+			t_near = t_far;
+			t_far = swap_t;
+		}
+		// pushed far first so near pops next
+		if (t_far != F32_MAX) {
+			stack[top] = far;
+			stack_t[top++] = t_far;
+		}
+		if (t_near != F32_MAX) {
+			stack[top] = near;
+			stack_t[top++] = t_near;
+		}
+	}
+	if (stack != local_stack) zi_mem_free(stack);
+}
+
+void zi_aabb_tree_query_aabb(const ZiAabbTree* tree, ZiAABB aabb, ZiAabbTreeQueryFn fn, VoidPtr context) {
+	ZiAabbTreeSink sink = {fn, context, ZI_NULL, 0, 0};
+	zi_aabb_tree_walk_aabb(tree, aabb, &sink);
+}
+
+void zi_aabb_tree_query_sphere(const ZiAabbTree* tree, ZiSphere sphere, ZiAabbTreeQueryFn fn, VoidPtr context) {
+	ZiAabbTreeSink sink = {fn, context, ZI_NULL, 0, 0};
+	zi_aabb_tree_walk_sphere(tree, sphere, &sink);
+}
+
+void zi_aabb_tree_query_frustum(const ZiAabbTree* tree, const ZiFrustum* frustum, ZiAabbTreeQueryFn fn, VoidPtr context) {
+	ZiAabbTreeSink sink = {fn, context, ZI_NULL, 0, 0};
+	zi_aabb_tree_walk_frustum(tree, frustum, &sink);
+}
+
+void zi_aabb_tree_raycast(const ZiAabbTree* tree, ZiRay ray, f32 max_t, ZiAabbTreeRayFn fn, VoidPtr context) {
+	// without fn the hits only go to an empty sink, like the queries with a NULL callback
+	ZiAabbTreeSink sink = {ZI_NULL, ZI_NULL, ZI_NULL, 0, 0};
+	zi_aabb_tree_walk_ray(tree, ray, max_t, fn, context, &sink);
+}
+
+u32 zi_aabb_tree_collect_aabb(const ZiAabbTree* tree, ZiAABB aabb, u32* proxies, u32 capacity) {
+	ZiAabbTreeSink sink = {ZI_NULL, ZI_NULL, proxies, capacity, 0};
+	zi_aabb_tree_walk_aabb(tree, aabb, &sink);
+	return sink.count;
+}
+
+u32 zi_aabb_tree_collect_sphere(const ZiAabbTree* tree, ZiSphere sphere, u32* proxies, u32 capacity) {
+	ZiAabbTreeSink sink = {ZI_NULL, ZI_NULL, proxies, capacity, 0};
+	zi_aabb_tree_walk_sphere(tree, sphere, &sink);
+	return sink.count;
+}
+
+u32 zi_aabb_tree_collect_frustum(const ZiAabbTree* tree, const ZiFrustum* frustum, u32* proxies, u32 capacity) {
+	ZiAabbTreeSink sink = {ZI_NULL, ZI_NULL, proxies, capacity, 0};
+	zi_aabb_tree_walk_frustum(tree, frustum, &sink);
+	return sink.count;
+}
+
+u32 zi_aabb_tree_collect_ray(const ZiAabbTree* tree, ZiRay ray, f32 max_t, u32* proxies, u32 capacity) {
+	ZiAabbTreeSink sink = {ZI_NULL, ZI_NULL, proxies, capacity, 0};
+	zi_aabb_tree_walk_ray(tree, ray, max_t, ZI_NULL, ZI_NULL, &sink);
+	return sink.count;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "zi_common.h"
+#include "zi_math.h"
+
+// ============================================================================
+// Dynamic AABB tree
+// ============================================================================
+//
+// Bounding volume tree over moving boxes for scene queries. Leaves store the box grown by
+// the tree's margin, a move that stays inside that fat box costs nothing. A move that doesn't
+// reinserts the leaf. Insert, remove and reinsert are O(log n), and the tree is rebalanced
+// with rotations on the way back up. Queries return anything whose fat box passes, so filter
+// against the real bounds when that matters.
+//
+// Proxies are node indices. They stay valid until removed and get reused afterwards. Not
+// thread safe for writes, any number of threads can query a tree nobody modifies.
+
+#define ZI_AABB_TREE_NULL           0xffffffffu
+#define ZI_AABB_TREE_DEFAULT_MARGIN 0.1f
+// a reinserted leaf is stretched this many times its last displacement ahead
+#define ZI_AABB_TREE_DISPLACEMENT_SCALE 4.0f
+// sizes the query stacks on the C stack, deeper trees walk with heap stacks
+#define ZI_AABB_TREE_MAX_DEPTH      128
+
+typedef struct ZiAabbTreeNode {
+	// fat box for leaves, union of the children for inner nodes
+	ZiAABB  aabb;
+	// next free node while on the free list
+	u32     parent;
+	// ZI_AABB_TREE_NULL for leaves
+	u32     child1;
+	u32     child2;
+	// leaves are 0, free nodes -1
+	i32     height;
+	VoidPtr user_data;
+} ZiAabbTreeNode;
+
+typedef struct ZiAabbTree {
+	ZiAabbTreeNode* nodes;
+	u32             capacity;
+	u32             node_count;
+	u32             root;
+	u32             free_list;
+	u32             proxy_count;
+	f32             margin;
+} ZiAabbTree;
+
+// return ZI_FALSE to stop the query
+typedef ZiBool (*ZiAabbTreeQueryFn)(VoidPtr context, u32 proxy, VoidPtr user_data);
+// Returns the new max_t, the ray is clipped to it from then on. Return max_t to keep going,
+// 0 to stop, or the hit distance to only look for closer ones.
+typedef f32 (*ZiAabbTreeRayFn)(VoidPtr context, u32 proxy, VoidPtr user_data, ZiRay ray, f32 max_t);
+
+// margin below 0 picks ZI_AABB_TREE_DEFAULT_MARGIN
+void    zi_aabb_tree_init(ZiAabbTree* tree, f32 margin);
+void    zi_aabb_tree_destroy(ZiAabbTree* tree);
+
+u32     zi_aabb_tree_insert(ZiAabbTree* tree, ZiAABB aabb, VoidPtr user_data);
+void    zi_aabb_tree_remove(ZiAabbTree* tree, u32 proxy);
+// Reinserts the leaf when aabb left its fat box, stretched along displacement (the motion per
+// update) so the next few moves fit. Returns whether it was reinserted.
+ZiBool  zi_aabb_tree_move(ZiAabbTree* tree, u32 proxy, ZiAABB aabb, ZiVec3 displacement);
+
+// Bulk path for when most objects move every frame: zi_aabb_tree_update refattens leaves
+// that left their fat box in place, without touching the rest of the tree, and
+// zi_aabb_tree_refit fixes all inner boxes in one pass afterwards. Queries in between miss
+// things. The structure stays as it was, reinsert the worst movers now and then to keep it good.
+void    zi_aabb_tree_update(ZiAabbTree* tree, u32 proxy, ZiAABB aabb);
+void    zi_aabb_tree_refit(ZiAabbTree* tree);
+
+VoidPtr zi_aabb_tree_user_data(const ZiAabbTree* tree, u32 proxy);
+ZiAABB  zi_aabb_tree_fat_aabb(const ZiAabbTree* tree, u32 proxy);
+// 0 for an empty tree or a single leaf
+i32     zi_aabb_tree_height(const ZiAabbTree* tree);
+
+void zi_aabb_tree_query_aabb(const ZiAabbTree* tree, ZiAABB aabb, ZiAabbTreeQueryFn fn, VoidPtr context);
+void zi_aabb_tree_query_sphere(const ZiAabbTree* tree, ZiSphere sphere, ZiAabbTreeQueryFn fn, VoidPtr context);
+// same test as zi_frustum_contains_aabb, whole subtrees inside a plane skip testing it again
+void zi_aabb_tree_query_frustum(const ZiAabbTree* tree, const ZiFrustum* frustum, ZiAabbTreeQueryFn fn, VoidPtr context);
+// fat boxes the ray enters before max_t, nearest subtree first
+void zi_aabb_tree_raycast(const ZiAabbTree* tree, ZiRay ray, f32 max_t, ZiAabbTreeRayFn fn, VoidPtr context);
+
+// Array forms, proxies in traversal order. Write at most capacity and return how many matched
+// in total, a result above capacity means the array was too small.
+u32 zi_aabb_tree_collect_aabb(const ZiAabbTree* tree, ZiAABB aabb, u32* proxies, u32 capacity);
+u32 zi_aabb_tree_collect_sphere(const ZiAabbTree* tree, ZiSphere sphere, u32* proxies, u32 capacity);
+u32 zi_aabb_tree_collect_frustum(const ZiAabbTree* tree, const ZiFrustum* frustum, u32* proxies, u32 capacity);
+u32 zi_aabb_tree_collect_ray(const ZiAabbTree* tree, ZiRay ray, f32 max_t, u32* proxies, u32 capacity);
@@ -1,32 +1,179 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_App
+
 #include "zi_app.h"
 
 #include "zi_graphics.h"
 #include "zi_log.h"
+#include "zi_platform.h"
+#include "zi_profiler.h"
+
+#include <string.h>
 
 
 static u8 is_running = ZI_FALSE;
 
+static ZiAppSettings   app_settings;
+static ZiFixedTimestep app_timestep;
+static ZiAppTime       app_time;
+static u64             last_ticks;
+static ZiFramePacer    app_pacer;
+static ZiBool          app_throttled;
+
 void zi_graphics_init(ZiGraphicsBackend backend);
 void zi_graphics_terminate();
 
-void zi_app_init() {
-	zi_graphics_init(0);
+void zi_app_init(const ZiAppSettings* settings) {
+	zi_log_init();
+	zi_profiler_init();
+
+	char cpu_features[256];
+	zi_platform_format_cpu_features(zi_platform_cpu_features(), cpu_features, sizeof(cpu_features));
+	zi_log_debug("cpu features: %s", cpu_features);
+
+	app_settings = *settings;
+	if (app_settings.fixed_timestep <= 0.0) {
+		app_settings.fixed_timestep = ZI_APP_DEFAULT_FIXED_TIMESTEP;
+	}
+	zi_fixed_timestep_init(&app_timestep, app_settings.fixed_timestep);
+	app_time = (ZiAppTime){0};
+	app_time.fixed_delta = app_settings.fixed_timestep;
+
+	if (app_settings.background_fps <= 0.0) {
+		app_settings.background_fps = ZI_APP_DEFAULT_BACKGROUND_FPS;
+	}
+	zi_frame_pacer_init(&app_pacer, app_settings.target_fps);
+	app_throttled = ZI_FALSE;
+
+	zi_graphics_init(app_settings.graphics_backend);
+
+	if (app_settings.frames_in_flight > 0) {
+		zi_graphics_set_frames_in_flight(app_settings.frames_in_flight);
+	}
+
+	last_ticks = zi_platform_get_ticks();
 	is_running = ZI_TRUE;
 }
 
+// explicit pairs rather than scoped zones, so the frame shows up on MSVC as well
 void zi_app_loop() {
-	//zi_log_info("app is running");
+	ZI_PROFILE_FRAME();
+	ZI_PROFILE_BEGIN(zi_app_loop);
+
+	ZI_PROFILE_BEGIN(zi_frame_pacer_wait);
+	zi_frame_pacer_wait(&app_pacer);
+	ZI_PROFILE_END(zi_frame_pacer_wait);
+
+	u64 now = zi_platform_get_ticks();
+	f64 frame_time = (f64)(now - last_ticks) / (f64)zi_platform_get_tick_frequency();
+	last_ticks = now;
+
+	u32 steps = zi_fixed_timestep_advance(&app_timestep, frame_time);
+
+	app_time.delta = frame_time < ZI_FIXED_TIMESTEP_MAX_FRAME_TIME ? frame_time : ZI_FIXED_TIMESTEP_MAX_FRAME_TIME;
+	app_time.elapsed += app_time.delta;
+
+	for (u32 i = 0; i < steps; ++i) {
+		ZI_PROFILE_BEGIN(fixed_update);
+		if (app_settings.fixed_update) {
+			app_settings.fixed_update(app_settings.fixed_timestep);
+		}
+		app_time.fixed_steps++;
+		ZI_PROFILE_END(fixed_update);
+	}
+
+	app_time.alpha = zi_fixed_timestep_alpha(&app_timestep);
+
+	if (app_settings.update) {
+		ZI_PROFILE_BEGIN(update);
+		app_settings.update(app_time.delta);
+		ZI_PROFILE_END(update);
+	}
+
+	if (app_settings.render) {
+		ZI_PROFILE_BEGIN(render);
+		app_settings.render(app_time.alpha);
+		ZI_PROFILE_END(render);
+	}
+	zi_graphics_end_frame();
+
+	app_time.frame++;
+	ZI_PROFILE_END(zi_app_loop);
+}
+
+// Seconds the platform loop can block waiting for events before the app has work again.
+// Apps that render are paced by presentation and the pacer, anything else only wakes up for the next fixed step.
+f64 zi_app_get_idle_time() {
+	f64 idle_time = 0.0;
+
+	if (!app_settings.render) {
+		f64 since_last = (f64)(zi_platform_get_ticks() - last_ticks) / (f64)zi_platform_get_tick_frequency();
+		idle_time = zi_fixed_timestep_remaining(&app_timestep) - since_last;
+	}
+
+	// precision doesn't matter in the background, let the platform block for the whole frame
+	if (app_throttled) {
+		f64 remaining = zi_frame_pacer_get_remaining(&app_pacer);
+		if (remaining > idle_time) {
+			idle_time = remaining;
+		}
+	}
+
+	return idle_time > 0.0 ? idle_time : 0.0;
+}
+
+// called by the platform when the window loses focus or gets minimized
+void zi_app_set_throttled(ZiBool throttled) {
+	if (app_throttled == throttled) {
+		return;
+	}
+	app_throttled = throttled;
+	zi_frame_pacer_set_target(&app_pacer, throttled ? app_settings.background_fps : app_settings.target_fps);
+}
+
+void zi_app_set_target_fps(f64 target_fps) {
+	app_settings.target_fps = target_fps;
+	if (!app_throttled) {
+		zi_frame_pacer_set_target(&app_pacer, target_fps);
+	}
+}
+
+void zi_app_get_frame_timing(ZiFrameTimingStats* stats) {
+	zi_frame_pacer_get_stats(&app_pacer, stats);
+}
+
+static void zi_app_write_profile(const char* path) {
+	ZiProfileCapture capture;
+	if (!zi_profiler_capture(&capture)) {
+		return;
+	}
+
+	u64    length = strlen(path);
+	ZiBool json = length >= 5 && strcmp(path + length - 5, ".json") == 0;
+	if (json ? zi_profiler_write_chrome_trace(&capture, path) : zi_profiler_write_binary(&capture, path)) {
+		zi_log_info("profile written to %s", path);
+	}
+	zi_profiler_capture_free(&capture);
 }
 
 void zi_app_terminate() {
 	zi_graphics_terminate();
 	is_running = ZI_FALSE;
+
+	if (app_settings.profile_path) {
+		zi_app_write_profile(app_settings.profile_path);
+	}
+	zi_profiler_shutdown();
+	zi_log_shutdown();
 }
 
 u8 zi_app_is_running() {
 	return is_running;
 }
 
+const ZiAppTime* zi_app_get_time(void) {
+	return &app_time;
+}
+
 void zi_app_set_app_running(u8 p_is_running) {
 	is_running = p_is_running;
 }
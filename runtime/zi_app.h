@@ -1,9 +1,93 @@
 #pragma once
 
 #include "zi_common.h"
+#include "zi_frame_pacer.h"
+#include "zi_graphics.h"
+
+typedef void (*ZiAppFixedUpdateFn)(f64 dt);
+typedef void (*ZiAppUpdateFn)(f64 dt);
+typedef void (*ZiAppRenderFn)(f64 alpha);
 
 typedef struct ZiAppSettings {
 	const char* title;
+	// simulation rate in seconds, 0 uses ZI_APP_DEFAULT_FIXED_TIMESTEP
+	f64 fixed_timestep;
+	// called zero or more times per frame, always with fixed_timestep
+	ZiAppFixedUpdateFn fixed_update;
+	// called once per frame with the real frame time
+	ZiAppUpdateFn update;
+	// alpha in [0, 1) is how far the frame is between the last and the next fixed step, for interpolation
+	ZiAppRenderFn render;
+	// frame rate cap, 0 leaves pacing to vsync
+	f64 target_fps;
+	// frame rate while the window is unfocused or minimized, 0 uses ZI_APP_DEFAULT_BACKGROUND_FPS
+	f64 background_fps;
+	// 1..ZI_MAX_FRAMES_IN_FLIGHT, fewer frames lower input latency at the cost of throughput; 0 keeps the default
+	u32 frames_in_flight;
+	// 0 lets the platform pick, headless runs force ZiGraphicsBackend_Null unless started with --gpu
+	ZiGraphicsBackend graphics_backend;
+	// profiler capture written on shutdown, a Chrome trace when it ends in .json, the binary format otherwise
+	const char* profile_path;
 } ZiAppSettings;
 
-u8 zi_app_is_running();
\ No newline at end of file
+#define ZI_APP_DEFAULT_BACKGROUND_FPS 10.0
+
+typedef struct ZiAppTime {
+	f64 delta;
+	f64 elapsed;
+	f64 fixed_delta;
+	f64 alpha;
+	u64 frame;
+	u64 fixed_steps;
+} ZiAppTime;
+
+u8               zi_app_is_running();
+const ZiAppTime* zi_app_get_time(void);
+void             zi_app_set_target_fps(f64 target_fps);
+// measured over the last ZI_FRAME_PACER_HISTORY frames
+void             zi_app_get_frame_timing(ZiFrameTimingStats* stats);
+
+// ============================================================================
+// Fixed timestep
+// ============================================================================
+
+#define ZI_APP_DEFAULT_FIXED_TIMESTEP    (1.0 / 60.0)
+#define ZI_FIXED_TIMESTEP_MAX_FRAME_TIME 0.25
+#define ZI_FIXED_TIMESTEP_MAX_STEPS      8
+
+typedef struct ZiFixedTimestep {
+	f64 step;
+	f64 accumulator;
+} ZiFixedTimestep;
+
+static inline void zi_fixed_timestep_init(ZiFixedTimestep* timestep, f64 step) {
+	timestep->step = step;
+	timestep->accumulator = 0.0;
+}
+
+// Adds the frame time and returns how many fixed steps are due. Long frames are clamped and at most
+// ZI_FIXED_TIMESTEP_MAX_STEPS run per frame, the rest is dropped so a slow frame can't snowball.
+static inline u32 zi_fixed_timestep_advance(ZiFixedTimestep* timestep, f64 frame_time) {
+	if (frame_time < 0.0) frame_time = 0.0;
+	if (frame_time > ZI_FIXED_TIMESTEP_MAX_FRAME_TIME) frame_time = ZI_FIXED_TIMESTEP_MAX_FRAME_TIME;
+
+	timestep->accumulator += frame_time;
+
+	u32 steps = 0;
+	while (timestep->accumulator >= timestep->step) {
+		timestep->accumulator -= timestep->step;
+		if (steps < ZI_FIXED_TIMESTEP_MAX_STEPS) {
+			steps++;
+		}
+	}
+	return steps;
+}
+
+static inline f64 zi_fixed_timestep_alpha(const ZiFixedTimestep* timestep) {
+	return timestep->accumulator / timestep->step;
+}
+
+// seconds of accumulated time missing until the next step is due
+static inline f64 zi_fixed_timestep_remaining(const ZiFixedTimestep* timestep) {
+	return timestep->step - timestep->accumulator;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "zi_common.h"
+
+// ============================================================================
+// Atomics
+// ============================================================================
+//
+// Thin wrappers so lock-free code does not depend on C11 <stdatomic.h>.
+// acquire/release follow the usual C11 semantics, the read-modify-write
+// operations are sequentially consistent.
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+static inline u32 zi_atomic_load_relaxed_u32(const volatile u32* ptr) { return *ptr; }
+static inline u64 zi_atomic_load_relaxed_u64(const volatile u64* ptr) { return *ptr; }
+static inline void zi_atomic_store_relaxed_u32(volatile u32* ptr, u32 value) { *ptr = value; }
+static inline void zi_atomic_store_relaxed_u64(volatile u64* ptr, u64 value) { *ptr = value; }
+
+static inline u32 zi_atomic_load_acquire_u32(const volatile u32* ptr) {
+    u32 value = *ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline u64 zi_atomic_load_acquire_u64(const volatile u64* ptr) {
+    u64 value = *ptr;
+    _ReadWriteBarrier();
+    return value;
+}
+
+static inline void zi_atomic_store_release_u32(volatile u32* ptr, u32 value) {
+    _ReadWriteBarrier();
+    *ptr = value;
+}
+
+static inline void zi_atomic_store_release_u64(volatile u64* ptr, u64 value) {
+    _ReadWriteBarrier();
+    *ptr = value;
+}
+
+static inline u32 zi_atomic_fetch_add_u32(volatile u32* ptr, u32 value) {
+    return (u32)_InterlockedExchangeAdd((volatile long*)ptr, (long)value);
+}
+
+static inline u64 zi_atomic_fetch_add_u64(volatile u64* ptr, u64 value) {
+    return (u64)_InterlockedExchangeAdd64((volatile __int64*)ptr, (__int64)value);
+}
+
+static inline u32 zi_atomic_exchange_u32(volatile u32* ptr, u32 value) {
+    return (u32)_InterlockedExchange((volatile long*)ptr, (long)value);
+}
+
+static inline ZiBool zi_atomic_cas_u32(volatile u32* ptr, u32* expected, u32 desired) {
+    u32 prev = (u32)_InterlockedCompareExchange((volatile long*)ptr, (long)desired, (long)*expected);
+    if (prev == *expected) return ZI_TRUE;
+    *expected = prev;
+    return ZI_FALSE;
+}
+
+static inline ZiBool zi_atomic_cas_u64(volatile u64* ptr, u64* expected, u64 desired) {
+    u64 prev = (u64)_InterlockedCompareExchange64((volatile __int64*)ptr, (__int64)desired, (__int64)*expected);
+    if (prev == *expected) return ZI_TRUE;
+    *expected = prev;
+    return ZI_FALSE;
+}
+
+static inline void zi_atomic_pause(void) { _mm_pause(); }
+
+#else
+
+static inline u32 zi_atomic_load_relaxed_u32(const volatile u32* ptr) { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+static inline u64 zi_atomic_load_relaxed_u64(const volatile u64* ptr) { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+static inline void zi_atomic_store_relaxed_u32(volatile u32* ptr, u32 value) { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+static inline void zi_atomic_store_relaxed_u64(volatile u64* ptr, u64 value) { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+
+static inline u32 zi_atomic_load_acquire_u32(const volatile u32* ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+static inline u64 zi_atomic_load_acquire_u64(const volatile u64* ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+static inline void zi_atomic_store_release_u32(volatile u32* ptr, u32 value) { __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+static inline void zi_atomic_store_release_u64(volatile u64* ptr, u64 value) { __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+
+static inline u32 zi_atomic_fetch_add_u32(volatile u32* ptr, u32 value) { return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST); }
+static inline u64 zi_atomic_fetch_add_u64(volatile u64* ptr, u64 value) { return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST); }
+static inline u32 zi_atomic_exchange_u32(volatile u32* ptr, u32 value) { return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST); }
+
+static inline ZiBool zi_atomic_cas_u32(volatile u32* ptr, u32* expected, u32 desired) {
+    return __atomic_compare_exchange_n(ptr, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline ZiBool zi_atomic_cas_u64(volatile u64* ptr, u64* expected, u64 desired) {
+    return __atomic_compare_exchange_n(ptr, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void zi_atomic_pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#endif
@@ -0,0 +1,731 @@
+#include "zi_batch.h"
+
+#include "zi_platform.h"
+
+#if ZI_ARCH_X86
+#include <immintrin.h>
+#endif
+
+enum ZiBatchTransform_ {
+	ZiBatchTransform_Point  = 0,
+	ZiBatchTransform_Vector = 1,
+	// vector, then renormalized
+	ZiBatchTransform_Normal = 2,
+};
+
+typedef u8 ZiBatchTransform;
+
+typedef void (*ZiBatchTransformFn)(const ZiMat34* m, ZiVec3SoA in, ZiVec3SoA out, u32 count, ZiBatchTransform kind);
+typedef void (*ZiBatchTransformMat4Fn)(const ZiMat4* m, ZiVec3SoA in, ZiVec3SoA out, u32 count);
+typedef void (*ZiBatchMat4MulFn)(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count);
+typedef void (*ZiBatchMat34MulFn)(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count);
+typedef void (*ZiBatchComposeFn)(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count);
+typedef void (*ZiBatchSlerpFn)(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count);
+// spheres when radii is set, boxes otherwise
+typedef void (*ZiBatchCullFn)(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, const f32* radii, u32 count, u32* visible_bits);
+
+typedef u32 (*ZiBatchCompactFn)(const u32* visible_bits, u32 count, u32 first_index, u32* indices);
+
+// elements per kernel call in the index variants, bits for them live on the stack
+#define ZI_BATCH_CULL_CHUNK 1024
+
+static ZiVec3SoA zi_batch_offset(ZiVec3SoA v, u32 offset) {
+	return (ZiVec3SoA){v.x + offset, v.y + offset, v.z + offset};
+}
+
+static ZiQuatSoA zi_batch_offset_quat(ZiQuatSoA q, u32 offset) {
+	return (ZiQuatSoA){q.x + offset, q.y + offset, q.z + offset, q.w + offset};
+}
+
+// ============================================================================
+// Portable
+// ============================================================================
+//
+// Straight loops over the arrays, left for the compiler to vectorize. The AVX2 kernels finish
+// their tails with these.
+
+static void zi_batch_transform_portable(const ZiMat34* m, ZiVec3SoA in, ZiVec3SoA out, u32 count, ZiBatchTransform kind) {
+	const f32* e = m->m;
+	f32 tx = kind == ZiBatchTransform_Point ? e[9] : 0.0f;
+	f32 ty = kind == ZiBatchTransform_Point ? e[10] : 0.0f;
+	f32 tz = kind == ZiBatchTransform_Point ? e[11] : 0.0f;
+
+	for (u32 i = 0; i < count; ++i) {
+		f32 x = in.x[i];
+		f32 y = in.y[i];
+		f32 z = in.z[i];
+		out.x[i] = e[0] * x + e[3] * y + e[6] * z + tx;
+		out.y[i] = e[1] * x + e[4] * y + e[7] * z + ty;
+		out.z[i] = e[2] * x + e[5] * y + e[8] * z + tz;
+	}
+
+	if (kind != ZiBatchTransform_Normal) return;
+
+	for (u32 i = 0; i < count; ++i) {
+		f32 len = sqrtf(out.x[i] * out.x[i] + out.y[i] * out.y[i] + out.z[i] * out.z[i]);
+		f32 inv = len > ZI_EPSILON ? 1.0f / len : 0.0f;
+		out.x[i] *= inv;
+		out.y[i] *= inv;
+		out.z[i] *= inv;
+	}
+}
+
+static void zi_batch_transform_mat4_portable(const ZiMat4* m, ZiVec3SoA in, ZiVec3SoA out, u32 count) {
+	const f32* e = m->m;
+	for (u32 i = 0; i < count; ++i) {
+		f32 x = in.x[i];
+		f32 y = in.y[i];
+		f32 z = in.z[i];
+		f32 w = e[3] * x + e[7] * y + e[11] * z + e[15];
+		if (zi_abs_f32(w) <= ZI_EPSILON) {
+			w = 1.0f;
+		}
+		out.x[i] = (e[0] * x + e[4] * y + e[8] * z + e[12]) / w;
+		out.y[i] = (e[1] * x + e[5] * y + e[9] * z + e[13]) / w;
+		out.z[i] = (e[2] * x + e[6] * y + e[10] * z + e[14]) / w;
+	}
+}
+
+static void zi_batch_mat4_mul_portable(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count) {
+	for (u32 i = 0; i < count; ++i) {
+#if ZI_MATH_HAS_SIMD
+		out[i] = zi_mat4_mul_simd(&a[i], &b[i]);
+#else
+		out[i] = zi_mat4_mul_scalar(&a[i], &b[i]);
+#endif
+	}
+}
+
+static void zi_batch_mat34_mul_portable(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count) {
+	for (u32 i = 0; i < count; ++i) {
+		out[i] = zi_mat34_mul(&a[i], &b[i]);
+	}
+}
+
+static void zi_batch_compose_portable(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count) {
+	for (u32 i = 0; i < count; ++i) {
+		ZiVec3 t = zi_vec3(translations.x[i], translations.y[i], translations.z[i]);
+		ZiQuat r = zi_quat(rotations.x[i], rotations.y[i], rotations.z[i], rotations.w[i]);
+		ZiVec3 s = zi_vec3(scales.x[i], scales.y[i], scales.z[i]);
+		out[i] = zi_mat34_compose(t, r, s);
+	}
+}
+
+static void zi_batch_slerp_portable(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count) {
+	for (u32 i = 0; i < count; ++i) {
+		ZiQuat q = zi_fast_quat_slerp(zi_quat(a.x[i], a.y[i], a.z[i], a.w[i]), zi_quat(b.x[i], b.y[i], b.z[i], b.w[i]), t[i]);
+		out.x[i] = q.x;
+		out.y[i] = q.y;
+		out.z[i] = q.z;
+		out.w[i] = q.w;
+	}
+}
+
+static void zi_batch_cull_portable(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, const f32* radii, u32 count, u32* visible_bits) {
+	for (u32 base = 0; base < count; base += 32) {
+		u32 lanes = count - base < 32 ? count - base : 32;
+		u32 word = 0;
+		for (u32 lane = 0; lane < lanes; ++lane) {
+			u32 i = base + lane;
+			u32 visible = 1;
+			for (u32 p = 0; p < 6; ++p) {
+				const ZiBatchPlane* plane = &frustum->planes[p];
+				f32 dist = plane->nx[0] * centers.x[i] + plane->ny[0] * centers.y[i] + plane->nz[0] * centers.z[i] + plane->d[0];
+				if (radii) {
+					dist += radii[i];
+				} else {
+					dist += plane->ax[0] * extents.x[i] + plane->ay[0] * extents.y[i] + plane->az[0] * extents.z[i];
+				}
+				// NaN stays visible like the per-object tests
+				visible &= !(dist < 0.0f);
+			}
+			word |= visible << lane;
+		}
+		visible_bits[base / 32] = word;
+	}
+}
+
+// Every lane stores and only visible ones advance. The store lands at or before the lane's own
+// slot, so it stays within count.
+static u32 zi_batch_compact_portable(const u32* visible_bits, u32 count, u32 first_index, u32* indices) {
+	u32 written = 0;
+	for (u32 i = 0; i < count; ++i) {
+		indices[written] = first_index + i;
+		written += (visible_bits[i / 32] >> (i & 31)) & 1;
+	}
+	return written;
+}
+
+// ============================================================================
+// AVX2 + FMA
+// ============================================================================
+
+#if ZI_ARCH_X86
+
+static ZI_TARGET("avx2,fma") void zi_batch_transform_avx2(const ZiMat34* m, ZiVec3SoA in, ZiVec3SoA out, u32 count, ZiBatchTransform kind) {
+	const f32* e = m->m;
+	__m256 m0 = _mm256_set1_ps(e[0]), m1 = _mm256_set1_ps(e[1]), m2 = _mm256_set1_ps(e[2]);
+	__m256 m3 = _mm256_set1_ps(e[3]), m4 = _mm256_set1_ps(e[4]), m5 = _mm256_set1_ps(e[5]);
+	__m256 m6 = _mm256_set1_ps(e[6]), m7 = _mm256_set1_ps(e[7]), m8 = _mm256_set1_ps(e[8]);
+	__m256 tx = _mm256_setzero_ps(), ty = _mm256_setzero_ps(), tz = _mm256_setzero_ps();
+	if (kind == ZiBatchTransform_Point) {
+		tx = _mm256_set1_ps(e[9]);
+		ty = _mm256_set1_ps(e[10]);
+		tz = _mm256_set1_ps(e[11]);
+	}
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 epsilon = _mm256_set1_ps(ZI_EPSILON);
+
+	u32 i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+		__m256 rx = _mm256_fmadd_ps(m0, x, _mm256_fmadd_ps(m3, y, _mm256_fmadd_ps(m6, z, tx)));
+		__m256 ry = _mm256_fmadd_ps(m1, x, _mm256_fmadd_ps(m4, y, _mm256_fmadd_ps(m7, z, ty)));
+		__m256 rz = _mm256_fmadd_ps(m2, x, _mm256_fmadd_ps(m5, y, _mm256_fmadd_ps(m8, z, tz)));
+
+		if (kind == ZiBatchTransform_Normal) {
+			__m256 len = _mm256_sqrt_ps(_mm256_fmadd_ps(rx, rx, _mm256_fmadd_ps(ry, ry, _mm256_mul_ps(rz, rz))));
+			// zero length stays zero like zi_vec3_normalize
+			__m256 inv = _mm256_and_ps(_mm256_cmp_ps(len, epsilon, _CMP_GT_OQ), _mm256_div_ps(one, len));
+			rx = _mm256_mul_ps(rx, inv);
+			ry = _mm256_mul_ps(ry, inv);
+			rz = _mm256_mul_ps(rz, inv);
+		}
+
+		_mm256_storeu_ps(out.x + i, rx);
+		_mm256_storeu_ps(out.y + i, ry);
+		_mm256_storeu_ps(out.z + i, rz);
+	}
+
+	zi_batch_transform_portable(m, zi_batch_offset(in, i), zi_batch_offset(out, i), count - i, kind);
+}
+
+static ZI_TARGET("avx2,fma") void zi_batch_transform_mat4_avx2(const ZiMat4* m, ZiVec3SoA in, ZiVec3SoA out, u32 count) {
+	const f32* e = m->m;
+	__m256 c[16];
+	for (u32 k = 0; k < 16; ++k) {
+		c[k] = _mm256_set1_ps(e[k]);
+	}
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 epsilon = _mm256_set1_ps(ZI_EPSILON);
+	__m256 sign = _mm256_set1_ps(-0.0f);
+
+	u32 i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 x = _mm256_loadu_ps(in.x + i);
+		__m256 y = _mm256_loadu_ps(in.y + i);
+		__m256 z = _mm256_loadu_ps(in.z + i);
+		__m256 rx = _mm256_fmadd_ps(c[0], x, _mm256_fmadd_ps(c[4], y, _mm256_fmadd_ps(c[8], z, c[12])));
+		__m256 ry = _mm256_fmadd_ps(c[1], x, _mm256_fmadd_ps(c[5], y, _mm256_fmadd_ps(c[9], z, c[13])));
+		__m256 rz = _mm256_fmadd_ps(c[2], x, _mm256_fmadd_ps(c[6], y, _mm256_fmadd_ps(c[10], z, c[14])));
+		__m256 w = _mm256_fmadd_ps(c[3], x, _mm256_fmadd_ps(c[7], y, _mm256_fmadd_ps(c[11], z, c[15])));
+		// no divide where w is ~0, like zi_mat4_transform_point
+		w = _mm256_blendv_ps(one, w, _mm256_cmp_ps(_mm256_andnot_ps(sign, w), epsilon, _CMP_GT_OQ));
+
+		_mm256_storeu_ps(out.x + i, _mm256_div_ps(rx, w));
+		_mm256_storeu_ps(out.y + i, _mm256_div_ps(ry, w));
+		_mm256_storeu_ps(out.z + i, _mm256_div_ps(rz, w));
+	}
+
+	zi_batch_transform_mat4_portable(m, zi_batch_offset(in, i), zi_batch_offset(out, i), count - i);
+}
+
+// two result columns per instruction, each 128 bit half of b01 / b23 splats its own column
+static ZI_TARGET("avx2,fma") void zi_batch_mat4_mul_avx2(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count) {
+	for (u32 i = 0; i < count; ++i) {
+		const f32* ea = a[i].m;
+		const f32* eb = b[i].m;
+		__m256 a0 = _mm256_broadcast_ps((const __m128*)(ea + 0));
+		__m256 a1 = _mm256_broadcast_ps((const __m128*)(ea + 4));
+		__m256 a2 = _mm256_broadcast_ps((const __m128*)(ea + 8));
+		__m256 a3 = _mm256_broadcast_ps((const __m128*)(ea + 12));
+		__m256 b01 = _mm256_loadu_ps(eb);
+		__m256 b23 = _mm256_loadu_ps(eb + 8);
+
+		__m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+		r01 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55), r01);
+		r01 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA), r01);
+		r01 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF), r01);
+
+		__m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+		r23 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55), r23);
+		r23 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA), r23);
+		r23 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF), r23);
+
+		_mm256_storeu_ps(out[i].m, r01);
+		_mm256_storeu_ps(out[i].m + 8, r23);
+	}
+}
+
+// Columns are 3 floats, loaded 4 wide. The overread is the next matrix's first float, so the last
+// matrix goes through the portable path, and stores leave column 3's fourth lane alone.
+static ZI_TARGET("avx2,fma") void zi_batch_mat34_mul_avx2(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count) {
+	u32 i = 0;
+	for (; i + 1 < count; ++i) {
+		const f32* ea = a[i].m;
+		const f32* eb = b[i].m;
+		__m128 a0 = _mm_loadu_ps(ea + 0);
+		__m128 a1 = _mm_loadu_ps(ea + 3);
+		__m128 a2 = _mm_loadu_ps(ea + 6);
+		__m128 a3 = _mm_loadu_ps(ea + 9);
+
+		__m128 c[4];
+		for (u32 col = 0; col < 4; ++col) {
+			c[col] = _mm_fmadd_ps(a0, _mm_set1_ps(eb[col * 3]),
+			                      _mm_fmadd_ps(a1, _mm_set1_ps(eb[col * 3 + 1]), _mm_mul_ps(a2, _mm_set1_ps(eb[col * 3 + 2]))));
+		}
+		c[3] = _mm_add_ps(c[3], a3);
+
+		// each store's fourth lane is overwritten by the next column
+		f32* eo = out[i].m;
+		_mm_storeu_ps(eo + 0, c[0]);
+		_mm_storeu_ps(eo + 3, c[1]);
+		_mm_storeu_ps(eo + 6, c[2]);
+		_mm_storel_pi((__m64*)(eo + 9), c[3]);
+		_mm_store_ss(eo + 11, _mm_movehl_ps(c[3], c[3]));
+	}
+
+	zi_batch_mat34_mul_portable(a + i, b + i, out + i, count - i);
+}
+
+// 8 matrices at a time as 12 SoA rows, transposed into 8 x 12 floats on the way out
+static ZI_TARGET("avx2,fma") void zi_batch_compose_avx2(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count) {
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 two = _mm256_set1_ps(2.0f);
+
+	u32 i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 qx = _mm256_loadu_ps(rotations.x + i);
+		__m256 qy = _mm256_loadu_ps(rotations.y + i);
+		__m256 qz = _mm256_loadu_ps(rotations.z + i);
+		__m256 qw = _mm256_loadu_ps(rotations.w + i);
+		__m256 sx = _mm256_loadu_ps(scales.x + i);
+		__m256 sy = _mm256_loadu_ps(scales.y + i);
+		__m256 sz = _mm256_loadu_ps(scales.z + i);
+
+		__m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+		__m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+		__m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+		__m256 rows[12];
+		rows[0] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+		rows[1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+		rows[2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+		rows[3] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+		rows[4] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+		rows[5] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+		rows[6] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+		rows[7] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+		rows[8] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+		rows[9] = _mm256_loadu_ps(translations.x + i);
+		rows[10] = _mm256_loadu_ps(translations.y + i);
+		rows[11] = _mm256_loadu_ps(translations.z + i);
+
+		// rows 0-7, 8x8 transpose
+		__m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+		__m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+		__m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+		__m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+		__m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+		__m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+		__m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+		__m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+		__m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+		__m256 s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+		__m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+		__m256 s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+		__m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+		__m256 s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+		__m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+		__m256 s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+		__m256 head[8] = {
+			_mm256_permute2f128_ps(s0, s4, 0x20), _mm256_permute2f128_ps(s1, s5, 0x20),
+			_mm256_permute2f128_ps(s2, s6, 0x20), _mm256_permute2f128_ps(s3, s7, 0x20),
+			_mm256_permute2f128_ps(s0, s4, 0x31), _mm256_permute2f128_ps(s1, s5, 0x31),
+			_mm256_permute2f128_ps(s2, s6, 0x31), _mm256_permute2f128_ps(s3, s7, 0x31),
+		};
+
+		// rows 8-11, one 4 float tail per matrix
+		__m256 u0 = _mm256_unpacklo_ps(rows[8], rows[9]);
+		__m256 u1 = _mm256_unpackhi_ps(rows[8], rows[9]);
+		__m256 u2 = _mm256_unpacklo_ps(rows[10], rows[11]);
+		__m256 u3 = _mm256_unpackhi_ps(rows[10], rows[11]);
+		__m256 v[4] = {
+			_mm256_shuffle_ps(u0, u2, 0x44), _mm256_shuffle_ps(u0, u2, 0xEE),
+			_mm256_shuffle_ps(u1, u3, 0x44), _mm256_shuffle_ps(u1, u3, 0xEE),
+		};
+
+		for (u32 l = 0; l < 4; ++l) {
+			_mm256_storeu_ps(out[i + l].m, head[l]);
+			_mm_storeu_ps(out[i + l].m + 8, _mm256_castps256_ps128(v[l]));
+			_mm256_storeu_ps(out[i + l + 4].m, head[l + 4]);
+			_mm_storeu_ps(out[i + l + 4].m + 8, _mm256_extractf128_ps(v[l], 1));
+		}
+	}
+
+	zi_batch_compose_portable(zi_batch_offset(translations, i), zi_batch_offset_quat(rotations, i), zi_batch_offset(scales, i), out + i, count - i);
+}
+
+// zi_fast_quat_slerp 8 wide, rsqrt estimate plus one Newton step in place of the bit trick
+static ZI_TARGET("avx2,fma") void zi_batch_slerp_avx2(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count) {
+	__m256 sign_bit = _mm256_set1_ps(-0.0f);
+	__m256 half = _mm256_set1_ps(0.5f);
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 three_halves = _mm256_set1_ps(1.5f);
+	u32    full = count & ~7u;
+
+	for (u32 i = 0; i < full; i += 8) {
+		__m256 ax = _mm256_loadu_ps(a.x + i), ay = _mm256_loadu_ps(a.y + i), az = _mm256_loadu_ps(a.z + i), aw = _mm256_loadu_ps(a.w + i);
+		__m256 bx = _mm256_loadu_ps(b.x + i), by = _mm256_loadu_ps(b.y + i), bz = _mm256_loadu_ps(b.z + i), bw = _mm256_loadu_ps(b.w + i);
+		__m256 tt = _mm256_loadu_ps(t + i);
+
+		__m256 dot = _mm256_mul_ps(ax, bx);
+		dot = _mm256_fmadd_ps(ay, by, dot);
+		dot = _mm256_fmadd_ps(az, bz, dot);
+		dot = _mm256_fmadd_ps(aw, bw, dot);
+		__m256 sign = _mm256_and_ps(dot, sign_bit);
+		__m256 d = _mm256_andnot_ps(sign_bit, dot);
+
+		// zi_fast_slerp_t
+		__m256 ka = _mm256_fmadd_ps(d, _mm256_set1_ps(-1.51229774f), _mm256_set1_ps(3.63301726f));
+		ka = _mm256_fmadd_ps(d, ka, _mm256_set1_ps(-3.22715622f));
+		ka = _mm256_fmadd_ps(d, ka, _mm256_set1_ps(1.07015237f));
+		__m256 kb = _mm256_fmadd_ps(d, _mm256_set1_ps(0.214132695f), _mm256_set1_ps(-1.05836274f));
+		kb = _mm256_fmadd_ps(d, kb, _mm256_set1_ps(0.847359724f));
+		__m256 u = _mm256_sub_ps(tt, half);
+		__m256 k = _mm256_fmadd_ps(_mm256_mul_ps(ka, u), u, kb);
+		__m256 bent = _mm256_fmadd_ps(_mm256_mul_ps(_mm256_mul_ps(tt, u), _mm256_sub_ps(tt, one)), k, tt);
+
+		__m256 wa = _mm256_sub_ps(one, bent);
+		__m256 wb = _mm256_xor_ps(bent, sign);
+		__m256 qx = _mm256_fmadd_ps(bx, wb, _mm256_mul_ps(ax, wa));
+		__m256 qy = _mm256_fmadd_ps(by, wb, _mm256_mul_ps(ay, wa));
+		__m256 qz = _mm256_fmadd_ps(bz, wb, _mm256_mul_ps(az, wa));
+		__m256 qw = _mm256_fmadd_ps(bw, wb, _mm256_mul_ps(aw, wa));
+
+		__m256 len_sq = _mm256_mul_ps(qx, qx);
+		len_sq = _mm256_fmadd_ps(qy, qy, len_sq);
+		len_sq = _mm256_fmadd_ps(qz, qz, len_sq);
+		len_sq = _mm256_fmadd_ps(qw, qw, len_sq);
+		__m256 inv = _mm256_rsqrt_ps(len_sq);
+		inv = _mm256_mul_ps(inv, _mm256_fnmadd_ps(_mm256_mul_ps(half, len_sq), _mm256_mul_ps(inv, inv), three_halves));
+
+		_mm256_storeu_ps(out.x + i, _mm256_mul_ps(qx, inv));
+		_mm256_storeu_ps(out.y + i, _mm256_mul_ps(qy, inv));
+		_mm256_storeu_ps(out.z + i, _mm256_mul_ps(qz, inv));
+		_mm256_storeu_ps(out.w + i, _mm256_mul_ps(qw, inv));
+	}
+
+	if (full < count) {
+		zi_batch_slerp_portable(zi_batch_offset_quat(a, full), zi_batch_offset_quat(b, full), t + full, zi_batch_offset_quat(out, full), count - full);
+	}
+}
+
+// 32 objects per output word, 8 per iteration, planes straight from memory
+static ZI_TARGET("avx2,fma") void zi_batch_cull_avx2(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, const f32* radii, u32 count, u32* visible_bits) {
+	__m256 zero = _mm256_setzero_ps();
+	u32 full = count & ~31u;
+
+	for (u32 base = 0; base < full; base += 32) {
+		u32 word = 0;
+		for (u32 group = 0; group < 32; group += 8) {
+			u32 i = base + group;
+			__m256 cx = _mm256_loadu_ps(centers.x + i);
+			__m256 cy = _mm256_loadu_ps(centers.y + i);
+			__m256 cz = _mm256_loadu_ps(centers.z + i);
+			__m256 outside = zero;
+
+			if (radii) {
+				__m256 r = _mm256_loadu_ps(radii + i);
+				for (u32 p = 0; p < 6; ++p) {
+					const ZiBatchPlane* plane = &frustum->planes[p];
+					__m256 dist = _mm256_add_ps(_mm256_load_ps(plane->d), r);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->nx), cx, dist);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->ny), cy, dist);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->nz), cz, dist);
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+				}
+			} else {
+				__m256 ex = _mm256_loadu_ps(extents.x + i);
+				__m256 ey = _mm256_loadu_ps(extents.y + i);
+				__m256 ez = _mm256_loadu_ps(extents.z + i);
+				for (u32 p = 0; p < 6; ++p) {
+					const ZiBatchPlane* plane = &frustum->planes[p];
+					__m256 dist = _mm256_fmadd_ps(_mm256_load_ps(plane->nx), cx, _mm256_load_ps(plane->d));
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->ny), cy, dist);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->nz), cz, dist);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->ax), ex, dist);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->ay), ey, dist);
+					dist = _mm256_fmadd_ps(_mm256_load_ps(plane->az), ez, dist);
+					outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+				}
+			}
+
+			word |= (u32)(~_mm256_movemask_ps(outside) & 0xff) << group;
+		}
+		visible_bits[base / 32] = word;
+	}
+
+	if (full < count) {
+		zi_batch_cull_portable(frustum, zi_batch_offset(centers, full), zi_batch_offset(extents, full), radii ? radii + full : ZI_NULL,
+		                       count - full, visible_bits + full / 32);
+	}
+}
+
+// positions of the set bits of a byte, one per nibble from the lowest up
+static const u32 zi_batch_compact_lut[256] = {
+	0x00000000, 0x00000000, 0x00000001, 0x00000010, 0x00000002, 0x00000020, 0x00000021, 0x00000210,
+	0x00000003, 0x00000030, 0x00000031, 0x00000310, 0x00000032, 0x00000320, 0x00000321, 0x00003210,
+	0x00000004, 0x00000040, 0x00000041, 0x00000410, 0x00000042, 0x00000420, 0x00000421, 0x00004210,
+	0x00000043, 0x00000430, 0x00000431, 0x00004310, 0x00000432, 0x00004320, 0x00004321, 0x00043210,
+	0x00000005, 0x00000050, 0x00000051, 0x00000510, 0x00000052, 0x00000520, 0x00000521, 0x00005210,
+	0x00000053, 0x00000530, 0x00000531, 0x00005310, 0x00000532, 0x00005320, 0x00005321, 0x00053210,
+	0x00000054, 0x00000540, 0x00000541, 0x00005410, 0x00000542, 0x00005420, 0x00005421, 0x00054210,
+	0x00000543, 0x00005430, 0x00005431, 0x00054310, 0x00005432, 0x00054320, 0x00054321, 0x00543210,
+	0x00000006, 0x00000060, 0x00000061, 0x00000610, 0x00000062, 0x00000620, 0x00000621, 0x00006210,
+	0x00000063, 0x00000630, 0x00000631, 0x00006310, 0x00000632, 0x00006320, 0x00006321, 0x00063210,
+	0x00000064, 0x00000640, 0x00000641, 0x00006410, 0x00000642, 0x00006420, 0x00006421, 0x00064210,
+	0x00000643, 0x00006430, 0x00006431, 0x00064310, 0x00006432, 0x00064320, 0x00064321, 0x00643210,
+	0x00000065, 0x00000650, 0x00000651, 0x00006510, 0x00000652, 0x00006520, 0x00006521, 0x00065210,
+	0x00000653, 0x00006530, 0x00006531, 0x00065310, 0x00006532, 0x00065320, 0x00065321, 0x00653210,
+	0x00000654, 0x00006540, 0x00006541, 0x00065410, 0x00006542, 0x00065420, 0x00065421, 0x00654210,
+	0x00006543, 0x00065430, 0x00065431, 0x00654310, 0x00065432, 0x00654320, 0x00654321, 0x06543210,
+	0x00000007, 0x00000070, 0x00000071, 0x00000710, 0x00000072, 0x00000720, 0x00000721, 0x00007210,
+	0x00000073, 0x00000730, 0x00000731, 0x00007310, 0x00000732, 0x00007320, 0x00007321, 0x00073210,
+	0x00000074, 0x00000740, 0x00000741, 0x00007410, 0x00000742, 0x00007420, 0x00007421, 0x00074210,
+	0x00000743, 0x00007430, 0x00007431, 0x00074310, 0x00007432, 0x00074320, 0x00074321, 0x00743210,
+	0x00000075, 0x00000750, 0x00000751, 0x00007510, 0x00000752, 0x00007520, 0x00007521, 0x00075210,
+	0x00000753, 0x00007530, 0x00007531, 0x00075310, 0x00007532, 0x00075320, 0x00075321, 0x00753210,
+	0x00000754, 0x00007540, 0x00007541, 0x00075410, 0x00007542, 0x00075420, 0x00075421, 0x00754210,
+	0x00007543, 0x00075430, 0x00075431, 0x00754310, 0x00075432, 0x00754320, 0x00754321, 0x07543210,
+	0x00000076, 0x00000760, 0x00000761, 0x00007610, 0x00000762, 0x00007620, 0x00007621, 0x00076210,
+	0x00000763, 0x00007630, 0x00007631, 0x00076310, 0x00007632, 0x00076320, 0x00076321, 0x00763210,
+	0x00000764, 0x00007640, 0x00007641, 0x00076410, 0x00007642, 0x00076420, 0x00076421, 0x00764210,
+	0x00007643, 0x00076430, 0x00076431, 0x00764310, 0x00076432, 0x00764320, 0x00764321, 0x07643210,
+	0x00000765, 0x00007650, 0x00007651, 0x00076510, 0x00007652, 0x00076520, 0x00076521, 0x00765210,
+	0x00007653, 0x00076530, 0x00076531, 0x00765310, 0x00076532, 0x00765320, 0x00765321, 0x07653210,
+	0x00007654, 0x00076540, 0x00076541, 0x00765410, 0x00076542, 0x00765420, 0x00765421, 0x07654210,
+	0x00076543, 0x00765430, 0x00765431, 0x07654310, 0x00765432, 0x07654320, 0x07654321, 0x76543210,
+};
+
+static inline u32 zi_batch_popcount8(u32 v) {
+	v = v - ((v >> 1) & 0x55);
+	v = (v & 0x33) + ((v >> 2) & 0x33);
+	return (v + (v >> 4)) & 0x0f;
+}
+
+// left-packs 8 indices per iteration, the 8 wide store stays within the group like the portable one
+static ZI_TARGET("avx2,fma") u32 zi_batch_compact_avx2(const u32* visible_bits, u32 count, u32 first_index, u32* indices) {
+	__m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+	__m256i nibble = _mm256_set1_epi32(0xf);
+	u32     full = count & ~7u;
+	u32     written = 0;
+
+	for (u32 i = 0; i < full; i += 8) {
+		u32     mask = (visible_bits[i / 32] >> (i & 31)) & 0xff;
+		__m256i lanes = _mm256_srlv_epi32(_mm256_set1_epi32((i32)zi_batch_compact_lut[mask]), shifts);
+		lanes = _mm256_add_epi32(_mm256_and_si256(lanes, nibble), _mm256_set1_epi32((i32)(first_index + i)));
+		_mm256_storeu_si256((__m256i*)(indices + written), lanes);
+		written += zi_batch_popcount8(mask);
+	}
+	for (u32 i = full; i < count; ++i) {
+		indices[written] = first_index + i;
+		written += (visible_bits[i / 32] >> (i & 31)) & 1;
+	}
+	return written;
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+#if ZI_ARCH_X86
+#define ZI_BATCH_AVX2(function) {ZiCpuFeature_AVX2 | ZiCpuFeature_FMA, (VoidPtr)function},
+#else
+#define ZI_BATCH_AVX2(function)
+#endif
+
+static void zi_batch_reset_dispatch(void);
+
+static void zi_batch_transform_resolve(const ZiMat34* m, ZiVec3SoA in, ZiVec3SoA out, u32 count, ZiBatchTransform kind);
+static ZiBatchTransformFn zi_batch_transform_impl = zi_batch_transform_resolve;
+static void zi_batch_transform_resolve(const ZiMat34* m, ZiVec3SoA in, ZiVec3SoA out, u32 count, ZiBatchTransform kind) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_transform_avx2) {0, (VoidPtr)zi_batch_transform_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_transform_impl = (ZiBatchTransformFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_transform_impl(m, in, out, count, kind);
+}
+
+static void zi_batch_transform_mat4_resolve(const ZiMat4* m, ZiVec3SoA in, ZiVec3SoA out, u32 count);
+static ZiBatchTransformMat4Fn zi_batch_transform_mat4_impl = zi_batch_transform_mat4_resolve;
+static void zi_batch_transform_mat4_resolve(const ZiMat4* m, ZiVec3SoA in, ZiVec3SoA out, u32 count) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_transform_mat4_avx2) {0, (VoidPtr)zi_batch_transform_mat4_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_transform_mat4_impl = (ZiBatchTransformMat4Fn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_transform_mat4_impl(m, in, out, count);
+}
+
+static void zi_batch_mat4_mul_resolve(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count);
+static ZiBatchMat4MulFn zi_batch_mat4_mul_impl = zi_batch_mat4_mul_resolve;
+static void zi_batch_mat4_mul_resolve(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_mat4_mul_avx2) {0, (VoidPtr)zi_batch_mat4_mul_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_mat4_mul_impl = (ZiBatchMat4MulFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_mat4_mul_impl(a, b, out, count);
+}
+
+static void zi_batch_mat34_mul_resolve(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count);
+static ZiBatchMat34MulFn zi_batch_mat34_mul_impl = zi_batch_mat34_mul_resolve;
+static void zi_batch_mat34_mul_resolve(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_mat34_mul_avx2) {0, (VoidPtr)zi_batch_mat34_mul_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_mat34_mul_impl = (ZiBatchMat34MulFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_mat34_mul_impl(a, b, out, count);
+}
+
+static void zi_batch_compose_resolve(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count);
+static ZiBatchComposeFn zi_batch_compose_impl = zi_batch_compose_resolve;
+static void zi_batch_compose_resolve(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_compose_avx2) {0, (VoidPtr)zi_batch_compose_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_compose_impl = (ZiBatchComposeFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_compose_impl(translations, rotations, scales, out, count);
+}
+
+static void zi_batch_slerp_resolve(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count);
+static ZiBatchSlerpFn zi_batch_slerp_impl = zi_batch_slerp_resolve;
+static void zi_batch_slerp_resolve(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_slerp_avx2) {0, (VoidPtr)zi_batch_slerp_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_slerp_impl = (ZiBatchSlerpFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_slerp_impl(a, b, t, out, count);
+}
+
+static void zi_batch_cull_resolve(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, const f32* radii, u32 count, u32* visible_bits);
+static ZiBatchCullFn zi_batch_cull_impl = zi_batch_cull_resolve;
+static void zi_batch_cull_resolve(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, const f32* radii, u32 count, u32* visible_bits) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_cull_avx2) {0, (VoidPtr)zi_batch_cull_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_cull_impl = (ZiBatchCullFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_batch_cull_impl(frustum, centers, extents, radii, count, visible_bits);
+}
+
+static u32 zi_batch_compact_resolve(const u32* visible_bits, u32 count, u32 first_index, u32* indices);
+static ZiBatchCompactFn zi_batch_compact_impl = zi_batch_compact_resolve;
+static u32 zi_batch_compact_resolve(const u32* visible_bits, u32 count, u32 first_index, u32* indices) {
+	static const ZiCpuDispatch table[] = {ZI_BATCH_AVX2(zi_batch_compact_avx2) {0, (VoidPtr)zi_batch_compact_portable}};
+	zi_platform_cpu_dispatch_register_reset(zi_batch_reset_dispatch);
+	zi_batch_compact_impl = (ZiBatchCompactFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	return zi_batch_compact_impl(visible_bits, count, first_index, indices);
+}
+
+static void zi_batch_reset_dispatch(void) {
+	zi_batch_transform_impl = zi_batch_transform_resolve;
+	zi_batch_transform_mat4_impl = zi_batch_transform_mat4_resolve;
+	zi_batch_mat4_mul_impl = zi_batch_mat4_mul_resolve;
+	zi_batch_mat34_mul_impl = zi_batch_mat34_mul_resolve;
+	zi_batch_compose_impl = zi_batch_compose_resolve;
+	zi_batch_slerp_impl = zi_batch_slerp_resolve;
+	zi_batch_cull_impl = zi_batch_cull_resolve;
+	zi_batch_compact_impl = zi_batch_compact_resolve;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+void zi_batch_transform_points(const ZiMat34* m, ZiVec3SoA points, ZiVec3SoA out, u32 count) {
+	zi_batch_transform_impl(m, points, out, count, ZiBatchTransform_Point);
+}
+
+void zi_batch_transform_vectors(const ZiMat34* m, ZiVec3SoA vectors, ZiVec3SoA out, u32 count) {
+	zi_batch_transform_impl(m, vectors, out, count, ZiBatchTransform_Vector);
+}
+
+void zi_batch_transform_normals(const ZiMat34* m, ZiVec3SoA normals, ZiVec3SoA out, u32 count) {
+	ZiMat3 linear;
+	for (i32 col = 0; col < 3; ++col) {
+		for (i32 row = 0; row < 3; ++row) {
+			zi_mat3_set(&linear, row, col, zi_mat34_at(m, row, col));
+		}
+	}
+	ZiMat3 inverse = zi_mat3_inverse(&linear);
+
+	ZiMat34 normal_matrix = zi_mat34_identity();
+	for (i32 col = 0; col < 3; ++col) {
+		for (i32 row = 0; row < 3; ++row) {
+			zi_mat34_set(&normal_matrix, row, col, zi_mat3_at(&inverse, col, row));
+		}
+	}
+	zi_batch_transform_impl(&normal_matrix, normals, out, count, ZiBatchTransform_Normal);
+}
+
+void zi_batch_transform_points_mat4(const ZiMat4* m, ZiVec3SoA points, ZiVec3SoA out, u32 count) {
+	zi_batch_transform_mat4_impl(m, points, out, count);
+}
+
+void zi_batch_mat4_mul(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count) {
+	zi_batch_mat4_mul_impl(a, b, out, count);
+}
+
+void zi_batch_mat34_mul(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count) {
+	zi_batch_mat34_mul_impl(a, b, out, count);
+}
+
+void zi_batch_compose_trs(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count) {
+	zi_batch_compose_impl(translations, rotations, scales, out, count);
+}
+
+void zi_batch_quat_slerp(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count) {
+	zi_batch_slerp_impl(a, b, t, out, count);
+}
+
+void zi_batch_frustum_init(ZiBatchFrustum* batch_frustum, const ZiFrustum* frustum) {
+	for (u32 p = 0; p < 6; ++p) {
+		const ZiPlane* plane = &frustum->planes[p];
+		ZiBatchPlane*  out = &batch_frustum->planes[p];
+		for (u32 lane = 0; lane < 8; ++lane) {
+			out->nx[lane] = plane->normal.x;
+			out->ny[lane] = plane->normal.y;
+			out->nz[lane] = plane->normal.z;
+			out->ax[lane] = zi_abs_f32(plane->normal.x);
+			out->ay[lane] = zi_abs_f32(plane->normal.y);
+			out->az[lane] = zi_abs_f32(plane->normal.z);
+			out->d[lane] = -plane->distance;
+		}
+	}
+}
+
+void zi_batch_cull_aabbs(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, u32 count, u32* visible_bits) {
+	zi_batch_cull_impl(frustum, centers, extents, ZI_NULL, count, visible_bits);
+}
+
+void zi_batch_cull_spheres(const ZiBatchFrustum* frustum, ZiVec3SoA centers, const f32* radii, u32 count, u32* visible_bits) {
+	zi_batch_cull_impl(frustum, centers, (ZiVec3SoA){0}, radii, count, visible_bits);
+}
+
+static u32 zi_batch_cull_indices(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, const f32* radii, u32 count,
+                                 u32 first_index, u32* indices) {
+	u32 words[ZI_BATCH_CULL_CHUNK / 32];
+	u32 written = 0;
+
+	for (u32 base = 0; base < count; base += ZI_BATCH_CULL_CHUNK) {
+		u32 chunk = count - base < ZI_BATCH_CULL_CHUNK ? count - base : ZI_BATCH_CULL_CHUNK;
+		zi_batch_cull_impl(frustum, zi_batch_offset(centers, base), radii ? extents : zi_batch_offset(extents, base),
+		                   radii ? radii + base : ZI_NULL, chunk, words);
+		written += zi_batch_compact_impl(words, chunk, first_index + base, indices + written);
+	}
+	return written;
+}
+
+u32 zi_batch_cull_aabbs_indices(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, u32 count, u32 first_index, u32* indices) {
+	return zi_batch_cull_indices(frustum, centers, extents, ZI_NULL, count, first_index, indices);
+}
+
+u32 zi_batch_cull_spheres_indices(const ZiBatchFrustum* frustum, ZiVec3SoA centers, const f32* radii, u32 count, u32 first_index, u32* indices) {
+	return zi_batch_cull_indices(frustum, centers, (ZiVec3SoA){0}, radii, count, first_index, indices);
+}
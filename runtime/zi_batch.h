@@ -0,0 +1,77 @@
+#pragma once
+
+#include "zi_common.h"
+#include "zi_math.h"
+
+// ============================================================================
+// Batch math kernels
+// ============================================================================
+//
+// Whole arrays per call over structure-of-arrays input, 8 elements per iteration with AVX2 + FMA
+// and plain loops the compiler vectorizes elsewhere, picked at the first call through
+// zi_platform_cpu_dispatch. Results match the per-element zi_math.h functions up to rounding,
+// not bit for bit. Output arrays may be the input arrays, partially overlapping ones may not.
+
+// element i is (x[i], y[i], z[i])
+typedef struct ZiVec3SoA {
+	f32* x;
+	f32* y;
+	f32* z;
+} ZiVec3SoA;
+
+typedef struct ZiQuatSoA {
+	f32* x;
+	f32* y;
+	f32* z;
+	f32* w;
+} ZiQuatSoA;
+
+// zi_mat34_transform_point / zi_mat34_transform_vector per element
+void zi_batch_transform_points(const ZiMat34* m, ZiVec3SoA points, ZiVec3SoA out, u32 count);
+void zi_batch_transform_vectors(const ZiMat34* m, ZiVec3SoA vectors, ZiVec3SoA out, u32 count);
+// by the inverse transpose of m's 3x3 and renormalized, stays perpendicular under non-uniform scale
+void zi_batch_transform_normals(const ZiMat34* m, ZiVec3SoA normals, ZiVec3SoA out, u32 count);
+// zi_mat4_transform_point per element, divides by w
+void zi_batch_transform_points_mat4(const ZiMat4* m, ZiVec3SoA points, ZiVec3SoA out, u32 count);
+
+// out[i] = a[i] * b[i], out may be a or b
+void zi_batch_mat4_mul(const ZiMat4* a, const ZiMat4* b, ZiMat4* out, u32 count);
+void zi_batch_mat34_mul(const ZiMat34* a, const ZiMat34* b, ZiMat34* out, u32 count);
+
+// out[i] = zi_mat34_compose(translations[i], rotations[i], scales[i])
+void zi_batch_compose_trs(ZiVec3SoA translations, ZiQuatSoA rotations, ZiVec3SoA scales, ZiMat34* out, u32 count);
+
+// out[i] = zi_fast_quat_slerp(a[i], b[i], t[i]), out may be a or b
+void zi_batch_quat_slerp(ZiQuatSoA a, ZiQuatSoA b, const f32* t, ZiQuatSoA out, u32 count);
+
+// ============================================================================
+// Culling
+// ============================================================================
+//
+// Same answers as zi_frustum_contains_aabb / zi_frustum_contains_sphere, 8 objects per iteration.
+// Each call covers its arrays from index 0. To split across threads, give each worker a range
+// starting at a multiple of 32 by offsetting the SoA pointers and visible_bits by first / 32, so
+// no two workers write the same word. The index variants write at most count indices.
+
+// planes of a ZiFrustum, every value splatted 8 wide so the kernels use them as memory operands
+typedef struct ZI_ALIGN(32) ZiBatchPlane {
+	f32 nx[8], ny[8], nz[8];
+	// |normal|, projects box extents onto the normal
+	f32 ax[8], ay[8], az[8];
+	// -distance, zi_plane_distance_to_point subtracts it
+	f32 d[8];
+} ZiBatchPlane;
+
+typedef struct ZiBatchFrustum {
+	ZiBatchPlane planes[6];
+} ZiBatchFrustum;
+
+void zi_batch_frustum_init(ZiBatchFrustum* batch_frustum, const ZiFrustum* frustum);
+
+// bit i of visible_bits[i / 32] is set when box i (center, half extents) may be visible, bits past count are cleared
+void zi_batch_cull_aabbs(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, u32 count, u32* visible_bits);
+void zi_batch_cull_spheres(const ZiBatchFrustum* frustum, ZiVec3SoA centers, const f32* radii, u32 count, u32* visible_bits);
+
+// first_index + i for every visible object i, in order, returns how many were written
+u32 zi_batch_cull_aabbs_indices(const ZiBatchFrustum* frustum, ZiVec3SoA centers, ZiVec3SoA extents, u32 count, u32 first_index, u32* indices);
+u32 zi_batch_cull_spheres_indices(const ZiBatchFrustum* frustum, ZiVec3SoA centers, const f32* radii, u32 count, u32 first_index, u32* indices);
@@ -0,0 +1,446 @@
+#include "zi_bvh.h"
+
+#include "zi_atomic.h"
+#include "zi_core.h"
+#include "zi_log.h"
+#include "zi_platform.h"
+
+#include <string.h>
+
+typedef char zi_bvh_node_size_check[sizeof(ZiBvhNode) == 32 ? 1 : -1];
+
+#define ZI_BVH_BINS           16
+// cost of visiting a node relative to testing a triangle
+#define ZI_BVH_TRAVERSAL_COST 1.0f
+// smallest range handed to another thread, below that the thread switch costs more than it saves
+#define ZI_BVH_MIN_TASK       2048
+
+// a subtree built on a worker into its own nodes, root at 0, then spliced in at node
+typedef struct ZiBvhTask {
+	u32        node;
+	u32        begin;
+	u32        end;
+	u32        depth;
+	ZiBvhNode* nodes;
+	u32        node_count;
+} ZiBvhTask;
+
+typedef struct ZiBvhBuilder {
+	const ZiAABB* bounds;
+	const ZiVec3* centroids;
+	// triangle indices, reordered in place so every node owns a contiguous range
+	u32*          indices;
+	u32           max_leaf_size;
+	// ranges from ZI_BVH_MIN_TASK up to this many triangles become tasks during the top build
+	u32           task_size;
+	ZiBvhTask*    tasks;
+	u32           task_count;
+	u32           next_task;
+	// a worker couldn't allocate its task's nodes
+	u32           failed;
+} ZiBvhBuilder;
+
+typedef struct ZiBvhNodeList {
+	ZiBvhNode* nodes;
+	u32        count;
+	ZiBool     make_tasks;
+} ZiBvhNodeList;
+
+// ============================================================================
+// Build
+// ============================================================================
+
+static u32 zi_bvh_bin(f32 centroid, f32 origin, f32 scale) {
+	i32 bin = (i32)((centroid - origin) * scale);
+	return (u32)zi_clamp_i32(bin, 0, ZI_BVH_BINS - 1);
+}
+
+static void zi_bvh_make_leaf(ZiBvhNode* node, u32 begin, u32 count) {
+	node->first = begin;
+	node->count = count;
+}
+
+static void zi_bvh_build_node(ZiBvhBuilder* builder, ZiBvhNodeList* list, u32 node_index, u32 begin, u32 end, u32 depth) {
+	ZiAABB box = zi_aabb_empty();
+	ZiAABB centroid_box = zi_aabb_empty();
+	for (u32 i = begin; i < end; ++i) {
+		u32 triangle = builder->indices[i];
+		box = zi_aabb_union(box, builder->bounds[triangle]);
+		centroid_box = zi_aabb_expand(centroid_box, builder->centroids[triangle]);
+	}
+
+	ZiBvhNode* node = &list->nodes[node_index];
+	node->min = box.min;
+	node->max = box.max;
+
+	u32 count = end - begin;
+	if (count <= 1 || depth + 1 >= ZI_BVH_MAX_DEPTH) {
+		zi_bvh_make_leaf(node, begin, count);
+		return;
+	}
+
+	if (list->make_tasks && count <= builder->task_size && count >= ZI_BVH_MIN_TASK) {
+		builder->tasks[builder->task_count++] = (ZiBvhTask){node_index, begin, end, depth, ZI_NULL, 0};
+		return;
+	}
+
+	// Binned SAH, all three axes in one pass over the range. Sweeping the bins from both sides
+	// finds the boundary with the least area * count over the two halves.
+	ZiAABB bin_boxes[3][ZI_BVH_BINS];
+	u32    bin_counts[3][ZI_BVH_BINS] = {{0}};
+	f32    origins[3];
+	f32    scales[3];
+	for (u32 axis = 0; axis < 3; ++axis) {
+		f32 extent = (&centroid_box.max.x)[axis] - (&centroid_box.min.x)[axis];
+		origins[axis] = (&centroid_box.min.x)[axis];
+		// a flat axis puts everything in bin 0 and never wins
+		scales[axis] = extent > 0.0f ? (f32)ZI_BVH_BINS / extent : 0.0f;
+		for (u32 b = 0; b < ZI_BVH_BINS; ++b) {
+			bin_boxes[axis][b] = zi_aabb_empty();
+		}
+	}
+	for (u32 i = begin; i < end; ++i) {
+		u32           triangle = builder->indices[i];
+		const ZiVec3* centroid = &builder->centroids[triangle];
+		ZiAABB        bounds = builder->bounds[triangle];
+		for (u32 axis = 0; axis < 3; ++axis) {
+			u32 b = zi_bvh_bin((&centroid->x)[axis], origins[axis], scales[axis]);
+			bin_boxes[axis][b] = zi_aabb_union(bin_boxes[axis][b], bounds);
+			bin_counts[axis][b]++;
+		}
+	}
+
+	f32 best_cost = F32_MAX;
+	u32 best_axis = 0;
+	u32 best_split = 0;
+	for (u32 axis = 0; axis < 3; ++axis) {
+		// right_costs[b] covers bins b and up
+		f32    right_costs[ZI_BVH_BINS];
+		ZiAABB right = zi_aabb_empty();
+		u32    right_count = 0;
+		for (u32 b = ZI_BVH_BINS - 1; b > 0; --b) {
+			right = zi_aabb_union(right, bin_boxes[axis][b]);
+			right_count += bin_counts[axis][b];
+			right_costs[b] = right_count ? zi_aabb_surface_area(right) * (f32)right_count : 0.0f;
+		}
+
+		ZiAABB left = zi_aabb_empty();
+		u32    left_count = 0;
+		for (u32 b = 0; b + 1 < ZI_BVH_BINS; ++b) {
+			left = zi_aabb_union(left, bin_boxes[axis][b]);
+			left_count += bin_counts[axis][b];
+			if (left_count == 0 || left_count == count) continue;
+			f32 cost = zi_aabb_surface_area(left) * (f32)left_count + right_costs[b + 1];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_split = b + 1;
+			}
+		}
+	}
+
+	u32 mid;
+	if (best_cost == F32_MAX) {
+		// every centroid in one spot, nothing to split on but the count
+		if (count <= builder->max_leaf_size) {
+			zi_bvh_make_leaf(node, begin, count);
+			return;
+		}
+		mid = begin + count / 2;
+	} else {
+		f32 area = zi_aabb_surface_area(box);
+		f32 split_cost = ZI_BVH_TRAVERSAL_COST + (area > 0.0f ? best_cost / area : (f32)count);
+		if (count <= builder->max_leaf_size && split_cost >= (f32)count) {
+			zi_bvh_make_leaf(node, begin, count);
+			return;
+		}
+
+		f32 origin = origins[best_axis];
+		f32 scale = scales[best_axis];
+		u32 i = begin;
+		u32 j = end;
+		while (i < j) {
+			u32 triangle = builder->indices[i];
+			if (zi_bvh_bin((&builder->centroids[triangle].x)[best_axis], origin, scale) < best_split) {
+				++i;
+			} else {
+				builder->indices[i] = builder->indices[--j];
+				builder->indices[j] = triangle;
+			}
+		}
+		mid = i;
+	}
+
+	u32 left = list->count;
+	list->count += 2;
+	node->first = left;
+	node->count = 0;
+	zi_bvh_build_node(builder, list, left, begin, mid, depth + 1);
+	zi_bvh_build_node(builder, list, left + 1, mid, end, depth + 1);
+}
+
+static void zi_bvh_worker(VoidPtr user_data) {
+	ZiBvhBuilder* builder = (ZiBvhBuilder*)user_data;
+	for (;;) {
+		u32 index = zi_atomic_fetch_add_u32(&builder->next_task, 1);
+		if (index >= builder->task_count) return;
+
+		ZiBvhTask*    task = &builder->tasks[index];
+		ZiBvhNodeList list = {(ZiBvhNode*)zi_mem_alloc(sizeof(ZiBvhNode) * (2 * (task->end - task->begin) - 1)), 1, ZI_FALSE};
+		if (!list.nodes) {
+			zi_atomic_store_relaxed_u32(&builder->failed, ZI_TRUE);
+			continue;
+		}
+		zi_bvh_build_node(builder, &list, 0, task->begin, task->end, task->depth);
+		task->nodes = list.nodes;
+		task->node_count = list.count;
+	}
+}
+
+// copies a task's subtree to the end of the top tree, its root into the placeholder node
+static void zi_bvh_splice(ZiBvhNodeList* list, const ZiBvhTask* task) {
+	// local index i > 0 lands at offset + i
+	u32 offset = list->count - 1;
+	for (u32 i = 0; i < task->node_count; ++i) {
+		ZiBvhNode node = task->nodes[i];
+		if (node.count == 0) {
+			node.first += offset;
+		}
+		list->nodes[i == 0 ? task->node : offset + i] = node;
+	}
+	list->count += task->node_count - 1;
+}
+
+ZiBool zi_bvh_build(ZiBvh* bvh, const ZiBvhBuildDesc* desc) {
+	memset(bvh, 0, sizeof(*bvh));
+	u32 count = desc->triangle_count;
+	if (count == 0) return ZI_TRUE;
+
+	ZiAABB*    bounds = (ZiAABB*)zi_mem_alloc(sizeof(ZiAABB) * count);
+	ZiVec3*    centroids = (ZiVec3*)zi_mem_alloc(sizeof(ZiVec3) * count);
+	u32*       indices = (u32*)zi_mem_alloc(sizeof(u32) * count);
+	ZiBvhNode* nodes = (ZiBvhNode*)zi_mem_alloc(sizeof(ZiBvhNode) * (2 * (u64)count - 1));
+	if (!bounds || !centroids || !indices || !nodes) {
+		zi_log_error("out of memory building a BVH over %u triangles", count);
+		zi_mem_free(bounds);
+		zi_mem_free(centroids);
+		zi_mem_free(indices);
+		zi_mem_free(nodes);
+		return ZI_FALSE;
+	}
+
+	for (u32 i = 0; i < count; ++i) {
+		const ZiTriangle* triangle = &desc->triangles[i];
+		ZiAABB box = {triangle->v0, triangle->v0};
+		box = zi_aabb_expand(box, triangle->v1);
+		bounds[i] = zi_aabb_expand(box, triangle->v2);
+		centroids[i] = zi_vec3_scale(zi_vec3_add(bounds[i].min, bounds[i].max), 0.5f);
+		indices[i] = i;
+	}
+
+#if defined(ZI_EMSCRIPTEN)
+	// no threads on the web, splitting into tasks would only cost time
+	u32 thread_count = 1;
+#else
+	u32 thread_count = desc->thread_count ? desc->thread_count : 1;
+#endif
+	ZiBvhBuilder builder = {0};
+	builder.bounds = bounds;
+	builder.centroids = centroids;
+	builder.indices = indices;
+	builder.max_leaf_size = desc->max_leaf_size ? desc->max_leaf_size : ZI_BVH_DEFAULT_LEAF_SIZE;
+
+	// top levels on this thread, what is left split into a few tasks per thread
+	ZiBvhNodeList list = {nodes, 1, thread_count > 1 && count >= 2 * ZI_BVH_MIN_TASK};
+	if (list.make_tasks) {
+		builder.task_size = count / (thread_count * 4);
+		builder.task_size = builder.task_size < ZI_BVH_MIN_TASK ? ZI_BVH_MIN_TASK : builder.task_size;
+		builder.tasks = (ZiBvhTask*)zi_mem_alloc(sizeof(ZiBvhTask) * (count / ZI_BVH_MIN_TASK));
+		// builds everything on this thread instead
+		list.make_tasks = builder.tasks != ZI_NULL;
+	}
+	zi_bvh_build_node(&builder, &list, 0, 0, count, 0);
+
+	if (builder.task_count > 0) {
+		ZiThreadHandle workers[64];
+		u32            worker_count = thread_count - 1 < builder.task_count ? thread_count - 1 : builder.task_count - 1;
+		worker_count = worker_count < 64 ? worker_count : 64;
+		for (u32 i = 0; i < worker_count; ++i) {
+			workers[i] = zi_platform_thread_create(zi_bvh_worker, &builder, "zi-bvh-build");
+		}
+		// failed creates leave their share to the others
+		zi_bvh_worker(&builder);
+		for (u32 i = 0; i < worker_count; ++i) {
+			if (workers[i].handler) {
+				zi_platform_thread_join(workers[i]);
+			}
+		}
+
+		// in task order, the layout doesn't depend on which thread finished first
+		for (u32 i = 0; i < builder.task_count; ++i) {
+			if (!builder.failed) {
+				zi_bvh_splice(&list, &builder.tasks[i]);
+			}
+			zi_mem_free(builder.tasks[i].nodes);
+		}
+	}
+	zi_mem_free(builder.tasks);
+
+	bvh->triangles = builder.failed ? ZI_NULL : (ZiBvhTriangle*)zi_mem_alloc(sizeof(ZiBvhTriangle) * count);
+	if (!bvh->triangles) {
+		zi_log_error("out of memory building a BVH over %u triangles", count);
+		zi_mem_free(bounds);
+		zi_mem_free(centroids);
+		zi_mem_free(indices);
+		zi_mem_free(nodes);
+		return ZI_FALSE;
+	}
+	for (u32 i = 0; i < count; ++i) {
+		const ZiTriangle* triangle = &desc->triangles[indices[i]];
+		bvh->triangles[i].v0 = triangle->v0;
+		bvh->triangles[i].e1 = zi_vec3_sub(triangle->v1, triangle->v0);
+		bvh->triangles[i].e2 = zi_vec3_sub(triangle->v2, triangle->v0);
+	}
+	bvh->nodes = nodes;
+	bvh->node_count = list.count;
+	bvh->indices = indices;
+	bvh->triangle_count = count;
+
+	zi_mem_free(bounds);
+	zi_mem_free(centroids);
+	return ZI_TRUE;
+}
+
+void zi_bvh_destroy(ZiBvh* bvh) {
+	zi_mem_free(bvh->nodes);
+	zi_mem_free(bvh->triangles);
+	zi_mem_free(bvh->indices);
+	memset(bvh, 0, sizeof(*bvh));
+}
+
+ZiAABB zi_bvh_bounds(const ZiBvh* bvh) {
+	if (bvh->node_count == 0) return (ZiAABB){0};
+	return (ZiAABB){bvh->nodes[0].min, bvh->nodes[0].max};
+}
+
+// ============================================================================
+// Traversal
+// ============================================================================
+
+// axis-parallel rays get a huge finite inverse instead of infinity, a zero offset times
+// infinity would make the slab test NaN
+static inline f32 zi_bvh_safe_inverse(f32 d) {
+	return zi_abs_f32(d) > 1e-30f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+}
+
+// distance where the ray enters the box, F32_MAX when it misses it before t_max
+static inline f32 zi_bvh_ray_box(const ZiBvhNode* node, ZiVec3 origin, ZiVec3 inv_dir, f32 t_max) {
+	f32 tx1 = (node->min.x - origin.x) * inv_dir.x;
+	f32 tx2 = (node->max.x - origin.x) * inv_dir.x;
+	f32 ty1 = (node->min.y - origin.y) * inv_dir.y;
+	f32 ty2 = (node->max.y - origin.y) * inv_dir.y;
+	f32 tz1 = (node->min.z - origin.z) * inv_dir.z;
+	f32 tz2 = (node->max.z - origin.z) * inv_dir.z;
+	f32 t_near = zi_max_f32(zi_max_f32(zi_min_f32(tx1, tx2), zi_min_f32(ty1, ty2)), zi_max_f32(zi_min_f32(tz1, tz2), 0.0f));
+	f32 t_far = zi_min_f32(zi_min_f32(zi_max_f32(tx1, tx2), zi_max_f32(ty1, ty2)), zi_min_f32(zi_max_f32(tz1, tz2), t_max));
+	return t_near <= t_far ? t_near : F32_MAX;
+}
+
+// zi_ray_triangle_intersect with the edges precomputed and t limited to below t_max
+static inline ZiBool zi_bvh_ray_triangle(const ZiBvhTriangle* tri, ZiVec3 origin, ZiVec3 dir, f32 t_max, ZiBvhHit* hit) {
+	ZiVec3 h = zi_vec3_cross(dir, tri->e2);
+	f32    a = zi_vec3_dot(tri->e1, h);
+	if (zi_abs_f32(a) < ZI_EPSILON) return ZI_FALSE;
+
+	f32    f = 1.0f / a;
+	ZiVec3 s = zi_vec3_sub(origin, tri->v0);
+	f32    u = f * zi_vec3_dot(s, h);
+	if (u < 0.0f || u > 1.0f) return ZI_FALSE;
+
+	ZiVec3 q = zi_vec3_cross(s, tri->e1);
+	f32    v = f * zi_vec3_dot(dir, q);
+	if (v < 0.0f || u + v > 1.0f) return ZI_FALSE;
+
+	f32 t = f * zi_vec3_dot(tri->e2, q);
+	if (t < ZI_EPSILON || t >= t_max) return ZI_FALSE;
+
+	hit->t = t;
+	hit->u = u;
+	hit->v = v;
+	return ZI_TRUE;
+}
+
+// Near child first, the far one goes on the stack with its entry distance so it can be
+// skipped once something closer was hit. any stops at the first hit.
+static ZiBool zi_bvh_traverse(const ZiBvh* bvh, ZiRay ray, f32 max_t, ZiBool any, ZiBvhHit* hit) {
+	if (bvh->node_count == 0) return ZI_FALSE;
+
+	ZiVec3 origin = ray.origin;
+	ZiVec3 dir = ray.direction;
+	ZiVec3 inv_dir = zi_vec3(zi_bvh_safe_inverse(dir.x), zi_bvh_safe_inverse(dir.y), zi_bvh_safe_inverse(dir.z));
+	if (zi_bvh_ray_box(&bvh->nodes[0], origin, inv_dir, max_t) == F32_MAX) return ZI_FALSE;
+
+	u32      stack[ZI_BVH_MAX_DEPTH];
+	f32      stack_t[ZI_BVH_MAX_DEPTH];
+	u32      top = 0;
+	u32      index = 0;
+	f32      best_t = max_t;
+	ZiBool   found = ZI_FALSE;
+	ZiBvhHit candidate;
+
+	for (;;) {
+		const ZiBvhNode* node = &bvh->nodes[index];
+		if (node->count > 0) {
+			for (u32 i = node->first; i < node->first + node->count; ++i) {
+				if (zi_bvh_ray_triangle(&bvh->triangles[i], origin, dir, best_t, &candidate)) {
+					candidate.triangle = bvh->indices[i];
+					*hit = candidate;
+					best_t = candidate.t;
+					found = ZI_TRUE;
+					if (any) return ZI_TRUE;
+				}
+			}
+		} else {
+			u32 near = node->first;
+			u32 far = node->first + 1;
+			f32 t_near = zi_bvh_ray_box(&bvh->nodes[near], origin, inv_dir, best_t);
+			f32 t_far = zi_bvh_ray_box(&bvh->nodes[far], origin, inv_dir, best_t);
+			if (t_far < t_near) {
+				u32 swap = near;
+				near = far;
+				far = swap;
+				f32 swap_t = t_near;
+				t_near = t_far;
+				t_far = swap_t;
+			}
+			if (t_near != F32_MAX) {
+				if (t_far != F32_MAX) {
+					stack[top] = far;
+					stack_t[top++] = t_far;
+				}
+				index = near;
+				continue;
+			}
+		}
+
+		// next stacked node the ray still reaches before the best hit
+		for (;;) {
+			if (top == 0) return found;
+			--top;
+			if (stack_t[top] < best_t) break;
+		}
+		index = stack[top];
+	}
+}
+
+ZiBool zi_bvh_raycast(const ZiBvh* bvh, ZiRay ray, f32 max_t, ZiBvhHit* hit) {
+	ZiBvhHit result;
+	if (!zi_bvh_traverse(bvh, ray, max_t, ZI_FALSE, &result)) return ZI_FALSE;
+	if (hit) *hit = result;
+	return ZI_TRUE;
+}
+
+ZiBool zi_bvh_raycast_any(const ZiBvh* bvh, ZiRay ray, f32 max_t) {
+	ZiBvhHit result;
+	return zi_bvh_traverse(bvh, ray, max_t, ZI_TRUE, &result);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "zi_common.h"
+#include "zi_math.h"
+
+// ============================================================================
+// Triangle BVH
+// ============================================================================
+//
+// Static bounding volume hierarchy over a triangle soup, for raycasts against level geometry:
+// line of sight, decal placement, lightmap baking. Built once with binned SAH, then read only,
+// any number of threads can trace against it at the same time. Moving geometry needs a rebuild.
+//
+// Hits follow zi_ray_triangle_intersect: both faces count, t is in units of the ray direction
+// (which doesn't have to be normalized) and has to be above ZI_EPSILON and below max_t.
+
+#define ZI_BVH_DEFAULT_LEAF_SIZE 4
+// deeper subtrees become leaves whatever their size, bounds the traversal stack
+#define ZI_BVH_MAX_DEPTH         64
+
+// 32 bytes, two per cache line. Children are stored next to each other, right = left + 1.
+typedef struct ZiBvhNode {
+	ZiVec3 min;
+	// inner nodes: left child, leaves: first triangle
+	u32    first;
+	ZiVec3 max;
+	// triangles in a leaf, 0 for inner nodes
+	u32    count;
+} ZiBvhNode;
+
+// a triangle as Moller-Trumbore wants it, e1 = v1 - v0 and e2 = v2 - v0
+typedef struct ZiBvhTriangle {
+	ZiVec3 v0;
+	ZiVec3 e1;
+	ZiVec3 e2;
+} ZiBvhTriangle;
+
+typedef struct ZiBvh {
+	// root at 0
+	ZiBvhNode*     nodes;
+	u32            node_count;
+	// copies in leaf order
+	ZiBvhTriangle* triangles;
+	// leaf order to the index the triangle had in the build input
+	u32*           indices;
+	u32            triangle_count;
+} ZiBvh;
+
+typedef struct ZiBvhBuildDesc {
+	const ZiTriangle* triangles;
+	u32               triangle_count;
+	// most triangles in a leaf, 0 is ZI_BVH_DEFAULT_LEAF_SIZE
+	u32               max_leaf_size;
+	// threads building at once including the caller, 0 or 1 builds on the calling thread, so does
+	// the web build. The tree is the same for every count, only the node order differs.
+	u32               thread_count;
+} ZiBvhBuildDesc;
+
+typedef struct ZiBvhHit {
+	f32 t;
+	// barycentrics of the hit point, weight of v1 and v2
+	f32 u;
+	f32 v;
+	// index in the build input
+	u32 triangle;
+} ZiBvhHit;
+
+// an empty input builds an empty tree that nothing hits
+ZiBool zi_bvh_build(ZiBvh* bvh, const ZiBvhBuildDesc* desc);
+void   zi_bvh_destroy(ZiBvh* bvh);
+// bounds of everything, zero when empty
+ZiAABB zi_bvh_bounds(const ZiBvh* bvh);
+
+// nearest hit in (ZI_EPSILON, max_t), hit is untouched on a miss
+ZiBool zi_bvh_raycast(const ZiBvh* bvh, ZiRay ray, f32 max_t, ZiBvhHit* hit);
+// whether anything is hit in (ZI_EPSILON, max_t), stops at the first triangle found
+ZiBool zi_bvh_raycast_any(const ZiBvh* bvh, ZiRay ray, f32 max_t);
@@ -26,7 +26,9 @@ typedef u8 ZiBool;
 
 #define ZI_NULL 0
 
+// default, can be changed at runtime up to ZI_MAX_FRAMES_IN_FLIGHT
 #define ZI_FRAMES_IN_FLIGHT 2
+#define ZI_MAX_FRAMES_IN_FLIGHT 3
 
 #if defined(_WIN64)
 #define ZI_WIN 1
@@ -44,6 +46,34 @@ typedef u8 ZiBool;
 #define ZI_API
 #endif
 
+#if defined(_MSC_VER)
+#define ZI_THREAD_LOCAL __declspec(thread)
+#else
+#define ZI_THREAD_LOCAL __thread
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ZI_ARCH_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ZI_ARCH_ARM64 1
+#elif defined(__arm__) || defined(_M_ARM)
+#define ZI_ARCH_ARM 1
+#endif
+
+// compiles a single function for an instruction set the rest of the binary doesn't assume,
+// only call it after checking zi_platform_cpu_features. MSVC accepts intrinsics without it.
+#if defined(__GNUC__) || defined(__clang__)
+#define ZI_TARGET(features) __attribute__((target(features)))
+#else
+#define ZI_TARGET(features)
+#endif
+
+#if defined(_MSC_VER)
+#define ZI_ALIGN(n) __declspec(align(n))
+#else
+#define ZI_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
 typedef f32 Float;
 
 #define ZI_HANDLER(StructName)                                                 \
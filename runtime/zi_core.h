@@ -34,6 +34,21 @@ static inline void zi_mem_free(VoidPtr ptr) {
 #define ZI_HASHMAP_INITIAL_CAPACITY 16
 #define ZI_HASHMAP_LOAD_FACTOR 0.75f
 
+// Key functions the maps look up as hash_<key_type> / compare_<key_type>, u64 keys are mixed
+// with the murmur3 finalizer so ids and packed pairs spread over the buckets.
+static inline u64 hash_u64(u64 key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+static inline i8 compare_u64(u64 a, u64 b) {
+    return a == b;
+}
+
 #define ZI_HASHMAP(name, key_type, value_type)                                 \
                                                                                \
 typedef struct name##_Entry {                                                  \
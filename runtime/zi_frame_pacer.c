@@ -0,0 +1,104 @@
+#include "zi_frame_pacer.h"
+
+#include "zi_atomic.h"
+#include "zi_platform.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void zi_frame_pacer_init(ZiFramePacer* pacer, f64 target_fps) {
+	memset(pacer, 0, sizeof(*pacer));
+	pacer->frequency = zi_platform_get_tick_frequency();
+	pacer->spin_ticks = pacer->frequency * ZI_FRAME_PACER_SPIN_US / 1000000ull;
+	zi_frame_pacer_set_target(pacer, target_fps);
+}
+
+void zi_frame_pacer_set_target(ZiFramePacer* pacer, f64 target_fps) {
+	u64 period = target_fps > 0.0 ? (u64)((f64)pacer->frequency / target_fps) : 0;
+	if (period != pacer->period) {
+		pacer->period = period;
+		pacer->next_deadline = 0;
+	}
+}
+
+f64 zi_frame_pacer_get_remaining(const ZiFramePacer* pacer) {
+	if (pacer->period == 0 || pacer->next_deadline == 0) {
+		return 0.0;
+	}
+	u64 now = zi_platform_get_ticks();
+	return now < pacer->next_deadline ? (f64)(pacer->next_deadline - now) / (f64)pacer->frequency : 0.0;
+}
+
+void zi_frame_pacer_wait(ZiFramePacer* pacer) {
+	u64 now = zi_platform_get_ticks();
+
+	if (pacer->period > 0) {
+		if (pacer->next_deadline == 0) {
+			pacer->next_deadline = (pacer->last_frame ? pacer->last_frame : now) + pacer->period;
+		}
+
+		u64 deadline = pacer->next_deadline;
+		if (now + pacer->spin_ticks < deadline) {
+			zi_platform_sleep_until(deadline - pacer->spin_ticks);
+		}
+		while ((now = zi_platform_get_ticks()) < deadline) {
+			zi_atomic_pause();
+		}
+
+		pacer->next_deadline += pacer->period;
+		if (pacer->next_deadline <= now) {
+			pacer->next_deadline = now + pacer->period;
+		}
+	}
+
+	zi_frame_pacer_record(pacer, now);
+}
+
+void zi_frame_pacer_record(ZiFramePacer* pacer, u64 now) {
+	if (pacer->last_frame != 0 && now > pacer->last_frame) {
+		pacer->history_ms[pacer->history_head] = (f32)((f64)(now - pacer->last_frame) * 1000.0 / (f64)pacer->frequency);
+		pacer->history_head = (pacer->history_head + 1) % ZI_FRAME_PACER_HISTORY;
+		if (pacer->history_count < ZI_FRAME_PACER_HISTORY) {
+			pacer->history_count++;
+		}
+	}
+	pacer->last_frame = now;
+}
+
+static int zi_frame_pacer_compare(const void* a, const void* b) {
+	f32 x = *(const f32*)a;
+	f32 y = *(const f32*)b;
+	return (x > y) - (x < y);
+}
+
+void zi_frame_pacer_get_stats(const ZiFramePacer* pacer, ZiFrameTimingStats* stats) {
+	memset(stats, 0, sizeof(*stats));
+
+	u32 count = pacer->history_count;
+	if (count == 0) {
+		return;
+	}
+
+	f32 sorted[ZI_FRAME_PACER_HISTORY];
+	f64 sum = 0.0;
+	for (u32 i = 0; i < count; ++i) {
+		sorted[i] = pacer->history_ms[i];
+		sum += pacer->history_ms[i];
+	}
+	qsort(sorted, count, sizeof(f32), zi_frame_pacer_compare);
+
+	f64 average = sum / count;
+	f64 variance = 0.0;
+	for (u32 i = 0; i < count; ++i) {
+		f64 diff = sorted[i] - average;
+		variance += diff * diff;
+	}
+
+	stats->average_ms = average;
+	stats->min_ms = sorted[0];
+	stats->max_ms = sorted[count - 1];
+	stats->std_dev_ms = sqrt(variance / count);
+	stats->p99_ms = sorted[(u32)((count - 1) * 0.99)];
+	stats->sample_count = count;
+}
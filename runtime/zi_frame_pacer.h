@@ -0,0 +1,48 @@
+#pragma once
+
+#include "zi_common.h"
+
+// ============================================================================
+// Frame pacer
+// ============================================================================
+
+#define ZI_FRAME_PACER_HISTORY 128
+
+// the OS sleep is only trusted up to this close to the deadline, the rest is spun
+#ifdef ZI_WIN
+#define ZI_FRAME_PACER_SPIN_US 2000
+#else
+#define ZI_FRAME_PACER_SPIN_US 1000
+#endif
+
+typedef struct ZiFrameTimingStats {
+	f64 average_ms;
+	f64 min_ms;
+	f64 max_ms;
+	f64 std_dev_ms;
+	f64 p99_ms;
+	u32 sample_count;
+} ZiFrameTimingStats;
+
+typedef struct ZiFramePacer {
+	u64 frequency;
+	u64 period;
+	u64 spin_ticks;
+	u64 next_deadline;
+	u64 last_frame;
+	f32 history_ms[ZI_FRAME_PACER_HISTORY];
+	u32 history_head;
+	u32 history_count;
+} ZiFramePacer;
+
+// target_fps 0 means unpaced, frames are only measured
+void zi_frame_pacer_init(ZiFramePacer* pacer, f64 target_fps);
+void zi_frame_pacer_set_target(ZiFramePacer* pacer, f64 target_fps);
+// seconds until the next frame is due, 0 when unpaced or late
+f64  zi_frame_pacer_get_remaining(const ZiFramePacer* pacer);
+// Blocks until the next frame is due with a coarse sleep followed by a short spin, then records the frame.
+// A pacer that fell behind by more than a frame restarts from now instead of rushing to catch up.
+void zi_frame_pacer_wait(ZiFramePacer* pacer);
+// Records a frame boundary at the given ticks, zi_frame_pacer_wait calls this itself
+void zi_frame_pacer_record(ZiFramePacer* pacer, u64 now);
+void zi_frame_pacer_get_stats(const ZiFramePacer* pacer, ZiFrameTimingStats* stats);
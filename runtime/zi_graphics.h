@@ -17,7 +17,9 @@ enum ZiGraphicsBackend_ {
 	ZiGraphicsBackend_Vulkan = 1,
 	ZiGraphicsBackend_Metal  = 2,
 	ZiGraphicsBackend_D3D12  = 3,
-	ZiGraphicsBackend_WebGPU = 4
+	ZiGraphicsBackend_WebGPU = 4,
+	// no GPU, every call is a no-op, for headless servers
+	ZiGraphicsBackend_Null   = 5
 };
 
 typedef u32 ZiGraphicsBackend;
@@ -555,6 +557,43 @@ typedef struct ZiDeviceFeatures {
 	ZiBool resolve_depth;
 } ZiDeviceFeatures;
 
+#define ZI_GRAPHICS_STATS_HISTORY 128
+
+// What went through the zi_graphics.c dispatch between two zi_graphics_end_frame calls. Counted on the
+// calling thread without atomics, commands recorded on several threads at once can be undercounted.
+typedef struct ZiRenderFrameStats {
+	u64 frame;
+	// direct draws plus the draw_count of indirect ones
+	u32 draw_calls;
+	// of direct draws, indirect instance counts live on the GPU
+	u64 instances;
+	u32 dispatches;
+	u32 pipeline_binds;
+	u32 bind_group_binds;
+	u64 push_constant_bytes;
+	u32 buffer_writes;
+	u64 uploaded_bytes;
+	// one per bind group created
+	u32 descriptor_sets_allocated;
+	// successful creates of any resource type, and destroys of non-null handles
+	u32 resources_created;
+	u32 resources_destroyed;
+} ZiRenderFrameStats;
+
+// timestamp pairs per command buffer, labels past this aren't timed
+#define ZI_GPU_TIMING_MAX_ZONES 256
+
+// GPU time spent between a begin/end debug label pair, zones are in begin order
+typedef struct ZiGpuTimingZone {
+	const char* label;
+	u32         depth;
+	// index of the enclosing zone, U32_MAX at the top level
+	u32         parent;
+	// from the first timed label of the submission
+	u64         begin_ns;
+	u64         duration_ns;
+} ZiGpuTimingZone;
+
 typedef struct ZiRenderDevice {
 	void (*init)();
 	void (*terminate)();
@@ -657,10 +696,15 @@ typedef struct ZiRenderDevice {
 	ZiTextureHandle         (*swapchain_get_texture)(ZiSwapchainHandle handle, u32 index);
 	void                    (*swapchain_present)(ZiSwapchainHandle handle);
 
+	// Frame
+	void                    (*set_frames_in_flight)(u32 count);
+	u32                     (*get_frames_in_flight)();
+
 	// Debug
 	void                    (*set_object_name)(void* handle, const char* name);
 	void                    (*cmd_begin_debug_label)(ZiCommandBufferHandle cmd, const char* label);
 	void                    (*cmd_end_debug_label)(ZiCommandBufferHandle cmd);
+	u32                     (*cmd_get_gpu_timings)(ZiCommandBufferHandle cmd, ZiGpuTimingZone* zones, u32 max_zones);
 } ZiRenderDevice;
 
 
@@ -763,7 +807,20 @@ u32                     zi_swapchain_get_texture_count(ZiSwapchainHandle handle)
 ZiTextureHandle         zi_swapchain_get_texture(ZiSwapchainHandle handle, u32 index);
 void                    zi_swapchain_present(ZiSwapchainHandle handle);
 
+// Frame
+// 1..ZI_MAX_FRAMES_IN_FLIGHT, waits for the GPU to go idle before switching
+void                    zi_graphics_set_frames_in_flight(u32 count);
+u32                     zi_graphics_get_frames_in_flight();
+// closes the frame's counters into the history, zi_app_loop calls it after render
+void                    zi_graphics_end_frame();
+// Copies up to max_frames of the last ZI_GRAPHICS_STATS_HISTORY completed frames, newest first,
+// returns how many were copied
+u32                     zi_graphics_get_frame_stats(ZiRenderFrameStats* frames, u32 max_frames);
+
 // Debug
 void                    zi_set_object_name(void* handle, const char* name);
 void                    zi_cmd_begin_debug_label(ZiCommandBufferHandle cmd, const char* label);
 void                    zi_cmd_end_debug_label(ZiCommandBufferHandle cmd);
+// Zones of the last submission of cmd that finished on the GPU, never waits for it. Also shows up
+// on the profiler's "GPU" track while it records. Returns the zone count, 0 without timestamp support.
+u32                     zi_cmd_get_gpu_timings(ZiCommandBufferHandle cmd, ZiGpuTimingZone* zones, u32 max_zones);
@@ -0,0 +1,243 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_Graphics
+
+#include "zi_graphics.h"
+#include "zi_log.h"
+
+#include <string.h>
+
+// ============================================================================
+// Null device, used by headless servers and benchmarks that run without a GPU.
+// Every create returns a null handle, maps return ZI_NULL and commands are dropped.
+// ============================================================================
+
+static u32 frames_in_flight = ZI_FRAMES_IN_FLIGHT;
+
+static void zi_null_init() {
+	zi_log_debug("null graphics device initialized");
+}
+
+static void zi_null_terminate() {
+}
+
+static void zi_null_get_device_limits(ZiDeviceLimits* limits) {
+	if (limits) memset(limits, 0, sizeof(ZiDeviceLimits));
+}
+
+// Buffer
+static ZiBufferHandle zi_null_buffer_create(const ZiBufferDesc* desc) { return (ZiBufferHandle){0}; }
+static void zi_null_buffer_destroy(ZiBufferHandle handle) {}
+static void zi_null_buffer_write(ZiBufferHandle handle, u64 offset, const void* data, u64 size) {}
+static void* zi_null_buffer_map(ZiBufferHandle handle, u64 offset, u64 size) { return ZI_NULL; }
+static void zi_null_buffer_unmap(ZiBufferHandle handle) {}
+
+// Texture
+static ZiTextureHandle zi_null_texture_create(const ZiTextureDesc* desc) { return (ZiTextureHandle){0}; }
+static void zi_null_texture_destroy(ZiTextureHandle handle) {}
+
+// Texture View
+static ZiTextureViewHandle zi_null_texture_view_create(const ZiTextureViewDesc* desc) { return (ZiTextureViewHandle){0}; }
+static void zi_null_texture_view_destroy(ZiTextureViewHandle handle) {}
+
+// Sampler
+static ZiSamplerHandle zi_null_sampler_create(const ZiSamplerDesc* desc) { return (ZiSamplerHandle){0}; }
+static void zi_null_sampler_destroy(ZiSamplerHandle handle) {}
+
+// Shader
+static ZiShaderHandle zi_null_shader_create(const ZiShaderDesc* desc) { return (ZiShaderHandle){0}; }
+static void zi_null_shader_destroy(ZiShaderHandle handle) {}
+
+// Pipeline Layout
+static ZiPipelineLayoutHandle zi_null_pipeline_layout_create(const ZiPipelineLayoutDesc* desc) { return (ZiPipelineLayoutHandle){0}; }
+static void zi_null_pipeline_layout_destroy(ZiPipelineLayoutHandle handle) {}
+
+// Pipelines
+static ZiPipelineHandle zi_null_graphics_pipeline_create(const ZiGraphicsPipelineDesc* desc) { return (ZiPipelineHandle){0}; }
+static ZiPipelineHandle zi_null_compute_pipeline_create(const ZiComputePipelineDesc* desc) { return (ZiPipelineHandle){0}; }
+static void zi_null_pipeline_destroy(ZiPipelineHandle handle) {}
+
+// Bind Group Layout
+static ZiBindGroupLayoutHandle zi_null_bind_group_layout_create(const ZiBindGroupLayoutDesc* desc) { return (ZiBindGroupLayoutHandle){0}; }
+static void zi_null_bind_group_layout_destroy(ZiBindGroupLayoutHandle handle) {}
+
+// Bind Group
+static ZiBindGroupHandle zi_null_bind_group_create(const ZiBindGroupDesc* desc) { return (ZiBindGroupHandle){0}; }
+static void zi_null_bind_group_destroy(ZiBindGroupHandle handle) {}
+
+// Render Pass
+static ZiRenderPassHandle zi_null_render_pass_create(const ZiRenderPassDesc* desc) { return (ZiRenderPassHandle){0}; }
+static void zi_null_render_pass_destroy(ZiRenderPassHandle handle) {}
+
+// Framebuffer
+static ZiFramebufferHandle zi_null_framebuffer_create(const ZiFramebufferDesc* desc) { return (ZiFramebufferHandle){0}; }
+static void zi_null_framebuffer_destroy(ZiFramebufferHandle handle) {}
+
+// Command Buffer
+static ZiCommandBufferHandle zi_null_command_buffer_create() { return (ZiCommandBufferHandle){0}; }
+static void zi_null_command_buffer_op(ZiCommandBufferHandle handle) {}
+
+// Command Buffer - Render Pass
+static void zi_null_cmd_begin_render_pass(ZiCommandBufferHandle cmd, const ZiRenderPassBeginDesc* desc) {}
+
+// Command Buffer - State
+static void zi_null_cmd_set_pipeline(ZiCommandBufferHandle cmd, ZiPipelineHandle pipeline) {}
+static void zi_null_cmd_set_bind_group(ZiCommandBufferHandle cmd, u32 index, ZiBindGroupHandle bind_group) {}
+static void zi_null_cmd_set_vertex_buffer(ZiCommandBufferHandle cmd, u32 slot, ZiBufferHandle buffer, u64 offset) {}
+static void zi_null_cmd_set_index_buffer(ZiCommandBufferHandle cmd, ZiBufferHandle buffer, u64 offset, ZiIndexFormat format) {}
+static void zi_null_cmd_push_constants(ZiCommandBufferHandle cmd, ZiShaderStage stages, u32 offset, u32 size, const void* data) {}
+static void zi_null_cmd_set_viewport(ZiCommandBufferHandle cmd, f32 x, f32 y, f32 width, f32 height, f32 min_depth, f32 max_depth) {}
+static void zi_null_cmd_set_scissor(ZiCommandBufferHandle cmd, u32 x, u32 y, u32 width, u32 height) {}
+static void zi_null_cmd_set_blend_constant(ZiCommandBufferHandle cmd, f32 color[4]) {}
+static void zi_null_cmd_set_stencil_reference(ZiCommandBufferHandle cmd, u32 reference) {}
+
+// Command Buffer - Draw
+static void zi_null_cmd_draw(ZiCommandBufferHandle cmd, u32 vertex_count, u32 instance_count, u32 first_vertex, u32 first_instance) {}
+static void zi_null_cmd_draw_indexed(ZiCommandBufferHandle cmd, u32 index_count, u32 instance_count, u32 first_index, i32 vertex_offset, u32 first_instance) {}
+static void zi_null_cmd_draw_indirect(ZiCommandBufferHandle cmd, ZiBufferHandle buffer, u64 offset, u32 draw_count, u32 stride) {}
+
+// Command Buffer - Compute
+static void zi_null_cmd_dispatch(ZiCommandBufferHandle cmd, u32 group_count_x, u32 group_count_y, u32 group_count_z) {}
+static void zi_null_cmd_dispatch_indirect(ZiCommandBufferHandle cmd, ZiBufferHandle buffer, u64 offset) {}
+
+// Command Buffer - Copy
+static void zi_null_cmd_copy_buffer(ZiCommandBufferHandle cmd, ZiBufferHandle src, u64 src_offset, ZiBufferHandle dst, u64 dst_offset, u64 size) {}
+static void zi_null_cmd_copy_texture(ZiCommandBufferHandle cmd, ZiTextureHandle src, ZiTextureHandle dst) {}
+static void zi_null_cmd_copy_buffer_to_texture(ZiCommandBufferHandle cmd, ZiBufferHandle src, u64 src_offset, ZiTextureHandle dst, u32 mip_level, u32 array_layer) {}
+static void zi_null_cmd_copy_texture_to_buffer(ZiCommandBufferHandle cmd, ZiTextureHandle src, u32 mip_level, u32 array_layer, ZiBufferHandle dst, u64 dst_offset) {}
+
+// Swapchain
+static ZiSwapchainHandle zi_null_swapchain_create(const ZiSwapchainDesc* desc) { return (ZiSwapchainHandle){0}; }
+static void zi_null_swapchain_destroy(ZiSwapchainHandle handle) {}
+static void zi_null_swapchain_resize(ZiSwapchainHandle handle, u32 width, u32 height) {}
+static u32 zi_null_swapchain_get_texture_count(ZiSwapchainHandle handle) { return 0; }
+static ZiTextureHandle zi_null_swapchain_get_texture(ZiSwapchainHandle handle, u32 index) { return (ZiTextureHandle){0}; }
+static void zi_null_swapchain_present(ZiSwapchainHandle handle) {}
+
+// Frame
+static void zi_null_set_frames_in_flight(u32 count) {
+	if (count < 1) count = 1;
+	if (count > ZI_MAX_FRAMES_IN_FLIGHT) count = ZI_MAX_FRAMES_IN_FLIGHT;
+	frames_in_flight = count;
+}
+
+static u32 zi_null_get_frames_in_flight() {
+	return frames_in_flight;
+}
+
+// Debug
+static void zi_null_set_object_name(void* handle, const char* name) {}
+static void zi_null_cmd_begin_debug_label(ZiCommandBufferHandle cmd, const char* label) {}
+
+static u32 zi_null_cmd_get_gpu_timings(ZiCommandBufferHandle cmd, ZiGpuTimingZone* zones, u32 max_zones) {
+	return 0;
+}
+
+void zi_graphics_init_null(ZiRenderDevice* device) {
+	device->init = zi_null_init;
+	device->terminate = zi_null_terminate;
+	device->get_device_limits = zi_null_get_device_limits;
+
+	// Buffer
+	device->buffer_create = zi_null_buffer_create;
+	device->buffer_destroy = zi_null_buffer_destroy;
+	device->buffer_write = zi_null_buffer_write;
+	device->buffer_map = zi_null_buffer_map;
+	device->buffer_unmap = zi_null_buffer_unmap;
+
+	// Texture
+	device->texture_create = zi_null_texture_create;
+	device->texture_destroy = zi_null_texture_destroy;
+
+	// Texture View
+	device->texture_view_create = zi_null_texture_view_create;
+	device->texture_view_destroy = zi_null_texture_view_destroy;
+
+	// Sampler
+	device->sampler_create = zi_null_sampler_create;
+	device->sampler_destroy = zi_null_sampler_destroy;
+
+	// Shader
+	device->shader_create = zi_null_shader_create;
+	device->shader_destroy = zi_null_shader_destroy;
+
+	// Pipeline Layout
+	device->pipeline_layout_create = zi_null_pipeline_layout_create;
+	device->pipeline_layout_destroy = zi_null_pipeline_layout_destroy;
+
+	// Pipelines
+	device->graphics_pipeline_create = zi_null_graphics_pipeline_create;
+	device->graphics_pipeline_destroy = zi_null_pipeline_destroy;
+	device->compute_pipeline_create = zi_null_compute_pipeline_create;
+	device->compute_pipeline_destroy = zi_null_pipeline_destroy;
+
+	// Bind Group Layout
+	device->bind_group_layout_create = zi_null_bind_group_layout_create;
+	device->bind_group_layout_destroy = zi_null_bind_group_layout_destroy;
+
+	// Bind Group
+	device->bind_group_create = zi_null_bind_group_create;
+	device->bind_group_destroy = zi_null_bind_group_destroy;
+
+	// Render Pass
+	device->render_pass_create = zi_null_render_pass_create;
+	device->render_pass_destroy = zi_null_render_pass_destroy;
+
+	// Framebuffer
+	device->framebuffer_create = zi_null_framebuffer_create;
+	device->framebuffer_destroy = zi_null_framebuffer_destroy;
+
+	// Command Buffer
+	device->command_buffer_create = zi_null_command_buffer_create;
+	device->command_buffer_destroy = zi_null_command_buffer_op;
+	device->command_buffer_begin = zi_null_command_buffer_op;
+	device->command_buffer_end = zi_null_command_buffer_op;
+	device->command_buffer_submit = zi_null_command_buffer_op;
+
+	// Command Buffer - Render Pass
+	device->cmd_begin_render_pass = zi_null_cmd_begin_render_pass;
+	device->cmd_end_render_pass = zi_null_command_buffer_op;
+
+	// Command Buffer - State
+	device->cmd_set_pipeline = zi_null_cmd_set_pipeline;
+	device->cmd_set_bind_group = zi_null_cmd_set_bind_group;
+	device->cmd_set_vertex_buffer = zi_null_cmd_set_vertex_buffer;
+	device->cmd_set_index_buffer = zi_null_cmd_set_index_buffer;
+	device->cmd_push_constants = zi_null_cmd_push_constants;
+	device->cmd_set_viewport = zi_null_cmd_set_viewport;
+	device->cmd_set_scissor = zi_null_cmd_set_scissor;
+	device->cmd_set_blend_constant = zi_null_cmd_set_blend_constant;
+	device->cmd_set_stencil_reference = zi_null_cmd_set_stencil_reference;
+
+	// Command Buffer - Draw
+	device->cmd_draw = zi_null_cmd_draw;
+	device->cmd_draw_indexed = zi_null_cmd_draw_indexed;
+	device->cmd_draw_indirect = zi_null_cmd_draw_indirect;
+	device->cmd_draw_indexed_indirect = zi_null_cmd_draw_indirect;
+
+	// Command Buffer - Compute
+	device->cmd_dispatch = zi_null_cmd_dispatch;
+	device->cmd_dispatch_indirect = zi_null_cmd_dispatch_indirect;
+
+	// Command Buffer - Copy
+	device->cmd_copy_buffer = zi_null_cmd_copy_buffer;
+	device->cmd_copy_texture = zi_null_cmd_copy_texture;
+	device->cmd_copy_buffer_to_texture = zi_null_cmd_copy_buffer_to_texture;
+	device->cmd_copy_texture_to_buffer = zi_null_cmd_copy_texture_to_buffer;
+
+	// Swapchain
+	device->swapchain_create = zi_null_swapchain_create;
+	device->swapchain_destroy = zi_null_swapchain_destroy;
+	device->swapchain_resize = zi_null_swapchain_resize;
+	device->swapchain_get_texture_count = zi_null_swapchain_get_texture_count;
+	device->swapchain_get_texture = zi_null_swapchain_get_texture;
+	device->swapchain_present = zi_null_swapchain_present;
+
+	// Frame
+	device->set_frames_in_flight = zi_null_set_frames_in_flight;
+	device->get_frames_in_flight = zi_null_get_frames_in_flight;
+
+	// Debug
+	device->set_object_name = zi_null_set_object_name;
+	device->cmd_begin_debug_label = zi_null_cmd_begin_debug_label;
+	device->cmd_end_debug_label = zi_null_command_buffer_op;
+	device->cmd_get_gpu_timings = zi_null_cmd_get_gpu_timings;
+}
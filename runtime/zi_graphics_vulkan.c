@@ -1,5 +1,9 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_Vulkan
+
 #include "zi_graphics.h"
 #include "zi_log.h"
+#include "zi_platform.h"
+#include "zi_profiler.h"
 
 #ifdef ZI_VULKAN_ENABLED
 
@@ -18,6 +22,7 @@ typedef struct ZiVulkanAdapter {
 	u32              score;
 	u32              graphics_family;
 	u32              present_family;
+	u32              timestamp_valid_bits;
 
 	VkPhysicalDeviceProperties2                      device_properties;
 	VkPhysicalDeviceRayQueryFeaturesKHR              device_ray_query_features_khr;
@@ -114,11 +119,32 @@ typedef struct ZiVulkanFramebuffer {
 	u32           layers;
 } ZiVulkanFramebuffer;
 
+#define ZI_VULKAN_LABEL_STACK_DEPTH 32
+
+typedef struct ZiVulkanTimingZone {
+	const char* label;
+	u32         depth;
+	u32         parent;
+} ZiVulkanTimingZone;
+
 typedef struct ZiVulkanCommandBuffer {
 	VkCommandBuffer cmd;
 	VkCommandPool   pool;
 	VkFence         fence;
 	ZiBool          is_recording;
+
+	// zone i writes queries 2i and 2i+1, read back once the fence signaled
+	VkQueryPool         query_pool;
+	ZiVulkanTimingZone* zones;
+	u32                 zone_count;
+	// open labels, U32_MAX for labels that got no zone
+	u32                 label_stack[ZI_VULKAN_LABEL_STACK_DEPTH];
+	u32                 label_depth;
+	u32                 label_overflow;
+	ZiBool              timings_pending;
+	u64                 submit_ticks;
+	ZiGpuTimingZone*    timings;
+	u32                 timing_count;
 } ZiVulkanCommandBuffer;
 
 typedef struct ZiVulkanSwapchain {
@@ -132,8 +158,10 @@ typedef struct ZiVulkanSwapchain {
 	VkImage*         images;
 	ZiVulkanTexture* textures;
 	VkImageView*     image_views;
-	VkSemaphore      image_available_semaphores[ZI_FRAMES_IN_FLIGHT];
-	VkSemaphore      render_finished_semaphores[ZI_FRAMES_IN_FLIGHT];
+	VkSemaphore      image_available_semaphores[ZI_MAX_FRAMES_IN_FLIGHT];
+	VkSemaphore      render_finished_semaphores[ZI_MAX_FRAMES_IN_FLIGHT];
+	// signaled once everything queued before the slot's present finished, waited on before the slot is reused
+	VkFence          in_flight_fences[ZI_MAX_FRAMES_IN_FLIGHT];
 	u32              current_image_index;
 	u32              current_frame;
 } ZiVulkanSwapchain;
@@ -154,6 +182,7 @@ static ZiBool vulkan_query_instance_extensions(const char** required_extensions,
 static void   vulkan_check_physical_device(ZiVulkanAdapter* adapter);
 static ZiBool vulkan_add_if_present(ZiVulkanExtension* extensions, const char* extension, VoidPtr feature);
 static void   vulkan_add_to_chain(VkPhysicalDeviceFeatures2* features, VoidPtr feature);
+static void   vulkan_init_timestamps();
 
 // Format conversion helpers
 static VkFormat zi_format_to_vk(ZiFormat format) {
@@ -458,11 +487,12 @@ static ZiVulkanAdapter*         selected_adapter = ZI_NULL;
 static VkDevice                 device = ZI_NULL;
 static VmaAllocator             vma_allocator = ZI_NULL;
 static VkDescriptorPool         descriptor_pool;
-static VkFence                  in_flight_fences[ZI_FRAMES_IN_FLIGHT];
 
 //global command buffers;
 static VkCommandPool   command_pool;
-static VkCommandBuffer command_buffers[ZI_FRAMES_IN_FLIGHT];
+static VkCommandBuffer command_buffers[ZI_MAX_FRAMES_IN_FLIGHT];
+// sync objects are created for ZI_MAX_FRAMES_IN_FLIGHT, only the first frames_in_flight rotate
+static u32             frames_in_flight = ZI_FRAMES_IN_FLIGHT;
 
 static VkQueue graphics_queue = ZI_NULL;
 static VkQueue present_queue = ZI_NULL;
@@ -470,10 +500,18 @@ static VkQueue present_queue = ZI_NULL;
 static ZiDeviceFeatures features;
 static ZiBool           has_buffer_device_address = ZI_FALSE;
 
+// GPU timestamps at debug labels
+static ZiBool          timestamps_supported = ZI_FALSE;
+static f64             timestamp_period = 1.0;
+static u64             timestamp_mask = ~0ull;
+static ZiBool          calibrated_timestamps = ZI_FALSE;
+static VkTimeDomainEXT calibrated_host_domain;
+
 static ZiVulkanAdapter* adapters;
 static u32              adapters_count;
 
 static void zi_vulkan_init() {
+	ZI_PROFILE_FUNCTION();
 	ZiBool enable_debug_layers = ZI_TRUE;
 
 	if (volkInitialize() != VK_SUCCESS) {
@@ -676,6 +714,9 @@ static void zi_vulkan_init() {
 	vulkan_add_if_present(&extensions, VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME, 0);
 	vulkan_add_if_present(&extensions, VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME, 0);
 
+	// maps GPU timestamps onto zi_platform_get_ticks, timings are anchored at submit time without it
+	calibrated_timestamps = vulkan_add_if_present(&extensions, VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, 0);
+
 	if (features.bindless_texture_supported) {
 		vulkan_add_to_chain(&device_features, &indexing_features);
 	}
@@ -752,6 +793,8 @@ static void zi_vulkan_init() {
 	vkGetDeviceQueue(device, selected_adapter->graphics_family, 0, &graphics_queue);
 	vkGetDeviceQueue(device, selected_adapter->present_family, 0, &present_queue);
 
+	vulkan_init_timestamps();
+
 	VmaVulkanFunctions vma_vulkan_functions = {0};
 	vma_vulkan_functions.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
 	vma_vulkan_functions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
@@ -785,21 +828,13 @@ static void zi_vulkan_init() {
 	pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 	vkCreateDescriptorPool(device, &pool_info, ZI_NULL, &descriptor_pool);
 
-	VkFenceCreateInfo fenceInfo = {0};
-	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-	for (int i = 0; i < ZI_FRAMES_IN_FLIGHT; ++i) {
-		vkCreateFence(device, &fenceInfo, ZI_NULL, &in_flight_fences[i]);
-	}
-
 	VkCommandPoolCreateInfo command_pool_info = {0};
 	command_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	command_pool_info.queueFamilyIndex = selected_adapter->graphics_family;
 	command_pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 	vkCreateCommandPool(device, &command_pool_info, ZI_NULL, &command_pool);
 
-	for (int i = 0; i < ZI_FRAMES_IN_FLIGHT; ++i) {
+	for (int i = 0; i < ZI_MAX_FRAMES_IN_FLIGHT; ++i) {
 		VkCommandBufferAllocateInfo alloc_info = {};
 		alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -820,10 +855,6 @@ static void zi_vulkan_terminate() {
 
 	vkDestroyCommandPool(device, command_pool, ZI_NULL);
 
-	for (u32 i = 0; i < ZI_FRAMES_IN_FLIGHT; ++i) {
-		vkDestroyFence(device, in_flight_fences[i], ZI_NULL);
-	}
-
 	vkDestroyDescriptorPool(device, descriptor_pool, ZI_NULL);
 
 	vmaDestroyAllocator(vma_allocator);
@@ -864,6 +895,7 @@ static void zi_vulkan_get_device_limits(ZiDeviceLimits* limits) {
 
 // Buffer
 static ZiBufferHandle zi_vulkan_buffer_create(const ZiBufferDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanBuffer* vk_buffer = zi_mem_alloc(sizeof(ZiVulkanBuffer));
 	memset(vk_buffer, 0, sizeof(ZiVulkanBuffer));
 
@@ -937,6 +969,7 @@ static void zi_vulkan_buffer_unmap(ZiBufferHandle handle) {
 
 // Texture
 static ZiTextureHandle zi_vulkan_texture_create(const ZiTextureDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanTexture* vk_texture = zi_mem_alloc(sizeof(ZiVulkanTexture));
 	memset(vk_texture, 0, sizeof(ZiVulkanTexture));
 
@@ -993,6 +1026,7 @@ static void zi_vulkan_texture_destroy(ZiTextureHandle handle) {
 
 // Texture View
 static ZiTextureViewHandle zi_vulkan_texture_view_create(const ZiTextureViewDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	if (desc->texture.handler == ZI_NULL) return (ZiTextureViewHandle){0};
 
 	ZiVulkanTexture* vk_texture = (ZiVulkanTexture*)desc->texture.handler;
@@ -1036,6 +1070,7 @@ static void zi_vulkan_texture_view_destroy(ZiTextureViewHandle handle) {
 
 // Sampler
 static ZiSamplerHandle zi_vulkan_sampler_create(const ZiSamplerDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanSampler* vk_sampler = zi_mem_alloc(sizeof(ZiVulkanSampler));
 	memset(vk_sampler, 0, sizeof(ZiVulkanSampler));
 
@@ -1075,6 +1110,7 @@ static void zi_vulkan_sampler_destroy(ZiSamplerHandle handle) {
 
 // Shader
 static ZiShaderHandle zi_vulkan_shader_create(const ZiShaderDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanShader* vk_shader = zi_mem_alloc(sizeof(ZiVulkanShader));
 	memset(vk_shader, 0, sizeof(ZiVulkanShader));
 
@@ -1104,6 +1140,7 @@ static void zi_vulkan_shader_destroy(ZiShaderHandle handle) {
 
 // Pipeline Layout
 static ZiPipelineLayoutHandle zi_vulkan_pipeline_layout_create(const ZiPipelineLayoutDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanPipelineLayout* vk_layout = zi_mem_alloc(sizeof(ZiVulkanPipelineLayout));
 	memset(vk_layout, 0, sizeof(ZiVulkanPipelineLayout));
 
@@ -1150,6 +1187,7 @@ static void zi_vulkan_pipeline_layout_destroy(ZiPipelineLayoutHandle handle) {
 
 // Graphics Pipeline
 static ZiPipelineHandle zi_vulkan_graphics_pipeline_create(const ZiGraphicsPipelineDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanPipeline* vk_pipeline = zi_mem_alloc(sizeof(ZiVulkanPipeline));
 	memset(vk_pipeline, 0, sizeof(ZiVulkanPipeline));
 
@@ -1312,6 +1350,7 @@ static void zi_vulkan_graphics_pipeline_destroy(ZiPipelineHandle handle) {
 
 // Compute Pipeline
 static ZiPipelineHandle zi_vulkan_compute_pipeline_create(const ZiComputePipelineDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanPipeline* vk_pipeline = zi_mem_alloc(sizeof(ZiVulkanPipeline));
 	memset(vk_pipeline, 0, sizeof(ZiVulkanPipeline));
 
@@ -1349,6 +1388,7 @@ static void zi_vulkan_compute_pipeline_destroy(ZiPipelineHandle handle) {
 
 // Bind Group Layout
 static ZiBindGroupLayoutHandle zi_vulkan_bind_group_layout_create(const ZiBindGroupLayoutDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanBindGroupLayout* vk_layout = zi_mem_alloc(sizeof(ZiVulkanBindGroupLayout));
 	memset(vk_layout, 0, sizeof(ZiVulkanBindGroupLayout));
 
@@ -1391,6 +1431,7 @@ static void zi_vulkan_bind_group_layout_destroy(ZiBindGroupLayoutHandle handle)
 
 // Bind Group
 static ZiBindGroupHandle zi_vulkan_bind_group_create(const ZiBindGroupDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	if (desc->layout.handler == ZI_NULL) return (ZiBindGroupHandle){0};
 
 	ZiVulkanBindGroup* vk_bind_group = zi_mem_alloc(sizeof(ZiVulkanBindGroup));
@@ -1476,6 +1517,7 @@ static void zi_vulkan_bind_group_destroy(ZiBindGroupHandle handle) {
 
 // Render Pass
 static ZiRenderPassHandle zi_vulkan_render_pass_create(const ZiRenderPassDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanRenderPass* vk_rp = zi_mem_alloc(sizeof(ZiVulkanRenderPass));
 	memset(vk_rp, 0, sizeof(ZiVulkanRenderPass));
 
@@ -1567,6 +1609,7 @@ static void zi_vulkan_render_pass_destroy(ZiRenderPassHandle handle) {
 
 // Framebuffer
 static ZiFramebufferHandle zi_vulkan_framebuffer_create(const ZiFramebufferDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	if (desc->render_pass.handler == ZI_NULL) {
 		zi_log_error("Framebuffer requires a valid render pass");
 		return (ZiFramebufferHandle){0};
@@ -1624,6 +1667,7 @@ static void zi_vulkan_framebuffer_destroy(ZiFramebufferHandle handle) {
 
 // Command Buffer
 static ZiCommandBufferHandle zi_vulkan_command_buffer_create() {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanCommandBuffer* vk_cmd = zi_mem_alloc(sizeof(ZiVulkanCommandBuffer));
 	memset(vk_cmd, 0, sizeof(ZiVulkanCommandBuffer));
 
@@ -1661,6 +1705,21 @@ static ZiCommandBufferHandle zi_vulkan_command_buffer_create() {
 		return (ZiCommandBufferHandle){0};
 	}
 
+	if (timestamps_supported) {
+		VkQueryPoolCreateInfo query_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+		query_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		query_info.queryCount = ZI_GPU_TIMING_MAX_ZONES * 2;
+
+		res = vkCreateQueryPool(device, &query_info, ZI_NULL, &vk_cmd->query_pool);
+		if (res == VK_SUCCESS) {
+			vk_cmd->zones = zi_mem_alloc(sizeof(ZiVulkanTimingZone) * ZI_GPU_TIMING_MAX_ZONES);
+			vk_cmd->timings = zi_mem_alloc(sizeof(ZiGpuTimingZone) * ZI_GPU_TIMING_MAX_ZONES);
+		} else {
+			zi_log_warn("Failed to create timestamp query pool: %s", string_VkResult(res));
+			vk_cmd->query_pool = VK_NULL_HANDLE;
+		}
+	}
+
 	vk_cmd->is_recording = ZI_FALSE;
 
 	return (ZiCommandBufferHandle){.handler = vk_cmd};
@@ -1669,15 +1728,120 @@ static ZiCommandBufferHandle zi_vulkan_command_buffer_create() {
 static void zi_vulkan_command_buffer_destroy(ZiCommandBufferHandle handle) {
 	if (handle.handler == ZI_NULL) return;
 	ZiVulkanCommandBuffer* vk_cmd = (ZiVulkanCommandBuffer*)handle.handler;
+	vkWaitForFences(device, 1, &vk_cmd->fence, VK_TRUE, U64_MAX);
+	if (vk_cmd->query_pool) {
+		vkDestroyQueryPool(device, vk_cmd->query_pool, ZI_NULL);
+		zi_mem_free(vk_cmd->zones);
+		zi_mem_free(vk_cmd->timings);
+	}
 	vkDestroyFence(device, vk_cmd->fence, ZI_NULL);
 	vkDestroyCommandPool(device, vk_cmd->pool, ZI_NULL);
 	zi_mem_free(vk_cmd);
 }
 
+// Reads the timestamps of the last submission into a zone tree. Only called once its fence signaled,
+// so nothing waits, and forwards the zones to the profiler's GPU track.
+static void zi_vulkan_resolve_timings(ZiVulkanCommandBuffer* vk_cmd) {
+	vk_cmd->timings_pending = ZI_FALSE;
+	vk_cmd->timing_count = 0;
+
+	// value and availability per query
+	u64      results[ZI_GPU_TIMING_MAX_ZONES * 2 * 2];
+	u32      query_count = vk_cmd->zone_count * 2;
+	VkResult res = vkGetQueryPoolResults(device, vk_cmd->query_pool, 0, query_count, sizeof(u64) * 2 * query_count, results,
+	                                     sizeof(u64) * 2, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	if (res != VK_SUCCESS && res != VK_NOT_READY) return;
+
+	// output index of every zone, labels left open at submit have no end and are dropped with their children
+	u32 remap[ZI_GPU_TIMING_MAX_ZONES];
+	u64 origin = 0;
+
+	for (u32 i = 0; i < vk_cmd->zone_count; ++i) {
+		const ZiVulkanTimingZone* zone = &vk_cmd->zones[i];
+		const u64*                query = &results[i * 4];
+		remap[i] = U32_MAX;
+
+		if (!query[1] || !query[3]) continue;
+		if (zone->parent != U32_MAX && remap[zone->parent] == U32_MAX) continue;
+
+		u64 begin = query[0] & timestamp_mask;
+		u64 end = query[2] & timestamp_mask;
+		if (vk_cmd->timing_count == 0) origin = begin;
+
+		u64 begin_ns = (u64)((f64)((begin - origin) & timestamp_mask) * timestamp_period);
+		u64 end_ns = (u64)((f64)((end - origin) & timestamp_mask) * timestamp_period);
+
+		u32 parent = zone->parent != U32_MAX ? remap[zone->parent] : U32_MAX;
+		if (parent != U32_MAX) {
+			// top and bottom of pipe stamps can land slightly outside the enclosing pair
+			const ZiGpuTimingZone* outer = &vk_cmd->timings[parent];
+			u64 outer_end = outer->begin_ns + outer->duration_ns;
+			if (begin_ns < outer->begin_ns) begin_ns = outer->begin_ns;
+			if (end_ns > outer_end) end_ns = outer_end;
+		}
+		if (end_ns < begin_ns) end_ns = begin_ns;
+
+		remap[i] = vk_cmd->timing_count;
+		vk_cmd->timings[vk_cmd->timing_count++] = (ZiGpuTimingZone){
+			.label = zone->label,
+			.depth = zone->depth,
+			.parent = parent,
+			.begin_ns = begin_ns,
+			.duration_ns = end_ns - begin_ns,
+		};
+	}
+
+	if (vk_cmd->timing_count == 0 || !zi_profiler_is_recording()) return;
+
+	// where origin lands on the host clock
+	f64 ticks_per_ns = (f64)zi_platform_get_tick_frequency() / 1e9;
+	u64 origin_ticks = vk_cmd->submit_ticks;
+
+	if (calibrated_timestamps) {
+		VkCalibratedTimestampInfoEXT infos[2] = {
+			{VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, ZI_NULL, VK_TIME_DOMAIN_DEVICE_EXT},
+			{VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT, ZI_NULL, calibrated_host_domain},
+		};
+		uint64_t values[2];
+		uint64_t deviation;
+		if (vkGetCalibratedTimestampsEXT(device, 2, infos, values, &deviation) == VK_SUCCESS) {
+			u64 since_origin = ((values[0] & timestamp_mask) - origin) & timestamp_mask;
+			origin_ticks = values[1] - (u64)((f64)since_origin * timestamp_period * ticks_per_ns);
+		}
+	}
+
+	u32 stack[ZI_VULKAN_LABEL_STACK_DEPTH];
+	u32 depth = 0;
+
+	for (u32 i = 0; i <= vk_cmd->timing_count; ++i) {
+		u32 parent = i < vk_cmd->timing_count ? vk_cmd->timings[i].parent : U32_MAX;
+		while (depth > 0 && stack[depth - 1] != parent) {
+			const ZiGpuTimingZone* zone = &vk_cmd->timings[stack[--depth]];
+			u64 end_ticks = origin_ticks + (u64)((f64)(zone->begin_ns + zone->duration_ns) * ticks_per_ns);
+			zi_profiler_record_gpu(ZiProfileEventType_End, zone->label, end_ticks);
+		}
+		if (i == vk_cmd->timing_count) break;
+
+		const ZiGpuTimingZone* zone = &vk_cmd->timings[i];
+		zi_profiler_record_gpu(ZiProfileEventType_Begin, zone->label, origin_ticks + (u64)((f64)zone->begin_ns * ticks_per_ns));
+		stack[depth++] = i;
+	}
+}
+
 static void zi_vulkan_command_buffer_begin(ZiCommandBufferHandle handle) {
 	if (handle.handler == ZI_NULL) return;
 	ZiVulkanCommandBuffer* vk_cmd = (ZiVulkanCommandBuffer*)handle.handler;
 
+	// the previous submission may still be executing, resetting a pending buffer is invalid
+	vkWaitForFences(device, 1, &vk_cmd->fence, VK_TRUE, U64_MAX);
+	if (vk_cmd->timings_pending) {
+		zi_vulkan_resolve_timings(vk_cmd);
+	}
+	vk_cmd->timings_pending = ZI_FALSE;
+	vk_cmd->zone_count = 0;
+	vk_cmd->label_depth = 0;
+	vk_cmd->label_overflow = 0;
+
 	vkResetCommandBuffer(vk_cmd->cmd, 0);
 
 	VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
@@ -1685,6 +1849,10 @@ static void zi_vulkan_command_buffer_begin(ZiCommandBufferHandle handle) {
 
 	vkBeginCommandBuffer(vk_cmd->cmd, &begin_info);
 	vk_cmd->is_recording = ZI_TRUE;
+
+	if (vk_cmd->query_pool) {
+		vkCmdResetQueryPool(vk_cmd->cmd, vk_cmd->query_pool, 0, ZI_GPU_TIMING_MAX_ZONES * 2);
+	}
 }
 
 static void zi_vulkan_command_buffer_end(ZiCommandBufferHandle handle) {
@@ -1702,7 +1870,12 @@ static void zi_vulkan_command_buffer_submit(ZiCommandBufferHandle handle) {
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers = &vk_cmd->cmd;
 
+	// the fence tells when the timestamps of this submission can be read
+	vkResetFences(device, 1, &vk_cmd->fence);
 	vkQueueSubmit(graphics_queue, 1, &submit_info, vk_cmd->fence);
+
+	vk_cmd->timings_pending = vk_cmd->zone_count > 0;
+	vk_cmd->submit_ticks = zi_platform_get_ticks();
 }
 
 // Command Buffer - Render Pass
@@ -1941,6 +2114,7 @@ static void zi_vulkan_cmd_copy_texture_to_buffer(ZiCommandBufferHandle cmd, ZiTe
 
 // Swapchain helper: create swapchain internal resources
 static ZiBool zi_vulkan_swapchain_create_resources(ZiVulkanSwapchain* sc) {
+	ZI_PROFILE_FUNCTION();
 	// Query surface capabilities
 	VkSurfaceCapabilitiesKHR capabilities;
 	vkGetPhysicalDeviceSurfaceCapabilitiesKHR(selected_adapter->device, sc->surface, &capabilities);
@@ -2073,6 +2247,7 @@ static void zi_vulkan_swapchain_destroy_resources(ZiVulkanSwapchain* sc) {
 }
 
 static ZiSwapchainHandle zi_vulkan_swapchain_create(const ZiSwapchainDesc* desc) {
+	ZI_PROFILE_FUNCTION();
 	ZiVulkanSwapchain* sc = zi_mem_alloc(sizeof(ZiVulkanSwapchain));
 	memset(sc, 0, sizeof(ZiVulkanSwapchain));
 
@@ -2122,9 +2297,12 @@ static ZiSwapchainHandle zi_vulkan_swapchain_create(const ZiSwapchainDesc* desc)
 
 	// Create semaphores for synchronization
 	VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
-	for (u32 i = 0; i < ZI_FRAMES_IN_FLIGHT; i++) {
+	VkFenceCreateInfo     fence_info = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+	fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+	for (u32 i = 0; i < ZI_MAX_FRAMES_IN_FLIGHT; i++) {
 		vkCreateSemaphore(device, &semaphore_info, ZI_NULL, &sc->image_available_semaphores[i]);
 		vkCreateSemaphore(device, &semaphore_info, ZI_NULL, &sc->render_finished_semaphores[i]);
+		vkCreateFence(device, &fence_info, ZI_NULL, &sc->in_flight_fences[i]);
 	}
 
 	sc->current_frame = 0;
@@ -2132,9 +2310,10 @@ static ZiSwapchainHandle zi_vulkan_swapchain_create(const ZiSwapchainDesc* desc)
 	// Create swapchain resources
 	if (!zi_vulkan_swapchain_create_resources(sc)) {
 		// Cleanup on failure
-		for (u32 i = 0; i < ZI_FRAMES_IN_FLIGHT; i++) {
+		for (u32 i = 0; i < ZI_MAX_FRAMES_IN_FLIGHT; i++) {
 			if (sc->image_available_semaphores[i]) vkDestroySemaphore(device, sc->image_available_semaphores[i], ZI_NULL);
 			if (sc->render_finished_semaphores[i]) vkDestroySemaphore(device, sc->render_finished_semaphores[i], ZI_NULL);
+			if (sc->in_flight_fences[i]) vkDestroyFence(device, sc->in_flight_fences[i], ZI_NULL);
 		}
 		vkDestroySurfaceKHR(instance, sc->surface, ZI_NULL);
 		zi_mem_free(sc);
@@ -2150,9 +2329,10 @@ static void zi_vulkan_swapchain_destroy(ZiSwapchainHandle handle) {
 
 	zi_vulkan_swapchain_destroy_resources(sc);
 
-	for (u32 i = 0; i < ZI_FRAMES_IN_FLIGHT; i++) {
+	for (u32 i = 0; i < ZI_MAX_FRAMES_IN_FLIGHT; i++) {
 		if (sc->image_available_semaphores[i]) vkDestroySemaphore(device, sc->image_available_semaphores[i], ZI_NULL);
 		if (sc->render_finished_semaphores[i]) vkDestroySemaphore(device, sc->render_finished_semaphores[i], ZI_NULL);
+		if (sc->in_flight_fences[i]) vkDestroyFence(device, sc->in_flight_fences[i], ZI_NULL);
 	}
 
 	if (sc->surface) {
@@ -2190,6 +2370,11 @@ static void zi_vulkan_swapchain_present(ZiSwapchainHandle handle) {
 	if (!handle.handler) return;
 	ZiVulkanSwapchain* sc = (ZiVulkanSwapchain*)handle.handler;
 
+	// The slot was last used frames_in_flight presents ago, block until the GPU finished that frame.
+	// This is what keeps the CPU from running more than frames_in_flight frames ahead.
+	VkFence slot_fence = sc->in_flight_fences[sc->current_frame];
+	vkWaitForFences(device, 1, &slot_fence, VK_TRUE, U64_MAX);
+
 	// Acquire next image
 	u32 image_index;
 	VkResult result = vkAcquireNextImageKHR(device, sc->swapchain, U64_MAX,
@@ -2214,12 +2399,34 @@ static void zi_vulkan_swapchain_present(ZiSwapchainHandle handle) {
 
 	result = vkQueuePresentKHR(present_queue, &present_info);
 
+	// An empty batch, its fence signals once everything submitted before it completed, the frame's
+	// command buffers included.
+	vkResetFences(device, 1, &slot_fence);
+	vkQueueSubmit(graphics_queue, 0, ZI_NULL, slot_fence);
+
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
 		zi_vulkan_swapchain_destroy_resources(sc);
 		zi_vulkan_swapchain_create_resources(sc);
 	}
 
-	sc->current_frame = (sc->current_frame + 1) % ZI_FRAMES_IN_FLIGHT;
+	sc->current_frame = (sc->current_frame + 1) % frames_in_flight;
+}
+
+// Frame
+static void zi_vulkan_set_frames_in_flight(u32 count) {
+	if (count < 1) count = 1;
+	if (count > ZI_MAX_FRAMES_IN_FLIGHT) count = ZI_MAX_FRAMES_IN_FLIGHT;
+	if (count == frames_in_flight) return;
+
+	// no frame may still reference a slot that stops rotating
+	if (device) {
+		vkDeviceWaitIdle(device);
+	}
+	frames_in_flight = count;
+}
+
+static u32 zi_vulkan_get_frames_in_flight() {
+	return frames_in_flight;
 }
 
 // Debug
@@ -2236,10 +2443,48 @@ static void zi_vulkan_set_object_name(void* handle, const char* name) {
 	vkSetDebugUtilsObjectNameEXT(device, &name_info);
 }
 
+static void zi_vulkan_timing_begin(ZiVulkanCommandBuffer* vk_cmd, const char* label) {
+	if (!vk_cmd->query_pool) return;
+
+	if (vk_cmd->label_depth >= ZI_VULKAN_LABEL_STACK_DEPTH) {
+		vk_cmd->label_overflow++;
+		return;
+	}
+
+	u32 index = U32_MAX;
+	if (vk_cmd->zone_count < ZI_GPU_TIMING_MAX_ZONES) {
+		index = vk_cmd->zone_count++;
+		ZiVulkanTimingZone* zone = &vk_cmd->zones[index];
+		zone->label = zi_profiler_intern(label);
+		zone->depth = vk_cmd->label_depth;
+		zone->parent = vk_cmd->label_depth > 0 ? vk_cmd->label_stack[vk_cmd->label_depth - 1] : U32_MAX;
+		vkCmdWriteTimestamp(vk_cmd->cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, vk_cmd->query_pool, index * 2);
+	}
+	vk_cmd->label_stack[vk_cmd->label_depth++] = index;
+}
+
+static void zi_vulkan_timing_end(ZiVulkanCommandBuffer* vk_cmd) {
+	if (!vk_cmd->query_pool) return;
+
+	if (vk_cmd->label_overflow > 0) {
+		vk_cmd->label_overflow--;
+		return;
+	}
+	if (vk_cmd->label_depth == 0) return;
+
+	u32 index = vk_cmd->label_stack[--vk_cmd->label_depth];
+	if (index != U32_MAX) {
+		vkCmdWriteTimestamp(vk_cmd->cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, vk_cmd->query_pool, index * 2 + 1);
+	}
+}
+
 static void zi_vulkan_cmd_begin_debug_label(ZiCommandBufferHandle cmd, const char* label) {
-	if (!debug_utils_enabled || !cmd.handler || !label) return;
+	if (!cmd.handler || !label) return;
 
 	ZiVulkanCommandBuffer* vk_cmd = (ZiVulkanCommandBuffer*)cmd.handler;
+	zi_vulkan_timing_begin(vk_cmd, label);
+
+	if (!debug_utils_enabled) return;
 
 	VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT};
 	label_info.pLabelName = label;
@@ -2252,12 +2497,31 @@ static void zi_vulkan_cmd_begin_debug_label(ZiCommandBufferHandle cmd, const cha
 }
 
 static void zi_vulkan_cmd_end_debug_label(ZiCommandBufferHandle cmd) {
-	if (!debug_utils_enabled || !cmd.handler) return;
+	if (!cmd.handler) return;
 
 	ZiVulkanCommandBuffer* vk_cmd = (ZiVulkanCommandBuffer*)cmd.handler;
+	zi_vulkan_timing_end(vk_cmd);
+
+	if (!debug_utils_enabled) return;
 	vkCmdEndDebugUtilsLabelEXT(vk_cmd->cmd);
 }
 
+static u32 zi_vulkan_cmd_get_gpu_timings(ZiCommandBufferHandle cmd, ZiGpuTimingZone* zones, u32 max_zones) {
+	if (!cmd.handler) return 0;
+
+	ZiVulkanCommandBuffer* vk_cmd = (ZiVulkanCommandBuffer*)cmd.handler;
+	if (!vk_cmd->query_pool) return 0;
+
+	if (vk_cmd->timings_pending && vkGetFenceStatus(device, vk_cmd->fence) == VK_SUCCESS) {
+		zi_vulkan_resolve_timings(vk_cmd);
+	}
+
+	// parents come before their children, a cut keeps the tree intact
+	u32 count = vk_cmd->timing_count < max_zones ? vk_cmd->timing_count : max_zones;
+	memcpy(zones, vk_cmd->timings, sizeof(ZiGpuTimingZone) * count);
+	return count;
+}
+
 //helper impls
 static VkBool32 vulkan_debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT      messageSeverity,
                                       VkDebugUtilsMessageTypeFlagsEXT             messageType,
@@ -2265,16 +2529,16 @@ static VkBool32 vulkan_debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT
                                       void*                                       userData) {
 	switch (messageSeverity) {
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-			zi_log(ZiLogLevel_Trace, callbackDataExt->pMessage);
+			zi_log_trace("%s", callbackDataExt->pMessage);
 			break;
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-			zi_log(ZiLogLevel_Info, callbackDataExt->pMessage);
+			zi_log_info("%s", callbackDataExt->pMessage);
 			break;
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-			zi_log(ZiLogLevel_Warn, callbackDataExt->pMessage);
+			zi_log_warn("%s", callbackDataExt->pMessage);
 			break;
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-			zi_log(ZiLogLevel_Error, callbackDataExt->pMessage);
+			zi_log_error("%s", callbackDataExt->pMessage);
 			break;
 		case VK_DEBUG_UTILS_MESSAGE_SEVERITY_FLAG_BITS_MAX_ENUM_EXT:
 			break;
@@ -2398,6 +2662,7 @@ static void vulkan_check_physical_device(ZiVulkanAdapter* adapter) {
 
 		if (has_graphics_family && adapter->graphics_family == U32_MAX) {
 			adapter->graphics_family = i;
+			adapter->timestamp_valid_bits = queue_family_properties->timestampValidBits;
 		}
 
 		if (has_present_family && adapter->present_family == U32_MAX) {
@@ -2427,6 +2692,12 @@ static void vulkan_check_physical_device(ZiVulkanAdapter* adapter) {
 		adapter->score += 100;
 	}
 
+	// headless runs render offscreen, any graphics queue will do
+	if (!has_present_queue && zi_platform_is_headless()) {
+		adapter->present_family = adapter->graphics_family;
+		has_present_queue = ZI_TRUE;
+	}
+
 	if (!has_graphics_queue || !has_present_queue) {
 		adapter->score = 0;
 	}
@@ -2463,6 +2734,46 @@ static void vulkan_add_to_chain(VkPhysicalDeviceFeatures2* device_features, Void
 	}
 }
 
+static void vulkan_init_timestamps() {
+	u32 valid_bits = selected_adapter->timestamp_valid_bits;
+	timestamps_supported = valid_bits > 0;
+	if (!timestamps_supported) {
+		zi_log_debug("graphics queue has no timestamp support, GPU timings disabled");
+		calibrated_timestamps = ZI_FALSE;
+		return;
+	}
+
+	timestamp_period = (f64)selected_adapter->device_properties.properties.limits.timestampPeriod;
+	timestamp_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+	if (!calibrated_timestamps) return;
+
+	// the host domain has to be the clock zi_platform_get_ticks reads
+#if defined(ZI_WIN)
+	VkTimeDomainEXT host_domain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#elif defined(ZI_LINUX)
+	VkTimeDomainEXT host_domain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#else
+	VkTimeDomainEXT host_domain = VK_TIME_DOMAIN_MAX_ENUM_KHR;
+#endif
+
+	ZiBool has_device = ZI_FALSE;
+	ZiBool has_host = ZI_FALSE;
+	u32    domain_count = 0;
+	vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(selected_adapter->device, &domain_count, ZI_NULL);
+	VkTimeDomainEXT* domains = zi_mem_alloc(sizeof(VkTimeDomainEXT) * (domain_count > 0 ? domain_count : 1));
+	vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(selected_adapter->device, &domain_count, domains);
+
+	for (u32 i = 0; i < domain_count; ++i) {
+		if (domains[i] == VK_TIME_DOMAIN_DEVICE_EXT) has_device = ZI_TRUE;
+		if (domains[i] == host_domain) has_host = ZI_TRUE;
+	}
+	zi_mem_free(domains);
+
+	calibrated_timestamps = has_device && has_host;
+	calibrated_host_domain = host_domain;
+}
+
 void zi_graphics_init_vulkan(ZiRenderDevice* device) {
 	device->init = zi_vulkan_init;
 	device->terminate = zi_vulkan_terminate;
@@ -2565,10 +2876,15 @@ void zi_graphics_init_vulkan(ZiRenderDevice* device) {
 	device->swapchain_get_texture = zi_vulkan_swapchain_get_texture;
 	device->swapchain_present = zi_vulkan_swapchain_present;
 
+	// Frame
+	device->set_frames_in_flight = zi_vulkan_set_frames_in_flight;
+	device->get_frames_in_flight = zi_vulkan_get_frames_in_flight;
+
 	// Debug
 	device->set_object_name = zi_vulkan_set_object_name;
 	device->cmd_begin_debug_label = zi_vulkan_cmd_begin_debug_label;
 	device->cmd_end_debug_label = zi_vulkan_cmd_end_debug_label;
+	device->cmd_get_gpu_timings = zi_vulkan_cmd_get_gpu_timings;
 }
 #else
 void zi_graphics_init_vulkan(ZiRenderDevice* device) {
@@ -1,3 +1,5 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_WebGPU
+
 #include "zi_graphics.h"
 #include "zi_log.h"
 
@@ -6,6 +8,7 @@
 #include <webgpu/webgpu.h>
 
 static WGPUInstance instance = 0;
+static u32          frames_in_flight = ZI_FRAMES_IN_FLIGHT;
 
 void zi_webgpu_init() {
 	WGPUInstanceDescriptor desc = {};
@@ -22,9 +25,22 @@ void zi_webgpu_terminate() {
 	zi_log_debug("WebGPU terminated successfully");
 }
 
+// the browser owns presentation, the value is only kept for the app to query
+void zi_webgpu_set_frames_in_flight(u32 count) {
+	if (count < 1) count = 1;
+	if (count > ZI_MAX_FRAMES_IN_FLIGHT) count = ZI_MAX_FRAMES_IN_FLIGHT;
+	frames_in_flight = count;
+}
+
+u32 zi_webgpu_get_frames_in_flight() {
+	return frames_in_flight;
+}
+
 void zi_graphics_init_webgpu(ZiRenderDevice* device) {
 	device->init = zi_webgpu_init;
 	device->terminate = zi_webgpu_terminate;
+	device->set_frames_in_flight = zi_webgpu_set_frames_in_flight;
+	device->get_frames_in_flight = zi_webgpu_get_frames_in_flight;
 }
 #else
 void zi_graphics_init_webgpu(ZiRenderDevice* device) {
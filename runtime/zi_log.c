@@ -1,30 +1,808 @@
 #include "zi_log.h"
 
+#include "zi_atomic.h"
+#include "zi_core.h"
+#include "zi_log_binary.h"
 #include "zi_platform.h"
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+// no threads on the web, everything goes straight to the console there
+#if !defined(ZI_EMSCRIPTEN)
+#define ZI_LOG_ASYNC 1
+#endif
+
+#define ZI_LOG_MESSAGE_SIZE 1024
 
 static const char* level_desc[] = {"trace", "debug", "info", "warn", "error", "critical", "off"};
+static const char* category_desc[] = {"core", "platform", "graphics", "vulkan", "webgpu", "app"};
 
-void zi_log(ZiLogLevel level, const char* fmt, ...) {
+ZiLogLevel zi_log_category_levels[ZiLogCategory_Count] = {
+	ZiLogLevel_Debug,
+	ZiLogLevel_Debug,
+	ZiLogLevel_Debug,
+	ZiLogLevel_Debug,
+	ZiLogLevel_Debug,
+	ZiLogLevel_Debug,
+};
+
+void zi_log_set_level(ZiLogCategory category, ZiLogLevel level) {
+	if (category < ZiLogCategory_Count) {
+		zi_log_category_levels[category] = level;
+	}
+}
+
+void zi_log_set_all_levels(ZiLogLevel level) {
+	for (u32 i = 0; i < ZiLogCategory_Count; ++i) {
+		zi_log_category_levels[i] = level;
+	}
+}
+
+const char* zi_log_category_name(ZiLogCategory category) {
+	return category < ZiLogCategory_Count ? category_desc[category] : "unknown";
+}
+
+const char* zi_log_level_name(ZiLogLevel level) {
+	return level <= ZiLogLevel_Off ? level_desc[level] : "unknown";
+}
+
+typedef struct ZiLogTimestampCache {
+	u64  second;
+	char text[32];
+	i32  length;
+} ZiLogTimestampCache;
+
+static i32 zi_log_append_tag(char* buf, i32 len, const char* tag) {
+	size_t tag_len = strlen(tag);
+	buf[len++] = '[';
+	memcpy(buf + len, tag, tag_len);
+	len += (i32)tag_len;
+	buf[len++] = ']';
+	buf[len++] = ' ';
+	return len;
+}
+
+// "[timestamp] [level] [category] ", localtime is only resolved once per second, the milliseconds are patched in place
+static i32 zi_log_format_header(ZiLogTimestampCache* cache, char* buf, u64 wall_clock_us, ZiLogCategory category, ZiLogLevel level) {
+	u64 second = wall_clock_us / 1000000ull;
+	if (cache->length <= 0 || cache->second != second) {
+		cache->length = zi_platform_format_timestamp(wall_clock_us, cache->text, sizeof(cache->text));
+		cache->second = second;
+	}
+
+	i32 len = 0;
+	buf[len++] = '[';
+	memcpy(buf + len, cache->text, (size_t)cache->length);
+	len += cache->length;
+
+	u32 ms = (u32)((wall_clock_us / 1000ull) % 1000ull);
+	buf[len - 3] = (char)('0' + ms / 100);
+	buf[len - 2] = (char)('0' + ms / 10 % 10);
+	buf[len - 1] = (char)('0' + ms % 10);
+
+	buf[len++] = ']';
+	buf[len++] = ' ';
+	len = zi_log_append_tag(buf, len, zi_log_level_name(level));
+	len = zi_log_append_tag(buf, len, zi_log_category_name(category));
+	return len;
+}
 
-	if (level <= ZiLogLevel_Trace) {
+// ============================================================================
+// Sinks
+// ============================================================================
+
+#define ZI_LOG_MEMORY_SIZE (64 * 1024)
+#define ZI_LOG_PATH_SIZE   256
+
+typedef struct ZiLogFileSink {
+	ZiWritableMappedFile file;
+	u64                  offset;
+	u64                  max_size;
+	u32                  max_files;
+	char                 path[ZI_LOG_PATH_SIZE];
+} ZiLogFileSink;
+
+static volatile u32 log_sinks = ZiLogSink_Console;
+static ZiLogFileSink log_file;
+static char         log_memory[ZI_LOG_MEMORY_SIZE];
+static u64          log_memory_written;
+
+// Serializes everything that writes to the sinks. Recursive, so a sink that logs
+// (e.g. a failed rotation) from inside the lock writes straight through instead of deadlocking.
+static volatile u32        log_output_lock;
+static ZI_THREAD_LOCAL u32 log_output_depth;
+
+static void zi_log_lock_output(void) {
+	if (log_output_depth++ > 0) {
 		return;
 	}
+	u32 expected = 0;
+	while (!zi_atomic_cas_u32(&log_output_lock, &expected, 1)) {
+		expected = 0;
+		zi_platform_thread_yield();
+	}
+}
+
+static void zi_log_unlock_output(void) {
+	if (--log_output_depth == 0) {
+		zi_atomic_store_release_u32(&log_output_lock, 0);
+	}
+}
+
+static void zi_log_file_rotate(void) {
+	zi_platform_close_mapped_file(&log_file.file, log_file.offset);
+	log_file.offset = 0;
+
+	// path -> path.1 -> path.2 ... the oldest one gets overwritten
+	char from[ZI_LOG_PATH_SIZE + 16];
+	char to[ZI_LOG_PATH_SIZE + 16];
+	for (u32 i = log_file.max_files; i > 0; --i) {
+		if (i == 1) {
+			snprintf(from, sizeof(from), "%s", log_file.path);
+		} else {
+			snprintf(from, sizeof(from), "%s.%u", log_file.path, i - 1);
+		}
+		snprintf(to, sizeof(to), "%s.%u", log_file.path, i);
+		zi_platform_rename_file(from, to);
+	}
+
+	zi_platform_create_mapped_file(log_file.path, log_file.max_size, &log_file.file);
+}
+
+static void zi_log_file_write(const ZiConsoleChunk* chunks, u32 count) {
+	u32 begin = 0;
+	while (begin < count) {
+		// every message ends with the chunk holding its newline, rotate only between messages
+		u32 end = begin;
+		u64 size = 0;
+		while (end < count) {
+			size += chunks[end].size;
+			ZiBool last = chunks[end].size > 0 && chunks[end].data[chunks[end].size - 1] == '\n';
+			end++;
+			if (last) break;
+		}
+
+		if (log_file.offset + size > log_file.file.size && log_file.offset > 0) {
+			zi_log_file_rotate();
+		}
+
+		for (u32 i = begin; i < end && log_file.file.data; ++i) {
+			u64 chunk_size = chunks[i].size;
+			if (chunk_size > log_file.file.size - log_file.offset) {
+				chunk_size = log_file.file.size - log_file.offset;
+			}
+			memcpy(log_file.file.data + log_file.offset, chunks[i].data, (size_t)chunk_size);
+			log_file.offset += chunk_size;
+		}
+
+		begin = end;
+	}
+}
+
+static void zi_log_memory_write(const ZiConsoleChunk* chunks, u32 count) {
+	for (u32 i = 0; i < count; ++i) {
+		const char* data = chunks[i].data;
+		u32         size = chunks[i].size;
+		if (size > ZI_LOG_MEMORY_SIZE) {
+			data += size - ZI_LOG_MEMORY_SIZE;
+			size = ZI_LOG_MEMORY_SIZE;
+		}
+
+		u32 pos = (u32)(log_memory_written % ZI_LOG_MEMORY_SIZE);
+		u32 first = ZI_LOG_MEMORY_SIZE - pos < size ? ZI_LOG_MEMORY_SIZE - pos : size;
+		memcpy(log_memory + pos, data, first);
+		memcpy(log_memory, data + first, size - first);
+		log_memory_written += size;
+	}
+}
+
+// caller must hold the output lock
+static void zi_log_emit(const ZiConsoleChunk* chunks, u32 count, u8 error) {
+	u32 sinks = zi_atomic_load_relaxed_u32(&log_sinks);
+
+	if (sinks & ZiLogSink_Console) {
+		zi_platform_console_log_batch(chunks, count, error);
+	}
+	if ((sinks & ZiLogSink_File) && log_file.file.data) {
+		zi_log_file_write(chunks, count);
+	}
+	if (sinks & ZiLogSink_Memory) {
+		zi_log_memory_write(chunks, count);
+	}
+}
+
+static void zi_log_write_sync(ZiLogCategory category, ZiLogLevel level, u64 wall_clock_us, const char* text, i32 len) {
+	ZiLogTimestampCache cache = {0};
+	char                header[64];
+
+	ZiConsoleChunk chunks[2];
+	chunks[0].data = header;
+	chunks[0].size = (u32)zi_log_format_header(&cache, header, wall_clock_us, category, level);
+	chunks[1].data = text;
+	chunks[1].size = (u32)len;
+
+	zi_log_lock_output();
+	zi_log_emit(chunks, 2, level >= ZiLogLevel_Error);
+	zi_log_unlock_output();
+}
+
+#if ZI_LOG_ASYNC
+
+// Bounded lock-free MPSC ring (Vyukov style sequence numbers). Messages longer than one slot
+// take several consecutive slots, a producer reserves the whole span with a single CAS.
+// A background thread drains the ring and hands whole batches to the console with one gather write.
+
+#define ZI_LOG_SLOT_SIZE         128
+#define ZI_LOG_SLOT_TEXT         (ZI_LOG_SLOT_SIZE - 22)
+#define ZI_LOG_RING_CAPACITY     4096
+#define ZI_LOG_RING_MASK         (ZI_LOG_RING_CAPACITY - 1)
+#define ZI_LOG_BATCH_MESSAGES    128
+#define ZI_LOG_BATCH_CHUNKS      512
+#define ZI_LOG_BATCH_INTERVAL_MS 2
+#define ZI_LOG_IDLE_TIMEOUT_MS   50
+#define ZI_LOG_FULL_RETRIES      1024
+#define ZI_LOG_SCRATCH_SIZE      (32 * 1024)
+#define ZI_LOG_FILE_BUFFER_SIZE  (64 * 1024)
+
+// payload is a u64 format id (the format string pointer) followed by zi_log_binary_encode args
+#define ZI_LOG_SLOT_BINARY 0x01
+
+ZI_HASHMAP(ZiLogFormatSet, u64, u8)
+
+typedef struct ZiLogSlot {
+	volatile u64 sequence;
+	u64          wall_clock_us;
+	u16          length;
+	u8           level;
+	u8           span;
+	u8           flags;
+	u8           category;
+	char         text[ZI_LOG_SLOT_TEXT];
+} ZiLogSlot;
+
+typedef struct ZiLogRing {
+	volatile u64 enqueue_pos;
+	u8           pad0[56];
+
+	volatile u32 consumer_sleeping;
+	volatile u32 dropped;
+	volatile u32 running;
+	u8           pad1[52];
+
+	u64                 dequeue_pos;
+	ZiLogTimestampCache timestamp_cache;
+	ZiThreadHandle      thread;
+	ZiSemaphoreHandle   wake;
+
+	// deferred records go here instead of the console while open
+	FILE*          binary_file;
+	ZiLogFormatSet binary_formats;
+} ZiLogRing;
+
+static ZiLogSlot log_slots[ZI_LOG_RING_CAPACITY];
+static ZiLogRing log_ring;
+
+static void zi_log_wake_consumer(void) {
+	zi_platform_semaphore_post(log_ring.wake);
+}
+
+static ZiBool zi_log_enqueue(ZiLogCategory category, ZiLogLevel level, u8 flags, u64 wall_clock_us, const char* text, i32 len) {
+	u32 span = ((u32)len + ZI_LOG_SLOT_TEXT - 1) / ZI_LOG_SLOT_TEXT;
+	u32 retries = 0;
+
+	u64 pos = zi_atomic_load_relaxed_u64(&log_ring.enqueue_pos);
+	for (;;) {
+		// the consumer frees slots in order, so if the last slot of the span is free all of them are
+		u64        last_pos = pos + span - 1;
+		ZiLogSlot* last = &log_slots[last_pos & ZI_LOG_RING_MASK];
+		i64        diff = (i64)(zi_atomic_load_acquire_u64(&last->sequence) - last_pos);
+
+		if (diff == 0) {
+			if (zi_atomic_cas_u64(&log_ring.enqueue_pos, &pos, pos + span)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// full, drop anything below error, errors wait a little for the consumer to catch up
+			if (level < ZiLogLevel_Error || ++retries > ZI_LOG_FULL_RETRIES) {
+				zi_atomic_fetch_add_u32(&log_ring.dropped, 1);
+				return ZI_TRUE;
+			}
+			zi_log_wake_consumer();
+			zi_platform_thread_yield();
+			pos = zi_atomic_load_relaxed_u64(&log_ring.enqueue_pos);
+		} else {
+			pos = zi_atomic_load_relaxed_u64(&log_ring.enqueue_pos);
+		}
+	}
+
+	for (u32 i = 0; i < span; ++i) {
+		ZiLogSlot* slot = &log_slots[(pos + i) & ZI_LOG_RING_MASK];
+		u32        offset = i * ZI_LOG_SLOT_TEXT;
+		u32        size = (u32)len - offset < ZI_LOG_SLOT_TEXT ? (u32)len - offset : ZI_LOG_SLOT_TEXT;
+
+		memcpy(slot->text, text + offset, size);
+		slot->length = (u16)size;
+		slot->level = level;
+		slot->span = (u8)span;
+		slot->flags = flags;
+		slot->category = category;
+		slot->wall_clock_us = wall_clock_us;
+		zi_atomic_store_release_u64(&slot->sequence, pos + i + 1);
+	}
 
-	char buffer[1024];
+	if (level >= ZiLogLevel_Error) {
+		zi_log_wake_consumer();
+	} else if (zi_atomic_load_relaxed_u32(&log_ring.consumer_sleeping) &&
+	           zi_atomic_exchange_u32(&log_ring.consumer_sleeping, 0)) {
+		zi_log_wake_consumer();
+	}
+	return ZI_TRUE;
+}
+
+static void zi_log_release_slots(u64 begin, u64 end) {
+	for (u64 pos = begin; pos < end; ++pos) {
+		zi_atomic_store_release_u64(&log_slots[pos & ZI_LOG_RING_MASK].sequence, pos + ZI_LOG_RING_CAPACITY);
+	}
+}
+
+static ZiBool zi_log_message_ready(u64 pos) {
+	ZiLogSlot* first = &log_slots[pos & ZI_LOG_RING_MASK];
+	if (zi_atomic_load_acquire_u64(&first->sequence) != pos + 1) {
+		return ZI_FALSE;
+	}
+	for (u32 i = 1; i < first->span; ++i) {
+		if (zi_atomic_load_acquire_u64(&log_slots[(pos + i) & ZI_LOG_RING_MASK].sequence) != pos + i + 1) {
+			return ZI_FALSE;
+		}
+	}
+	return ZI_TRUE;
+}
+
+static void zi_log_write_binary_record(const ZiLogSlot* first, u64 format_id, const u8* args, u32 args_size) {
+	FILE* file = log_ring.binary_file;
+
+	if (!ZiLogFormatSet_has(&log_ring.binary_formats, format_id)) {
+		const char* fmt = (const char*)(uintptr_t)format_id;
+		u16         fmt_len = (u16)strlen(fmt);
+		u8          type = ZiLogRecordType_Format;
+
+		fwrite(&type, sizeof(type), 1, file);
+		fwrite(&format_id, sizeof(format_id), 1, file);
+		fwrite(&fmt_len, sizeof(fmt_len), 1, file);
+		fwrite(fmt, 1, fmt_len + 1u, file);
+		ZiLogFormatSet_set(&log_ring.binary_formats, format_id, 1);
+	}
+
+	u8  type = ZiLogRecordType_Message;
+	u8  level = first->level;
+	u8  category = first->category;
+	u64 wall_clock_us = first->wall_clock_us;
+	u16 size = (u16)args_size;
+
+	fwrite(&type, sizeof(type), 1, file);
+	fwrite(&level, sizeof(level), 1, file);
+	fwrite(&category, sizeof(category), 1, file);
+	fwrite(&wall_clock_us, sizeof(wall_clock_us), 1, file);
+	fwrite(&format_id, sizeof(format_id), 1, file);
+	fwrite(&size, sizeof(size), 1, file);
+	fwrite(args, 1, args_size, file);
+}
+
+// caller must hold the output lock
+static u32 zi_log_drain(void) {
+	static ZiConsoleChunk chunks[ZI_LOG_BATCH_CHUNKS];
+	static char           headers[ZI_LOG_BATCH_MESSAGES][64];
+	static char           scratch[ZI_LOG_SCRATCH_SIZE];
+
+	u32    chunk_count = 0;
+	u32    message_count = 0;
+	u32    scratch_used = 0;
+	u32    total = 0;
+	u8     batch_error = 0;
+	ZiBool wrote_file = ZI_FALSE;
+	u64    pos = log_ring.dequeue_pos;
+	u64    batch_start = pos;
+
+	while (zi_log_message_ready(pos)) {
+		ZiLogSlot* first = &log_slots[pos & ZI_LOG_RING_MASK];
+		u32        span = first->span;
+		u8         error = first->level >= ZiLogLevel_Error;
+		ZiBool     binary = (first->flags & ZI_LOG_SLOT_BINARY) != 0;
+
+		if (message_count > 0 && (error != batch_error || message_count == ZI_LOG_BATCH_MESSAGES ||
+		                          chunk_count + span + 1 > ZI_LOG_BATCH_CHUNKS ||
+		                          (binary && scratch_used + ZI_LOG_MESSAGE_SIZE > ZI_LOG_SCRATCH_SIZE))) {
+			zi_log_emit(chunks, chunk_count, batch_error);
+			zi_log_release_slots(batch_start, pos);
+			chunk_count = 0;
+			message_count = 0;
+			scratch_used = 0;
+			batch_start = pos;
+		}
+
+		if (binary) {
+			u8  record[ZI_LOG_MESSAGE_SIZE];
+			u32 record_size = 0;
+			for (u32 i = 0; i < span; ++i) {
+				ZiLogSlot* slot = &log_slots[(pos + i) & ZI_LOG_RING_MASK];
+				memcpy(record + record_size, slot->text, slot->length);
+				record_size += slot->length;
+			}
+
+			u64 format_id;
+			memcpy(&format_id, record, sizeof(format_id));
+
+			if (log_ring.binary_file) {
+				zi_log_write_binary_record(first, format_id, record + sizeof(format_id), record_size - (u32)sizeof(format_id));
+				wrote_file = ZI_TRUE;
+				pos += span;
+				total++;
+				continue;
+			}
+
+			// no file open, format here instead of on the caller
+			char* text = scratch + scratch_used;
+			i32   len = zi_log_binary_format((const char*)(uintptr_t)format_id, record + sizeof(format_id),
+			                                 record_size - (u32)sizeof(format_id), text, ZI_LOG_MESSAGE_SIZE - 1);
+			text[len++] = '\n';
+			scratch_used += (u32)len;
+
+			batch_error = error;
+			char* header = headers[message_count++];
+			chunks[chunk_count].data = header;
+			chunks[chunk_count].size = (u32)zi_log_format_header(&log_ring.timestamp_cache, header, first->wall_clock_us, first->category, first->level);
+			chunk_count++;
+			chunks[chunk_count].data = text;
+			chunks[chunk_count].size = (u32)len;
+			chunk_count++;
+
+			pos += span;
+			total++;
+			continue;
+		}
+
+		batch_error = error;
+
+		char* header = headers[message_count++];
+		chunks[chunk_count].data = header;
+		chunks[chunk_count].size = (u32)zi_log_format_header(&log_ring.timestamp_cache, header, first->wall_clock_us, first->category, first->level);
+		chunk_count++;
+
+		for (u32 i = 0; i < span; ++i) {
+			ZiLogSlot* slot = &log_slots[(pos + i) & ZI_LOG_RING_MASK];
+			chunks[chunk_count].data = slot->text;
+			chunks[chunk_count].size = slot->length;
+			chunk_count++;
+		}
+
+		pos += span;
+		total++;
+	}
+
+	if (message_count > 0) {
+		zi_log_emit(chunks, chunk_count, batch_error);
+	}
+	zi_log_release_slots(batch_start, pos);
+	log_ring.dequeue_pos = pos;
+
+	if (wrote_file) {
+		fflush(log_ring.binary_file);
+	}
+
+	u32 dropped = zi_atomic_exchange_u32(&log_ring.dropped, 0);
+	if (dropped > 0) {
+		char message[64];
+		i32  len = snprintf(message, sizeof(message), "log ring full, %u messages dropped\n", dropped);
+		zi_log_write_sync(ZiLogCategory_Core, ZiLogLevel_Warn, zi_platform_get_wall_clock_us(), message, len);
+	}
+
+	return total;
+}
+
+static u32 zi_log_drain_locked(void) {
+	zi_log_lock_output();
+	u32 drained = zi_log_drain();
+	zi_log_unlock_output();
+	return drained;
+}
+
+static void zi_log_thread_main(VoidPtr user_data) {
+	while (zi_atomic_load_acquire_u32(&log_ring.running)) {
+		if (zi_log_drain_locked() > 0) {
+			// let producers fill up a bigger batch before the next write
+			zi_platform_semaphore_wait(log_ring.wake, ZI_LOG_BATCH_INTERVAL_MS);
+			continue;
+		}
+
+		zi_atomic_exchange_u32(&log_ring.consumer_sleeping, 1);
+		if (zi_log_message_ready(log_ring.dequeue_pos)) {
+			zi_atomic_store_relaxed_u32(&log_ring.consumer_sleeping, 0);
+			continue;
+		}
+		zi_platform_semaphore_wait(log_ring.wake, ZI_LOG_IDLE_TIMEOUT_MS);
+		zi_atomic_store_relaxed_u32(&log_ring.consumer_sleeping, 0);
+	}
+}
+
+static void zi_log_crash_flush(void) {
+	// the crashing thread may be the consumer itself, so never wait forever on the lock
+	u32 expected = 0;
+	for (u32 i = 0; i < 100000 && !zi_atomic_cas_u32(&log_output_lock, &expected, 1); ++i) {
+		expected = 0;
+		zi_atomic_pause();
+	}
+	log_output_depth = 1;
+	zi_log_drain();
+	if (log_ring.binary_file) {
+		fflush(log_ring.binary_file);
+	}
+}
+
+#endif
+
+void zi_log_init(void) {
+#if ZI_LOG_ASYNC
+	if (zi_atomic_load_acquire_u32(&log_ring.running)) {
+		return;
+	}
+
+	for (u64 i = 0; i < ZI_LOG_RING_CAPACITY; ++i) {
+		log_slots[i].sequence = i;
+	}
+	log_ring.enqueue_pos = 0;
+	log_ring.dequeue_pos = 0;
+	log_ring.wake = zi_platform_semaphore_create(0);
+
+	zi_atomic_store_release_u32(&log_ring.running, 1);
+	log_ring.thread = zi_platform_thread_create(zi_log_thread_main, ZI_NULL, "zi-log");
+	if (!log_ring.thread.handler) {
+		zi_atomic_store_release_u32(&log_ring.running, 0);
+		zi_platform_semaphore_destroy(log_ring.wake);
+		return;
+	}
+
+	zi_platform_set_crash_handler(zi_log_crash_flush);
+
+	static ZiBool exit_handler_registered = ZI_FALSE;
+	if (!exit_handler_registered) {
+		atexit(zi_log_shutdown);
+		exit_handler_registered = ZI_TRUE;
+	}
+#endif
+}
+
+void zi_log_shutdown(void) {
+#if ZI_LOG_ASYNC
+	if (!zi_atomic_exchange_u32(&log_ring.running, 0)) {
+		return;
+	}
+
+	zi_log_wake_consumer();
+	zi_platform_thread_join(log_ring.thread);
+	log_ring.thread = (ZiThreadHandle){0};
+
+	zi_log_drain_locked();
+	zi_log_close_binary_file();
+	zi_log_close_file();
+
+	zi_platform_set_crash_handler(ZI_NULL);
+	zi_platform_semaphore_destroy(log_ring.wake);
+	log_ring.wake = (ZiSemaphoreHandle){0};
+#endif
+}
+
+void zi_log_flush(void) {
+#if ZI_LOG_ASYNC
+	zi_log_drain_locked();
+#endif
+}
+
+void zi_log_set_sinks(ZiLogSinks sinks) {
+	zi_atomic_store_relaxed_u32(&log_sinks, sinks);
+}
+
+ZiLogSinks zi_log_get_sinks(void) {
+	return zi_atomic_load_relaxed_u32(&log_sinks);
+}
+
+ZiBool zi_log_open_file(const char* path, u64 max_size, u32 max_files) {
+	if (strlen(path) >= ZI_LOG_PATH_SIZE) {
+		zi_log_error("log file path too long: %s", path);
+		return ZI_FALSE;
+	}
+
+	zi_log_close_file();
+
+	zi_log_lock_output();
+	snprintf(log_file.path, sizeof(log_file.path), "%s", path);
+	log_file.max_size = max_size;
+	log_file.max_files = max_files;
+	log_file.offset = 0;
+	ZiBool ok = zi_platform_create_mapped_file(path, max_size, &log_file.file);
+	zi_log_unlock_output();
+
+	if (ok) {
+		zi_log_set_sinks(zi_log_get_sinks() | ZiLogSink_File);
+	}
+	return ok;
+}
+
+void zi_log_close_file(void) {
+	zi_log_lock_output();
+#if ZI_LOG_ASYNC
+	// queued messages still belong in this file
+	zi_log_drain();
+#endif
+	zi_log_set_sinks(zi_log_get_sinks() & ~(ZiLogSinks)ZiLogSink_File);
+	zi_platform_close_mapped_file(&log_file.file, log_file.offset);
+	log_file.offset = 0;
+	zi_log_unlock_output();
+}
+
+u32 zi_log_copy_recent(char* out, u32 capacity) {
+	if (capacity == 0) {
+		return 0;
+	}
+
+	zi_log_lock_output();
+
+	u64 available = log_memory_written < ZI_LOG_MEMORY_SIZE ? log_memory_written : ZI_LOG_MEMORY_SIZE;
+	u32 len = available < capacity - 1 ? (u32)available : capacity - 1;
+	u64 start = log_memory_written - len;
+
+	for (u32 i = 0; i < len; ++i) {
+		out[i] = log_memory[(start + i) % ZI_LOG_MEMORY_SIZE];
+	}
+
+	// the copy starts mid line unless the byte before it ended one
+	ZiBool partial = start > 0 && (len == ZI_LOG_MEMORY_SIZE || log_memory[(start - 1) % ZI_LOG_MEMORY_SIZE] != '\n');
+
+	zi_log_unlock_output();
+
+	u32 skip = 0;
+	if (partial) {
+		while (skip < len && out[skip] != '\n') skip++;
+		if (skip < len) skip++;
+	}
+	memmove(out, out + skip, len - skip);
+	len -= skip;
+	out[len] = 0;
+	return len;
+}
+
+ZiBool zi_log_open_binary_file(const char* path) {
+#if ZI_LOG_ASYNC
+	FILE* file = fopen(path, "wb");
+	if (!file) {
+		zi_log_error("failed to open binary log file %s", path);
+		return ZI_FALSE;
+	}
+	setvbuf(file, ZI_NULL, _IOFBF, ZI_LOG_FILE_BUFFER_SIZE);
+
+	u32 version = ZI_LOG_BINARY_VERSION;
+	fwrite(ZI_LOG_BINARY_MAGIC, 1, ZI_LOG_BINARY_MAGIC_SIZE, file);
+	fwrite(&version, sizeof(version), 1, file);
+
+	zi_log_lock_output();
+	// whatever is queued so far still belongs to the previous destination
+	zi_log_drain();
+	if (log_ring.binary_file) {
+		fclose(log_ring.binary_file);
+		ZiLogFormatSet_free(&log_ring.binary_formats);
+	}
+	ZiLogFormatSet_init(&log_ring.binary_formats, ZI_NULL);
+	log_ring.binary_file = file;
+	zi_log_unlock_output();
+	return ZI_TRUE;
+#else
+	zi_log_error("binary logging requires the async logger, can't open %s", path);
+	return ZI_FALSE;
+#endif
+}
+
+void zi_log_close_binary_file(void) {
+#if ZI_LOG_ASYNC
+	zi_log_lock_output();
+	zi_log_drain();
+	if (log_ring.binary_file) {
+		fclose(log_ring.binary_file);
+		log_ring.binary_file = ZI_NULL;
+		ZiLogFormatSet_free(&log_ring.binary_formats);
+	}
+	zi_log_unlock_output();
+#endif
+}
+
+static void zi_log_deferred_v(ZiLogCategory category, ZiLogLevel level, const char* fmt, va_list args) {
+	u64 now = zi_platform_get_wall_clock_us();
+
+#if ZI_LOG_ASYNC
+	if (zi_atomic_load_acquire_u32(&log_ring.running)) {
+		u8  record[ZI_LOG_MESSAGE_SIZE];
+		u64 format_id = (u64)(uintptr_t)fmt;
+		memcpy(record, &format_id, sizeof(format_id));
+		u32 size = (u32)sizeof(format_id) + zi_log_binary_encode(fmt, args, record + sizeof(format_id), sizeof(record) - sizeof(format_id));
+
+		zi_log_enqueue(category, level, ZI_LOG_SLOT_BINARY, now, (const char*)record, (i32)size);
+
+		// raced with shutdown, nobody else is going to pick this message up
+		if (!zi_atomic_load_acquire_u32(&log_ring.running)) {
+			zi_log_flush();
+		}
+		return;
+	}
+#endif
+
+	char buffer[ZI_LOG_MESSAGE_SIZE];
+	i32  len = vsnprintf(buffer, sizeof(buffer) - 1, fmt, args);
+
+	if (len < 0) len = 0;
+	if (len > (i32)sizeof(buffer) - 2) len = (i32)sizeof(buffer) - 2;
+	buffer[len++] = '\n';
+
+	zi_log_write_sync(category, level, now, buffer, len);
+}
+
+static void zi_log_write_v(ZiLogCategory category, ZiLogLevel level, const char* fmt, va_list args) {
+	char buffer[ZI_LOG_MESSAGE_SIZE];
+	i32  len = vsnprintf(buffer, sizeof(buffer) - 1, fmt, args);
+
+	if (len < 0) len = 0;
+	if (len > (i32)sizeof(buffer) - 2) len = (i32)sizeof(buffer) - 2;
+	buffer[len++] = '\n';
+
+	u64 now = zi_platform_get_wall_clock_us();
+
+#if ZI_LOG_ASYNC
+	if (zi_atomic_load_acquire_u32(&log_ring.running)) {
+		zi_log_enqueue(category, level, 0, now, buffer, len);
+
+		if (!zi_atomic_load_acquire_u32(&log_ring.running)) {
+			zi_log_flush();
+		}
+		return;
+	}
+#endif
+
+	zi_log_write_sync(category, level, now, buffer, len);
+}
+
+void zi_log_deferred(ZiLogLevel level, const char* fmt, ...) {
+	if (!zi_log_enabled(ZiLogCategory_Core, level)) {
+		return;
+	}
 
 	va_list args;
 	va_start(args, fmt);
-	vsnprintf(buffer, sizeof(buffer), fmt, args);
+	zi_log_deferred_v(ZiLogCategory_Core, level, fmt, args);
 	va_end(args);
+}
 
-	char time_str[32];
-	zi_platform_get_timestamp(time_str, sizeof(time_str));
+void zi_log_deferred_write(ZiLogCategory category, ZiLogLevel level, const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	zi_log_deferred_v(category, level, fmt, args);
+	va_end(args);
+}
 
-	char buffer2[1024];
-	i32  size = snprintf(buffer2, sizeof(buffer2), "[%s] [%s] %s\n", time_str, level_desc[level], buffer);
-	zi_platform_console_log(buffer2, size, level >= ZiLogLevel_Error);
+void zi_log(ZiLogLevel level, const char* fmt, ...) {
+	if (!zi_log_enabled(ZiLogCategory_Core, level)) {
+		return;
+	}
+
+	va_list args;
+	va_start(args, fmt);
+	zi_log_write_v(ZiLogCategory_Core, level, fmt, args);
+	va_end(args);
+}
+
+void zi_log_write(ZiLogCategory category, ZiLogLevel level, const char* fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	zi_log_write_v(category, level, fmt, args);
+	va_end(args);
 }
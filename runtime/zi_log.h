@@ -14,8 +14,161 @@ enum ZiLogLevel_ {
 
 typedef u8 ZiLogLevel;
 
+enum ZiLogCategory_ {
+	ZiLogCategory_Core     = 0,
+	ZiLogCategory_Platform = 1,
+	ZiLogCategory_Graphics = 2,
+	ZiLogCategory_Vulkan   = 3,
+	ZiLogCategory_WebGPU   = 4,
+	ZiLogCategory_App      = 5,
+	ZiLogCategory_Count    = 6
+};
+
+typedef u8 ZiLogCategory;
+
+enum ZiLogSink_ {
+	ZiLogSink_Console = 1 << 0,
+	ZiLogSink_File    = 1 << 1, // memory mapped, see zi_log_open_file
+	ZiLogSink_Memory  = 1 << 2  // in-memory ring of recent output, e.g. for a debug overlay
+};
+
+typedef u32 ZiLogSinks;
+
+// ============================================================================
+// Filtering
+// ============================================================================
+
+// numeric copies of ZiLogLevel, usable in #if
+#define ZI_LOG_LEVEL_TRACE    0
+#define ZI_LOG_LEVEL_DEBUG    1
+#define ZI_LOG_LEVEL_INFO     2
+#define ZI_LOG_LEVEL_WARN     3
+#define ZI_LOG_LEVEL_ERROR    4
+#define ZI_LOG_LEVEL_CRITICAL 5
+#define ZI_LOG_LEVEL_OFF      6
+
+// log sites below this level compile to nothing, arguments included
+#ifndef ZI_LOG_MIN_LEVEL
+#define ZI_LOG_MIN_LEVEL ZI_LOG_LEVEL_DEBUG
+#endif
+
+// category used by the zi_log_* macros, define it before the first include to change it for a file
+#ifndef ZI_LOG_CATEGORY
+#define ZI_LOG_CATEGORY ZiLogCategory_Core
+#endif
+
+// runtime minimum level per category, read inline by every log site
+extern ZiLogLevel zi_log_category_levels[ZiLogCategory_Count];
+
+static inline ZiBool zi_log_enabled(ZiLogCategory category, ZiLogLevel level) {
+	return level >= zi_log_category_levels[category];
+}
+
+void        zi_log_set_level(ZiLogCategory category, ZiLogLevel level);
+void        zi_log_set_all_levels(ZiLogLevel level);
+const char* zi_log_category_name(ZiLogCategory category);
+const char* zi_log_level_name(ZiLogLevel level);
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+// Starts the background writer, until then (and after shutdown) messages are written synchronously.
+void zi_log_init(void);
+void zi_log_shutdown(void);
+// Writes out everything queued so far on the calling thread
+void zi_log_flush(void);
+
+void       zi_log_set_sinks(ZiLogSinks sinks);
+ZiLogSinks zi_log_get_sinks(void);
+
+// Preallocates max_size bytes at path and writes into a shared mapping, no syscall per message.
+// When full the file rotates to path.1 .. path.max_files. Enables the file sink.
+ZiBool zi_log_open_file(const char* path, u64 max_size, u32 max_files);
+void   zi_log_close_file(void);
+
+// Copies the most recent whole lines of the memory sink into out, zero terminated, returns the length
+u32 zi_log_copy_recent(char* out, u32 capacity);
+
+// While open, deferred messages are written to path in binary form instead of the console
+ZiBool zi_log_open_binary_file(const char* path);
+void   zi_log_close_binary_file(void);
+
+// ============================================================================
+// Writing
+// ============================================================================
+
+// core category, checks the runtime level itself
 void zi_log(ZiLogLevel level, const char* fmt, ...);
 
-#define zi_log_debug(...) zi_log(ZiLogLevel_Debug, __VA_ARGS__)
-#define zi_log_info(...) zi_log(ZiLogLevel_Info, __VA_ARGS__)
-#define zi_log_error(...) zi_log(ZiLogLevel_Error, __VA_ARGS__)
+// no level check, the macros below do it before the call
+void zi_log_write(ZiLogCategory category, ZiLogLevel level, const char* fmt, ...);
+
+// Captures the format pointer and raw arguments only, formatting happens on the log thread or
+// offline with zi-log-decoder when a binary file is open. fmt must be a string literal.
+void zi_log_deferred(ZiLogLevel level, const char* fmt, ...);
+void zi_log_deferred_write(ZiLogCategory category, ZiLogLevel level, const char* fmt, ...);
+
+#define zi_log_at(category, level, ...)                                                                \
+	do {                                                                                               \
+		if ((level) >= ZI_LOG_MIN_LEVEL && zi_log_enabled(category, level)) {                          \
+			zi_log_write(category, level, __VA_ARGS__);                                                \
+		}                                                                                              \
+	} while (0)
+
+#define zi_log_deferred_at(category, level, ...)                                                       \
+	do {                                                                                               \
+		if ((level) >= ZI_LOG_MIN_LEVEL && zi_log_enabled(category, level)) {                          \
+			zi_log_deferred_write(category, level, __VA_ARGS__);                                       \
+		}                                                                                              \
+	} while (0)
+
+#define ZI_LOG_DISABLED(...) ((void)0)
+
+#if ZI_LOG_MIN_LEVEL <= ZI_LOG_LEVEL_TRACE
+#define zi_log_trace(...) zi_log_at(ZI_LOG_CATEGORY, ZiLogLevel_Trace, __VA_ARGS__)
+#define zi_log_deferred_trace(...) zi_log_deferred_at(ZI_LOG_CATEGORY, ZiLogLevel_Trace, __VA_ARGS__)
+#else
+#define zi_log_trace(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#define zi_log_deferred_trace(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if ZI_LOG_MIN_LEVEL <= ZI_LOG_LEVEL_DEBUG
+#define zi_log_debug(...) zi_log_at(ZI_LOG_CATEGORY, ZiLogLevel_Debug, __VA_ARGS__)
+#define zi_log_deferred_debug(...) zi_log_deferred_at(ZI_LOG_CATEGORY, ZiLogLevel_Debug, __VA_ARGS__)
+#else
+#define zi_log_debug(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#define zi_log_deferred_debug(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if ZI_LOG_MIN_LEVEL <= ZI_LOG_LEVEL_INFO
+#define zi_log_info(...) zi_log_at(ZI_LOG_CATEGORY, ZiLogLevel_Info, __VA_ARGS__)
+#define zi_log_deferred_info(...) zi_log_deferred_at(ZI_LOG_CATEGORY, ZiLogLevel_Info, __VA_ARGS__)
+#else
+#define zi_log_info(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#define zi_log_deferred_info(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if ZI_LOG_MIN_LEVEL <= ZI_LOG_LEVEL_WARN
+#define zi_log_warn(...) zi_log_at(ZI_LOG_CATEGORY, ZiLogLevel_Warn, __VA_ARGS__)
+#define zi_log_deferred_warn(...) zi_log_deferred_at(ZI_LOG_CATEGORY, ZiLogLevel_Warn, __VA_ARGS__)
+#else
+#define zi_log_warn(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#define zi_log_deferred_warn(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if ZI_LOG_MIN_LEVEL <= ZI_LOG_LEVEL_ERROR
+#define zi_log_error(...) zi_log_at(ZI_LOG_CATEGORY, ZiLogLevel_Error, __VA_ARGS__)
+#define zi_log_deferred_error(...) zi_log_deferred_at(ZI_LOG_CATEGORY, ZiLogLevel_Error, __VA_ARGS__)
+#else
+#define zi_log_error(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#define zi_log_deferred_error(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if ZI_LOG_MIN_LEVEL <= ZI_LOG_LEVEL_CRITICAL
+#define zi_log_critical(...) zi_log_at(ZI_LOG_CATEGORY, ZiLogLevel_Critical, __VA_ARGS__)
+#define zi_log_deferred_critical(...) zi_log_deferred_at(ZI_LOG_CATEGORY, ZiLogLevel_Critical, __VA_ARGS__)
+#else
+#define zi_log_critical(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#define zi_log_deferred_critical(...) ZI_LOG_DISABLED(__VA_ARGS__)
+#endif
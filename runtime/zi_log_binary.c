@@ -0,0 +1,494 @@
+#include "zi_log_binary.h"
+
+#include "zi_core.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+enum ZiLogLength_ {
+	ZiLogLength_None       = 0,
+	ZiLogLength_Char       = 1,
+	ZiLogLength_Short      = 2,
+	ZiLogLength_Long       = 3,
+	ZiLogLength_LongLong   = 4,
+	ZiLogLength_IntMax     = 5,
+	ZiLogLength_Size       = 6,
+	ZiLogLength_PtrDiff    = 7,
+	ZiLogLength_LongDouble = 8
+};
+
+typedef u8 ZiLogLength;
+
+typedef struct ZiLogSpec {
+	const char* flags;
+	u32         flags_len;
+	const char* width;
+	u32         width_len;
+	const char* precision;
+	u32         precision_len;
+	ZiBool      has_precision;
+	ZiLogLength length;
+	char        conversion;
+} ZiLogSpec;
+
+// p points right after the '%', returns a pointer to the conversion character
+static const char* zi_log_parse_spec(const char* p, ZiLogSpec* spec) {
+	memset(spec, 0, sizeof(*spec));
+
+	spec->flags = p;
+	while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') p++;
+	spec->flags_len = (u32)(p - spec->flags);
+
+	spec->width = p;
+	if (*p == '*') {
+		p++;
+	} else {
+		while (*p >= '0' && *p <= '9') p++;
+	}
+	spec->width_len = (u32)(p - spec->width);
+
+	if (*p == '.') {
+		p++;
+		spec->has_precision = ZI_TRUE;
+		spec->precision = p;
+		if (*p == '*') {
+			p++;
+		} else {
+			while (*p >= '0' && *p <= '9') p++;
+		}
+		spec->precision_len = (u32)(p - spec->precision);
+	}
+
+	switch (*p) {
+		case 'h':
+			p++;
+			spec->length = ZiLogLength_Short;
+			if (*p == 'h') {
+				p++;
+				spec->length = ZiLogLength_Char;
+			}
+			break;
+		case 'l':
+			p++;
+			spec->length = ZiLogLength_Long;
+			if (*p == 'l') {
+				p++;
+				spec->length = ZiLogLength_LongLong;
+			}
+			break;
+		case 'q': p++; spec->length = ZiLogLength_LongLong; break;
+		case 'j': p++; spec->length = ZiLogLength_IntMax; break;
+		case 'z': p++; spec->length = ZiLogLength_Size; break;
+		case 't': p++; spec->length = ZiLogLength_PtrDiff; break;
+		case 'L': p++; spec->length = ZiLogLength_LongDouble; break;
+		default: break;
+	}
+
+	spec->conversion = *p;
+	return p;
+}
+
+static i64 zi_log_read_signed(va_list* args, ZiLogLength length) {
+	switch (length) {
+		case ZiLogLength_Char: return (signed char)va_arg(*args, int);
+		case ZiLogLength_Short: return (short)va_arg(*args, int);
+		case ZiLogLength_Long: return va_arg(*args, long);
+		case ZiLogLength_LongLong: return va_arg(*args, long long);
+		case ZiLogLength_IntMax: return (i64)va_arg(*args, intmax_t);
+		case ZiLogLength_Size: return (i64)va_arg(*args, size_t);
+		case ZiLogLength_PtrDiff: return (i64)va_arg(*args, ptrdiff_t);
+		default: return va_arg(*args, int);
+	}
+}
+
+static u64 zi_log_read_unsigned(va_list* args, ZiLogLength length) {
+	switch (length) {
+		case ZiLogLength_Char: return (unsigned char)va_arg(*args, unsigned int);
+		case ZiLogLength_Short: return (unsigned short)va_arg(*args, unsigned int);
+		case ZiLogLength_Long: return va_arg(*args, unsigned long);
+		case ZiLogLength_LongLong: return va_arg(*args, unsigned long long);
+		case ZiLogLength_IntMax: return (u64)va_arg(*args, uintmax_t);
+		case ZiLogLength_Size: return (u64)va_arg(*args, size_t);
+		case ZiLogLength_PtrDiff: return (u64)va_arg(*args, ptrdiff_t);
+		default: return va_arg(*args, unsigned int);
+	}
+}
+
+static ZiBool zi_log_put(u8* out, u32 capacity, u32* size, const void* value, u32 value_size) {
+	if (*size + value_size > capacity) {
+		return ZI_FALSE;
+	}
+	memcpy(out + *size, value, value_size);
+	*size += value_size;
+	return ZI_TRUE;
+}
+
+u32 zi_log_binary_encode(const char* fmt, va_list args, u8* out, u32 capacity) {
+	va_list ap;
+	va_copy(ap, args);
+
+	u32 size = 0;
+	for (const char* p = fmt; *p; ++p) {
+		if (*p != '%') {
+			continue;
+		}
+
+		ZiLogSpec spec;
+		p = zi_log_parse_spec(p + 1, &spec);
+
+		if (spec.conversion == '%') {
+			continue;
+		}
+		if (spec.conversion == 0) {
+			break;
+		}
+
+		ZiBool ok = ZI_TRUE;
+		if (spec.width_len == 1 && spec.width[0] == '*') {
+			i64 width = va_arg(ap, int);
+			ok = zi_log_put(out, capacity, &size, &width, sizeof(width));
+		}
+		if (ok && spec.precision_len == 1 && spec.precision[0] == '*') {
+			i64 precision = va_arg(ap, int);
+			ok = zi_log_put(out, capacity, &size, &precision, sizeof(precision));
+		}
+		if (!ok) {
+			break;
+		}
+
+		switch (spec.conversion) {
+			case 'd':
+			case 'i': {
+				i64 value = zi_log_read_signed(&ap, spec.length);
+				ok = zi_log_put(out, capacity, &size, &value, sizeof(value));
+				break;
+			}
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X': {
+				u64 value = zi_log_read_unsigned(&ap, spec.length);
+				ok = zi_log_put(out, capacity, &size, &value, sizeof(value));
+				break;
+			}
+			case 'c': {
+				i64 value = va_arg(ap, int);
+				ok = zi_log_put(out, capacity, &size, &value, sizeof(value));
+				break;
+			}
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A': {
+				f64 value = spec.length == ZiLogLength_LongDouble ? (f64)va_arg(ap, long double) : va_arg(ap, double);
+				ok = zi_log_put(out, capacity, &size, &value, sizeof(value));
+				break;
+			}
+			case 'p': {
+				u64 value = (u64)(uintptr_t)va_arg(ap, void*);
+				ok = zi_log_put(out, capacity, &size, &value, sizeof(value));
+				break;
+			}
+			case 's': {
+				const char* str = va_arg(ap, const char*);
+				if (!str) {
+					str = "(null)";
+				}
+				u32 available = capacity - size;
+				if (available < sizeof(u16) + 1) {
+					ok = ZI_FALSE;
+					break;
+				}
+				u32 max_len = available - sizeof(u16) - 1;
+				if (max_len > 0xFFFF) {
+					max_len = 0xFFFF;
+				}
+				u16 len = 0;
+				while (len < max_len && str[len]) len++;
+
+				zi_log_put(out, capacity, &size, &len, sizeof(len));
+				zi_log_put(out, capacity, &size, str, len);
+				out[size++] = 0;
+				break;
+			}
+			case 'n':
+				(void)va_arg(ap, int*);
+				break;
+			default:
+				// unknown conversion, the remaining argument types can't be known
+				ok = ZI_FALSE;
+				break;
+		}
+
+		if (!ok) {
+			break;
+		}
+	}
+
+	va_end(ap);
+	return size;
+}
+
+static ZiBool zi_log_get(const u8* args, u32 args_size, u32* offset, void* value, u32 value_size) {
+	if (*offset + value_size > args_size) {
+		return ZI_FALSE;
+	}
+	memcpy(value, args + *offset, value_size);
+	*offset += value_size;
+	return ZI_TRUE;
+}
+
+// rebuilds the conversion spec with '*' resolved and our own length modifier
+static ZiBool zi_log_build_spec(const ZiLogSpec* spec, const u8* args, u32 args_size, u32* offset, const char* length, char* buf, u32 buf_size) {
+	u32 n = 0;
+	buf[n++] = '%';
+
+	if (spec->flags_len + spec->width_len + spec->precision_len + 32 > buf_size) {
+		return ZI_FALSE;
+	}
+
+	memcpy(buf + n, spec->flags, spec->flags_len);
+	n += spec->flags_len;
+
+	if (spec->width_len == 1 && spec->width[0] == '*') {
+		i64 width;
+		if (!zi_log_get(args, args_size, offset, &width, sizeof(width))) return ZI_FALSE;
+		n += (u32)snprintf(buf + n, buf_size - n, "%d", (int)width);
+	} else {
+		memcpy(buf + n, spec->width, spec->width_len);
+		n += spec->width_len;
+	}
+
+	if (spec->has_precision) {
+		buf[n++] = '.';
+		if (spec->precision_len == 1 && spec->precision[0] == '*') {
+			i64 precision;
+			if (!zi_log_get(args, args_size, offset, &precision, sizeof(precision))) return ZI_FALSE;
+			n += (u32)snprintf(buf + n, buf_size - n, "%d", (int)precision);
+		} else {
+			memcpy(buf + n, spec->precision, spec->precision_len);
+			n += spec->precision_len;
+		}
+	}
+
+	while (*length) {
+		buf[n++] = *length++;
+	}
+	buf[n++] = spec->conversion;
+	buf[n] = 0;
+	return ZI_TRUE;
+}
+
+i32 zi_log_binary_format(const char* fmt, const u8* args, u32 args_size, char* out, i32 capacity) {
+	if (capacity <= 0) {
+		return 0;
+	}
+
+	i32 len = 0;
+	u32 offset = 0;
+	const char* p = fmt;
+
+	while (*p && len < capacity - 1) {
+		if (*p != '%') {
+			out[len++] = *p++;
+			continue;
+		}
+
+		ZiLogSpec   spec;
+		const char* conversion = zi_log_parse_spec(p + 1, &spec);
+
+		if (spec.conversion == '%') {
+			out[len++] = '%';
+			p = conversion + 1;
+			continue;
+		}
+		if (spec.conversion == 0) {
+			break;
+		}
+
+		char   spec_buf[64];
+		i32    written = 0;
+		ZiBool ok = ZI_TRUE;
+
+		switch (spec.conversion) {
+			case 'd':
+			case 'i':
+			case 'c': {
+				i64 value;
+				ok = zi_log_build_spec(&spec, args, args_size, &offset, spec.conversion == 'c' ? "" : "ll", spec_buf, sizeof(spec_buf)) &&
+				     zi_log_get(args, args_size, &offset, &value, sizeof(value));
+				if (ok) {
+					written = spec.conversion == 'c' ? snprintf(out + len, (size_t)(capacity - len), spec_buf, (int)value)
+					                                 : snprintf(out + len, (size_t)(capacity - len), spec_buf, (long long)value);
+				}
+				break;
+			}
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X': {
+				u64 value;
+				ok = zi_log_build_spec(&spec, args, args_size, &offset, "ll", spec_buf, sizeof(spec_buf)) &&
+				     zi_log_get(args, args_size, &offset, &value, sizeof(value));
+				if (ok) {
+					written = snprintf(out + len, (size_t)(capacity - len), spec_buf, (unsigned long long)value);
+				}
+				break;
+			}
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A': {
+				f64 value;
+				ok = zi_log_build_spec(&spec, args, args_size, &offset, "", spec_buf, sizeof(spec_buf)) &&
+				     zi_log_get(args, args_size, &offset, &value, sizeof(value));
+				if (ok) {
+					written = snprintf(out + len, (size_t)(capacity - len), spec_buf, value);
+				}
+				break;
+			}
+			case 'p': {
+				u64 value;
+				ok = zi_log_build_spec(&spec, args, args_size, &offset, "", spec_buf, sizeof(spec_buf)) &&
+				     zi_log_get(args, args_size, &offset, &value, sizeof(value));
+				if (ok) {
+					written = snprintf(out + len, (size_t)(capacity - len), spec_buf, (void*)(uintptr_t)value);
+				}
+				break;
+			}
+			case 's': {
+				u16 str_len;
+				ok = zi_log_build_spec(&spec, args, args_size, &offset, "", spec_buf, sizeof(spec_buf)) &&
+				     zi_log_get(args, args_size, &offset, &str_len, sizeof(str_len)) &&
+				     offset + str_len + 1 <= args_size;
+				if (ok) {
+					written = snprintf(out + len, (size_t)(capacity - len), spec_buf, (const char*)(args + offset));
+					offset += str_len + 1u;
+				}
+				break;
+			}
+			case 'n':
+				break;
+			default:
+				ok = ZI_FALSE;
+				break;
+		}
+
+		if (!ok) {
+			break;
+		}
+
+		if (written > 0) {
+			len += written < capacity - len ? written : capacity - len - 1;
+		}
+		p = conversion + 1;
+	}
+
+	out[len] = 0;
+	return len;
+}
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+ZI_HASHMAP(ZiLogFormatTable, u64, const char*)
+
+typedef struct ZiLogReader {
+	const u8* data;
+	u64       size;
+	u64       offset;
+} ZiLogReader;
+
+static ZiBool zi_log_read(ZiLogReader* reader, void* value, u64 size) {
+	if (reader->offset + size > reader->size) {
+		return ZI_FALSE;
+	}
+	memcpy(value, reader->data + reader->offset, size);
+	reader->offset += size;
+	return ZI_TRUE;
+}
+
+ZiLogDecodeResult zi_log_binary_decode(const u8* data, u64 size, ZiLogDecodeFn fn, VoidPtr user_data) {
+	ZiLogDecodeResult result = {ZiLogDecodeStatus_Ok, 0, 0, 0};
+	ZiLogReader       reader = {data, size, 0};
+
+	if (size < ZI_LOG_BINARY_MAGIC_SIZE || memcmp(data, ZI_LOG_BINARY_MAGIC, ZI_LOG_BINARY_MAGIC_SIZE) != 0) {
+		result.status = ZiLogDecodeStatus_NotBinary;
+		return result;
+	}
+	reader.offset = ZI_LOG_BINARY_MAGIC_SIZE;
+	if (!zi_log_read(&reader, &result.version, sizeof(result.version)) || result.version != ZI_LOG_BINARY_VERSION) {
+		result.status = ZiLogDecodeStatus_BadVersion;
+		result.offset = reader.offset;
+		return result;
+	}
+
+	ZiLogFormatTable formats;
+	ZiLogFormatTable_init(&formats, ZI_NULL);
+
+	for (;;) {
+		u64 record_start = reader.offset;
+		u8  type;
+		if (!zi_log_read(&reader, &type, sizeof(type))) {
+			break;
+		}
+
+		if (type == ZiLogRecordType_Format) {
+			u64 format_id;
+			u16 len;
+			if (!zi_log_read(&reader, &format_id, sizeof(format_id)) || !zi_log_read(&reader, &len, sizeof(len)) ||
+			    reader.offset + len + 1 > reader.size) {
+				result.status = ZiLogDecodeStatus_Truncated;
+				reader.offset = record_start;
+				break;
+			}
+			ZiLogFormatTable_set(&formats, format_id, (const char*)(reader.data + reader.offset));
+			reader.offset += len + 1u;
+		} else if (type == ZiLogRecordType_Message) {
+			u64 format_id;
+			u16 args_size;
+			ZiLogDecodedMessage message;
+			if (!zi_log_read(&reader, &message.level, sizeof(message.level)) ||
+			    !zi_log_read(&reader, &message.category, sizeof(message.category)) ||
+			    !zi_log_read(&reader, &message.wall_clock_us, sizeof(message.wall_clock_us)) ||
+			    !zi_log_read(&reader, &format_id, sizeof(format_id)) || !zi_log_read(&reader, &args_size, sizeof(args_size)) ||
+			    reader.offset + args_size > reader.size) {
+				result.status = ZiLogDecodeStatus_Truncated;
+				reader.offset = record_start;
+				break;
+			}
+
+			const char** fmt = ZiLogFormatTable_get(&formats, format_id);
+			char         text[1024];
+			if (fmt) {
+				message.length = zi_log_binary_format(*fmt, reader.data + reader.offset, args_size, text, sizeof(text));
+			} else {
+				message.length = snprintf(text, sizeof(text), "<unknown format %llx>", (unsigned long long)format_id);
+			}
+			message.text = text;
+			fn(&message, user_data);
+
+			reader.offset += args_size;
+			result.messages++;
+		} else {
+			result.status = ZiLogDecodeStatus_Corrupted;
+			reader.offset = record_start;
+			break;
+		}
+	}
+
+	result.offset = reader.offset;
+	ZiLogFormatTable_free(&formats);
+	return result;
+}
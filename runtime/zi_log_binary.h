@@ -0,0 +1,67 @@
+#pragma once
+
+#include "zi_common.h"
+
+#include <stdarg.h>
+
+// ============================================================================
+// Deferred-format log records
+// ============================================================================
+
+// Arguments are captured raw, driven by the printf format string, and formatted later by the
+// log thread or offline by zi-log-decoder. The format string must outlive the process lifetime of
+// the record (use string literals), strings passed as %s are copied.
+
+#define ZI_LOG_BINARY_MAGIC      "ZILOGBIN"
+#define ZI_LOG_BINARY_MAGIC_SIZE 8
+#define ZI_LOG_BINARY_VERSION    2
+
+enum ZiLogRecordType_ {
+	ZiLogRecordType_Format  = 1, // u64 format id, u16 length, format string + '\0'
+	ZiLogRecordType_Message = 2, // u8 level, u8 category, u64 wall clock us, u64 format id, u16 args size, args
+};
+
+typedef u8 ZiLogRecordType;
+
+// Captures the arguments described by fmt into out. Integers and pointers take 8 bytes, floating
+// point 8 bytes, strings a u16 length followed by the bytes and a terminating zero.
+// Returns the number of bytes written, arguments that don't fit are dropped.
+u32 zi_log_binary_encode(const char* fmt, va_list args, u8* out, u32 capacity);
+
+// Formats fmt with arguments captured by zi_log_binary_encode, returns the length written to out
+i32 zi_log_binary_format(const char* fmt, const u8* args, u32 args_size, char* out, i32 capacity);
+
+// ============================================================================
+// Decoding
+// ============================================================================
+
+enum ZiLogDecodeStatus_ {
+	ZiLogDecodeStatus_Ok         = 0,
+	ZiLogDecodeStatus_NotBinary  = 1, // no ZI_LOG_BINARY_MAGIC at the start
+	ZiLogDecodeStatus_BadVersion = 2,
+	ZiLogDecodeStatus_Corrupted  = 3, // unknown record type at offset
+	ZiLogDecodeStatus_Truncated  = 4, // the last record is cut off at offset, the ones before it were decoded
+};
+
+typedef u8 ZiLogDecodeStatus;
+
+typedef struct ZiLogDecodeResult {
+	ZiLogDecodeStatus status;
+	u32               version;
+	u64               offset;
+	u64               messages;
+} ZiLogDecodeResult;
+
+typedef struct ZiLogDecodedMessage {
+	u8          level;
+	u8          category;
+	u64         wall_clock_us;
+	// formatted text without a newline, "<unknown format id>" when no format record came before it
+	const char* text;
+	i32         length;
+} ZiLogDecodedMessage;
+
+typedef void (*ZiLogDecodeFn)(const ZiLogDecodedMessage* message, VoidPtr user_data);
+
+// Walks a file written by zi_log_open_binary_file and calls fn for every message in order
+ZiLogDecodeResult zi_log_binary_decode(const u8* data, u64 size, ZiLogDecodeFn fn, VoidPtr user_data);
@@ -0,0 +1,177 @@
+#include "zi_lz4.h"
+
+#include <string.h>
+
+#define ZI_LZ4_MIN_MATCH 4
+// the last 5 bytes are always literals and no match may start in the last 12
+#define ZI_LZ4_LAST_LITERALS 5
+#define ZI_LZ4_MF_LIMIT 12
+#define ZI_LZ4_MAX_OFFSET 65535
+#define ZI_LZ4_HASH_BITS 14
+
+static inline u32 zi_lz4_read32(const u8* p) {
+	u32 value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline u32 zi_lz4_hash(u32 sequence) {
+	return (sequence * 2654435761u) >> (32 - ZI_LZ4_HASH_BITS);
+}
+
+static u8* zi_lz4_write_length(u8* op, const u8* op_end, u64 length) {
+	while (length >= 255) {
+		if (op >= op_end) return ZI_NULL;
+		*op++ = 255;
+		length -= 255;
+	}
+	if (op >= op_end) return ZI_NULL;
+	*op++ = (u8)length;
+	return op;
+}
+
+// literals followed by an optional match, match_length 0 marks the last sequence
+static u8* zi_lz4_write_sequence(u8* op, const u8* op_end, const u8* literals, u64 literal_length, u64 offset, u64 match_length) {
+	if (op >= op_end) return ZI_NULL;
+	u8* token = op++;
+
+	u64 match_code = match_length ? match_length - ZI_LZ4_MIN_MATCH : 0;
+	*token = (u8)(((literal_length < 15 ? literal_length : 15) << 4) | (match_code < 15 ? match_code : 15));
+
+	if (literal_length >= 15) {
+		op = zi_lz4_write_length(op, op_end, literal_length - 15);
+		if (!op) return ZI_NULL;
+	}
+
+	if ((u64)(op_end - op) < literal_length) return ZI_NULL;
+	memcpy(op, literals, literal_length);
+	op += literal_length;
+
+	if (match_length == 0) {
+		return op;
+	}
+
+	if (op_end - op < 2) return ZI_NULL;
+	*op++ = (u8)(offset & 0xff);
+	*op++ = (u8)(offset >> 8);
+
+	if (match_code >= 15) {
+		op = zi_lz4_write_length(op, op_end, match_code - 15);
+	}
+	return op;
+}
+
+u64 zi_lz4_compress(const u8* src, u64 src_size, u8* dst, u64 dst_capacity) {
+	u8*       op = dst;
+	const u8* op_end = dst + dst_capacity;
+	const u8* anchor = src;
+
+	if (src_size > ZI_LZ4_MF_LIMIT) {
+		u32 table[1 << ZI_LZ4_HASH_BITS];
+		memset(table, 0, sizeof(table));
+
+		const u8* ip = src;
+		const u8* match_limit = src + src_size - ZI_LZ4_MF_LIMIT;
+		const u8* match_end_limit = src + src_size - ZI_LZ4_LAST_LITERALS;
+		u32       misses = 0;
+
+		while (ip < match_limit) {
+			u32       sequence = zi_lz4_read32(ip);
+			u32       h = zi_lz4_hash(sequence);
+			const u8* ref = src + table[h];
+			table[h] = (u32)(ip - src);
+
+			if (ref >= ip || ip - ref > ZI_LZ4_MAX_OFFSET || zi_lz4_read32(ref) != sequence) {
+				// skip faster through data that doesn't compress
+				ip += 1 + (misses++ >> 6);
+				continue;
+			}
+			misses = 0;
+
+			while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+				ip--;
+				ref--;
+			}
+
+			const u8* match_end = ip + ZI_LZ4_MIN_MATCH;
+			const u8* ref_end = ref + ZI_LZ4_MIN_MATCH;
+			while (match_end < match_end_limit && *match_end == *ref_end) {
+				match_end++;
+				ref_end++;
+			}
+
+			op = zi_lz4_write_sequence(op, op_end, anchor, (u64)(ip - anchor), (u64)(ip - ref), (u64)(match_end - ip));
+			if (!op) return 0;
+
+			ip = match_end;
+			anchor = ip;
+
+			if (ip - 2 > src) {
+				table[zi_lz4_hash(zi_lz4_read32(ip - 2))] = (u32)(ip - 2 - src);
+			}
+		}
+	}
+
+	op = zi_lz4_write_sequence(op, op_end, anchor, (u64)(src + src_size - anchor), 0, 0);
+	return op ? (u64)(op - dst) : 0;
+}
+
+ZiBool zi_lz4_decompress(const u8* src, u64 src_size, u8* dst, u64 dst_size) {
+	const u8* ip = src;
+	const u8* ip_end = src + src_size;
+	u8*       op = dst;
+	u8*       op_end = dst + dst_size;
+
+	while (ip < ip_end) {
+		u8  token = *ip++;
+		u64 literal_length = token >> 4;
+
+		if (literal_length == 15) {
+			u8 byte;
+			do {
+				if (ip >= ip_end) return ZI_FALSE;
+				byte = *ip++;
+				literal_length += byte;
+			} while (byte == 255);
+		}
+
+		if ((u64)(ip_end - ip) < literal_length || (u64)(op_end - op) < literal_length) return ZI_FALSE;
+		memcpy(op, ip, literal_length);
+		ip += literal_length;
+		op += literal_length;
+
+		// the last sequence ends after its literals
+		if (ip == ip_end) break;
+
+		if (ip_end - ip < 2) return ZI_FALSE;
+		u64 offset = (u64)ip[0] | ((u64)ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (u64)(op - dst)) return ZI_FALSE;
+
+		u64 match_length = token & 15;
+		if (match_length == 15) {
+			u8 byte;
+			do {
+				if (ip >= ip_end) return ZI_FALSE;
+				byte = *ip++;
+				match_length += byte;
+			} while (byte == 255);
+		}
+		match_length += ZI_LZ4_MIN_MATCH;
+
+		if ((u64)(op_end - op) < match_length) return ZI_FALSE;
+
+		const u8* match = op - offset;
+		if (offset >= match_length) {
+			memcpy(op, match, match_length);
+			op += match_length;
+		} else {
+			// overlapping copy repeats the last offset bytes
+			for (u64 i = 0; i < match_length; ++i) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return op == op_end;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "zi_common.h"
+
+// ============================================================================
+// LZ4 block format, compatible with LZ4_compress_default / LZ4_decompress_safe.
+// Only raw blocks, no frame header or checksums, the caller stores both sizes.
+// ============================================================================
+
+// worst case compressed size of size bytes
+static inline u64 zi_lz4_compress_bound(u64 size) {
+	return size + size / 255 + 16;
+}
+
+// returns the compressed size, 0 when dst_capacity is too small
+u64    zi_lz4_compress(const u8* src, u64 src_size, u8* dst, u64 dst_capacity);
+// fails on malformed input or when the output isn't exactly dst_size bytes, never writes outside dst
+ZiBool zi_lz4_decompress(const u8* src, u64 src_size, u8* dst, u64 dst_size);
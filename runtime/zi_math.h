@@ -3,6 +3,42 @@
 #include "zi_common.h"
 #include <math.h>
 
+// ============================================================================
+// SIMD Configuration
+// ============================================================================
+//
+// Mat4 products, inverse and transpose, quaternion products and frustum extraction have SSE
+// (x86-64 baseline, AVX2 + FMA when the compiler targets it) and NEON versions next to the
+// scalar ones. zi_*_scalar is the reference and always there, zi_*_simd exists when
+// ZI_MATH_HAS_SIMD. The plain entry points stay scalar unless ZI_MATH_SIMD is 1
+// (cmake -DZI_MATH_SIMD=ON, -DZI_MATH_AVX2=ON for the wider kernels): the SIMD results
+// differ from the scalar ones in the last bits, which matters for lockstep and replays.
+
+#ifndef ZI_MATH_SIMD
+#define ZI_MATH_SIMD 0
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZI_MATH_SSE 1
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define ZI_MATH_AVX2 1
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ZI_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(ZI_MATH_SSE) || defined(ZI_MATH_NEON)
+#define ZI_MATH_HAS_SIMD 1
+#else
+#define ZI_MATH_HAS_SIMD 0
+#endif
+
+#define ZI_MATH_USE_SIMD (ZI_MATH_SIMD && ZI_MATH_HAS_SIMD)
+
 // ============================================================================
 // Constants
 // ============================================================================
@@ -93,33 +129,155 @@ static inline f32 zi_mod_f32(f32 a, f32 b) {
 }
 
 // ============================================================================
-// Random Number Generation (simple LCG-based)
+// Random Number Generation (PCG32)
 // ============================================================================
+//
+// PCG32 (XSH RR): 64 bits of state, a 2^64 period and 2^63 selectable streams. A ZiRandom is
+// explicit state, give each job its own and results don't depend on which thread runs it. Hand
+// a job a stream with zi_random_split, or a slice of one sequence with zi_random_advance so a
+// parallel fill matches the serial one value for value.
+//
+// zi_random_u32 / zi_random_f32 / zi_random_range_* draw from the calling thread's default
+// stream. Unseeded threads start on distinct streams in the order they first draw,
+// zi_random_seed makes the calling thread's sequence reproducible, the same seed on two
+// threads gives both the same sequence.
+
+#define ZI_RANDOM_MULTIPLIER   6364136223846793005ULL
+#define ZI_RANDOM_DEFAULT_SEED 12345u
+
+typedef struct ZiRandom {
+    u64 state;
+    // stream selector, always odd, 0 marks a thread's default stream as not started yet
+    u64 inc;
+} ZiRandom;
+
+static inline u32 zi_random_next_u32(ZiRandom* rng) {
+    u64 old = rng->state;
+    rng->state = old * ZI_RANDOM_MULTIPLIER + rng->inc;
+    u32 xorshifted = (u32)(((old >> 18) ^ old) >> 27);
+    u32 rot = (u32)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+}
+
+static inline void zi_random_init(ZiRandom* rng, u64 seed, u64 stream) {
+    rng->state = 0;
+    rng->inc = (stream << 1) | 1;
+    zi_random_next_u32(rng);
+    rng->state += seed;
+    zi_random_next_u32(rng);
+}
+
+static inline ZiRandom zi_random_create(u64 seed, u64 stream) {
+    ZiRandom rng;
+    zi_random_init(&rng, seed, stream);
+    return rng;
+}
+
+// Multiplier and increment that step the state delta times at once, a jump is
+// state * mult + plus. Wraps mod 2^64, (u64)-n steps back.
+static inline void zi_random_jump_constants(u64 inc, u64 delta, u64* mult, u64* plus) {
+    u64 cur_mult = ZI_RANDOM_MULTIPLIER;
+    u64 cur_plus = inc;
+    u64 acc_mult = 1;
+    u64 acc_plus = 0;
+    while (delta > 0) {
+        if (delta & 1) {
+            acc_mult *= cur_mult;
+            acc_plus = acc_plus * cur_mult + cur_plus;
+        }
+        cur_plus = (cur_mult + 1) * cur_plus;
+        cur_mult *= cur_mult;
+        delta >>= 1;
+    }
+    *mult = acc_mult;
+    *plus = acc_plus;
+}
+
+// same state as delta calls to zi_random_next_u32, in O(log delta)
+static inline void zi_random_advance(ZiRandom* rng, u64 delta) {
+    u64 mult, plus;
+    zi_random_jump_constants(rng->inc, delta, &mult, &plus);
+    rng->state = rng->state * mult + plus;
+}
+
+// New generator on its own stream, seeded from rng's next four outputs. Split every job's
+// generator off one seeded parent in a fixed order and the jobs stay reproducible however
+// they get scheduled.
+static inline ZiRandom zi_random_split(ZiRandom* rng) {
+    u64 seed = ((u64)zi_random_next_u32(rng) << 32) | zi_random_next_u32(rng);
+    u64 stream = ((u64)zi_random_next_u32(rng) << 32) | zi_random_next_u32(rng);
+    return zi_random_create(seed, stream);
+}
 
-static u32 _zi_random_seed = 12345;
+// [0, 1) in steps of 2^-24, every value a float can hold exactly
+static inline f32 zi_random_next_f32(ZiRandom* rng) {
+    return (f32)(zi_random_next_u32(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// [min, max) for min < max. The product can round up to max when max - min is small next to min,
+// those land on the float just below max instead.
+static inline f32 zi_random_next_range_f32(ZiRandom* rng, f32 min_val, f32 max_val) {
+    f32 value = min_val + zi_random_next_f32(rng) * (max_val - min_val);
+    return zi_min_f32(value, nextafterf(max_val, min_val));
+}
+
+// [min, max], unbiased (multiply and reject, Lemire)
+static inline i32 zi_random_next_range_i32(ZiRandom* rng, i32 min_val, i32 max_val) {
+    u32 range = (u32)max_val - (u32)min_val + 1u;
+    if (range == 0) {
+        return (i32)zi_random_next_u32(rng);
+    }
+    u64 m = (u64)zi_random_next_u32(rng) * range;
+    if ((u32)m < range) {
+        u32 threshold = (0u - range) % range;
+        while ((u32)m < threshold) {
+            m = (u64)zi_random_next_u32(rng) * range;
+        }
+    }
+    return (i32)((u32)min_val + (u32)(m >> 32));
+}
+
+// count zi_random_next_u32 / zi_random_next_range_f32 values in order, 8 streams at once with AVX2,
+// leaves rng where count single calls would. The floats match up to the last bit.
+void zi_random_fill_u32(ZiRandom* rng, u32* out, u32 count);
+void zi_random_fill_f32(ZiRandom* rng, f32* out, u32 count, f32 min_val, f32 max_val);
+
+// Default streams
+
+extern ZI_THREAD_LOCAL ZiRandom zi_random_thread_state;
+
+// picks the next free stream for a thread that never drew a number
+void zi_random_thread_start(void);
+
+// the calling thread's default stream, e.g. for zi_random_fill_*
+static inline ZiRandom* zi_random_thread(void) {
+    if (zi_random_thread_state.inc == 0) {
+        zi_random_thread_start();
+    }
+    return &zi_random_thread_state;
+}
 
 static inline void zi_random_seed(u32 seed) {
-    _zi_random_seed = seed;
+    zi_random_init(&zi_random_thread_state, seed, 0);
 }
 
 static inline u32 zi_random_u32(void) {
-    _zi_random_seed = _zi_random_seed * 1103515245 + 12345;
-    return _zi_random_seed;
+    return zi_random_next_u32(zi_random_thread());
 }
 
 // Returns random float in [0, 1)
 static inline f32 zi_random_f32(void) {
-    return (f32)(zi_random_u32() & 0x7FFFFFFF) / (f32)0x7FFFFFFF;
+    return zi_random_next_f32(zi_random_thread());
 }
 
 // Returns random float in [min, max)
 static inline f32 zi_random_range_f32(f32 min_val, f32 max_val) {
-    return zi_lerp_f32(min_val, max_val, zi_random_f32());
+    return zi_random_next_range_f32(zi_random_thread(), min_val, max_val);
 }
 
 // Returns random int in [min, max]
 static inline i32 zi_random_range_i32(i32 min_val, i32 max_val) {
-    return min_val + (i32)(zi_random_u32() % (u32)(max_val - min_val + 1));
+    return zi_random_next_range_i32(zi_random_thread(), min_val, max_val);
 }
 
 // ============================================================================
@@ -928,6 +1086,294 @@ static inline ZiVec3 zi_mat34_transform_vector(const ZiMat34* m, ZiVec3 v) {
     };
 }
 
+// a * b as affine 4x4 transforms with an implicit 0 0 0 1 last row
+static inline ZiMat34 zi_mat34_mul(const ZiMat34* a, const ZiMat34* b) {
+    ZiMat34 result;
+    for (i32 col = 0; col < 4; col++) {
+        for (i32 row = 0; row < 3; row++) {
+            f32 sum = col == 3 ? zi_mat34_at(a, row, 3) : 0.0f;
+            for (i32 k = 0; k < 3; k++) {
+                sum += zi_mat34_at(a, row, k) * zi_mat34_at(b, k, col);
+            }
+            zi_mat34_set(&result, row, col, sum);
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// SIMD Kernels
+// ============================================================================
+//
+// Column-major f32[16] matrices through unaligned loads, so the plain and the aligned types share
+// them, output may alias an input. Vectors and quaternions come in as registers: by-value structs
+// arrive split over two registers and a 16 byte reload of their spill stalls on store forwarding.
+
+#if defined(ZI_MATH_SSE)
+
+typedef __m128 ZiF32x4;
+
+#define ZI_SIMD_SPLAT(v, i)            _mm_shuffle_ps((v), (v), _MM_SHUFFLE(i, i, i, i))
+#define ZI_SIMD_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(w, z, y, x))
+
+static inline ZiF32x4 _zi_simd_set(f32 x, f32 y, f32 z, f32 w) {
+    return _mm_setr_ps(x, y, z, w);
+}
+
+static inline void _zi_simd_store(f32* out, ZiF32x4 v) {
+    _mm_storeu_ps(out, v);
+}
+
+// a * b + c, fused with AVX2 + FMA
+static inline __m128 _zi_simd_madd(__m128 a, __m128 b, __m128 c) {
+#if defined(ZI_MATH_AVX2)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+static inline void _zi_simd_mat4_mul(f32* out, const f32* a, const f32* b) {
+#if defined(ZI_MATH_AVX2)
+    // two result columns per iteration, each half of b01 broadcasts its own column's coefficients
+    __m256 a0 = _mm256_broadcast_ps((const __m128*)(a + 0));
+    __m256 a1 = _mm256_broadcast_ps((const __m128*)(a + 4));
+    __m256 a2 = _mm256_broadcast_ps((const __m128*)(a + 8));
+    __m256 a3 = _mm256_broadcast_ps((const __m128*)(a + 12));
+    __m256 b01 = _mm256_loadu_ps(b);
+    __m256 b23 = _mm256_loadu_ps(b + 8);
+
+    __m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+    r01 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55), r01);
+    r01 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA), r01);
+    r01 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF), r01);
+
+    __m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+    r23 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55), r23);
+    r23 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA), r23);
+    r23 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF), r23);
+
+    _mm256_storeu_ps(out, r01);
+    _mm256_storeu_ps(out + 8, r23);
+#else
+    __m128 a0 = _mm_loadu_ps(a + 0);
+    __m128 a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+    __m128 b0 = _mm_loadu_ps(b + 0);
+    __m128 b1 = _mm_loadu_ps(b + 4);
+    __m128 b2 = _mm_loadu_ps(b + 8);
+    __m128 b3 = _mm_loadu_ps(b + 12);
+    __m128 bc[4] = { b0, b1, b2, b3 };
+
+    for (i32 col = 0; col < 4; col++) {
+        __m128 r = _mm_mul_ps(a0, ZI_SIMD_SPLAT(bc[col], 0));
+        r = _zi_simd_madd(a1, ZI_SIMD_SPLAT(bc[col], 1), r);
+        r = _zi_simd_madd(a2, ZI_SIMD_SPLAT(bc[col], 2), r);
+        r = _zi_simd_madd(a3, ZI_SIMD_SPLAT(bc[col], 3), r);
+        _mm_storeu_ps(out + col * 4, r);
+    }
+#endif
+}
+
+static inline ZiF32x4 _zi_simd_mat4_mul_vec4(const f32* m, ZiF32x4 v) {
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(m), ZI_SIMD_SPLAT(v, 0));
+    r = _zi_simd_madd(_mm_loadu_ps(m + 4), ZI_SIMD_SPLAT(v, 1), r);
+    r = _zi_simd_madd(_mm_loadu_ps(m + 8), ZI_SIMD_SPLAT(v, 2), r);
+    return _zi_simd_madd(_mm_loadu_ps(m + 12), ZI_SIMD_SPLAT(v, 3), r);
+}
+
+static inline void _zi_simd_mat4_transpose(f32* out, const f32* m) {
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(out + 0, c0);
+    _mm_storeu_ps(out + 4, c1);
+    _mm_storeu_ps(out + 8, c2);
+    _mm_storeu_ps(out + 12, c3);
+}
+
+// 2x2 blocks packed row by row into one register: A * B, adj(A) * B and A * adj(B)
+static inline __m128 _zi_simd_mat2_mul(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_mul_ps(a, ZI_SIMD_SWIZZLE(b, 0, 3, 0, 3)),
+                      _mm_mul_ps(ZI_SIMD_SWIZZLE(a, 1, 0, 3, 2), ZI_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+static inline __m128 _zi_simd_mat2_adj_mul(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(ZI_SIMD_SWIZZLE(a, 3, 3, 0, 0), b),
+                      _mm_mul_ps(ZI_SIMD_SWIZZLE(a, 1, 1, 2, 2), ZI_SIMD_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+static inline __m128 _zi_simd_mat2_mul_adj(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(a, ZI_SIMD_SWIZZLE(b, 3, 0, 3, 0)),
+                      _mm_mul_ps(ZI_SIMD_SWIZZLE(a, 1, 0, 3, 2), ZI_SIMD_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// Block-wise inverse over the four 2x2 sub-matrices. Fed columns it inverts the transpose, whose
+// rows are the inverse's columns, so the layout works out. Returns ZI_FALSE when singular.
+static inline ZiBool _zi_simd_mat4_inverse(f32* out, const f32* m) {
+    __m128 c0 = _mm_loadu_ps(m + 0);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+
+    __m128 a = _mm_movelh_ps(c0, c1);
+    __m128 b = _mm_movehl_ps(c1, c0);
+    __m128 c = _mm_movelh_ps(c2, c3);
+    __m128 d = _mm_movehl_ps(c3, c2);
+
+    // |A| |B| |C| |D|
+    __m128 det_sub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(c0, c2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(c1, c3, _MM_SHUFFLE(2, 0, 2, 0))));
+    __m128 det_a = ZI_SIMD_SPLAT(det_sub, 0);
+    __m128 det_b = ZI_SIMD_SPLAT(det_sub, 1);
+    __m128 det_c = ZI_SIMD_SPLAT(det_sub, 2);
+    __m128 det_d = ZI_SIMD_SPLAT(det_sub, 3);
+
+    __m128 d_c = _zi_simd_mat2_adj_mul(d, c);
+    __m128 a_b = _zi_simd_mat2_adj_mul(a, b);
+    __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), _zi_simd_mat2_mul(b, d_c));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), _zi_simd_mat2_mul(c, a_b));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), _zi_simd_mat2_mul_adj(d, a_b));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), _zi_simd_mat2_mul_adj(a, d_c));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 tr = _mm_mul_ps(a_b, ZI_SIMD_SWIZZLE(d_c, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, ZI_SIMD_SWIZZLE(tr, 2, 3, 0, 1));
+    tr = _mm_add_ps(tr, ZI_SIMD_SWIZZLE(tr, 1, 0, 3, 2));
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), tr);
+
+    f32 det_scalar = _mm_cvtss_f32(det);
+    if (det_scalar < ZI_EPSILON && det_scalar > -ZI_EPSILON) {
+        return ZI_FALSE;
+    }
+
+    __m128 inv_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, inv_det);
+    y = _mm_mul_ps(y, inv_det);
+    z = _mm_mul_ps(z, inv_det);
+    w = _mm_mul_ps(w, inv_det);
+
+    // adjugate and store in one shuffle
+    _mm_storeu_ps(out + 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(out + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+    return ZI_TRUE;
+}
+
+// Hamilton product, xyzw
+static inline ZiF32x4 _zi_simd_quat_mul(ZiF32x4 qa, ZiF32x4 qb) {
+    __m128 r = _mm_mul_ps(ZI_SIMD_SPLAT(qa, 3), qb);
+    r = _zi_simd_madd(ZI_SIMD_SPLAT(qa, 0), _mm_xor_ps(ZI_SIMD_SWIZZLE(qb, 3, 2, 1, 0), _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)), r);
+    r = _zi_simd_madd(ZI_SIMD_SPLAT(qa, 1), _mm_xor_ps(ZI_SIMD_SWIZZLE(qb, 2, 3, 0, 1), _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)), r);
+    return _zi_simd_madd(ZI_SIMD_SPLAT(qa, 2), _mm_xor_ps(ZI_SIMD_SWIZZLE(qb, 1, 0, 3, 2), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)), r);
+}
+
+static inline __m128 _zi_simd_plane_normalize(__m128 p) {
+    __m128 sq = _mm_mul_ps(p, p);
+    __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(ZI_SIMD_SPLAT(sq, 0), ZI_SIMD_SPLAT(sq, 1)), ZI_SIMD_SPLAT(sq, 2)));
+    __m128 valid = _mm_cmpgt_ps(len, _mm_set1_ps(ZI_EPSILON));
+    return _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(p, len)), _mm_andnot_ps(valid, p));
+}
+
+// Six normalized xyz + distance planes, row 3 plus and minus rows 0, 1 and 2 with w negated
+static inline void _zi_simd_frustum_planes(f32* planes, const f32* m) {
+    __m128 rows[4] = {_mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12)};
+    _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+    __m128 negate_w = _mm_setr_ps(0.0f, 0.0f, 0.0f, -0.0f);
+    for (i32 i = 0; i < 3; i++) {
+        __m128 plus = _mm_xor_ps(_mm_add_ps(rows[3], rows[i]), negate_w);
+        __m128 minus = _mm_xor_ps(_mm_sub_ps(rows[3], rows[i]), negate_w);
+        _mm_storeu_ps(planes + i * 8, _zi_simd_plane_normalize(plus));
+        _mm_storeu_ps(planes + i * 8 + 4, _zi_simd_plane_normalize(minus));
+    }
+}
+
+#elif defined(ZI_MATH_NEON)
+
+typedef float32x4_t ZiF32x4;
+
+static inline ZiF32x4 _zi_simd_set(f32 x, f32 y, f32 z, f32 w) {
+    float32x4_t v = vdupq_n_f32(x);
+    v = vsetq_lane_f32(y, v, 1);
+    v = vsetq_lane_f32(z, v, 2);
+    return vsetq_lane_f32(w, v, 3);
+}
+
+static inline void _zi_simd_store(f32* out, ZiF32x4 v) {
+    vst1q_f32(out, v);
+}
+
+static inline void _zi_simd_mat4_mul(f32* out, const f32* a, const f32* b) {
+    float32x4_t a0 = vld1q_f32(a + 0);
+    float32x4_t a1 = vld1q_f32(a + 4);
+    float32x4_t a2 = vld1q_f32(a + 8);
+    float32x4_t a3 = vld1q_f32(a + 12);
+    float32x4_t bc[4] = { vld1q_f32(b + 0), vld1q_f32(b + 4), vld1q_f32(b + 8), vld1q_f32(b + 12) };
+
+    for (i32 col = 0; col < 4; col++) {
+        float32x4_t r = vmulq_laneq_f32(a0, bc[col], 0);
+        r = vfmaq_laneq_f32(r, a1, bc[col], 1);
+        r = vfmaq_laneq_f32(r, a2, bc[col], 2);
+        r = vfmaq_laneq_f32(r, a3, bc[col], 3);
+        vst1q_f32(out + col * 4, r);
+    }
+}
+
+static inline ZiF32x4 _zi_simd_mat4_mul_vec4(const f32* m, ZiF32x4 v) {
+    float32x4_t r = vmulq_laneq_f32(vld1q_f32(m), v, 0);
+    r = vfmaq_laneq_f32(r, vld1q_f32(m + 4), v, 1);
+    r = vfmaq_laneq_f32(r, vld1q_f32(m + 8), v, 2);
+    return vfmaq_laneq_f32(r, vld1q_f32(m + 12), v, 3);
+}
+
+static inline void _zi_simd_mat4_transpose(f32* out, const f32* m) {
+    // de-interleaving load, val[i] is row i
+    float32x4x4_t rows = vld4q_f32(m);
+    vst1q_f32(out + 0, rows.val[0]);
+    vst1q_f32(out + 4, rows.val[1]);
+    vst1q_f32(out + 8, rows.val[2]);
+    vst1q_f32(out + 12, rows.val[3]);
+}
+
+// Hamilton product, xyzw
+static inline ZiF32x4 _zi_simd_quat_mul(ZiF32x4 qa, ZiF32x4 qb) {
+    static const f32 sign_x[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+    static const f32 sign_y[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+    static const f32 sign_z[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+    float32x4_t b_zwxy = vextq_f32(qb, qb, 2);
+    float32x4_t r = vmulq_laneq_f32(qb, qa, 3);
+    r = vfmaq_laneq_f32(r, vmulq_f32(vrev64q_f32(b_zwxy), vld1q_f32(sign_x)), qa, 0);
+    r = vfmaq_laneq_f32(r, vmulq_f32(b_zwxy, vld1q_f32(sign_y)), qa, 1);
+    return vfmaq_laneq_f32(r, vmulq_f32(vrev64q_f32(qb), vld1q_f32(sign_z)), qa, 2);
+}
+
+static inline float32x4_t _zi_simd_plane_normalize(float32x4_t p) {
+    float32x4_t sq = vmulq_f32(p, p);
+    f32 len = sqrtf(vgetq_lane_f32(sq, 0) + vgetq_lane_f32(sq, 1) + vgetq_lane_f32(sq, 2));
+    return len > ZI_EPSILON ? vdivq_f32(p, vdupq_n_f32(len)) : p;
+}
+
+// Six normalized xyz + distance planes, row 3 plus and minus rows 0, 1 and 2 with w negated
+static inline void _zi_simd_frustum_planes(f32* planes, const f32* m) {
+    // the de-interleaving load transposes the column-major matrix into rows
+    float32x4x4_t rows = vld4q_f32(m);
+    static const f32 negate_w[4] = {1.0f, 1.0f, 1.0f, -1.0f};
+    float32x4_t sign = vld1q_f32(negate_w);
+    for (i32 i = 0; i < 3; i++) {
+        float32x4_t plus = vmulq_f32(vaddq_f32(rows.val[3], rows.val[i]), sign);
+        float32x4_t minus = vmulq_f32(vsubq_f32(rows.val[3], rows.val[i]), sign);
+        vst1q_f32(planes + i * 8, _zi_simd_plane_normalize(plus));
+        vst1q_f32(planes + i * 8 + 4, _zi_simd_plane_normalize(minus));
+    }
+}
+
+#endif
+
 // ============================================================================
 // Matrix 4x4 (column-major)
 // ============================================================================
@@ -957,7 +1403,7 @@ static inline void zi_mat4_set(ZiMat4* m, i32 row, i32 col, f32 val) {
     m->m[col * 4 + row] = val;
 }
 
-static inline ZiMat4 zi_mat4_mul(const ZiMat4* a, const ZiMat4* b) {
+static inline ZiMat4 zi_mat4_mul_scalar(const ZiMat4* a, const ZiMat4* b) {
     ZiMat4 result = zi_mat4_zero();
     for (i32 col = 0; col < 4; col++) {
         for (i32 row = 0; row < 4; row++) {
@@ -971,7 +1417,7 @@ static inline ZiMat4 zi_mat4_mul(const ZiMat4* a, const ZiMat4* b) {
     return result;
 }
 
-static inline ZiVec4 zi_mat4_mul_vec4(const ZiMat4* m, ZiVec4 v) {
+static inline ZiVec4 zi_mat4_mul_vec4_scalar(const ZiMat4* m, ZiVec4 v) {
     return (ZiVec4){
         zi_mat4_at(m, 0, 0) * v.x + zi_mat4_at(m, 0, 1) * v.y + zi_mat4_at(m, 0, 2) * v.z + zi_mat4_at(m, 0, 3) * v.w,
         zi_mat4_at(m, 1, 0) * v.x + zi_mat4_at(m, 1, 1) * v.y + zi_mat4_at(m, 1, 2) * v.z + zi_mat4_at(m, 1, 3) * v.w,
@@ -980,6 +1426,36 @@ static inline ZiVec4 zi_mat4_mul_vec4(const ZiMat4* m, ZiVec4 v) {
     };
 }
 
+#if ZI_MATH_HAS_SIMD
+static inline ZiMat4 zi_mat4_mul_simd(const ZiMat4* a, const ZiMat4* b) {
+    ZiMat4 result;
+    _zi_simd_mat4_mul(result.m, a->m, b->m);
+    return result;
+}
+
+static inline ZiVec4 zi_mat4_mul_vec4_simd(const ZiMat4* m, ZiVec4 v) {
+    ZiVec4 result;
+    _zi_simd_store(&result.x, _zi_simd_mat4_mul_vec4(m->m, _zi_simd_set(v.x, v.y, v.z, v.w)));
+    return result;
+}
+#endif
+
+static inline ZiMat4 zi_mat4_mul(const ZiMat4* a, const ZiMat4* b) {
+#if ZI_MATH_USE_SIMD
+    return zi_mat4_mul_simd(a, b);
+#else
+    return zi_mat4_mul_scalar(a, b);
+#endif
+}
+
+static inline ZiVec4 zi_mat4_mul_vec4(const ZiMat4* m, ZiVec4 v) {
+#if ZI_MATH_USE_SIMD
+    return zi_mat4_mul_vec4_simd(m, v);
+#else
+    return zi_mat4_mul_vec4_scalar(m, v);
+#endif
+}
+
 static inline ZiVec3 zi_mat4_transform_point(const ZiMat4* m, ZiVec3 p) {
     ZiVec4 result = zi_mat4_mul_vec4(m, zi_vec4(p.x, p.y, p.z, 1.0f));
     if (zi_abs_f32(result.w) > ZI_EPSILON) {
@@ -993,7 +1469,7 @@ static inline ZiVec3 zi_mat4_transform_vector(const ZiMat4* m, ZiVec3 v) {
     return zi_vec3(result.x, result.y, result.z);
 }
 
-static inline ZiMat4 zi_mat4_transpose(const ZiMat4* m) {
+static inline ZiMat4 zi_mat4_transpose_scalar(const ZiMat4* m) {
     ZiMat4 result;
     for (i32 row = 0; row < 4; row++) {
         for (i32 col = 0; col < 4; col++) {
@@ -1003,6 +1479,22 @@ static inline ZiMat4 zi_mat4_transpose(const ZiMat4* m) {
     return result;
 }
 
+#if ZI_MATH_HAS_SIMD
+static inline ZiMat4 zi_mat4_transpose_simd(const ZiMat4* m) {
+    ZiMat4 result;
+    _zi_simd_mat4_transpose(result.m, m->m);
+    return result;
+}
+#endif
+
+static inline ZiMat4 zi_mat4_transpose(const ZiMat4* m) {
+#if ZI_MATH_USE_SIMD
+    return zi_mat4_transpose_simd(m);
+#else
+    return zi_mat4_transpose_scalar(m);
+#endif
+}
+
 static inline ZiMat4 zi_mat4_translate(ZiVec3 t) {
     ZiMat4 m = zi_mat4_identity();
     zi_mat4_set(&m, 0, 3, t.x);
@@ -1114,7 +1606,7 @@ static inline ZiMat4 zi_mat4_ortho(f32 left, f32 right, f32 bottom, f32 top, f32
     return m;
 }
 
-static inline ZiMat4 zi_mat4_inverse(const ZiMat4* m) {
+static inline ZiMat4 zi_mat4_inverse_scalar(const ZiMat4* m) {
     f32 a00 = zi_mat4_at(m, 0, 0), a01 = zi_mat4_at(m, 0, 1), a02 = zi_mat4_at(m, 0, 2), a03 = zi_mat4_at(m, 0, 3);
     f32 a10 = zi_mat4_at(m, 1, 0), a11 = zi_mat4_at(m, 1, 1), a12 = zi_mat4_at(m, 1, 2), a13 = zi_mat4_at(m, 1, 3);
     f32 a20 = zi_mat4_at(m, 2, 0), a21 = zi_mat4_at(m, 2, 1), a22 = zi_mat4_at(m, 2, 2), a23 = zi_mat4_at(m, 2, 3);
@@ -1159,6 +1651,29 @@ static inline ZiMat4 zi_mat4_inverse(const ZiMat4* m) {
     return result;
 }
 
+#if ZI_MATH_HAS_SIMD
+static inline ZiMat4 zi_mat4_inverse_simd(const ZiMat4* m) {
+#if defined(ZI_MATH_SSE)
+    ZiMat4 result;
+    if (!_zi_simd_mat4_inverse(result.m, m->m)) {
+        return zi_mat4_identity();
+    }
+    return result;
+#else
+    // no NEON kernel yet
+    return zi_mat4_inverse_scalar(m);
+#endif
+}
+#endif
+
+static inline ZiMat4 zi_mat4_inverse(const ZiMat4* m) {
+#if ZI_MATH_USE_SIMD
+    return zi_mat4_inverse_simd(m);
+#else
+    return zi_mat4_inverse_scalar(m);
+#endif
+}
+
 // Extract upper-left 3x3 from 4x4
 static inline ZiMat3 zi_mat4_to_mat3(const ZiMat4* m) {
     ZiMat3 result;
@@ -1238,7 +1753,7 @@ static inline ZiQuat zi_quat_inverse(ZiQuat q) {
     return zi_quat_identity();
 }
 
-static inline ZiQuat zi_quat_mul(ZiQuat a, ZiQuat b) {
+static inline ZiQuat zi_quat_mul_scalar(ZiQuat a, ZiQuat b) {
     return (ZiQuat){
         a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
         a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
@@ -1247,6 +1762,22 @@ static inline ZiQuat zi_quat_mul(ZiQuat a, ZiQuat b) {
     };
 }
 
+#if ZI_MATH_HAS_SIMD
+static inline ZiQuat zi_quat_mul_simd(ZiQuat a, ZiQuat b) {
+    ZiQuat result;
+    _zi_simd_store(&result.x, _zi_simd_quat_mul(_zi_simd_set(a.x, a.y, a.z, a.w), _zi_simd_set(b.x, b.y, b.z, b.w)));
+    return result;
+}
+#endif
+
+static inline ZiQuat zi_quat_mul(ZiQuat a, ZiQuat b) {
+#if ZI_MATH_USE_SIMD
+    return zi_quat_mul_simd(a, b);
+#else
+    return zi_quat_mul_scalar(a, b);
+#endif
+}
+
 static inline ZiVec3 zi_quat_rotate_vec3(ZiQuat q, ZiVec3 v) {
     ZiVec3 qv = { q.x, q.y, q.z };
     ZiVec3 uv = zi_vec3_cross(qv, v);
@@ -1447,6 +1978,293 @@ static inline ZiVec3 zi_quat_up(ZiQuat q) {
     return zi_quat_rotate_vec3(q, zi_vec3(0, 1, 0));
 }
 
+// ============================================================================
+// Fast Approximations
+// ============================================================================
+//
+// zi_fast_* trade accuracy for speed: polynomials and bit tricks instead of libm, no branches on
+// the data, so loops over them vectorize. That is where the gain is, a lone rsqrt isn't faster
+// than sqrtf and a divide on current x86. Max errors are measured against double precision libm
+// over the stated input ranges. The polynomials are minimax fits on a reduced range, refit them
+// rather than tweaking digits.
+
+static inline u32 zi_f32_bits(f32 v) {
+    union { f32 f; u32 u; } bits = { v };
+    return bits.u;
+}
+
+static inline f32 zi_f32_from_bits(u32 v) {
+    union { u32 u; f32 f; } bits = { v };
+    return bits.f;
+}
+
+// a where mask is all ones, b where it is zero. Ternaries between floats get turned into branches
+// and the loop split, which stops it from vectorizing.
+static inline f32 zi_fast_select(u32 mask, f32 a, f32 b) {
+    return zi_f32_from_bits((zi_f32_bits(a) & mask) | (zi_f32_bits(b) & ~mask));
+}
+
+// Relative error < 5e-6 for positive normal x. Bit trick estimate plus two Newton steps.
+static inline f32 zi_fast_rsqrt(f32 x) {
+    f32 half = 0.5f * x;
+    f32 y = zi_f32_from_bits(0x5f375a86u - (zi_f32_bits(x) >> 1));
+    y = y * (1.5f - half * y * y);
+    y = y * (1.5f - half * y * y);
+    return y;
+}
+
+// Relative error < 5e-6, 0 for 0
+static inline f32 zi_fast_sqrt(f32 x) {
+    return x * zi_fast_rsqrt(x);
+}
+
+// Absolute error < 1.5e-7 for |x| <= 8192, grows with |x| past that as the quadrant reduction
+// runs out of bits (1e-6 at 1e5).
+static inline void zi_fast_sincos(f32 x, f32* sin_out, f32* cos_out) {
+    f32 v = x * (2.0f * ZI_INV_PI);
+    // rounds half away from zero, 0.5 takes the sign bit of v instead of a compare
+    i32 quadrant = (i32)(v + zi_f32_from_bits(0x3f000000u | (zi_f32_bits(v) & 0x80000000u)));
+    f32 q = (f32)quadrant;
+    // pi/2 in three parts so r lands in [-pi/4, pi/4] without cancellation
+    f32 r = x - q * 1.5703125f;
+    r = r - q * 4.837512969970703125e-4f;
+    r = r - q * 7.54978995489188216e-8f;
+
+    f32 z = r * r;
+    f32 s = r + r * z * (-1.66666549e-1f + z * (8.33217815e-3f + z * -1.95172990e-4f));
+    f32 c = 1.0f - 0.5f * z + z * z * (4.16666469e-2f + z * (-1.38873675e-3f + z * 2.44384516e-5f));
+
+    // odd quadrants swap sin and cos, the signs come straight from the quadrant
+    u32 swap = 0u - (u32)(quadrant & 1);
+    *sin_out = zi_f32_from_bits(zi_f32_bits(zi_fast_select(swap, c, s)) ^ ((u32)(quadrant & 2) << 30));
+    *cos_out = zi_f32_from_bits(zi_f32_bits(zi_fast_select(swap, s, c)) ^ ((u32)((quadrant + 1) & 2) << 30));
+}
+
+static inline f32 zi_fast_sin(f32 x) {
+    f32 s, c;
+    zi_fast_sincos(x, &s, &c);
+    return s;
+}
+
+static inline f32 zi_fast_cos(f32 x) {
+    f32 s, c;
+    zi_fast_sincos(x, &s, &c);
+    return c;
+}
+
+// Absolute error < 2.5e-6 radians. Signed zeros are handled like atan2f and (0, 0) gives 0, two
+// infinities give NaN.
+static inline f32 zi_fast_atan2(f32 y, f32 x) {
+    u32 x_bits = zi_f32_bits(x);
+    u32 y_bits = zi_f32_bits(y);
+    f32 ax = zi_f32_from_bits(x_bits & 0x7fffffffu);
+    f32 ay = zi_f32_from_bits(y_bits & 0x7fffffffu);
+    u32 steep = 0u - (u32)(ay > ax);
+    f32 hi = zi_fast_select(steep, ay, ax);
+    f32 lo = zi_fast_select(steep, ax, ay);
+    // the smallest normal only matters when hi is 0, and keeps 0 / 0 out
+    f32 t = lo / (hi + 1.17549435e-38f);
+
+    f32 z = t * t;
+    f32 a = t * (9.99977219e-1f + z * (-3.32622828e-1f + z * (1.93540376e-1f + z * (-1.16426481e-1f +
+                 z * (5.26473507e-2f + z * -1.17191355e-2f)))));
+    a = zi_fast_select(steep, ZI_HALF_PI - a, a);
+    a = zi_fast_select(0u - (x_bits >> 31), ZI_PI - a, a);
+    return zi_f32_from_bits(zi_f32_bits(a) | (y_bits & 0x80000000u));
+}
+
+// Relative error < 3e-7 for x in [-126, 127], saturates between about 2^-126 and 2^127.5 outside
+static inline f32 zi_fast_exp2(f32 x) {
+    // round to nearest through the mantissa of 1.5 * 2^23, no float to int conversion
+    f32 big = x + 12582912.0f;
+    f32 r = big - 12582912.0f;
+    i32 n = zi_clamp_i32((i32)(zi_f32_bits(big) - 0x4b400000u), -126, 127);
+    f32 f = x - r;
+    f32 p = 1.00000007f + f * (6.93146967e-1f + f * (2.40221197e-1f + f * (5.55071327e-2f +
+            f * (9.67554134e-3f + f * 1.32764720e-3f))));
+    return p * zi_f32_from_bits((u32)(n + 127) << 23);
+}
+
+// Relative error < 4e-6 for |x| <= 80, the scaling by log2(e) rounds
+static inline f32 zi_fast_exp(f32 x) {
+    return zi_fast_exp2(x * 1.44269504f);
+}
+
+// Absolute error < 7e-7 while |log2(x)| <= 8, past that the result's own rounding dominates
+// (< 1e-7 relative). Positive normal x only, garbage for zero, negatives and NaN.
+static inline f32 zi_fast_log2(f32 x) {
+    // exponent and mantissa split around sqrt(1/2) so the mantissa lands in [sqrt(1/2), sqrt(2))
+    u32 bits = zi_f32_bits(x);
+    i32 e = (i32)(bits - 0x3f3504f3u) >> 23;
+    f32 t = zi_f32_from_bits(bits - ((u32)e << 23)) - 1.0f;
+    f32 p = 1.44269973f + t * (-7.21375871e-1f + t * (4.80465034e-1f + t * (-3.58961851e-1f +
+            t * (2.97262587e-1f + t * (-2.72697926e-1f + t * 1.70634504e-1f)))));
+    return (f32)e + t * p;
+}
+
+static inline f32 zi_fast_log(f32 x) {
+    return zi_fast_log2(x) * 0.693147181f;
+}
+
+// x > 0, relative error grows with |y * log2(x)|, < 1e-6 while that stays under 4
+static inline f32 zi_fast_pow(f32 x, f32 y) {
+    return zi_fast_exp2(y * zi_fast_log2(x));
+}
+
+// zi_linear_to_srgb / zi_srgb_to_linear through zi_fast_pow, absolute error < 1e-6 on [0, 1]
+static inline f32 zi_fast_linear_to_srgb(f32 linear) {
+    f32 line = linear * 12.92f;
+    f32 curve = 1.055f * zi_fast_pow(linear, 1.0f / 2.4f) - 0.055f;
+    return zi_fast_select(0u - (u32)(linear <= 0.0031308f), line, curve);
+}
+
+static inline f32 zi_fast_srgb_to_linear(f32 srgb) {
+    f32 line = srgb * (1.0f / 12.92f);
+    f32 curve = zi_fast_pow((srgb + 0.055f) * (1.0f / 1.055f), 2.4f);
+    return zi_fast_select(0u - (u32)(srgb <= 0.04045f), line, curve);
+}
+
+static inline ZiVec3 zi_fast_vec3_normalize(ZiVec3 v) {
+    f32 len_sq = zi_vec3_length_sq(v);
+    f32 inv = zi_fast_select(0u - (u32)(len_sq > ZI_EPSILON * ZI_EPSILON), zi_fast_rsqrt(len_sq), 0.0f);
+    return zi_vec3_scale(v, inv);
+}
+
+// Shortest path lerp, renormalized. Speed changes along the arc, fine for small steps.
+static inline ZiQuat zi_fast_quat_nlerp(ZiQuat a, ZiQuat b, f32 t) {
+    f32 ta = 1.0f - t;
+    f32 tb = zi_f32_from_bits(zi_f32_bits(t) ^ (zi_f32_bits(zi_quat_dot(a, b)) & 0x80000000u));
+    ZiQuat q = { a.x * ta + b.x * tb, a.y * ta + b.y * tb, a.z * ta + b.z * tb, a.w * ta + b.w * tb };
+    f32 inv = zi_fast_rsqrt(zi_quat_dot(q, q));
+    return (ZiQuat){ q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+}
+
+// zi_fast_quat_nlerp with t bent to keep the angular speed constant. Rotation angle error
+// < 1.2e-3 radians against zi_quat_slerp, no acos/sin and no branch for nearly equal inputs.
+static inline f32 zi_fast_slerp_t(f32 abs_dot, f32 t) {
+    f32 d = abs_dot;
+    f32 a = 1.07015237f + d * (-3.22715622f + d * (3.63301726f + d * -1.51229774f));
+    f32 b = 0.847359724f + d * (-1.05836274f + d * 0.214132695f);
+    f32 u = t - 0.5f;
+    return t + t * u * (t - 1.0f) * (a * u * u + b);
+}
+
+static inline ZiQuat zi_fast_quat_slerp(ZiQuat a, ZiQuat b, f32 t) {
+    return zi_fast_quat_nlerp(a, b, zi_fast_slerp_t(zi_abs_f32(zi_quat_dot(a, b)), t));
+}
+
+// ============================================================================
+// Aligned Types
+// ============================================================================
+//
+// ZiVec4 / ZiMat4 / ZiQuat on 16 byte boundaries, for arrays the SIMD paths stream through.
+// Convert at the edges, the hot operations have their own entry points here.
+
+typedef struct ZI_ALIGN(16) ZiVec4A {
+    f32 x, y, z, w;
+} ZiVec4A;
+
+typedef struct ZI_ALIGN(16) ZiMat4A {
+    f32 m[16]; // Column-major: m[col * 4 + row]
+} ZiMat4A;
+
+typedef struct ZI_ALIGN(16) ZiQuatA {
+    f32 x, y, z, w;
+} ZiQuatA;
+
+static inline ZiVec4A zi_vec4a_from_vec4(ZiVec4 v) {
+    return (ZiVec4A){ v.x, v.y, v.z, v.w };
+}
+
+static inline ZiVec4 zi_vec4a_to_vec4(ZiVec4A v) {
+    return (ZiVec4){ v.x, v.y, v.z, v.w };
+}
+
+static inline ZiQuatA zi_quata_from_quat(ZiQuat q) {
+    return (ZiQuatA){ q.x, q.y, q.z, q.w };
+}
+
+static inline ZiQuat zi_quata_to_quat(ZiQuatA q) {
+    return (ZiQuat){ q.x, q.y, q.z, q.w };
+}
+
+static inline ZiMat4A zi_mat4a_from_mat4(const ZiMat4* m) {
+    ZiMat4A result;
+    for (i32 i = 0; i < 16; i++) {
+        result.m[i] = m->m[i];
+    }
+    return result;
+}
+
+static inline ZiMat4 zi_mat4a_to_mat4(const ZiMat4A* m) {
+    ZiMat4 result;
+    for (i32 i = 0; i < 16; i++) {
+        result.m[i] = m->m[i];
+    }
+    return result;
+}
+
+static inline ZiMat4A zi_mat4a_mul(const ZiMat4A* a, const ZiMat4A* b) {
+#if ZI_MATH_USE_SIMD
+    ZiMat4A result;
+    _zi_simd_mat4_mul(result.m, a->m, b->m);
+    return result;
+#else
+    ZiMat4 ua = zi_mat4a_to_mat4(a);
+    ZiMat4 ub = zi_mat4a_to_mat4(b);
+    ZiMat4 result = zi_mat4_mul_scalar(&ua, &ub);
+    return zi_mat4a_from_mat4(&result);
+#endif
+}
+
+static inline ZiVec4A zi_mat4a_mul_vec4a(const ZiMat4A* m, ZiVec4A v) {
+#if ZI_MATH_USE_SIMD
+    ZiVec4A result;
+    _zi_simd_store(&result.x, _zi_simd_mat4_mul_vec4(m->m, _zi_simd_set(v.x, v.y, v.z, v.w)));
+    return result;
+#else
+    ZiMat4 um = zi_mat4a_to_mat4(m);
+    return zi_vec4a_from_vec4(zi_mat4_mul_vec4_scalar(&um, zi_vec4a_to_vec4(v)));
+#endif
+}
+
+static inline ZiMat4A zi_mat4a_transpose(const ZiMat4A* m) {
+#if ZI_MATH_USE_SIMD
+    ZiMat4A result;
+    _zi_simd_mat4_transpose(result.m, m->m);
+    return result;
+#else
+    ZiMat4 um = zi_mat4a_to_mat4(m);
+    ZiMat4 result = zi_mat4_transpose_scalar(&um);
+    return zi_mat4a_from_mat4(&result);
+#endif
+}
+
+static inline ZiMat4A zi_mat4a_inverse(const ZiMat4A* m) {
+#if ZI_MATH_USE_SIMD && defined(ZI_MATH_SSE)
+    ZiMat4A result;
+    if (_zi_simd_mat4_inverse(result.m, m->m)) {
+        return result;
+    }
+    ZiMat4 identity = zi_mat4_identity();
+    return zi_mat4a_from_mat4(&identity);
+#else
+    ZiMat4 um = zi_mat4a_to_mat4(m);
+    ZiMat4 result = zi_mat4_inverse_scalar(&um);
+    return zi_mat4a_from_mat4(&result);
+#endif
+}
+
+static inline ZiQuatA zi_quata_mul(ZiQuatA a, ZiQuatA b) {
+#if ZI_MATH_USE_SIMD
+    ZiQuatA result;
+    _zi_simd_store(&result.x, _zi_simd_quat_mul(_zi_simd_set(a.x, a.y, a.z, a.w), _zi_simd_set(b.x, b.y, b.z, b.w)));
+    return result;
+#else
+    return zi_quata_from_quat(zi_quat_mul_scalar(zi_quata_to_quat(a), zi_quata_to_quat(b)));
+#endif
+}
+
 // ============================================================================
 // Geometric Primitives
 // ============================================================================
@@ -1515,6 +2333,23 @@ static inline ZiAABB zi_aabb_expand(ZiAABB b, ZiVec3 point) {
     };
 }
 
+// min above max, the identity for zi_aabb_union and zi_aabb_expand
+static inline ZiAABB zi_aabb_empty(void) {
+    return (ZiAABB){ zi_vec3(F32_MAX, F32_MAX, F32_MAX), zi_vec3(F32_LOW, F32_LOW, F32_LOW) };
+}
+
+static inline ZiAABB zi_aabb_union(ZiAABB a, ZiAABB b) {
+    return (ZiAABB){
+        zi_vec3(zi_min_f32(a.min.x, b.min.x), zi_min_f32(a.min.y, b.min.y), zi_min_f32(a.min.z, b.min.z)),
+        zi_vec3(zi_max_f32(a.max.x, b.max.x), zi_max_f32(a.max.y, b.max.y), zi_max_f32(a.max.z, b.max.z))
+    };
+}
+
+static inline f32 zi_aabb_surface_area(ZiAABB b) {
+    ZiVec3 d = zi_vec3_sub(b.max, b.min);
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
 static inline i32 zi_aabb_contains_point(ZiAABB b, ZiVec3 point) {
     return point.x >= b.min.x && point.x <= b.max.x &&
            point.y >= b.min.y && point.y <= b.max.y &&
@@ -1609,38 +2444,22 @@ typedef struct ZiFrustum {
     ZiPlane planes[6]; // Left, Right, Bottom, Top, Near, Far
 } ZiFrustum;
 
-static inline ZiFrustum zi_frustum_from_mat4(const ZiMat4* vp) {
+// Gribb-Hartmann: a point is inside when -w <= x, y, z <= w in clip space, so each plane is row 3
+// plus or minus row 0, 1 or 2 of the view projection. ZiPlane keeps the negated w as its distance.
+static inline ZiFrustum zi_frustum_from_mat4_scalar(const ZiMat4* vp) {
     ZiFrustum f;
-    // Left
-    f.planes[0].normal.x = zi_mat4_at(vp, 0, 3) + zi_mat4_at(vp, 0, 0);
-    f.planes[0].normal.y = zi_mat4_at(vp, 1, 3) + zi_mat4_at(vp, 1, 0);
-    f.planes[0].normal.z = zi_mat4_at(vp, 2, 3) + zi_mat4_at(vp, 2, 0);
-    f.planes[0].distance = zi_mat4_at(vp, 3, 3) + zi_mat4_at(vp, 3, 0);
-    // Right
-    f.planes[1].normal.x = zi_mat4_at(vp, 0, 3) - zi_mat4_at(vp, 0, 0);
-    f.planes[1].normal.y = zi_mat4_at(vp, 1, 3) - zi_mat4_at(vp, 1, 0);
-    f.planes[1].normal.z = zi_mat4_at(vp, 2, 3) - zi_mat4_at(vp, 2, 0);
-    f.planes[1].distance = zi_mat4_at(vp, 3, 3) - zi_mat4_at(vp, 3, 0);
-    // Bottom
-    f.planes[2].normal.x = zi_mat4_at(vp, 0, 3) + zi_mat4_at(vp, 0, 1);
-    f.planes[2].normal.y = zi_mat4_at(vp, 1, 3) + zi_mat4_at(vp, 1, 1);
-    f.planes[2].normal.z = zi_mat4_at(vp, 2, 3) + zi_mat4_at(vp, 2, 1);
-    f.planes[2].distance = zi_mat4_at(vp, 3, 3) + zi_mat4_at(vp, 3, 1);
-    // Top
-    f.planes[3].normal.x = zi_mat4_at(vp, 0, 3) - zi_mat4_at(vp, 0, 1);
-    f.planes[3].normal.y = zi_mat4_at(vp, 1, 3) - zi_mat4_at(vp, 1, 1);
-    f.planes[3].normal.z = zi_mat4_at(vp, 2, 3) - zi_mat4_at(vp, 2, 1);
-    f.planes[3].distance = zi_mat4_at(vp, 3, 3) - zi_mat4_at(vp, 3, 1);
-    // Near
-    f.planes[4].normal.x = zi_mat4_at(vp, 0, 3) + zi_mat4_at(vp, 0, 2);
-    f.planes[4].normal.y = zi_mat4_at(vp, 1, 3) + zi_mat4_at(vp, 1, 2);
-    f.planes[4].normal.z = zi_mat4_at(vp, 2, 3) + zi_mat4_at(vp, 2, 2);
-    f.planes[4].distance = zi_mat4_at(vp, 3, 3) + zi_mat4_at(vp, 3, 2);
-    // Far
-    f.planes[5].normal.x = zi_mat4_at(vp, 0, 3) - zi_mat4_at(vp, 0, 2);
-    f.planes[5].normal.y = zi_mat4_at(vp, 1, 3) - zi_mat4_at(vp, 1, 2);
-    f.planes[5].normal.z = zi_mat4_at(vp, 2, 3) - zi_mat4_at(vp, 2, 2);
-    f.planes[5].distance = zi_mat4_at(vp, 3, 3) - zi_mat4_at(vp, 3, 2);
+    for (i32 i = 0; i < 3; i++) {
+        ZiPlane* plus = &f.planes[i * 2];     // Left, Bottom, Near
+        ZiPlane* minus = &f.planes[i * 2 + 1]; // Right, Top, Far
+        plus->normal.x = zi_mat4_at(vp, 3, 0) + zi_mat4_at(vp, i, 0);
+        plus->normal.y = zi_mat4_at(vp, 3, 1) + zi_mat4_at(vp, i, 1);
+        plus->normal.z = zi_mat4_at(vp, 3, 2) + zi_mat4_at(vp, i, 2);
+        plus->distance = -(zi_mat4_at(vp, 3, 3) + zi_mat4_at(vp, i, 3));
+        minus->normal.x = zi_mat4_at(vp, 3, 0) - zi_mat4_at(vp, i, 0);
+        minus->normal.y = zi_mat4_at(vp, 3, 1) - zi_mat4_at(vp, i, 1);
+        minus->normal.z = zi_mat4_at(vp, 3, 2) - zi_mat4_at(vp, i, 2);
+        minus->distance = -(zi_mat4_at(vp, 3, 3) - zi_mat4_at(vp, i, 3));
+    }
 
     // Normalize all planes
     for (i32 i = 0; i < 6; i++) {
@@ -1653,6 +2472,27 @@ static inline ZiFrustum zi_frustum_from_mat4(const ZiMat4* vp) {
     return f;
 }
 
+#if ZI_MATH_HAS_SIMD
+static inline ZiFrustum zi_frustum_from_mat4_simd(const ZiMat4* vp) {
+    f32 planes[24];
+    _zi_simd_frustum_planes(planes, vp->m);
+    ZiFrustum f;
+    for (i32 i = 0; i < 6; i++) {
+        f.planes[i].normal = zi_vec3(planes[i * 4], planes[i * 4 + 1], planes[i * 4 + 2]);
+        f.planes[i].distance = planes[i * 4 + 3];
+    }
+    return f;
+}
+#endif
+
+static inline ZiFrustum zi_frustum_from_mat4(const ZiMat4* vp) {
+#if ZI_MATH_USE_SIMD
+    return zi_frustum_from_mat4_simd(vp);
+#else
+    return zi_frustum_from_mat4_scalar(vp);
+#endif
+}
+
 // ============================================================================
 // Intersection Tests
 // ============================================================================
@@ -1951,6 +2791,21 @@ static inline ZiMat4 zi_mat4_compose(ZiVec3 translation, ZiQuat rotation, ZiVec3
     return zi_mat4_mul(&t, &rs);
 }
 
+// T * R * S like zi_mat4_compose, without the constant last row
+static inline ZiMat34 zi_mat34_compose(ZiVec3 translation, ZiQuat rotation, ZiVec3 scale) {
+    ZiMat4 r = zi_quat_to_mat4(rotation);
+    ZiMat34 m;
+    for (i32 row = 0; row < 3; row++) {
+        zi_mat34_set(&m, row, 0, zi_mat4_at(&r, row, 0) * scale.x);
+        zi_mat34_set(&m, row, 1, zi_mat4_at(&r, row, 1) * scale.y);
+        zi_mat34_set(&m, row, 2, zi_mat4_at(&r, row, 2) * scale.z);
+    }
+    zi_mat34_set(&m, 0, 3, translation.x);
+    zi_mat34_set(&m, 1, 3, translation.y);
+    zi_mat34_set(&m, 2, 3, translation.z);
+    return m;
+}
+
 // ============================================================================
 // Spline Interpolation
 // ============================================================================
@@ -4,8 +4,177 @@
 #include "zi_graphics.h"
 
 
+typedef struct ZiConsoleChunk {
+	const char* data;
+	u32         size;
+} ZiConsoleChunk;
+
 // Time
+// monotonic, unaffected by wall clock changes; ticks are only meaningful relative to each other
+u64               zi_platform_get_ticks(void);
+u64               zi_platform_get_tick_frequency(void);
+// seconds since an arbitrary point, same clock as the ticks
 f64               zi_platform_get_time(void);
+// sleeps until zi_platform_get_ticks() >= ticks, returns immediately if that already passed
+void              zi_platform_sleep_until(u64 ticks);
 void              zi_platform_console_log(const char* message, i32 len, u8 error);
+void              zi_platform_console_log_batch(const ZiConsoleChunk* chunks, u32 count, u8 error);
 i32               zi_platform_get_timestamp(char* buf, i32 buf_size);
+u64               zi_platform_get_wall_clock_us(void);
+i32               zi_platform_format_timestamp(u64 wall_clock_us, char* buf, i32 buf_size);
 ZiGraphicsBackend zi_platform_get_graphics_backend(ZiGraphicsBackend backend);
+// true when running without a window, either the headless build or a desktop build started with --headless
+ZiBool            zi_platform_is_headless(void);
+
+// CPU features
+enum ZiCpuFeature_ {
+	ZiCpuFeature_SSE2     = 1 << 0,
+	ZiCpuFeature_SSE3     = 1 << 1,
+	ZiCpuFeature_SSSE3    = 1 << 2,
+	ZiCpuFeature_SSE41    = 1 << 3,
+	ZiCpuFeature_SSE42    = 1 << 4,
+	ZiCpuFeature_POPCNT   = 1 << 5,
+	ZiCpuFeature_AVX      = 1 << 6,
+	ZiCpuFeature_AVX2     = 1 << 7,
+	ZiCpuFeature_FMA      = 1 << 8,
+	ZiCpuFeature_F16C     = 1 << 9,
+	ZiCpuFeature_BMI1     = 1 << 10,
+	ZiCpuFeature_BMI2     = 1 << 11,
+	ZiCpuFeature_AVX512F  = 1 << 12,
+	ZiCpuFeature_AVX512DQ = 1 << 13,
+	ZiCpuFeature_AVX512BW = 1 << 14,
+	ZiCpuFeature_AVX512VL = 1 << 15,
+	ZiCpuFeature_NEON     = 1 << 16,
+};
+
+typedef u32 ZiCpuFeatures;
+
+// One implementation of a kernel and the features it needs. Tables are ordered best first
+// and end with a portable entry that requires nothing. Kernels resolve on their first call:
+//
+//   static void sum_resolve(const f32* v, u32 n, f32* out);
+//   static void (*sum_impl)(const f32* v, u32 n, f32* out) = sum_resolve;
+//   static void sum_resolve(const f32* v, u32 n, f32* out) {
+//       static const ZiCpuDispatch table[] = {{ZiCpuFeature_AVX2 | ZiCpuFeature_FMA, sum_avx2}, {0, sum_scalar}};
+//       sum_impl = zi_platform_cpu_dispatch(table, 2);
+//       sum_impl(v, n, out);
+//   }
+typedef struct ZiCpuDispatch {
+	ZiCpuFeatures required;
+	VoidPtr       function;
+} ZiCpuDispatch;
+
+// detected once, AVX and AVX-512 are only reported when the OS saves their registers
+ZiCpuFeatures     zi_platform_cpu_features(void);
+// hides features from zi_platform_cpu_features and the dispatch, to test or benchmark the fallbacks.
+// Calls every registered reset so kernels that already resolved pick again on their next call.
+// Not meant to race with calls into those kernels.
+void              zi_platform_set_cpu_features_mask(ZiCpuFeatures mask);
+i32               zi_platform_format_cpu_features(ZiCpuFeatures features, char* buf, i32 buf_size);
+// first entry whose requirements are all available
+VoidPtr           zi_platform_cpu_dispatch(const ZiCpuDispatch* table, u32 count);
+
+typedef void (*ZiCpuDispatchResetFn)(void);
+
+// A module that caches dispatched functions registers one function pointing them back at their
+// resolvers. Registering the same function again is a no-op, up to ZI_CPU_DISPATCH_MAX_RESETS
+// functions are kept.
+#define ZI_CPU_DISPATCH_MAX_RESETS 32
+void              zi_platform_cpu_dispatch_register_reset(ZiCpuDispatchResetFn reset);
+
+// Threads
+ZI_HANDLER(ZiThreadHandle);
+ZI_HANDLER(ZiSemaphoreHandle);
+
+typedef void (*ZiThreadFn)(VoidPtr user_data);
+
+// The web build has no threads, create returns an empty handle that join accepts and semaphores
+// never block.
+ZiThreadHandle    zi_platform_thread_create(ZiThreadFn fn, VoidPtr user_data, const char* name);
+void              zi_platform_thread_join(ZiThreadHandle thread);
+void              zi_platform_thread_yield(void);
+ZiSemaphoreHandle zi_platform_semaphore_create(u32 initial_count);
+void              zi_platform_semaphore_destroy(ZiSemaphoreHandle semaphore);
+void              zi_platform_semaphore_post(ZiSemaphoreHandle semaphore);
+// returns ZI_FALSE on timeout
+ZiBool            zi_platform_semaphore_wait(ZiSemaphoreHandle semaphore, u32 timeout_ms);
+
+// Called on fatal signals / unhandled exceptions before the process dies,
+// the handler must not allocate or take locks.
+typedef void (*ZiCrashHandlerFn)(void);
+void zi_platform_set_crash_handler(ZiCrashHandlerFn handler);
+
+// File mapping
+enum ZiFileMapFlags_ {
+	ZiFileMapFlags_None       = 0,
+	ZiFileMapFlags_Sequential = 1 << 0, // aggressive read-ahead, pages behind the cursor may be dropped early
+	ZiFileMapFlags_Random     = 1 << 1, // disable read-ahead
+	ZiFileMapFlags_WillNeed   = 1 << 2, // start paging the whole file in asynchronously
+	ZiFileMapFlags_HugePage   = 1 << 3  // back the mapping with huge pages when the OS supports it
+};
+
+typedef u32 ZiFileMapFlags;
+
+typedef struct ZiMappedFile {
+	const u8* data;
+	u64       size;
+} ZiMappedFile;
+
+// Maps a whole file read-only. Empty files succeed with data == ZI_NULL.
+ZiBool zi_platform_map_file(const char* path, ZiFileMapFlags flags, ZiMappedFile* file);
+void   zi_platform_unmap_file(ZiMappedFile* file);
+
+// Range hints, offsets do not need to be page aligned.
+// prefetch starts asynchronous paging of the range so it is resident by the time it is touched,
+// release tells the OS the range is no longer needed and its pages can be reclaimed first.
+void zi_platform_prefetch_mapped_range(const ZiMappedFile* file, u64 offset, u64 size);
+void zi_platform_release_mapped_range(const ZiMappedFile* file, u64 offset, u64 size);
+
+typedef struct ZiWritableMappedFile {
+	u8*     data;
+	u64     size;
+	VoidPtr handle;
+} ZiWritableMappedFile;
+
+// Creates or truncates path, preallocates size bytes and maps them shared read-write.
+// Written bytes live in the page cache, so they reach the file even if the process dies.
+ZiBool zi_platform_create_mapped_file(const char* path, u64 size, ZiWritableMappedFile* file);
+// Starts writeback of the range without waiting for it
+void   zi_platform_flush_mapped_file(const ZiWritableMappedFile* file, u64 offset, u64 size);
+// Unmaps and cuts the file down to used_size bytes
+void   zi_platform_close_mapped_file(ZiWritableMappedFile* file, u64 used_size);
+ZiBool zi_platform_rename_file(const char* from, const char* to);
+
+// File watching
+#define ZI_FILE_WATCH_MAX_PATH 512
+// events for one path are merged until it has been quiet this long, editors touch a file several times per save
+#define ZI_FILE_WATCH_SETTLE_MS 100
+
+enum ZiFileChange_ {
+	ZiFileChange_Created  = 1,
+	ZiFileChange_Modified = 2,
+	ZiFileChange_Deleted  = 3,
+	// the OS dropped events, everything under the watched directory has to be rescanned
+	ZiFileChange_Overflow = 4,
+};
+
+typedef u8 ZiFileChange;
+
+typedef struct ZiFileChangeEvent {
+	ZiFileChange change;
+	// relative to the watched directory with '/' separators
+	char         path[ZI_FILE_WATCH_MAX_PATH];
+} ZiFileChangeEvent;
+
+ZI_HANDLER(ZiFileWatchHandle);
+
+// Watches the files under directory from a background thread. Only files are reported, except for
+// directories moved or deleted as a whole which are reported once as Deleted with their own path.
+// A file created and deleted again within the settle time produces no event, one deleted and
+// recreated produces Modified. A file renamed over another one is reported as Created.
+// Only supported on Linux (inotify). Elsewhere create logs an error and returns an empty handle,
+// which destroy accepts and poll answers with ZI_FALSE.
+ZiFileWatchHandle zi_platform_file_watch_create(const char* directory, ZiBool recursive);
+void              zi_platform_file_watch_destroy(ZiFileWatchHandle handle);
+// never blocks, returns false once the queue is empty. Events have to be polled from a single thread.
+ZiBool            zi_platform_file_watch_poll(ZiFileWatchHandle handle, ZiFileChangeEvent* event);
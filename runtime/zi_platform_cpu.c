@@ -0,0 +1,244 @@
+#include "zi_platform.h"
+
+#include "zi_atomic.h"
+#include "zi_common.h"
+#include "zi_log.h"
+
+#include <stdio.h>
+
+#if ZI_ARCH_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#if defined(ZI_MACOS)
+#include <sys/sysctl.h>
+#endif
+#elif defined(ZI_LINUX) && (ZI_ARCH_ARM64 || ZI_ARCH_ARM)
+#include <sys/auxv.h>
+#endif
+
+// detection runs per architecture, the OS only matters for the pieces that need kernel support
+
+#define ZI_CPU_FEATURES_UNKNOWN 0xffffffffu
+
+static u32 detected_features = ZI_CPU_FEATURES_UNKNOWN;
+static u32 features_mask = ZI_CPU_FEATURES_UNKNOWN;
+
+// guarded by dispatch_resets_lock, registration only happens from resolvers and is rare
+static ZiCpuDispatchResetFn dispatch_resets[ZI_CPU_DISPATCH_MAX_RESETS];
+static u32                  dispatch_reset_count = 0;
+static u32                  dispatch_resets_lock = 0;
+
+static void zi_cpu_dispatch_lock(void) {
+	while (zi_atomic_exchange_u32(&dispatch_resets_lock, 1)) {
+		zi_atomic_pause();
+	}
+}
+
+static void zi_cpu_dispatch_unlock(void) {
+	zi_atomic_store_release_u32(&dispatch_resets_lock, 0);
+}
+
+#if ZI_ARCH_X86
+
+static void zi_cpuid(u32 leaf, u32 subleaf, u32 regs[4]) {
+#if defined(_MSC_VER)
+	__cpuidex((int*)regs, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static u64 zi_xgetbv(u32 index) {
+#if defined(_MSC_VER)
+	return _xgetbv(index);
+#else
+	u32 lo, hi;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(index));
+	return ((u64)hi << 32) | lo;
+#endif
+}
+
+static ZiCpuFeatures zi_cpu_detect(void) {
+	ZiCpuFeatures features = 0;
+	u32 regs[4];
+
+	zi_cpuid(0, 0, regs);
+	u32 max_leaf = regs[0];
+	if (max_leaf < 1) {
+		return 0;
+	}
+
+	zi_cpuid(1, 0, regs);
+	u32 ecx = regs[2];
+	u32 edx = regs[3];
+
+	if (edx & (1u << 26)) features |= ZiCpuFeature_SSE2;
+	if (ecx & (1u << 0)) features |= ZiCpuFeature_SSE3;
+	if (ecx & (1u << 9)) features |= ZiCpuFeature_SSSE3;
+	if (ecx & (1u << 19)) features |= ZiCpuFeature_SSE41;
+	if (ecx & (1u << 20)) features |= ZiCpuFeature_SSE42;
+	if (ecx & (1u << 23)) features |= ZiCpuFeature_POPCNT;
+
+	// AVX state has to be enabled by the OS too, otherwise the first ymm instruction faults
+	ZiBool os_avx = ZI_FALSE;
+	ZiBool os_avx512 = ZI_FALSE;
+	if ((ecx & (1u << 27)) && (ecx & (1u << 28))) {
+		u64 xcr0 = zi_xgetbv(0);
+		os_avx = (xcr0 & 0x6) == 0x6;
+		os_avx512 = os_avx && (xcr0 & 0xe0) == 0xe0;
+	}
+
+	if (os_avx) {
+		features |= ZiCpuFeature_AVX;
+		if (ecx & (1u << 12)) features |= ZiCpuFeature_FMA;
+		if (ecx & (1u << 29)) features |= ZiCpuFeature_F16C;
+	}
+
+	if (max_leaf >= 7) {
+		zi_cpuid(7, 0, regs);
+		u32 ebx = regs[1];
+
+		if (ebx & (1u << 3)) features |= ZiCpuFeature_BMI1;
+		if (ebx & (1u << 8)) features |= ZiCpuFeature_BMI2;
+		if (os_avx && (ebx & (1u << 5))) features |= ZiCpuFeature_AVX2;
+
+#if defined(ZI_MACOS)
+		// macOS enables the AVX-512 state lazily on first use, XCR0 doesn't show it up front
+		i32    has_avx512 = 0;
+		size_t size = sizeof(has_avx512);
+		if (sysctlbyname("hw.optional.avx512f", &has_avx512, &size, ZI_NULL, 0) == 0 && has_avx512) {
+			os_avx512 = os_avx;
+		}
+#endif
+
+		if (os_avx512 && (ebx & (1u << 16))) {
+			features |= ZiCpuFeature_AVX512F;
+			if (ebx & (1u << 17)) features |= ZiCpuFeature_AVX512DQ;
+			if (ebx & (1u << 30)) features |= ZiCpuFeature_AVX512BW;
+			if (ebx & (1u << 31)) features |= ZiCpuFeature_AVX512VL;
+		}
+	}
+
+	return features;
+}
+
+#elif ZI_ARCH_ARM64 || ZI_ARCH_ARM
+
+static ZiCpuFeatures zi_cpu_detect(void) {
+#if defined(ZI_LINUX)
+	u64 hwcap = getauxval(AT_HWCAP);
+#if ZI_ARCH_ARM64
+	// HWCAP_ASIMD
+	return (hwcap & (1u << 1)) ? ZiCpuFeature_NEON : 0;
+#else
+	// HWCAP_NEON
+	return (hwcap & (1u << 12)) ? ZiCpuFeature_NEON : 0;
+#endif
+#elif ZI_ARCH_ARM64
+	// Advanced SIMD is mandatory on every arm64 target we ship (Apple silicon, Windows on ARM)
+	return ZiCpuFeature_NEON;
+#else
+	return 0;
+#endif
+}
+
+#else
+
+static ZiCpuFeatures zi_cpu_detect(void) {
+	return 0;
+}
+
+#endif
+
+ZiCpuFeatures zi_platform_cpu_features(void) {
+	u32 features = zi_atomic_load_relaxed_u32(&detected_features);
+	if (features == ZI_CPU_FEATURES_UNKNOWN) {
+		// racing threads compute the same value
+		features = zi_cpu_detect();
+		zi_atomic_store_relaxed_u32(&detected_features, features);
+	}
+	return features & zi_atomic_load_relaxed_u32(&features_mask);
+}
+
+void zi_platform_set_cpu_features_mask(ZiCpuFeatures mask) {
+	zi_atomic_store_relaxed_u32(&features_mask, mask);
+
+	zi_cpu_dispatch_lock();
+	for (u32 i = 0; i < dispatch_reset_count; ++i) {
+		dispatch_resets[i]();
+	}
+	zi_cpu_dispatch_unlock();
+}
+
+i32 zi_platform_format_cpu_features(ZiCpuFeatures features, char* buf, i32 buf_size) {
+	static const struct {
+		ZiCpuFeatures feature;
+		const char*   name;
+	} names[] = {
+		{ZiCpuFeature_SSE2, "sse2"},
+		{ZiCpuFeature_SSE3, "sse3"},
+		{ZiCpuFeature_SSSE3, "ssse3"},
+		{ZiCpuFeature_SSE41, "sse4.1"},
+		{ZiCpuFeature_SSE42, "sse4.2"},
+		{ZiCpuFeature_POPCNT, "popcnt"},
+		{ZiCpuFeature_AVX, "avx"},
+		{ZiCpuFeature_AVX2, "avx2"},
+		{ZiCpuFeature_FMA, "fma"},
+		{ZiCpuFeature_F16C, "f16c"},
+		{ZiCpuFeature_BMI1, "bmi1"},
+		{ZiCpuFeature_BMI2, "bmi2"},
+		{ZiCpuFeature_AVX512F, "avx512f"},
+		{ZiCpuFeature_AVX512DQ, "avx512dq"},
+		{ZiCpuFeature_AVX512BW, "avx512bw"},
+		{ZiCpuFeature_AVX512VL, "avx512vl"},
+		{ZiCpuFeature_NEON, "neon"},
+	};
+
+	if (buf_size <= 0) {
+		return 0;
+	}
+
+	buf[0] = '\0';
+	i32 len = 0;
+	for (u32 i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+		if (!(features & names[i].feature)) continue;
+
+		i32 written = snprintf(buf + len, buf_size - len, len > 0 ? " %s" : "%s", names[i].name);
+		if (written < 0 || written >= buf_size - len) {
+			buf[len] = '\0';
+			break;
+		}
+		len += written;
+	}
+	return len;
+}
+
+VoidPtr zi_platform_cpu_dispatch(const ZiCpuDispatch* table, u32 count) {
+	ZiCpuFeatures features = zi_platform_cpu_features();
+	for (u32 i = 0; i < count; ++i) {
+		if ((table[i].required & features) == table[i].required) {
+			return table[i].function;
+		}
+	}
+	return ZI_NULL;
+}
+
+void zi_platform_cpu_dispatch_register_reset(ZiCpuDispatchResetFn reset) {
+	zi_cpu_dispatch_lock();
+	u32 i = 0;
+	while (i < dispatch_reset_count && dispatch_resets[i] != reset) {
+		++i;
+	}
+	ZiBool full = i == ZI_CPU_DISPATCH_MAX_RESETS;
+	if (i == dispatch_reset_count && !full) {
+		dispatch_resets[dispatch_reset_count++] = reset;
+	}
+	zi_cpu_dispatch_unlock();
+
+	if (full) {
+		zi_log_error("cpu dispatch: more than %d reset functions, later ones ignore the features mask", ZI_CPU_DISPATCH_MAX_RESETS);
+	}
+}
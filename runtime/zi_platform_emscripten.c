@@ -1,19 +1,36 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_Platform
+
 #include "zi_platform.h"
 #include "zi_common.h"
+#include "zi_core.h"
+#include "zi_log.h"
 
 #ifdef ZI_EMSCRIPTEN
 
 #include <emscripten/emscripten.h>
 #include <emscripten/html5.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
 
 
+u64 zi_platform_get_ticks(void) {
+	return (u64)(emscripten_get_now() * 1000.0);
+}
+
+u64 zi_platform_get_tick_frequency(void) {
+	return 1000000ull;
+}
+
 f64 zi_platform_get_time(void) {
 	return emscripten_get_now() / 1000.0;
 }
 
+void zi_platform_sleep_until(u64 ticks) {
+	// the browser drives the frame rate through requestAnimationFrame, blocking here would stall it
+}
+
 void zi_platform_console_log(const char* message, i32 len, u8 error) {
 	if (error) {
 		emscripten_console_error(message);
@@ -22,26 +39,168 @@ void zi_platform_console_log(const char* message, i32 len, u8 error) {
 	}
 }
 
-i32 zi_platform_get_timestamp(char* buf, i32 buf_size) {
+void zi_platform_console_log_batch(const ZiConsoleChunk* chunks, u32 count, u8 error) {
+	// the console API wants null terminated strings
+	char buffer[4096];
+	u32  used = 0;
+	for (u32 i = 0; i < count; ++i) {
+		u32 copy = chunks[i].size < sizeof(buffer) - 1 - used ? chunks[i].size : (u32)sizeof(buffer) - 1 - used;
+		memcpy(buffer + used, chunks[i].data, copy);
+		used += copy;
+	}
+	buffer[used] = 0;
+	zi_platform_console_log(buffer, (i32)used, error);
+}
+
+u64 zi_platform_get_wall_clock_us(void) {
 	struct timeval tv;
 	gettimeofday(&tv, NULL);
+	return (u64)tv.tv_sec * 1000000ull + (u64)tv.tv_usec;
+}
+
+i32 zi_platform_format_timestamp(u64 wall_clock_us, char* buf, i32 buf_size) {
+	time_t seconds = (time_t)(wall_clock_us / 1000000ull);
 
 	struct tm tm_info;
-	localtime_r(&tv.tv_sec, &tm_info);
+	localtime_r(&seconds, &tm_info);
 
-	i32 ms = tv.tv_usec / 1000;
+	i32 ms = (i32)((wall_clock_us / 1000ull) % 1000ull);
 	return snprintf(buf, buf_size, "%04d-%02d-%02d %02d:%02d:%02d:%03d",
 	                tm_info.tm_year + 1900, tm_info.tm_mon + 1, tm_info.tm_mday,
 	                tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec, ms);
 }
 
+i32 zi_platform_get_timestamp(char* buf, i32 buf_size) {
+	return zi_platform_format_timestamp(zi_platform_get_wall_clock_us(), buf, buf_size);
+}
+
+void zi_platform_set_crash_handler(ZiCrashHandlerFn handler) {
+}
+
 ZiGraphicsBackend zi_platform_get_graphics_backend(ZiGraphicsBackend backend) {
 	return ZiGraphicsBackend_WebGPU;
 }
 
-void zi_app_init();
+ZiBool zi_platform_is_headless(void) {
+	return ZI_FALSE;
+}
+
+// File mapping, there is no real mmap on the web so the file is copied into the wasm heap
+ZiBool zi_platform_map_file(const char* path, ZiFileMapFlags flags, ZiMappedFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+
+	FILE* fp = fopen(path, "rb");
+	if (!fp) {
+		zi_log_error("failed to open %s", path);
+		return ZI_FALSE;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	if (size <= 0) {
+		fclose(fp);
+		return ZI_TRUE;
+	}
+
+	u8* data = zi_mem_alloc((u64)size);
+	if (fread(data, 1, (size_t)size, fp) != (size_t)size) {
+		zi_log_error("failed to read %s", path);
+		zi_mem_free(data);
+		fclose(fp);
+		return ZI_FALSE;
+	}
+	fclose(fp);
+
+	file->data = data;
+	file->size = (u64)size;
+	return ZI_TRUE;
+}
+
+void zi_platform_unmap_file(ZiMappedFile* file) {
+	if (file->data) {
+		zi_mem_free((VoidPtr)file->data);
+	}
+	file->data = ZI_NULL;
+	file->size = 0;
+}
+
+void zi_platform_prefetch_mapped_range(const ZiMappedFile* file, u64 offset, u64 size) {
+}
+
+void zi_platform_release_mapped_range(const ZiMappedFile* file, u64 offset, u64 size) {
+}
+
+ZiBool zi_platform_create_mapped_file(const char* path, u64 size, ZiWritableMappedFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->handle = ZI_NULL;
+	zi_log_error("writable mapped files are not supported on the web, can't create %s", path);
+	return ZI_FALSE;
+}
+
+void zi_platform_flush_mapped_file(const ZiWritableMappedFile* file, u64 offset, u64 size) {
+}
+
+void zi_platform_close_mapped_file(ZiWritableMappedFile* file, u64 used_size) {
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->handle = ZI_NULL;
+}
+
+ZiBool zi_platform_rename_file(const char* from, const char* to) {
+	return rename(from, to) == 0;
+}
+
+// File watching
+// the web build has no file system to watch
+ZiFileWatchHandle zi_platform_file_watch_create(const char* directory, ZiBool recursive) {
+	zi_log_error("file watching is not supported on this platform");
+	return (ZiFileWatchHandle){0};
+}
+
+void zi_platform_file_watch_destroy(ZiFileWatchHandle handle) {
+}
+
+ZiBool zi_platform_file_watch_poll(ZiFileWatchHandle handle, ZiFileChangeEvent* event) {
+	return ZI_FALSE;
+}
+
+// Threads
+// no worker threads on the web build, creating one fails and callers do the work themselves
+ZiThreadHandle zi_platform_thread_create(ZiThreadFn fn, VoidPtr user_data, const char* name) {
+	return (ZiThreadHandle){0};
+}
+
+void zi_platform_thread_join(ZiThreadHandle handle) {
+}
+
+void zi_platform_thread_yield(void) {
+}
+
+// nothing could post from another thread, waits time out straight away
+ZiSemaphoreHandle zi_platform_semaphore_create(u32 initial_count) {
+	return (ZiSemaphoreHandle){0};
+}
+
+void zi_platform_semaphore_destroy(ZiSemaphoreHandle handle) {
+}
+
+void zi_platform_semaphore_post(ZiSemaphoreHandle handle) {
+}
+
+ZiBool zi_platform_semaphore_wait(ZiSemaphoreHandle handle, u32 timeout_ms) {
+	return ZI_FALSE;
+}
+
+#include "zi_app.h"
+
+void zi_app_init(const ZiAppSettings* settings);
 void zi_app_loop();
 void zi_app_terminate();
+void zi_bootstrap(ZiAppSettings* settings);
 
 static void zi_web_loop(void *user_data) {
 	zi_app_loop();
@@ -52,7 +211,10 @@ static void zi_web_app_shutdown() {
 }
 
 int main(void) {
-	zi_app_init();
+	ZiAppSettings settings = {0};
+	zi_bootstrap(&settings);
+
+	zi_app_init(&settings);
 	atexit(zi_web_app_shutdown);
 	emscripten_set_main_loop_arg(zi_web_loop, NULL, 0, 0);
 	return 0;
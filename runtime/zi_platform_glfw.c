@@ -1,6 +1,8 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_Platform
+
 #include "zi_log.h"
 
-#if ZI_DESKTOP
+#if ZI_DESKTOP && !ZI_HEADLESS
 
 
 #ifdef ZI_VULKAN_ENABLED
@@ -11,19 +13,38 @@
 
 #include <GLFW/glfw3.h>
 
+#include <string.h>
+
 #include "zi_app.h"
 #include "zi_graphics.h"
+#include "zi_platform.h"
 
-void zi_app_init();
+void zi_app_init(const ZiAppSettings* settings);
 void zi_app_loop();
 void zi_app_terminate();
+f64  zi_app_get_idle_time();
+void zi_app_set_throttled(ZiBool throttled);
 
 void zi_app_set_app_running(u8 p_is_running);
 void zi_bootstrap(ZiAppSettings* settings);
+i32  zi_platform_run_headless(int argc, char** argv);
 
 
 static GLFWwindow*       main_window;
 static ZiSwapchainHandle swapchain_handle;
+static ZiBool            window_focused = ZI_TRUE;
+static ZiBool            window_iconified = ZI_FALSE;
+static ZiBool            headless = ZI_FALSE;
+
+static void zi_glfw_focus_callback(GLFWwindow* window, int focused) {
+	window_focused = focused == GLFW_TRUE;
+	zi_app_set_throttled(!window_focused || window_iconified);
+}
+
+static void zi_glfw_iconify_callback(GLFWwindow* window, int iconified) {
+	window_iconified = iconified == GLFW_TRUE;
+	zi_app_set_throttled(!window_focused || window_iconified);
+}
 
 
 #ifdef ZI_VULKAN_ENABLED
@@ -35,7 +56,17 @@ static PFN_vkVoidFunction zi_vulkan_loader(VkInstance instance, const char* proc
 
 #endif
 
+ZiBool zi_platform_is_headless(void) {
+	return headless;
+}
+
 i32 zi_platform_run(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--headless") == 0) {
+			headless = ZI_TRUE;
+			return zi_platform_run_headless(argc, argv);
+		}
+	}
 
 #ifdef ZI_VULKAN_ENABLED
 	glfwInitVulkanLoader(zi_vulkan_loader);
@@ -48,10 +79,12 @@ i32 zi_platform_run(int argc, char** argv) {
 	ZiAppSettings settings = {0};
 	zi_bootstrap(&settings);
 
-	zi_app_init();
+	zi_app_init(&settings);
 
 	glfwWindowHint(GLFW_MAXIMIZED, GLFW_TRUE);
 	main_window = glfwCreateWindow(800, 600, settings.title, NULL, NULL);
+	glfwSetWindowFocusCallback(main_window, zi_glfw_focus_callback);
+	glfwSetWindowIconifyCallback(main_window, zi_glfw_iconify_callback);
 
 	ZiSwapchainDesc swapchain_desc;
 	swapchain_desc.window_handle = main_window;
@@ -61,7 +94,13 @@ i32 zi_platform_run(int argc, char** argv) {
 	swapchain_handle = zi_swapchain_create(&swapchain_desc);
 
 	while (zi_app_is_running()) {
-		glfwPollEvents();
+		// block on events instead of spinning when the app has nothing to do until its next frame
+		f64 idle_time = zi_app_get_idle_time();
+		if (idle_time > 0.0) {
+			glfwWaitEventsTimeout(idle_time);
+		} else {
+			glfwPollEvents();
+		}
 
 		if (glfwWindowShouldClose(main_window)) {
 			zi_app_set_app_running(ZI_FALSE);
@@ -86,11 +125,19 @@ void zi_platform_set_vulkan_loader(const PFN_vkGetInstanceProcAddr p_vulkan_load
 	vulkan_loader = p_vulkan_loader;
 }
 
+// glfw is never initialized in --headless runs, the device is created without surface support
 const char** zi_platform_get_required_extensions(u32* count) {
+	if (headless) {
+		*count = 0;
+		return ZI_NULL;
+	}
 	return glfwGetRequiredInstanceExtensions(count);
 }
 
 ZiBool zi_get_physical_device_presentation_support(VkInstance instance, VkPhysicalDevice device, uint32_t queue_family) {
+	if (headless) {
+		return ZI_FALSE;
+	}
 	return glfwGetPhysicalDevicePresentationSupport(instance, device, queue_family);
 }
 
@@ -0,0 +1,146 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_Platform
+
+#include "zi_log.h"
+
+#ifndef ZI_EMSCRIPTEN
+
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zi_app.h"
+#include "zi_platform.h"
+
+// ============================================================================
+// Headless platform, runs the app lifecycle without a window for dedicated servers and CI benchmarks.
+// Linked as the whole platform in zi-runtime-headless (ZI_HEADLESS), desktop builds reach it with --headless.
+//
+//   --gpu          keep the platform graphics backend and render offscreen, the default is ZiGraphicsBackend_Null
+//   --frames N     exit after N frames
+//   --tick-rate N  fixed updates per second, overrides the app setting
+//   --fps N        frame rate cap
+//   --profile PATH write a profiler capture on exit, see ZiAppSettings.profile_path
+// ============================================================================
+
+void zi_app_init(const ZiAppSettings* settings);
+void zi_app_loop();
+void zi_app_terminate();
+f64  zi_app_get_idle_time();
+
+void zi_app_set_app_running(u8 p_is_running);
+void zi_bootstrap(ZiAppSettings* settings);
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void zi_headless_signal_handler(int signal_number) {
+	stop_requested = 1;
+}
+
+i32 zi_platform_run_headless(int argc, char** argv) {
+	ZiBool use_gpu = ZI_FALSE;
+	u64    max_frames = 0;
+	f64    tick_rate = 0.0;
+	f64    target_fps = 0.0;
+	char*  profile_path = ZI_NULL;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--gpu") == 0) {
+			use_gpu = ZI_TRUE;
+		} else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			max_frames = strtoull(argv[++i], ZI_NULL, 10);
+		} else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+			tick_rate = strtod(argv[++i], ZI_NULL);
+		} else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+			target_fps = strtod(argv[++i], ZI_NULL);
+		} else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+			profile_path = argv[++i];
+		}
+	}
+
+	ZiAppSettings settings = {0};
+	zi_bootstrap(&settings);
+
+	if (!use_gpu) {
+		settings.graphics_backend = ZiGraphicsBackend_Null;
+	}
+	if (tick_rate > 0.0) {
+		settings.fixed_timestep = 1.0 / tick_rate;
+	}
+	if (target_fps > 0.0) {
+		settings.target_fps = target_fps;
+	}
+	if (profile_path) {
+		settings.profile_path = profile_path;
+	}
+
+	signal(SIGINT, zi_headless_signal_handler);
+	signal(SIGTERM, zi_headless_signal_handler);
+
+	zi_app_init(&settings);
+
+	u64 frequency = zi_platform_get_tick_frequency();
+	u64 start = zi_platform_get_ticks();
+	u64 frames = 0;
+
+	while (zi_app_is_running()) {
+		if (stop_requested || (max_frames > 0 && frames >= max_frames)) {
+			zi_app_set_app_running(ZI_FALSE);
+			break;
+		}
+
+		// nothing to poll, sleep straight through to the next fixed step
+		f64 idle_time = zi_app_get_idle_time();
+		if (idle_time > 0.0) {
+			zi_platform_sleep_until(zi_platform_get_ticks() + (u64)(idle_time * (f64)frequency));
+		}
+
+		zi_app_loop();
+		frames++;
+	}
+
+	f64 elapsed = (f64)(zi_platform_get_ticks() - start) / (f64)frequency;
+	zi_log_info("headless run finished, %llu frames in %.3f s (%.1f frames/s)",
+	            (unsigned long long)frames, elapsed, elapsed > 0.0 ? (f64)frames / elapsed : 0.0);
+
+	zi_app_terminate();
+
+	return 0;
+}
+
+#if ZI_HEADLESS
+
+ZiBool zi_platform_is_headless(void) {
+	return ZI_TRUE;
+}
+
+i32 zi_platform_run(int argc, char** argv) {
+	return zi_platform_run_headless(argc, argv);
+}
+
+#ifdef ZI_VULKAN_ENABLED
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+
+// no window system, the vulkan device is created for offscreen rendering only
+
+void zi_platform_set_vulkan_loader(const PFN_vkGetInstanceProcAddr p_vulkan_loader) {
+}
+
+const char** zi_platform_get_required_extensions(u32* count) {
+	*count = 0;
+	return ZI_NULL;
+}
+
+ZiBool zi_get_physical_device_presentation_support(VkInstance instance, VkPhysicalDevice device, uint32_t queue_family) {
+	return ZI_FALSE;
+}
+
+void zi_platform_create_surface(VkInstance instance, VoidPtr window_handle, VkSurfaceKHR* surface) {
+	zi_log_error("surfaces are not available on the headless platform");
+	*surface = VK_NULL_HANDLE;
+}
+
+#endif
+#endif
+#endif
@@ -1,33 +1,138 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#define ZI_LOG_CATEGORY ZiLogCategory_Platform
+
 #include "zi_platform.h"
 
 #include "zi_common.h"
+#include "zi_core.h"
+#include "zi_log.h"
 
 #if defined(ZI_LINUX) || defined(ZI_MACOS)
 
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
+#if defined(ZI_LINUX)
+#include <dirent.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#include "zi_atomic.h"
+#include "zi_core.h"
+#include "zi_profiler.h"
+
 
 void zi_platform_console_log(const char* message, i32 len, u8 error) {
 	int fd = error ? STDERR_FILENO : STDOUT_FILENO;
 	write(fd, message, len);
 }
 
-i32 zi_platform_get_timestamp(char* buf, i32 buf_size) {
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
+void zi_platform_console_log_batch(const ZiConsoleChunk* chunks, u32 count, u8 error) {
+	int fd = error ? STDERR_FILENO : STDOUT_FILENO;
+
+	struct iovec iov[64];
+	u32          next = 0;
+
+	while (next < count) {
+		u32 iov_count = 0;
+		while (next < count && iov_count < 64) {
+			iov[iov_count].iov_base = (VoidPtr)chunks[next].data;
+			iov[iov_count].iov_len = chunks[next].size;
+			iov_count++;
+			next++;
+		}
+
+		struct iovec* cursor = iov;
+		while (iov_count > 0) {
+			ssize_t written = writev(fd, cursor, (int)iov_count);
+			if (written < 0) {
+				if (errno == EINTR) continue;
+				return;
+			}
+			while (iov_count > 0 && (size_t)written >= cursor->iov_len) {
+				written -= (ssize_t)cursor->iov_len;
+				cursor++;
+				iov_count--;
+			}
+			if (iov_count > 0) {
+				cursor->iov_base = (u8*)cursor->iov_base + written;
+				cursor->iov_len -= (size_t)written;
+			}
+		}
+	}
+}
+
+u64 zi_platform_get_ticks(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+u64 zi_platform_get_tick_frequency(void) {
+	return 1000000000ull;
+}
+
+f64 zi_platform_get_time(void) {
+	return (f64)zi_platform_get_ticks() / 1000000000.0;
+}
+
+void zi_platform_sleep_until(u64 ticks) {
+	struct timespec ts;
+#if defined(ZI_LINUX)
+	ts.tv_sec = (time_t)(ticks / 1000000000ull);
+	ts.tv_nsec = (long)(ticks % 1000000000ull);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, ZI_NULL) == EINTR) {
+	}
+#else
+	// no absolute sleep on macOS, sleep the remaining delta
+	u64 now = zi_platform_get_ticks();
+	if (ticks <= now) return;
+	u64 delta = ticks - now;
+	ts.tv_sec = (time_t)(delta / 1000000000ull);
+	ts.tv_nsec = (long)(delta % 1000000000ull);
+	while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+	}
+#endif
+}
+
+u64 zi_platform_get_wall_clock_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (u64)ts.tv_sec * 1000000ull + (u64)ts.tv_nsec / 1000ull;
+}
+
+i32 zi_platform_format_timestamp(u64 wall_clock_us, char* buf, i32 buf_size) {
+	time_t seconds = (time_t)(wall_clock_us / 1000000ull);
 
 	struct tm tm_info;
-	localtime_r(&tv.tv_sec, &tm_info);
+	localtime_r(&seconds, &tm_info);
 
-	i32 ms = tv.tv_usec / 1000;
+	i32 ms = (i32)((wall_clock_us / 1000ull) % 1000ull);
 	return snprintf(buf, buf_size, "%04d-%02d-%02d %02d:%02d:%02d:%03d",
 	                tm_info.tm_year + 1900, tm_info.tm_mon + 1, tm_info.tm_mday,
 	                tm_info.tm_hour, tm_info.tm_min, tm_info.tm_sec, ms);
 }
 
+i32 zi_platform_get_timestamp(char* buf, i32 buf_size) {
+	return zi_platform_format_timestamp(zi_platform_get_wall_clock_us(), buf, buf_size);
+}
+
 ZiGraphicsBackend zi_platform_get_graphics_backend(ZiGraphicsBackend backend) {
 #ifdef ZI_MACOS
 	return ZiGraphicsBackend_Metal;
@@ -36,10 +141,654 @@ ZiGraphicsBackend zi_platform_get_graphics_backend(ZiGraphicsBackend backend) {
 #endif
 }
 
-i32 zi_platform_run(int argc, char** argv);
-//TODO: this will work only on desktops, iOS and Android will need a different startup code
-int main(int argc, char** argv) {
-	return zi_platform_run(argc, argv);
+// File mapping
+static u64 zi_unix_page_size(void) {
+	static u64 page_size = 0;
+	if (page_size == 0) {
+		page_size = (u64)sysconf(_SC_PAGESIZE);
+	}
+	return page_size;
+}
+
+static ZiBool zi_unix_page_range(const ZiMappedFile* file, u64 offset, u64 size, VoidPtr* start, u64* length) {
+	if (!file || !file->data || offset >= file->size || size == 0) return ZI_FALSE;
+	if (size > file->size - offset) size = file->size - offset;
+
+	u64 page_mask = zi_unix_page_size() - 1;
+	u64 begin = offset & ~page_mask;
+	u64 end = offset + size;
+
+	*start = (VoidPtr)(file->data + begin);
+	*length = end - begin;
+	return ZI_TRUE;
+}
+
+ZiBool zi_platform_map_file(const char* path, ZiFileMapFlags flags, ZiMappedFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		zi_log_error("failed to open %s: %s", path, strerror(errno));
+		return ZI_FALSE;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		zi_log_error("failed to stat %s: %s", path, strerror(errno));
+		close(fd);
+		return ZI_FALSE;
+	}
+
+	if (st.st_size == 0) {
+		close(fd);
+		return ZI_TRUE;
+	}
+
+	VoidPtr data = mmap(ZI_NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping keeps its own reference to the file
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		zi_log_error("failed to map %s: %s", path, strerror(errno));
+		return ZI_FALSE;
+	}
+
+	if (flags & ZiFileMapFlags_Sequential) {
+		madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+	} else if (flags & ZiFileMapFlags_Random) {
+		madvise(data, (size_t)st.st_size, MADV_RANDOM);
+	}
+
+#ifdef MADV_HUGEPAGE
+	if (flags & ZiFileMapFlags_HugePage) {
+		// only honored on file systems with THP support, EINVAL otherwise which is fine
+		madvise(data, (size_t)st.st_size, MADV_HUGEPAGE);
+	}
+#endif
+
+	if (flags & ZiFileMapFlags_WillNeed) {
+		madvise(data, (size_t)st.st_size, MADV_WILLNEED);
+	}
+
+	file->data = data;
+	file->size = (u64)st.st_size;
+	return ZI_TRUE;
+}
+
+void zi_platform_unmap_file(ZiMappedFile* file) {
+	if (file->data) {
+		munmap((VoidPtr)file->data, (size_t)file->size);
+	}
+	file->data = ZI_NULL;
+	file->size = 0;
+}
+
+void zi_platform_prefetch_mapped_range(const ZiMappedFile* file, u64 offset, u64 size) {
+	VoidPtr start;
+	u64     length;
+	if (zi_unix_page_range(file, offset, size, &start, &length)) {
+		madvise(start, (size_t)length, MADV_WILLNEED);
+	}
+}
+
+void zi_platform_release_mapped_range(const ZiMappedFile* file, u64 offset, u64 size) {
+	VoidPtr start;
+	u64     length;
+	if (zi_unix_page_range(file, offset, size, &start, &length)) {
+		// read-only private mapping, dropped pages are simply read back from the file on next access
+		madvise(start, (size_t)length, MADV_DONTNEED);
+	}
+}
+
+ZiBool zi_platform_create_mapped_file(const char* path, u64 size, ZiWritableMappedFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->handle = ZI_NULL;
+
+	int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		zi_log_error("failed to create %s: %s", path, strerror(errno));
+		return ZI_FALSE;
+	}
+
+#if defined(ZI_LINUX)
+	// reserve the blocks up front so writing into the mapping can't SIGBUS on a full disk
+	int res = posix_fallocate(fd, 0, (off_t)size);
+#else
+	int res = ftruncate(fd, (off_t)size) == 0 ? 0 : errno;
+#endif
+	if (res != 0) {
+		zi_log_error("failed to allocate %llu bytes for %s: %s", (unsigned long long)size, path, strerror(res));
+		close(fd);
+		return ZI_FALSE;
+	}
+
+	VoidPtr data = mmap(ZI_NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (data == MAP_FAILED) {
+		zi_log_error("failed to map %s: %s", path, strerror(errno));
+		close(fd);
+		return ZI_FALSE;
+	}
+
+	// kept open to truncate the file on close
+	file->data = data;
+	file->size = size;
+	file->handle = (VoidPtr)(intptr_t)(fd + 1);
+	return ZI_TRUE;
+}
+
+void zi_platform_flush_mapped_file(const ZiWritableMappedFile* file, u64 offset, u64 size) {
+	if (!file->data || offset >= file->size || size == 0) return;
+	if (size > file->size - offset) size = file->size - offset;
+
+	u64 page_mask = zi_unix_page_size() - 1;
+	u64 begin = offset & ~page_mask;
+	msync(file->data + begin, (size_t)(offset + size - begin), MS_ASYNC);
+}
+
+void zi_platform_close_mapped_file(ZiWritableMappedFile* file, u64 used_size) {
+	if (file->data) {
+		munmap(file->data, (size_t)file->size);
+	}
+	if (file->handle) {
+		int fd = (int)(intptr_t)file->handle - 1;
+		if (used_size < file->size && ftruncate(fd, (off_t)used_size) != 0) {
+			zi_log_error("failed to truncate mapped file: %s", strerror(errno));
+		}
+		close(fd);
+	}
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->handle = ZI_NULL;
+}
+
+ZiBool zi_platform_rename_file(const char* from, const char* to) {
+	return rename(from, to) == 0;
+}
+
+// Threads
+typedef struct ZiUnixThread {
+	pthread_t   thread;
+	ZiThreadFn  fn;
+	VoidPtr     user_data;
+	const char* name;
+} ZiUnixThread;
+
+typedef struct ZiUnixSemaphore {
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond;
+	u32             count;
+} ZiUnixSemaphore;
+
+static void* zi_unix_thread_main(void* arg) {
+	ZiUnixThread* thread = arg;
+	if (thread->name) {
+#if defined(ZI_MACOS)
+		pthread_setname_np(thread->name);
+#else
+		char name[16];
+		snprintf(name, sizeof(name), "%s", thread->name);
+		pthread_setname_np(pthread_self(), name);
+#endif
+		zi_profiler_set_thread_name(thread->name);
+	}
+	thread->fn(thread->user_data);
+	zi_profiler_thread_exit();
+	return ZI_NULL;
+}
+
+ZiThreadHandle zi_platform_thread_create(ZiThreadFn fn, VoidPtr user_data, const char* name) {
+	ZiUnixThread* thread = zi_mem_alloc(sizeof(ZiUnixThread));
+	thread->fn = fn;
+	thread->user_data = user_data;
+	thread->name = name;
+
+	int res = pthread_create(&thread->thread, ZI_NULL, zi_unix_thread_main, thread);
+	if (res != 0) {
+		zi_log_error("failed to create thread %s: %s", name ? name : "", strerror(res));
+		zi_mem_free(thread);
+		return (ZiThreadHandle){0};
+	}
+	return (ZiThreadHandle){.handler = thread};
+}
+
+void zi_platform_thread_join(ZiThreadHandle handle) {
+	if (!handle.handler) return;
+	ZiUnixThread* thread = handle.handler;
+	pthread_join(thread->thread, ZI_NULL);
+	zi_mem_free(thread);
+}
+
+void zi_platform_thread_yield(void) {
+	sched_yield();
+}
+
+ZiSemaphoreHandle zi_platform_semaphore_create(u32 initial_count) {
+	ZiUnixSemaphore* semaphore = zi_mem_alloc(sizeof(ZiUnixSemaphore));
+	pthread_mutex_init(&semaphore->mutex, ZI_NULL);
+	pthread_cond_init(&semaphore->cond, ZI_NULL);
+	semaphore->count = initial_count;
+	return (ZiSemaphoreHandle){.handler = semaphore};
+}
+
+void zi_platform_semaphore_destroy(ZiSemaphoreHandle handle) {
+	if (!handle.handler) return;
+	ZiUnixSemaphore* semaphore = handle.handler;
+	pthread_cond_destroy(&semaphore->cond);
+	pthread_mutex_destroy(&semaphore->mutex);
+	zi_mem_free(semaphore);
+}
+
+void zi_platform_semaphore_post(ZiSemaphoreHandle handle) {
+	ZiUnixSemaphore* semaphore = handle.handler;
+	pthread_mutex_lock(&semaphore->mutex);
+	semaphore->count++;
+	pthread_cond_signal(&semaphore->cond);
+	pthread_mutex_unlock(&semaphore->mutex);
+}
+
+ZiBool zi_platform_semaphore_wait(ZiSemaphoreHandle handle, u32 timeout_ms) {
+	ZiUnixSemaphore* semaphore = handle.handler;
+
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeout_ms / 1000;
+	deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000l;
+	if (deadline.tv_nsec >= 1000000000l) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000l;
+	}
+
+	pthread_mutex_lock(&semaphore->mutex);
+	while (semaphore->count == 0) {
+		if (pthread_cond_timedwait(&semaphore->cond, &semaphore->mutex, &deadline) == ETIMEDOUT) {
+			break;
+		}
+	}
+	ZiBool acquired = semaphore->count > 0;
+	if (acquired) {
+		semaphore->count--;
+	}
+	pthread_mutex_unlock(&semaphore->mutex);
+	return acquired;
+}
+
+// Crash handler
+static ZiCrashHandlerFn crash_handler = ZI_NULL;
+
+static void zi_unix_crash_signal(int sig) {
+	ZiCrashHandlerFn handler = crash_handler;
+	crash_handler = ZI_NULL;
+	if (handler) {
+		handler();
+	}
+	// SA_RESETHAND restored the default action, re-raise to get the usual core dump / exit code
+	raise(sig);
+}
+
+void zi_platform_set_crash_handler(ZiCrashHandlerFn handler) {
+	crash_handler = handler;
+
+	static const int signals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = handler ? zi_unix_crash_signal : SIG_DFL;
+	action.sa_flags = SA_RESETHAND;
+	sigemptyset(&action.sa_mask);
+
+	for (u32 i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i) {
+		sigaction(signals[i], &action, ZI_NULL);
+	}
+}
+
+// File watching
+#if defined(ZI_LINUX)
+
+#define ZI_FILE_WATCH_QUEUE_SIZE 512
+#define ZI_FILE_WATCH_MASK (IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF)
+
+typedef struct ZiUnixPendingChange {
+	u64          hash;
+	u64          last_ticks;
+	ZiFileChange first;
+	ZiFileChange last;
+	char         path[ZI_FILE_WATCH_MAX_PATH];
+} ZiUnixPendingChange;
+
+// watch descriptor -> directory relative to the root, path hash -> index into pending
+ZI_HASHMAP(ZiUnixWatchDirs, u64, char*)
+ZI_HASHMAP(ZiUnixPendingIndex, u64, u64)
+ZI_ARRAY(ZiUnixPendingChanges, ZiUnixPendingChange)
+
+typedef struct ZiUnixFileWatch {
+	int                  inotify_fd;
+	int                  wake_pipe[2];
+	ZiBool               recursive;
+	char*                root;
+	ZiThreadHandle       thread;
+	ZiUnixWatchDirs      dirs;
+	ZiUnixPendingIndex   pending_index;
+	ZiUnixPendingChanges pending;
+
+	// single producer (watch thread), single consumer (zi_platform_file_watch_poll)
+	ZiFileChangeEvent*   queue;
+	u32                  queue_head;
+	u32                  queue_tail;
+} ZiUnixFileWatch;
+
+static u64 zi_unix_hash_path(const char* path) {
+	u64 hash = 0xcbf29ce484222325ull;
+	while (*path) {
+		hash ^= (u8)*path++;
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static void zi_unix_watch_record(ZiUnixFileWatch* watch, const char* path, ZiFileChange change) {
+	u64 hash = zi_unix_hash_path(path);
+	u64 now = zi_platform_get_ticks();
+
+	u64* index = ZiUnixPendingIndex_get(&watch->pending_index, hash);
+	if (index) {
+		ZiUnixPendingChange* pending = &watch->pending.data[*index];
+		pending->last = change;
+		pending->last_ticks = now;
+		return;
+	}
+
+	ZiUnixPendingChange pending;
+	pending.hash = hash;
+	pending.last_ticks = now;
+	pending.first = change;
+	pending.last = change;
+	snprintf(pending.path, sizeof(pending.path), "%s", path);
+
+	ZiUnixPendingIndex_set(&watch->pending_index, hash, watch->pending.count);
+	ZiUnixPendingChanges_push(&watch->pending, pending);
+}
+
+// what a burst of events on one path amounts to, 0 when nothing is left to report
+static ZiFileChange zi_unix_watch_resolve(const ZiUnixPendingChange* pending) {
+	if (pending->first == ZiFileChange_Overflow) return ZiFileChange_Overflow;
+	if (pending->first == ZiFileChange_Created) return pending->last == ZiFileChange_Deleted ? 0 : ZiFileChange_Created;
+	if (pending->last == ZiFileChange_Deleted) return ZiFileChange_Deleted;
+	return ZiFileChange_Modified;
+}
+
+static ZiBool zi_unix_watch_push(ZiUnixFileWatch* watch, const ZiUnixPendingChange* pending, ZiFileChange change) {
+	u32 tail = zi_atomic_load_relaxed_u32(&watch->queue_tail);
+	u32 head = zi_atomic_load_acquire_u32(&watch->queue_head);
+	if (tail - head >= ZI_FILE_WATCH_QUEUE_SIZE) {
+		return ZI_FALSE;
+	}
+
+	ZiFileChangeEvent* event = &watch->queue[tail & (ZI_FILE_WATCH_QUEUE_SIZE - 1)];
+	event->change = change;
+	memcpy(event->path, pending->path, sizeof(event->path));
+	zi_atomic_store_release_u32(&watch->queue_tail, tail + 1);
+	return ZI_TRUE;
+}
+
+static void zi_unix_watch_flush(ZiUnixFileWatch* watch) {
+	u64 now = zi_platform_get_ticks();
+	u64 settle = zi_platform_get_tick_frequency() * ZI_FILE_WATCH_SETTLE_MS / 1000;
+
+	for (u64 i = watch->pending.count; i-- > 0;) {
+		ZiUnixPendingChange* pending = &watch->pending.data[i];
+		if (now - pending->last_ticks < settle) continue;
+
+		ZiFileChange change = zi_unix_watch_resolve(pending);
+		// a full queue keeps the change pending, the next flush tries again
+		if (change != 0 && !zi_unix_watch_push(watch, pending, change)) continue;
+
+		ZiUnixPendingIndex_remove(&watch->pending_index, pending->hash);
+		u64 last = watch->pending.count - 1;
+		if (i != last) {
+			ZiUnixPendingIndex_set(&watch->pending_index, watch->pending.data[last].hash, i);
+		}
+		ZiUnixPendingChanges_remove_swap(&watch->pending, i);
+	}
+}
+
+static void zi_unix_watch_join(char* out, u64 size, const char* dir, const char* name) {
+	snprintf(out, size, "%s%s%s", dir, dir[0] ? "/" : "", name);
+}
+
+static ZiBool zi_unix_watch_add_dir(ZiUnixFileWatch* watch, const char* relative, ZiBool report_files) {
+	char os_path[ZI_FILE_WATCH_MAX_PATH * 2];
+	zi_unix_watch_join(os_path, sizeof(os_path), watch->root, relative);
+
+	int wd = inotify_add_watch(watch->inotify_fd, os_path, ZI_FILE_WATCH_MASK | IN_ONLYDIR);
+	if (wd < 0) {
+		zi_log_warn("failed to watch %s: %s", os_path, strerror(errno));
+		return ZI_FALSE;
+	}
+
+	// a directory moved inside the tree keeps its descriptor, only the path changes
+	char** existing = ZiUnixWatchDirs_get(&watch->dirs, (u64)wd);
+	if (existing) {
+		zi_mem_free(*existing);
+	}
+	u64 length = strlen(relative);
+	char* copy = zi_mem_alloc(length + 1);
+	memcpy(copy, relative, length + 1);
+	ZiUnixWatchDirs_set(&watch->dirs, (u64)wd, copy);
+
+	if (!watch->recursive && !report_files) {
+		return ZI_TRUE;
+	}
+
+	DIR* dir = opendir(os_path);
+	if (!dir) {
+		return ZI_TRUE;
+	}
+
+	struct dirent* item;
+	while ((item = readdir(dir)) != ZI_NULL) {
+		if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) continue;
+
+		char child[ZI_FILE_WATCH_MAX_PATH];
+		zi_unix_watch_join(child, sizeof(child), relative, item->d_name);
+
+		ZiBool is_dir = item->d_type == DT_DIR;
+		if (item->d_type == DT_UNKNOWN) {
+			char child_os_path[ZI_FILE_WATCH_MAX_PATH * 2];
+			zi_unix_watch_join(child_os_path, sizeof(child_os_path), watch->root, child);
+			struct stat st;
+			is_dir = stat(child_os_path, &st) == 0 && S_ISDIR(st.st_mode);
+		}
+
+		if (is_dir) {
+			if (watch->recursive) {
+				zi_unix_watch_add_dir(watch, child, report_files);
+			}
+		} else if (report_files) {
+			// files that appeared before the watch on a new directory was in place
+			zi_unix_watch_record(watch, child, ZiFileChange_Created);
+		}
+	}
+	closedir(dir);
+	return ZI_TRUE;
+}
+
+static void zi_unix_watch_process(ZiUnixFileWatch* watch, const struct inotify_event* event) {
+	if (event->mask & IN_Q_OVERFLOW) {
+		zi_unix_watch_record(watch, "", ZiFileChange_Overflow);
+		return;
+	}
+
+	char** dir = ZiUnixWatchDirs_get(&watch->dirs, (u64)event->wd);
+	if (!dir) return;
+
+	if (event->mask & IN_IGNORED) {
+		zi_mem_free(*dir);
+		ZiUnixWatchDirs_remove(&watch->dirs, (u64)event->wd);
+		return;
+	}
+
+	// events about the watched directory itself, its parent reports those
+	if (event->len == 0) return;
+
+	char path[ZI_FILE_WATCH_MAX_PATH];
+	zi_unix_watch_join(path, sizeof(path), *dir, event->name);
+
+	if (event->mask & IN_ISDIR) {
+		if (watch->recursive && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+			zi_unix_watch_add_dir(watch, path, ZI_TRUE);
+		} else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+			zi_unix_watch_record(watch, path, ZiFileChange_Deleted);
+		}
+		return;
+	}
+
+	ZiFileChange change = ZiFileChange_Modified;
+	if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+		change = ZiFileChange_Created;
+	} else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+		change = ZiFileChange_Deleted;
+	}
+	zi_unix_watch_record(watch, path, change);
+}
+
+static void zi_unix_file_watch_thread(VoidPtr user_data) {
+	ZiUnixFileWatch* watch = user_data;
+	char buffer[16384] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	for (;;) {
+		// wake up to flush while changes are settling, otherwise sleep until something happens
+		int timeout = watch->pending.count > 0 ? ZI_FILE_WATCH_SETTLE_MS / 4 : -1;
+
+		struct pollfd fds[2] = {
+			{.fd = watch->inotify_fd, .events = POLLIN},
+			{.fd = watch->wake_pipe[0], .events = POLLIN},
+		};
+		if (poll(fds, 2, timeout) < 0 && errno != EINTR) {
+			zi_log_error("file watch poll failed: %s", strerror(errno));
+			break;
+		}
+		if (fds[1].revents) {
+			break;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			ssize_t length;
+			while ((length = read(watch->inotify_fd, buffer, sizeof(buffer))) > 0) {
+				for (char* p = buffer; p < buffer + length;) {
+					const struct inotify_event* event = (const struct inotify_event*)p;
+					zi_unix_watch_process(watch, event);
+					p += sizeof(struct inotify_event) + event->len;
+				}
+			}
+		}
+
+		zi_unix_watch_flush(watch);
+	}
+}
+
+static void zi_unix_file_watch_free(ZiUnixFileWatch* watch) {
+	for (u64 i = 0; i < watch->dirs.capacity; ++i) {
+		ZiUnixWatchDirs_Entry* entry = &watch->dirs.entries[i];
+		if (entry->occupied && !entry->deleted) {
+			zi_mem_free(entry->value);
+		}
+	}
+	ZiUnixWatchDirs_free(&watch->dirs);
+	ZiUnixPendingIndex_free(&watch->pending_index);
+	ZiUnixPendingChanges_free(&watch->pending);
+
+	if (watch->inotify_fd >= 0) close(watch->inotify_fd);
+	if (watch->wake_pipe[0] >= 0) close(watch->wake_pipe[0]);
+	if (watch->wake_pipe[1] >= 0) close(watch->wake_pipe[1]);
+
+	zi_mem_free(watch->queue);
+	zi_mem_free(watch->root);
+	zi_mem_free(watch);
+}
+
+ZiFileWatchHandle zi_platform_file_watch_create(const char* directory, ZiBool recursive) {
+	ZiUnixFileWatch* watch = zi_mem_alloc(sizeof(ZiUnixFileWatch));
+	memset(watch, 0, sizeof(ZiUnixFileWatch));
+	watch->recursive = recursive;
+	watch->wake_pipe[0] = -1;
+	watch->wake_pipe[1] = -1;
+
+	u64 length = strlen(directory);
+	while (length > 1 && directory[length - 1] == '/') length--;
+	watch->root = zi_mem_alloc(length + 1);
+	memcpy(watch->root, directory, length);
+	watch->root[length] = '\0';
+
+	ZiUnixWatchDirs_init(&watch->dirs, ZI_NULL);
+	ZiUnixPendingIndex_init(&watch->pending_index, ZI_NULL);
+	ZiUnixPendingChanges_init(&watch->pending, ZI_NULL);
+	watch->queue = zi_mem_alloc(sizeof(ZiFileChangeEvent) * ZI_FILE_WATCH_QUEUE_SIZE);
+
+	watch->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watch->inotify_fd < 0 || pipe2(watch->wake_pipe, O_CLOEXEC) != 0) {
+		zi_log_error("failed to create file watch: %s", strerror(errno));
+		zi_unix_file_watch_free(watch);
+		return (ZiFileWatchHandle){0};
+	}
+
+	if (!zi_unix_watch_add_dir(watch, "", ZI_FALSE)) {
+		zi_unix_file_watch_free(watch);
+		return (ZiFileWatchHandle){0};
+	}
+
+	watch->thread = zi_platform_thread_create(zi_unix_file_watch_thread, watch, "zi-file-watch");
+	if (!watch->thread.handler) {
+		zi_unix_file_watch_free(watch);
+		return (ZiFileWatchHandle){0};
+	}
+
+	return (ZiFileWatchHandle){.handler = watch};
+}
+
+void zi_platform_file_watch_destroy(ZiFileWatchHandle handle) {
+	if (!handle.handler) return;
+	ZiUnixFileWatch* watch = handle.handler;
+
+	char wake = 1;
+	while (write(watch->wake_pipe[1], &wake, 1) < 0 && errno == EINTR) {}
+	zi_platform_thread_join(watch->thread);
+
+	zi_unix_file_watch_free(watch);
+}
+
+ZiBool zi_platform_file_watch_poll(ZiFileWatchHandle handle, ZiFileChangeEvent* event) {
+	if (!handle.handler) return ZI_FALSE;
+	ZiUnixFileWatch* watch = handle.handler;
+
+	u32 head = zi_atomic_load_relaxed_u32(&watch->queue_head);
+	u32 tail = zi_atomic_load_acquire_u32(&watch->queue_tail);
+	if (head == tail) {
+		return ZI_FALSE;
+	}
+
+	*event = watch->queue[head & (ZI_FILE_WATCH_QUEUE_SIZE - 1)];
+	zi_atomic_store_release_u32(&watch->queue_head, head + 1);
+	return ZI_TRUE;
+}
+
+#else
+
+// no inotify on macOS and the BSDs, file watching is unsupported there
+ZiFileWatchHandle zi_platform_file_watch_create(const char* directory, ZiBool recursive) {
+	zi_log_error("file watching is not supported on this platform");
+	return (ZiFileWatchHandle){0};
 }
 
+void zi_platform_file_watch_destroy(ZiFileWatchHandle handle) {
+}
+
+ZiBool zi_platform_file_watch_poll(ZiFileWatchHandle handle, ZiFileChangeEvent* event) {
+	return ZI_FALSE;
+}
+
+#endif
+
 #endif
@@ -0,0 +1,15 @@
+#include "zi_platform.h"
+
+#include "zi_common.h"
+
+#if defined(ZI_LINUX) || defined(ZI_MACOS)
+
+// own translation unit so tools and tests can link the runtime with their own main
+
+i32 zi_platform_run(int argc, char** argv);
+//TODO: this will work only on desktops, iOS and Android will need a different startup code
+int main(int argc, char** argv) {
+	return zi_platform_run(argc, argv);
+}
+
+#endif
@@ -1,6 +1,9 @@
+#define ZI_LOG_CATEGORY ZiLogCategory_Platform
+
 #include "zi_platform.h"
 
 #include "zi_common.h"
+#include "zi_log.h"
 
 #ifdef ZI_WIN
 
@@ -9,6 +12,10 @@
 #include <shellapi.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "zi_core.h"
+#include "zi_profiler.h"
 
 
 void zi_platform_console_log(const char* message, i32 len, u8 error) {
@@ -18,18 +25,356 @@ void zi_platform_console_log(const char* message, i32 len, u8 error) {
 	//FlushFileBuffers(h);
 }
 
-i32 zi_platform_get_timestamp(char* buf, i32 buf_size) {
-	SYSTEMTIME st;
-	GetLocalTime(&st);
+void zi_platform_console_log_batch(const ZiConsoleChunk* chunks, u32 count, u8 error) {
+	HANDLE h = error ? GetStdHandle(STD_ERROR_HANDLE) : GetStdHandle(STD_OUTPUT_HANDLE);
+
+	// coalesce into one WriteFile per 4KB, there is no gather write for console handles
+	char buffer[4096];
+	u32  used = 0;
+	for (u32 i = 0; i < count; ++i) {
+		const char* data = chunks[i].data;
+		u32         size = chunks[i].size;
+		while (size > 0) {
+			u32 copy = size < sizeof(buffer) - used ? size : (u32)sizeof(buffer) - used;
+			memcpy(buffer + used, data, copy);
+			used += copy;
+			data += copy;
+			size -= copy;
+			if (used == sizeof(buffer)) {
+				WriteFile(h, buffer, used, NULL, NULL);
+				used = 0;
+			}
+		}
+	}
+	if (used > 0) {
+		WriteFile(h, buffer, used, NULL, NULL);
+	}
+}
+
+u64 zi_platform_get_ticks(void) {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (u64)counter.QuadPart;
+}
+
+u64 zi_platform_get_tick_frequency(void) {
+	static u64 frequency = 0;
+	if (frequency == 0) {
+		LARGE_INTEGER value;
+		QueryPerformanceFrequency(&value);
+		frequency = (u64)value.QuadPart;
+	}
+	return frequency;
+}
+
+f64 zi_platform_get_time(void) {
+	return (f64)zi_platform_get_ticks() / (f64)zi_platform_get_tick_frequency();
+}
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+void zi_platform_sleep_until(u64 ticks) {
+	// high resolution timers wake within ~0.5ms, Sleep() is bound to the 1-15ms scheduler tick
+	static ZI_THREAD_LOCAL HANDLE timer = ZI_NULL;
+	if (!timer) {
+		timer = CreateWaitableTimerExW(ZI_NULL, ZI_NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	}
+
+	u64 now = zi_platform_get_ticks();
+	if (ticks <= now) return;
+
+	// relative due time in 100ns units
+	u64 delta_100ns = (ticks - now) * 10000000ull / zi_platform_get_tick_frequency();
+
+	if (timer) {
+		LARGE_INTEGER due;
+		due.QuadPart = -(LONGLONG)delta_100ns;
+		if (SetWaitableTimer(timer, &due, 0, ZI_NULL, ZI_NULL, FALSE)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+	Sleep((DWORD)(delta_100ns / 10000ull));
+}
+
+// FILETIME counts 100ns intervals since 1601-01-01
+#define ZI_WIN_EPOCH_OFFSET_US 11644473600000000ull
+
+u64 zi_platform_get_wall_clock_us(void) {
+	FILETIME ft;
+	GetSystemTimePreciseAsFileTime(&ft);
+	u64 ticks = ((u64)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+	return ticks / 10ull - ZI_WIN_EPOCH_OFFSET_US;
+}
+
+i32 zi_platform_format_timestamp(u64 wall_clock_us, char* buf, i32 buf_size) {
+	u64      ticks = (wall_clock_us + ZI_WIN_EPOCH_OFFSET_US) * 10ull;
+	FILETIME ft;
+	ft.dwLowDateTime = (DWORD)ticks;
+	ft.dwHighDateTime = (DWORD)(ticks >> 32);
+
+	SYSTEMTIME utc, st;
+	FileTimeToSystemTime(&ft, &utc);
+	SystemTimeToTzSpecificLocalTime(NULL, &utc, &st);
 	return snprintf(buf, buf_size, "%04d-%02d-%02d %02d:%02d:%02d:%03d",
 	                st.wYear, st.wMonth, st.wDay,
 	                st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
 }
 
+i32 zi_platform_get_timestamp(char* buf, i32 buf_size) {
+	return zi_platform_format_timestamp(zi_platform_get_wall_clock_us(), buf, buf_size);
+}
+
 ZiGraphicsBackend zi_platform_get_graphics_backend(ZiGraphicsBackend backend) {
 	return ZiGraphicsBackend_Vulkan;
 }
 
+// File mapping
+ZiBool zi_platform_map_file(const char* path, ZiFileMapFlags flags, ZiMappedFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+
+	DWORD file_flags = FILE_ATTRIBUTE_NORMAL;
+	if (flags & ZiFileMapFlags_Sequential) file_flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	if (flags & ZiFileMapFlags_Random) file_flags |= FILE_FLAG_RANDOM_ACCESS;
+
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, file_flags, NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		zi_log_error("failed to open %s: error %lu", path, GetLastError());
+		return ZI_FALSE;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size)) {
+		zi_log_error("failed to get size of %s: error %lu", path, GetLastError());
+		CloseHandle(handle);
+		return ZI_FALSE;
+	}
+
+	if (size.QuadPart == 0) {
+		CloseHandle(handle);
+		return ZI_TRUE;
+	}
+
+	HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(handle);
+
+	if (!mapping) {
+		zi_log_error("failed to create mapping for %s: error %lu", path, GetLastError());
+		return ZI_FALSE;
+	}
+
+	// the view keeps the mapping and the file alive
+	VoidPtr data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (!data) {
+		zi_log_error("failed to map %s: error %lu", path, GetLastError());
+		return ZI_FALSE;
+	}
+
+	file->data = data;
+	file->size = (u64)size.QuadPart;
+
+	if (flags & ZiFileMapFlags_WillNeed) {
+		zi_platform_prefetch_mapped_range(file, 0, file->size);
+	}
+
+	return ZI_TRUE;
+}
+
+void zi_platform_unmap_file(ZiMappedFile* file) {
+	if (file->data) {
+		UnmapViewOfFile(file->data);
+	}
+	file->data = ZI_NULL;
+	file->size = 0;
+}
+
+void zi_platform_prefetch_mapped_range(const ZiMappedFile* file, u64 offset, u64 size) {
+	if (!file->data || offset >= file->size || size == 0) return;
+	if (size > file->size - offset) size = file->size - offset;
+
+	WIN32_MEMORY_RANGE_ENTRY entry;
+	entry.VirtualAddress = (VoidPtr)(file->data + offset);
+	entry.NumberOfBytes = (SIZE_T)size;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+}
+
+void zi_platform_release_mapped_range(const ZiMappedFile* file, u64 offset, u64 size) {
+	if (!file->data || offset >= file->size || size == 0) return;
+	if (size > file->size - offset) size = file->size - offset;
+
+	// unlocking pages that are not locked removes them from the working set
+	VirtualUnlock((VoidPtr)(file->data + offset), (SIZE_T)size);
+}
+
+ZiBool zi_platform_create_mapped_file(const char* path, u64 size, ZiWritableMappedFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->handle = ZI_NULL;
+
+	HANDLE handle = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, ZI_NULL,
+	                            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, ZI_NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		zi_log_error("failed to create %s: error %lu", path, GetLastError());
+		return ZI_FALSE;
+	}
+
+	// the mapping grows the file to size
+	HANDLE mapping = CreateFileMappingA(handle, ZI_NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), ZI_NULL);
+	if (!mapping) {
+		zi_log_error("failed to create mapping for %s: error %lu", path, GetLastError());
+		CloseHandle(handle);
+		return ZI_FALSE;
+	}
+
+	VoidPtr data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+
+	// the view keeps the mapping alive
+	CloseHandle(mapping);
+
+	if (!data) {
+		zi_log_error("failed to map %s: error %lu", path, GetLastError());
+		CloseHandle(handle);
+		return ZI_FALSE;
+	}
+
+	file->data = (u8*)data;
+	file->size = size;
+	file->handle = handle;
+	return ZI_TRUE;
+}
+
+void zi_platform_flush_mapped_file(const ZiWritableMappedFile* file, u64 offset, u64 size) {
+	if (!file->data || offset >= file->size || size == 0) return;
+	if (size > file->size - offset) size = file->size - offset;
+
+	// FlushViewOfFile doesn't wait for the disk, it only queues the dirty pages
+	FlushViewOfFile(file->data + offset, (SIZE_T)size);
+}
+
+void zi_platform_close_mapped_file(ZiWritableMappedFile* file, u64 used_size) {
+	if (file->data) {
+		UnmapViewOfFile(file->data);
+	}
+	if (file->handle) {
+		if (used_size < file->size) {
+			LARGE_INTEGER position;
+			position.QuadPart = (LONGLONG)used_size;
+			if (!SetFilePointerEx(file->handle, position, ZI_NULL, FILE_BEGIN) || !SetEndOfFile(file->handle)) {
+				zi_log_error("failed to truncate mapped file: error %lu", GetLastError());
+			}
+		}
+		CloseHandle(file->handle);
+	}
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->handle = ZI_NULL;
+}
+
+ZiBool zi_platform_rename_file(const char* from, const char* to) {
+	return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+// File watching
+// unsupported on Windows, see zi_platform_file_watch_create
+ZiFileWatchHandle zi_platform_file_watch_create(const char* directory, ZiBool recursive) {
+	zi_log_error("file watching is not supported on this platform");
+	return (ZiFileWatchHandle){0};
+}
+
+void zi_platform_file_watch_destroy(ZiFileWatchHandle handle) {
+}
+
+ZiBool zi_platform_file_watch_poll(ZiFileWatchHandle handle, ZiFileChangeEvent* event) {
+	return ZI_FALSE;
+}
+
+// Threads
+typedef struct ZiWin32Thread {
+	HANDLE      thread;
+	ZiThreadFn  fn;
+	VoidPtr     user_data;
+	const char* name;
+} ZiWin32Thread;
+
+static DWORD WINAPI zi_win32_thread_main(LPVOID arg) {
+	ZiWin32Thread* thread = arg;
+	if (thread->name) {
+		wchar_t name[64];
+		MultiByteToWideChar(CP_UTF8, 0, thread->name, -1, name, 64);
+		SetThreadDescription(GetCurrentThread(), name);
+		zi_profiler_set_thread_name(thread->name);
+	}
+	thread->fn(thread->user_data);
+	zi_profiler_thread_exit();
+	return 0;
+}
+
+ZiThreadHandle zi_platform_thread_create(ZiThreadFn fn, VoidPtr user_data, const char* name) {
+	ZiWin32Thread* thread = zi_mem_alloc(sizeof(ZiWin32Thread));
+	thread->fn = fn;
+	thread->user_data = user_data;
+	thread->name = name;
+
+	thread->thread = CreateThread(NULL, 0, zi_win32_thread_main, thread, 0, NULL);
+	if (!thread->thread) {
+		zi_log_error("failed to create thread %s: error %lu", name ? name : "", GetLastError());
+		zi_mem_free(thread);
+		return (ZiThreadHandle){0};
+	}
+	return (ZiThreadHandle){.handler = thread};
+}
+
+void zi_platform_thread_join(ZiThreadHandle handle) {
+	if (!handle.handler) return;
+	ZiWin32Thread* thread = handle.handler;
+	WaitForSingleObject(thread->thread, INFINITE);
+	CloseHandle(thread->thread);
+	zi_mem_free(thread);
+}
+
+void zi_platform_thread_yield(void) {
+	SwitchToThread();
+}
+
+ZiSemaphoreHandle zi_platform_semaphore_create(u32 initial_count) {
+	return (ZiSemaphoreHandle){.handler = CreateSemaphoreA(NULL, (LONG)initial_count, 0x7fffffff, NULL)};
+}
+
+void zi_platform_semaphore_destroy(ZiSemaphoreHandle semaphore) {
+	if (!semaphore.handler) return;
+	CloseHandle(semaphore.handler);
+}
+
+void zi_platform_semaphore_post(ZiSemaphoreHandle semaphore) {
+	ReleaseSemaphore(semaphore.handler, 1, NULL);
+}
+
+ZiBool zi_platform_semaphore_wait(ZiSemaphoreHandle semaphore, u32 timeout_ms) {
+	return WaitForSingleObject(semaphore.handler, timeout_ms) == WAIT_OBJECT_0;
+}
+
+// Crash handler
+static ZiCrashHandlerFn crash_handler = ZI_NULL;
+
+static LONG WINAPI zi_win32_unhandled_exception(EXCEPTION_POINTERS* info) {
+	ZiCrashHandlerFn handler = crash_handler;
+	crash_handler = ZI_NULL;
+	if (handler) {
+		handler();
+	}
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+
+void zi_platform_set_crash_handler(ZiCrashHandlerFn handler) {
+	crash_handler = handler;
+	SetUnhandledExceptionFilter(handler ? zi_win32_unhandled_exception : NULL);
+}
+
 i32 zi_platform_run(int argc, char** argv);
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
@@ -0,0 +1,694 @@
+#include "zi_profiler.h"
+
+#include "zi_atomic.h"
+#include "zi_core.h"
+#include "zi_log.h"
+#include "zi_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if ZI_ARCH_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#elif ZI_ARCH_X86
+#include <x86intrin.h>
+#endif
+
+#define ZI_PROFILER_MAX_DEPTH 256
+
+typedef struct ZiProfilerThread {
+	ZiProfileEvent* events;
+	// written by the owning thread only, events below head - ZI_PROFILER_RING_EVENTS are gone
+	u64             head;
+	// events before first belong to a thread that used the slot earlier
+	u64             first;
+	u32             id;
+	// times are zi_platform_get_ticks instead of the profiler clock
+	ZiBool          platform_ticks;
+	char            name[ZI_PROFILER_THREAD_NAME_MAX];
+} ZiProfilerThread;
+
+// string hash -> interned copy, copies whose hash collides with another string live in extra_names
+ZI_HASHMAP(ZiProfileInternMap, u64, char*)
+ZI_ARRAY(ZiProfileInternList, char*)
+
+u32 zi_profiler_recording;
+
+static volatile u64 profiler_threads[ZI_PROFILER_MAX_THREADS];
+static u32          profiler_thread_count;
+// slots of exited threads, registration is rare enough to take a lock
+static u32          profiler_slot_lock;
+static u32          profiler_free_slots[ZI_PROFILER_MAX_THREADS];
+static u32          profiler_free_slot_count;
+static ZiBool       profiler_slots_exhausted;
+// bumped by shutdown so threads drop their ring pointers and register again
+static u32          profiler_generation = 1;
+static u32          profiler_frame_index;
+static u64          profiler_clock_start;
+static u64          profiler_ticks_start;
+
+// GPU zones come from whichever thread resolves queries, the lock keeps the ring single producer
+static ZiProfilerThread*   profiler_gpu;
+static u32                 profiler_gpu_lock;
+static u32                 profiler_intern_lock;
+static ZiBool              profiler_intern_ready;
+static ZiProfileInternMap  profiler_interned;
+static ZiProfileInternList profiler_extra_names;
+
+// one thread local block, so the hot path resolves a single TLS address
+typedef struct ZiProfilerThreadState {
+	ZiProfilerThread* thread;
+	u32               generation;
+	char              name[ZI_PROFILER_THREAD_NAME_MAX];
+} ZiProfilerThreadState;
+
+static ZI_THREAD_LOCAL ZiProfilerThreadState profiler_local;
+
+// The invariant TSC is a few cycles to read where the monotonic clock may be a vDSO call or worse
+// in a VM. It gets mapped onto the platform clock when a capture is taken.
+static inline u64 zi_profiler_now(void) {
+#if ZI_ARCH_X86
+	return __rdtsc();
+#elif ZI_ARCH_ARM64 && (defined(__GNUC__) || defined(__clang__))
+	u64 value;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+	return value;
+#else
+	return zi_platform_get_ticks();
+#endif
+}
+
+void zi_profiler_init(void) {
+	profiler_clock_start = zi_profiler_now();
+	profiler_ticks_start = zi_platform_get_ticks();
+	zi_atomic_store_relaxed_u32(&profiler_frame_index, 0);
+
+	if (!profiler_local.name[0]) {
+		zi_profiler_set_thread_name("main");
+	}
+	zi_atomic_store_release_u32(&zi_profiler_recording, ZI_TRUE);
+}
+
+void zi_profiler_shutdown(void) {
+	zi_atomic_store_release_u32(&zi_profiler_recording, ZI_FALSE);
+
+	u32 count = zi_atomic_load_acquire_u32(&profiler_thread_count);
+	if (count > ZI_PROFILER_MAX_THREADS) count = ZI_PROFILER_MAX_THREADS;
+
+	// the owners are joined by now, see zi_profiler.h, nothing pushes into these anymore
+	for (u32 i = 0; i < count; ++i) {
+		ZiProfilerThread* thread = (ZiProfilerThread*)(uintptr_t)profiler_threads[i];
+		if (!thread) continue;
+		zi_mem_free(thread->events);
+		zi_mem_free(thread);
+		profiler_threads[i] = 0;
+	}
+
+	zi_atomic_store_release_u32(&profiler_thread_count, 0);
+	profiler_free_slot_count = 0;
+	profiler_slots_exhausted = ZI_FALSE;
+	zi_atomic_fetch_add_u32(&profiler_generation, 1);
+
+	if (profiler_gpu) {
+		zi_mem_free(profiler_gpu->events);
+		zi_mem_free(profiler_gpu);
+		profiler_gpu = ZI_NULL;
+	}
+
+	if (profiler_intern_ready) {
+		for (u64 i = 0; i < profiler_interned.capacity; ++i) {
+			ZiProfileInternMap_Entry* entry = &profiler_interned.entries[i];
+			if (entry->occupied && !entry->deleted) {
+				zi_mem_free(entry->value);
+			}
+		}
+		for (u64 i = 0; i < profiler_extra_names.count; ++i) {
+			zi_mem_free(profiler_extra_names.data[i]);
+		}
+		ZiProfileInternMap_free(&profiler_interned);
+		ZiProfileInternList_free(&profiler_extra_names);
+		profiler_intern_ready = ZI_FALSE;
+	}
+}
+
+static void zi_profiler_lock(u32* lock) {
+	u32 expected = 0;
+	while (!zi_atomic_cas_u32(lock, &expected, 1)) {
+		expected = 0;
+		zi_atomic_pause();
+	}
+}
+
+static void zi_profiler_unlock(u32* lock) {
+	zi_atomic_store_release_u32(lock, 0);
+}
+
+static ZiProfilerThread* zi_profiler_thread_alloc(u32 id, const char* name) {
+	ZiProfilerThread* thread = zi_mem_alloc(sizeof(ZiProfilerThread));
+	thread->events = zi_mem_alloc(sizeof(ZiProfileEvent) * ZI_PROFILER_RING_EVENTS);
+	thread->head = 0;
+	thread->first = 0;
+	thread->id = id;
+	thread->platform_ticks = ZI_FALSE;
+	snprintf(thread->name, sizeof(thread->name), "%s", name);
+	return thread;
+}
+
+static inline void zi_profiler_push(ZiProfilerThread* thread, u64 time, ZiProfileEventType type, const char* name, u32 data) {
+	u64             head = thread->head;
+	ZiProfileEvent* event = &thread->events[head & (ZI_PROFILER_RING_EVENTS - 1)];
+	event->time = time;
+	event->name = name;
+	event->data = data;
+	event->type = type;
+	zi_atomic_store_release_u64(&thread->head, head + 1);
+}
+
+void zi_profiler_set_recording(ZiBool recording) {
+	zi_atomic_store_release_u32(&zi_profiler_recording, recording ? ZI_TRUE : ZI_FALSE);
+}
+
+ZiBool zi_profiler_is_recording(void) {
+	return zi_atomic_load_relaxed_u32(&zi_profiler_recording) != 0;
+}
+
+void zi_profiler_set_thread_name(const char* name) {
+	ZiProfilerThreadState* local = &profiler_local;
+	snprintf(local->name, sizeof(local->name), "%s", name ? name : "");
+	if (local->thread && local->generation == zi_atomic_load_relaxed_u32(&profiler_generation)) {
+		memcpy(local->thread->name, local->name, sizeof(local->name));
+	}
+}
+
+static ZiProfilerThread* zi_profiler_register_thread(ZiProfilerThreadState* local) {
+	local->thread = ZI_NULL;
+	local->generation = zi_atomic_load_acquire_u32(&profiler_generation);
+
+	zi_profiler_lock(&profiler_slot_lock);
+
+	ZiProfilerThread* thread = ZI_NULL;
+	char              default_name[ZI_PROFILER_THREAD_NAME_MAX];
+	u32               slot = zi_atomic_load_relaxed_u32(&profiler_thread_count);
+	if (slot < ZI_PROFILER_MAX_THREADS) {
+		snprintf(default_name, sizeof(default_name), "thread %u", slot);
+		thread = zi_profiler_thread_alloc(slot, local->name[0] ? local->name : default_name);
+		zi_atomic_store_release_u64(&profiler_threads[slot], (u64)(uintptr_t)thread);
+		zi_atomic_store_release_u32(&profiler_thread_count, slot + 1);
+	} else if (profiler_free_slot_count > 0) {
+		// fresh slots go first so an exited thread's events last as long as possible
+		slot = profiler_free_slots[--profiler_free_slot_count];
+		thread = (ZiProfilerThread*)(uintptr_t)profiler_threads[slot];
+		snprintf(default_name, sizeof(default_name), "thread %u", slot);
+		snprintf(thread->name, sizeof(thread->name), "%s", local->name[0] ? local->name : default_name);
+		zi_atomic_store_release_u64(&thread->first, thread->head);
+	} else if (!profiler_slots_exhausted) {
+		profiler_slots_exhausted = ZI_TRUE;
+		zi_log_warn("profiler: more than %d threads recording, events of further threads are dropped", ZI_PROFILER_MAX_THREADS);
+	}
+
+	zi_profiler_unlock(&profiler_slot_lock);
+
+	// stays unregistered until the next shutdown when there was no slot
+	local->thread = thread;
+	return thread;
+}
+
+void zi_profiler_thread_exit(void) {
+	ZiProfilerThreadState* local = &profiler_local;
+	if (local->thread && local->generation == zi_atomic_load_acquire_u32(&profiler_generation)) {
+		zi_profiler_lock(&profiler_slot_lock);
+		profiler_free_slots[profiler_free_slot_count++] = local->thread->id;
+		zi_profiler_unlock(&profiler_slot_lock);
+	}
+	// generations start at 1, recording again registers a new slot
+	local->thread = ZI_NULL;
+	local->generation = 0;
+}
+
+void zi_profiler_record(ZiProfileEventType type, const char* name, u32 data) {
+	ZiProfilerThreadState* local = &profiler_local;
+	ZiProfilerThread*      thread = local->thread;
+	if (local->generation != zi_atomic_load_relaxed_u32(&profiler_generation)) {
+		thread = zi_profiler_register_thread(local);
+	}
+	if (!thread) return;
+
+	zi_profiler_push(thread, zi_profiler_now(), type, name, data);
+}
+
+void zi_profiler_frame(void) {
+	if (!zi_atomic_load_relaxed_u32(&zi_profiler_recording)) return;
+	u32 frame = zi_atomic_fetch_add_u32(&profiler_frame_index, 1);
+	zi_profiler_record(ZiProfileEventType_Frame, "frame", frame);
+}
+
+const char* zi_profiler_intern(const char* name) {
+	if (!name) return ZI_NULL;
+
+	u64 length = strlen(name);
+	u64 hash = 0xcbf29ce484222325ull;
+	for (u64 i = 0; i < length; ++i) {
+		hash ^= (u8)name[i];
+		hash *= 0x100000001b3ull;
+	}
+
+	zi_profiler_lock(&profiler_intern_lock);
+
+	if (!profiler_intern_ready) {
+		ZiProfileInternMap_init(&profiler_interned, ZI_NULL);
+		ZiProfileInternList_init(&profiler_extra_names, ZI_NULL);
+		profiler_intern_ready = ZI_TRUE;
+	}
+
+	char** existing = ZiProfileInternMap_get(&profiler_interned, hash);
+	if (existing && strcmp(*existing, name) == 0) {
+		zi_profiler_unlock(&profiler_intern_lock);
+		return *existing;
+	}
+
+	char* copy = zi_mem_alloc(length + 1);
+	memcpy(copy, name, length + 1);
+
+	if (existing) {
+		if (profiler_extra_names.count == profiler_extra_names.capacity) {
+			ZiProfileInternList_reserve(&profiler_extra_names, profiler_extra_names.capacity ? profiler_extra_names.capacity * 2 : 16);
+		}
+		ZiProfileInternList_push(&profiler_extra_names, copy);
+	} else {
+		ZiProfileInternMap_set(&profiler_interned, hash, copy);
+	}
+
+	zi_profiler_unlock(&profiler_intern_lock);
+	return copy;
+}
+
+void zi_profiler_record_gpu(ZiProfileEventType type, const char* name, u64 ticks) {
+	if (!zi_atomic_load_relaxed_u32(&zi_profiler_recording)) return;
+
+	zi_profiler_lock(&profiler_gpu_lock);
+	if (!profiler_gpu) {
+		profiler_gpu = zi_profiler_thread_alloc(ZI_PROFILER_GPU_THREAD_ID, "GPU");
+		profiler_gpu->platform_ticks = ZI_TRUE;
+	}
+	zi_profiler_push(profiler_gpu, ticks, type, name, 0);
+	zi_profiler_unlock(&profiler_gpu_lock);
+}
+
+// ============================================================================
+// Capture
+// ============================================================================
+
+// Pairs begins with ends: ends whose begin was overwritten are dropped and zones still open get
+// closed at end_time. Returns the new event count, events needs room for ZI_PROFILER_MAX_DEPTH more.
+static u32 zi_profiler_balance(ZiProfileEvent* events, u32 count, u64 end_time) {
+	const char* stack[ZI_PROFILER_MAX_DEPTH];
+	u32         depth = 0;
+	// zones nested deeper than the stack are dropped, begins and their ends alike
+	u32         overflow = 0;
+	u32         out = 0;
+
+	for (u32 i = 0; i < count; ++i) {
+		ZiProfileEvent event = events[i];
+		if (event.type == ZiProfileEventType_Begin) {
+			if (depth >= ZI_PROFILER_MAX_DEPTH) {
+				overflow++;
+				continue;
+			}
+			stack[depth++] = event.name;
+		} else if (event.type == ZiProfileEventType_End) {
+			if (overflow > 0) {
+				overflow--;
+				continue;
+			}
+			if (depth == 0) continue;
+			event.name = stack[--depth];
+		}
+		events[out++] = event;
+	}
+
+	while (depth > 0) {
+		events[out++] = (ZiProfileEvent){.time = end_time, .name = stack[--depth], .type = ZiProfileEventType_End};
+	}
+	return out;
+}
+
+ZiBool zi_profiler_capture(ZiProfileCapture* capture) {
+	memset(capture, 0, sizeof(ZiProfileCapture));
+
+	// maps the profiler clock onto nanoseconds through the platform clock
+	u64 clock_now = zi_profiler_now();
+	u64 ticks_now = zi_platform_get_ticks();
+	f64 ns_per_tick = 1e9 / (f64)zi_platform_get_tick_frequency();
+	f64 ns_per_unit = ns_per_tick;
+	if (clock_now > profiler_clock_start && ticks_now > profiler_ticks_start) {
+		ns_per_unit = (f64)(ticks_now - profiler_ticks_start) * ns_per_tick / (f64)(clock_now - profiler_clock_start);
+	}
+	u64 end_time = (u64)((f64)(clock_now - profiler_clock_start) * ns_per_unit);
+
+	u32 count = zi_atomic_load_acquire_u32(&profiler_thread_count);
+	if (count > ZI_PROFILER_MAX_THREADS) count = ZI_PROFILER_MAX_THREADS;
+
+	// one more for the GPU track
+	capture->threads = zi_mem_alloc(sizeof(ZiProfileCaptureThread) * (count + 1));
+
+	for (u32 i = 0; i <= count; ++i) {
+		ZiProfilerThread* thread;
+		if (i < count) {
+			thread = (ZiProfilerThread*)(uintptr_t)zi_atomic_load_acquire_u64(&profiler_threads[i]);
+		} else {
+			zi_profiler_lock(&profiler_gpu_lock);
+			thread = profiler_gpu;
+		}
+		if (!thread) {
+			if (i == count) zi_profiler_unlock(&profiler_gpu_lock);
+			continue;
+		}
+
+		u64 head = zi_atomic_load_acquire_u64(&thread->head);
+		u64 tail = head > ZI_PROFILER_RING_EVENTS ? head - ZI_PROFILER_RING_EVENTS : 0;
+		u64 first = zi_atomic_load_acquire_u64(&thread->first);
+		if (tail < first) tail = first;
+
+		ZiProfileEvent* events = zi_mem_alloc(sizeof(ZiProfileEvent) * ((head - tail) + ZI_PROFILER_MAX_DEPTH));
+		for (u64 e = tail; e < head; ++e) {
+			events[e - tail] = thread->events[e & (ZI_PROFILER_RING_EVENTS - 1)];
+		}
+
+		// the owner kept writing during the copy, anything it lapped may be torn
+		u64 new_head = zi_atomic_load_acquire_u64(&thread->head);
+		u64 skip = 0;
+		if (new_head > ZI_PROFILER_RING_EVENTS && new_head - ZI_PROFILER_RING_EVENTS > tail) {
+			skip = new_head - ZI_PROFILER_RING_EVENTS - tail;
+			if (skip > head - tail) skip = head - tail;
+		}
+
+		if (i == count) zi_profiler_unlock(&profiler_gpu_lock);
+
+		u32 event_count = (u32)(head - tail - skip);
+		memmove(events, events + skip, sizeof(ZiProfileEvent) * event_count);
+
+		for (u32 e = 0; e < event_count; ++e) {
+			if (thread->platform_ticks) {
+				u64 time = events[e].time > profiler_ticks_start ? events[e].time - profiler_ticks_start : 0;
+				events[e].time = (u64)((f64)time * ns_per_tick);
+			} else {
+				u64 time = events[e].time > profiler_clock_start ? events[e].time - profiler_clock_start : 0;
+				events[e].time = (u64)((f64)time * ns_per_unit);
+			}
+		}
+
+		ZiProfileCaptureThread* out = &capture->threads[capture->thread_count++];
+		memcpy(out->name, thread->name, sizeof(out->name));
+		out->name[sizeof(out->name) - 1] = '\0';
+		out->id = thread->id;
+		out->events = events;
+		out->event_count = zi_profiler_balance(events, event_count, end_time);
+	}
+
+	return ZI_TRUE;
+}
+
+void zi_profiler_capture_free(ZiProfileCapture* capture) {
+	for (u32 i = 0; i < capture->thread_count; ++i) {
+		zi_mem_free(capture->threads[i].events);
+	}
+	if (capture->threads) zi_mem_free(capture->threads);
+	if (capture->strings) zi_mem_free(capture->strings);
+	memset(capture, 0, sizeof(ZiProfileCapture));
+}
+
+// ============================================================================
+// Chrome trace
+// ============================================================================
+
+static void zi_profiler_write_json_string(FILE* fp, const char* str) {
+	fputc('"', fp);
+	for (const char* p = str ? str : ""; *p; ++p) {
+		u8 c = (u8)*p;
+		if (c == '"' || c == '\\') {
+			fputc('\\', fp);
+			fputc(c, fp);
+		} else if (c < 0x20) {
+			fprintf(fp, "\\u%04x", c);
+		} else {
+			fputc(c, fp);
+		}
+	}
+	fputc('"', fp);
+}
+
+ZiBool zi_profiler_write_chrome_trace(const ZiProfileCapture* capture, const char* path) {
+	FILE* fp = fopen(path, "wb");
+	if (!fp) {
+		zi_log_error("failed to open %s", path);
+		return ZI_FALSE;
+	}
+	setvbuf(fp, ZI_NULL, _IOFBF, 1 << 16);
+
+	fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", fp);
+
+	ZiBool first = ZI_TRUE;
+	for (u32 t = 0; t < capture->thread_count; ++t) {
+		const ZiProfileCaptureThread* thread = &capture->threads[t];
+
+		fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", thread->id);
+		zi_profiler_write_json_string(fp, thread->name);
+		fputs("}}", fp);
+		first = ZI_FALSE;
+
+		for (u32 e = 0; e < thread->event_count; ++e) {
+			const ZiProfileEvent* event = &thread->events[e];
+			// microseconds with nanosecond precision
+			u64 us = event->time / 1000;
+			u32 ns = (u32)(event->time % 1000);
+
+			switch (event->type) {
+				case ZiProfileEventType_Begin:
+					fputs(",\n{\"name\":", fp);
+					zi_profiler_write_json_string(fp, event->name);
+					fprintf(fp, ",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u}", thread->id, (unsigned long long)us, ns);
+					break;
+				case ZiProfileEventType_End:
+					fprintf(fp, ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u}", thread->id, (unsigned long long)us, ns);
+					break;
+				case ZiProfileEventType_Frame:
+					fprintf(fp, ",\n{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03u,\"args\":{\"frame\":%u}}",
+					        thread->id, (unsigned long long)us, ns, event->data);
+					break;
+				default: break;
+			}
+		}
+	}
+
+	fputs("\n]}\n", fp);
+
+	ZiBool ok = !ferror(fp);
+	if (fclose(fp) != 0) ok = ZI_FALSE;
+	if (!ok) {
+		zi_log_error("failed to write %s", path);
+	}
+	return ok;
+}
+
+// ============================================================================
+// Binary
+// ============================================================================
+
+typedef struct ZiProfileFileHeader {
+	char magic[8];
+	u32  version;
+	u32  thread_count;
+} ZiProfileFileHeader;
+
+typedef struct ZiProfileFileThread {
+	char name[ZI_PROFILER_THREAD_NAME_MAX];
+	u32  id;
+	u32  event_count;
+} ZiProfileFileThread;
+
+// name is a string index, or the frame index for frame events
+typedef struct ZiProfileFileEvent {
+	u64 time;
+	u32 name;
+	u32 type;
+} ZiProfileFileEvent;
+
+// name pointer -> string index, names are deduplicated by address only
+ZI_HASHMAP(ZiProfileNameMap, u64, u32)
+ZI_ARRAY(ZiProfileNames, const char*)
+
+ZiBool zi_profiler_write_binary(const ZiProfileCapture* capture, const char* path) {
+	ZiProfileNameMap name_map;
+	ZiProfileNames   names;
+	ZiProfileNameMap_init(&name_map, ZI_NULL);
+	ZiProfileNames_init(&names, ZI_NULL);
+
+	for (u32 t = 0; t < capture->thread_count; ++t) {
+		const ZiProfileCaptureThread* thread = &capture->threads[t];
+		for (u32 e = 0; e < thread->event_count; ++e) {
+			const char* name = thread->events[e].name;
+			if (thread->events[e].type == ZiProfileEventType_Frame) continue;
+			if (ZiProfileNameMap_has(&name_map, (u64)(uintptr_t)name)) continue;
+
+			ZiProfileNameMap_set(&name_map, (u64)(uintptr_t)name, (u32)names.count);
+			if (names.count == names.capacity) {
+				ZiProfileNames_reserve(&names, names.capacity ? names.capacity * 2 : 64);
+			}
+			ZiProfileNames_push(&names, name);
+		}
+	}
+
+	FILE* fp = fopen(path, "wb");
+	if (!fp) {
+		zi_log_error("failed to open %s", path);
+		ZiProfileNameMap_free(&name_map);
+		ZiProfileNames_free(&names);
+		return ZI_FALSE;
+	}
+	setvbuf(fp, ZI_NULL, _IOFBF, 1 << 16);
+
+	ZiProfileFileHeader header = {0};
+	memcpy(header.magic, ZI_PROFILE_MAGIC, sizeof(header.magic));
+	header.version = ZI_PROFILE_VERSION;
+	header.thread_count = capture->thread_count;
+	fwrite(&header, sizeof(header), 1, fp);
+
+	u32 string_count = (u32)names.count;
+	fwrite(&string_count, sizeof(string_count), 1, fp);
+	for (u64 i = 0; i < names.count; ++i) {
+		const char* name = names.data[i] ? names.data[i] : "";
+		u64 length = strlen(name);
+		u16 length16 = (u16)(length < 0xFFFF ? length : 0xFFFF);
+		fwrite(&length16, sizeof(length16), 1, fp);
+		fwrite(name, 1, length16, fp);
+	}
+
+	for (u32 t = 0; t < capture->thread_count; ++t) {
+		const ZiProfileCaptureThread* thread = &capture->threads[t];
+
+		ZiProfileFileThread file_thread = {0};
+		memcpy(file_thread.name, thread->name, sizeof(file_thread.name));
+		file_thread.id = thread->id;
+		file_thread.event_count = thread->event_count;
+		fwrite(&file_thread, sizeof(file_thread), 1, fp);
+
+		for (u32 e = 0; e < thread->event_count; ++e) {
+			const ZiProfileEvent* event = &thread->events[e];
+			ZiProfileFileEvent file_event;
+			file_event.time = event->time;
+			file_event.type = event->type;
+			if (event->type == ZiProfileEventType_Frame) {
+				file_event.name = event->data;
+			} else {
+				file_event.name = *ZiProfileNameMap_get(&name_map, (u64)(uintptr_t)event->name);
+			}
+			fwrite(&file_event, sizeof(file_event), 1, fp);
+		}
+	}
+
+	ZiProfileNameMap_free(&name_map);
+	ZiProfileNames_free(&names);
+
+	ZiBool ok = !ferror(fp);
+	if (fclose(fp) != 0) ok = ZI_FALSE;
+	if (!ok) {
+		zi_log_error("failed to write %s", path);
+	}
+	return ok;
+}
+
+ZiBool zi_profiler_load_binary(const char* path, ZiProfileCapture* capture) {
+	memset(capture, 0, sizeof(ZiProfileCapture));
+
+	ZiMappedFile file;
+	if (!zi_platform_map_file(path, ZiFileMapFlags_Sequential, &file)) {
+		return ZI_FALSE;
+	}
+
+	const u8* p = file.data;
+	const u8* end = p + file.size;
+	ZiBool    ok = ZI_FALSE;
+	const char** names = ZI_NULL;
+
+	ZiProfileFileHeader header;
+	if (file.size < sizeof(header)) goto done;
+	memcpy(&header, p, sizeof(header));
+	p += sizeof(header);
+	if (memcmp(header.magic, ZI_PROFILE_MAGIC, sizeof(header.magic)) != 0 || header.version != ZI_PROFILE_VERSION) goto done;
+
+	u32 string_count;
+	if ((u64)(end - p) < sizeof(string_count)) goto done;
+	memcpy(&string_count, p, sizeof(string_count));
+	p += sizeof(string_count);
+
+	// the strings section can't be larger than what is left of the file, plus a terminator each
+	if (string_count > (u64)(end - p) / sizeof(u16)) goto done;
+	char* strings = zi_mem_alloc((u64)(end - p) + string_count);
+	capture->strings = strings;
+	names = zi_mem_alloc(sizeof(const char*) * (string_count > 0 ? string_count : 1));
+
+	for (u32 i = 0; i < string_count; ++i) {
+		u16 length;
+		if ((u64)(end - p) < sizeof(length)) goto done;
+		memcpy(&length, p, sizeof(length));
+		p += sizeof(length);
+		if ((u64)(end - p) < length) goto done;
+
+		memcpy(strings, p, length);
+		strings[length] = '\0';
+		names[i] = strings;
+		strings += length + 1;
+		p += length;
+	}
+
+	if (header.thread_count > ZI_PROFILER_MAX_THREADS + 1) goto done;
+	capture->threads = zi_mem_alloc(sizeof(ZiProfileCaptureThread) * (header.thread_count > 0 ? header.thread_count : 1));
+
+	for (u32 t = 0; t < header.thread_count; ++t) {
+		ZiProfileFileThread file_thread;
+		if ((u64)(end - p) < sizeof(file_thread)) goto done;
+		memcpy(&file_thread, p, sizeof(file_thread));
+		p += sizeof(file_thread);
+
+		if (file_thread.event_count > (u64)(end - p) / sizeof(ZiProfileFileEvent)) goto done;
+
+		ZiProfileCaptureThread* thread = &capture->threads[capture->thread_count++];
+		memcpy(thread->name, file_thread.name, sizeof(thread->name));
+		thread->name[sizeof(thread->name) - 1] = '\0';
+		thread->id = file_thread.id;
+		thread->event_count = 0;
+		thread->events = zi_mem_alloc(sizeof(ZiProfileEvent) * (file_thread.event_count > 0 ? file_thread.event_count : 1));
+
+		for (u32 e = 0; e < file_thread.event_count; ++e) {
+			ZiProfileFileEvent file_event;
+			memcpy(&file_event, p, sizeof(file_event));
+			p += sizeof(file_event);
+
+			ZiProfileEvent* event = &thread->events[thread->event_count++];
+			event->time = file_event.time;
+			event->type = (ZiProfileEventType)file_event.type;
+			event->data = 0;
+			event->name = ZI_NULL;
+			if (event->type == ZiProfileEventType_Frame) {
+				event->name = "frame";
+				event->data = file_event.name;
+			} else if (file_event.name < string_count) {
+				event->name = names[file_event.name];
+			} else {
+				goto done;
+			}
+		}
+	}
+
+	ok = ZI_TRUE;
+
+done:
+	if (names) zi_mem_free((VoidPtr)names);
+	zi_platform_unmap_file(&file);
+	if (!ok) {
+		zi_log_error("%s is not a valid profile capture", path);
+		zi_profiler_capture_free(capture);
+	}
+	return ok;
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "zi_common.h"
+
+// ============================================================================
+// CPU profiler
+// ============================================================================
+//
+// Zones write a begin and an end event into a ring owned by the calling thread, there are no
+// locks and no allocations after a thread's first event. Rings keep the most recent
+// ZI_PROFILER_RING_EVENTS events, a capture is whatever is still in them when it is taken.
+// Zone names are stored by pointer, use string literals or anything else that outlives the capture.
+//
+// Build with ZI_PROFILE_ENABLED=0 (cmake -DZI_PROFILER=OFF) to compile every ZI_PROFILE_* site out.
+
+#ifndef ZI_PROFILE_ENABLED
+#define ZI_PROFILE_ENABLED 1
+#endif
+
+// threads recording at the same time, slots of exited threads are reused
+#define ZI_PROFILER_MAX_THREADS     64
+// per thread, power of two
+#define ZI_PROFILER_RING_EVENTS     32768
+// track id of GPU zones in captures, after every real thread
+#define ZI_PROFILER_GPU_THREAD_ID   ZI_PROFILER_MAX_THREADS
+#define ZI_PROFILER_THREAD_NAME_MAX 32
+
+#define ZI_PROFILE_MAGIC   "ZIPROF\0\0"
+#define ZI_PROFILE_VERSION 1
+
+enum ZiProfileEventType_ {
+	ZiProfileEventType_Begin = 1,
+	ZiProfileEventType_End   = 2,
+	// global instant event, data is the frame index
+	ZiProfileEventType_Frame = 3,
+};
+
+typedef u8 ZiProfileEventType;
+
+// time is in raw profiler clock units while in a ring and in nanoseconds since the capture start once captured
+typedef struct ZiProfileEvent {
+	u64                time;
+	const char*        name;
+	u32                data;
+	ZiProfileEventType type;
+} ZiProfileEvent;
+
+typedef struct ZiProfileCaptureThread {
+	char            name[ZI_PROFILER_THREAD_NAME_MAX];
+	u32             id;
+	u32             event_count;
+	ZiProfileEvent* events;
+} ZiProfileCaptureThread;
+
+// Every thread's events in order, zones cut by the ring wrapping or still open are dropped or
+// closed so begins and ends always pair up.
+typedef struct ZiProfileCapture {
+	u32                     thread_count;
+	ZiProfileCaptureThread* threads;
+	// names of a loaded capture point into this
+	VoidPtr                 strings;
+} ZiProfileCapture;
+
+// starts recording, zones before this are free and record nothing
+void   zi_profiler_init(void);
+// Frees every thread's ring and the interned names. Join every other thread that recorded first:
+// threads keep a pointer to their ring, and one still inside a zone writes the end into it when
+// the scope closes, after the ring is gone.
+void   zi_profiler_shutdown(void);
+void   zi_profiler_set_recording(ZiBool recording);
+ZiBool zi_profiler_is_recording(void);
+// shows up as the thread's name in traces, zi_platform_thread_create threads are named already
+void   zi_profiler_set_thread_name(const char* name);
+// Gives the calling thread's slot to the next thread that starts recording, its events stay in
+// captures until then. zi_platform_thread_create threads call it when they return, other threads
+// that record should call it before they exit.
+void   zi_profiler_thread_exit(void);
+
+void   zi_profiler_record(ZiProfileEventType type, const char* name, u32 data);
+// marks the start of a frame on the calling thread
+void   zi_profiler_frame(void);
+
+// copy of name that stays valid until zi_profiler_shutdown, for names that aren't literals
+const char* zi_profiler_intern(const char* name);
+// Begin/end events on the "GPU" track with zi_platform_get_ticks timestamps, e.g. resolved timestamp
+// queries. Zones have to nest and arrive in order, like on a CPU thread.
+void        zi_profiler_record_gpu(ZiProfileEventType type, const char* name, u64 ticks);
+
+// snapshot of all rings, safe while other threads keep recording
+ZiBool zi_profiler_capture(ZiProfileCapture* capture);
+void   zi_profiler_capture_free(ZiProfileCapture* capture);
+
+// Chrome trace event JSON, for chrome://tracing, Perfetto or speedscope
+ZiBool zi_profiler_write_chrome_trace(const ZiProfileCapture* capture, const char* path);
+// Compact form, 16 bytes per event, convert with zi-profile-convert:
+// header | u32 string count, strings (u16 length + bytes) | per thread: name, u32 id, u32 count, events
+ZiBool zi_profiler_write_binary(const ZiProfileCapture* capture, const char* path);
+ZiBool zi_profiler_load_binary(const char* path, ZiProfileCapture* capture);
+
+// ============================================================================
+// Instrumentation
+// ============================================================================
+
+extern u32 zi_profiler_recording;
+
+typedef struct ZiProfileZone {
+	const char* name;
+	ZiBool      active;
+} ZiProfileZone;
+
+static inline ZiProfileZone zi_profile_zone_begin(const char* name) {
+	ZiProfileZone zone = {name, zi_profiler_recording != 0};
+	if (zone.active) {
+		zi_profiler_record(ZiProfileEventType_Begin, name, 0);
+	}
+	return zone;
+}
+
+static inline void zi_profile_zone_end(ZiProfileZone* zone) {
+	if (zone->active) {
+		zi_profiler_record(ZiProfileEventType_End, zone->name, 0);
+	}
+}
+
+#define ZI_PROFILE_CONCAT_(a, b) a##b
+#define ZI_PROFILE_CONCAT(a, b)  ZI_PROFILE_CONCAT_(a, b)
+
+// Scoped zones need the cleanup attribute. MSVC has no scope exit hook in C, there ZI_PROFILE_ZONE
+// and ZI_PROFILE_FUNCTION record nothing and only ZI_PROFILE_BEGIN/ZI_PROFILE_END pairs show up.
+#if defined(__GNUC__) || defined(__clang__)
+#define ZI_PROFILE_SCOPED_ZONES 1
+#else
+#define ZI_PROFILE_SCOPED_ZONES 0
+#endif
+
+#if ZI_PROFILE_ENABLED
+
+// ends with the enclosing scope, early returns included
+#if ZI_PROFILE_SCOPED_ZONES
+#define ZI_PROFILE_ZONE(name)                                                                          \
+	ZiProfileZone ZI_PROFILE_CONCAT(zi_profile_zone_, __LINE__)                                        \
+		__attribute__((cleanup(zi_profile_zone_end))) = zi_profile_zone_begin(name)
+#else
+#define ZI_PROFILE_ZONE(name) ((void)0)
+#endif
+
+#define ZI_PROFILE_FUNCTION() ZI_PROFILE_ZONE(__func__)
+// explicit pair for zones that don't match a scope, must nest properly with other zones
+#define ZI_PROFILE_BEGIN(name) ZiProfileZone ZI_PROFILE_CONCAT(zi_profile_zone_, name) = zi_profile_zone_begin(#name)
+#define ZI_PROFILE_END(name)   zi_profile_zone_end(&ZI_PROFILE_CONCAT(zi_profile_zone_, name))
+#define ZI_PROFILE_FRAME()     zi_profiler_frame()
+
+#else
+
+#define ZI_PROFILE_ZONE(name)  ((void)0)
+#define ZI_PROFILE_FUNCTION()  ((void)0)
+#define ZI_PROFILE_BEGIN(name) ((void)0)
+#define ZI_PROFILE_END(name)   ((void)0)
+#define ZI_PROFILE_FRAME()     ((void)0)
+
+#endif
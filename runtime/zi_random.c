@@ -0,0 +1,149 @@
+#include "zi_math.h"
+
+#include "zi_atomic.h"
+#include "zi_platform.h"
+
+#if ZI_ARCH_X86
+#include <immintrin.h>
+#endif
+
+ZI_THREAD_LOCAL ZiRandom zi_random_thread_state;
+
+// streams handed out to unseeded threads so far
+static u32 random_thread_streams;
+
+void zi_random_thread_start(void) {
+	u32 stream = zi_atomic_fetch_add_u32(&random_thread_streams, 1);
+	// stream 0 is the one zi_random_seed picks
+	zi_random_init(&zi_random_thread_state, ZI_RANDOM_DEFAULT_SEED, (u64)stream + 1);
+}
+
+typedef void (*ZiRandomFillFn)(ZiRandom* rng, u32* out, u32 count, const f32* range);
+
+// ============================================================================
+// Portable
+// ============================================================================
+//
+// range is {min, max - min, largest value below max} when out receives floats, NULL for raw u32s.
+
+static void zi_random_fill_portable(ZiRandom* rng, u32* out, u32 count, const f32* range) {
+	if (!range) {
+		for (u32 i = 0; i < count; ++i) {
+			out[i] = zi_random_next_u32(rng);
+		}
+		return;
+	}
+
+	f32* values = (f32*)out;
+	for (u32 i = 0; i < count; ++i) {
+		values[i] = zi_min_f32(range[0] + zi_random_next_f32(rng) * range[1], range[2]);
+	}
+}
+
+// ============================================================================
+// AVX2
+// ============================================================================
+//
+// Eight copies of the generator, copy k starts k steps ahead and every copy jumps 8 steps per
+// iteration, so together they write the serial sequence. AVX2 has no 64 bit multiply, the low
+// half comes from three 32x32 products. Two registers hold the eight states, copies 0 1 4 5 in
+// one and 2 3 6 7 in the other, which is the order shuffle_ps leaves the 32 bit outputs in.
+
+#if ZI_ARCH_X86
+
+static ZI_TARGET("avx2,fma") __m256i zi_random_mul_u64_avx2(__m256i a, __m256i b, __m256i b_high) {
+	__m256i low = _mm256_mul_epu32(a, b);
+	__m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, b_high));
+	return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+// XSH RR on each 64 bit lane, the result sits in the low 32 bits
+static ZI_TARGET("avx2,fma") __m256i zi_random_output_avx2(__m256i state) {
+	__m256i xorshifted = _mm256_srli_epi64(_mm256_xor_si256(_mm256_srli_epi64(state, 18), state), 27);
+	__m256i rot = _mm256_srli_epi64(state, 59);
+	// shifting a 32 bit lane by 32 gives 0, which is the rot == 0 case
+	__m256i left = _mm256_sub_epi32(_mm256_set1_epi64x(32), rot);
+	return _mm256_or_si256(_mm256_srlv_epi32(xorshifted, rot), _mm256_sllv_epi32(xorshifted, left));
+}
+
+static ZI_TARGET("avx2,fma") void zi_random_fill_avx2(ZiRandom* rng, u32* out, u32 count, const f32* range) {
+	u32 full = count & ~7u;
+	if (full > 0) {
+		u64 lanes[8];
+		ZiRandom step = *rng;
+		for (u32 k = 0; k < 8; ++k) {
+			lanes[k] = step.state;
+			zi_random_next_u32(&step);
+		}
+		u64 mult, plus;
+		zi_random_jump_constants(rng->inc, 8, &mult, &plus);
+
+		__m256i a = _mm256_setr_epi64x((long long)lanes[0], (long long)lanes[1], (long long)lanes[4], (long long)lanes[5]);
+		__m256i b = _mm256_setr_epi64x((long long)lanes[2], (long long)lanes[3], (long long)lanes[6], (long long)lanes[7]);
+		__m256i m = _mm256_set1_epi64x((long long)mult);
+		__m256i m_high = _mm256_set1_epi64x((long long)(mult >> 32));
+		__m256i p = _mm256_set1_epi64x((long long)plus);
+
+		__m256 offset = _mm256_set1_ps(range ? range[0] : 0.0f);
+		__m256 scale = _mm256_set1_ps(range ? range[1] : 0.0f);
+		__m256 limit = _mm256_set1_ps(range ? range[2] : 0.0f);
+		__m256 unit = _mm256_set1_ps(1.0f / 16777216.0f);
+
+		for (u32 i = 0; i < full; i += 8) {
+			__m256i bits = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(zi_random_output_avx2(a)),
+			                                                     _mm256_castsi256_ps(zi_random_output_avx2(b)), _MM_SHUFFLE(2, 0, 2, 0)));
+			if (range) {
+				__m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 8)), unit);
+				// the second operand unless the first is smaller, like zi_min_f32
+				_mm256_storeu_ps((f32*)out + i, _mm256_min_ps(_mm256_add_ps(offset, _mm256_mul_ps(f, scale)), limit));
+			} else {
+				_mm256_storeu_si256((__m256i*)(out + i), bits);
+			}
+			a = _mm256_add_epi64(zi_random_mul_u64_avx2(a, m, m_high), p);
+			b = _mm256_add_epi64(zi_random_mul_u64_avx2(b, m, m_high), p);
+		}
+		// copy 0 is now full steps ahead of where it started
+		_mm256_storeu_si256((__m256i*)lanes, a);
+		rng->state = lanes[0];
+	}
+	zi_random_fill_portable(rng, out + full, count - full, range);
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+#if ZI_ARCH_X86
+#define ZI_RANDOM_AVX2(function) {ZiCpuFeature_AVX2 | ZiCpuFeature_FMA, (VoidPtr)function},
+#else
+#define ZI_RANDOM_AVX2(function)
+#endif
+
+static void zi_random_fill_resolve(ZiRandom* rng, u32* out, u32 count, const f32* range);
+static ZiRandomFillFn zi_random_fill_impl = zi_random_fill_resolve;
+
+static void zi_random_reset_dispatch(void) {
+	zi_random_fill_impl = zi_random_fill_resolve;
+}
+
+static void zi_random_fill_resolve(ZiRandom* rng, u32* out, u32 count, const f32* range) {
+	zi_platform_cpu_dispatch_register_reset(zi_random_reset_dispatch);
+	static const ZiCpuDispatch table[] = {ZI_RANDOM_AVX2(zi_random_fill_avx2) {0, (VoidPtr)zi_random_fill_portable}};
+	zi_random_fill_impl = (ZiRandomFillFn)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	zi_random_fill_impl(rng, out, count, range);
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+void zi_random_fill_u32(ZiRandom* rng, u32* out, u32 count) {
+	zi_random_fill_impl(rng, out, count, ZI_NULL);
+}
+
+void zi_random_fill_f32(ZiRandom* rng, f32* out, u32 count, f32 min_val, f32 max_val) {
+	f32 range[3] = {min_val, max_val - min_val, nextafterf(max_val, min_val)};
+	zi_random_fill_impl(rng, (u32*)out, count, range);
+}
@@ -0,0 +1,361 @@
+#include "zi_ray_packet.h"
+
+#include "zi_platform.h"
+
+#include <string.h>
+
+#if ZI_ARCH_X86
+#include <immintrin.h>
+#endif
+
+// lanes entering the box before t_max, t_near is F32_MAX for the others
+typedef u32 (*ZiRayPacketBoxFn)(const ZiRayPacket* packet, ZiVec3 min, ZiVec3 max, const f32* t_max, f32* t_near);
+// lanes hitting the triangle before t_max, t, u and v are only meaningful for those
+typedef u32 (*ZiRayPacketTriangleFn)(const ZiRayPacket* packet, const ZiBvhTriangle* tri, const f32* t_max, f32* t, f32* u, f32* v);
+
+typedef struct ZiRayPacketKernels {
+	ZiRayPacketBoxFn      box;
+	ZiRayPacketTriangleFn triangle;
+} ZiRayPacketKernels;
+
+static inline f32 zi_ray_packet_safe_inverse(f32 d) {
+	return zi_abs_f32(d) > 1e-30f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+}
+
+// ============================================================================
+// Portable
+// ============================================================================
+//
+// The scalar tests of zi_bvh.c once per lane.
+
+static u32 zi_ray_packet_box_portable(const ZiRayPacket* packet, ZiVec3 min, ZiVec3 max, const f32* t_max, f32* t_near) {
+	u32 mask = 0;
+	for (u32 lane = 0; lane < 8; ++lane) {
+		f32 tx1 = (min.x - packet->ox[lane]) * packet->inv_dx[lane];
+		f32 tx2 = (max.x - packet->ox[lane]) * packet->inv_dx[lane];
+		f32 ty1 = (min.y - packet->oy[lane]) * packet->inv_dy[lane];
+		f32 ty2 = (max.y - packet->oy[lane]) * packet->inv_dy[lane];
+		f32 tz1 = (min.z - packet->oz[lane]) * packet->inv_dz[lane];
+		f32 tz2 = (max.z - packet->oz[lane]) * packet->inv_dz[lane];
+		f32 enter = zi_max_f32(zi_max_f32(zi_min_f32(tx1, tx2), zi_min_f32(ty1, ty2)), zi_max_f32(zi_min_f32(tz1, tz2), 0.0f));
+		f32 leave = zi_min_f32(zi_min_f32(zi_max_f32(tx1, tx2), zi_max_f32(ty1, ty2)), zi_min_f32(zi_max_f32(tz1, tz2), t_max[lane]));
+		ZiBool hit = enter <= leave;
+		t_near[lane] = hit ? enter : F32_MAX;
+		mask |= (u32)hit << lane;
+	}
+	return mask;
+}
+
+static u32 zi_ray_packet_triangle_portable(const ZiRayPacket* packet, const ZiBvhTriangle* tri, const f32* t_max, f32* t, f32* u, f32* v) {
+	u32 mask = 0;
+	for (u32 lane = 0; lane < 8; ++lane) {
+		ZiVec3 dir = zi_vec3(packet->dx[lane], packet->dy[lane], packet->dz[lane]);
+		ZiVec3 h = zi_vec3_cross(dir, tri->e2);
+		f32    a = zi_vec3_dot(tri->e1, h);
+		if (zi_abs_f32(a) < ZI_EPSILON) continue;
+
+		f32    f = 1.0f / a;
+		ZiVec3 s = zi_vec3_sub(zi_vec3(packet->ox[lane], packet->oy[lane], packet->oz[lane]), tri->v0);
+		f32    lane_u = f * zi_vec3_dot(s, h);
+		if (lane_u < 0.0f || lane_u > 1.0f) continue;
+
+		ZiVec3 q = zi_vec3_cross(s, tri->e1);
+		f32    lane_v = f * zi_vec3_dot(dir, q);
+		if (lane_v < 0.0f || lane_u + lane_v > 1.0f) continue;
+
+		f32 lane_t = f * zi_vec3_dot(tri->e2, q);
+		if (lane_t < ZI_EPSILON || lane_t >= t_max[lane]) continue;
+
+		t[lane] = lane_t;
+		u[lane] = lane_u;
+		v[lane] = lane_v;
+		mask |= 1u << lane;
+	}
+	return mask;
+}
+
+// ============================================================================
+// AVX2 + FMA
+// ============================================================================
+
+#if ZI_ARCH_X86
+
+static ZI_TARGET("avx2,fma") u32 zi_ray_packet_box_avx2(const ZiRayPacket* packet, ZiVec3 min, ZiVec3 max, const f32* t_max, f32* t_near) {
+	__m256 ox = _mm256_load_ps(packet->ox);
+	__m256 oy = _mm256_load_ps(packet->oy);
+	__m256 oz = _mm256_load_ps(packet->oz);
+	__m256 ix = _mm256_load_ps(packet->inv_dx);
+	__m256 iy = _mm256_load_ps(packet->inv_dy);
+	__m256 iz = _mm256_load_ps(packet->inv_dz);
+	__m256 tx1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min.x), ox), ix);
+	__m256 tx2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max.x), ox), ix);
+	__m256 ty1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min.y), oy), iy);
+	__m256 ty2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max.y), oy), iy);
+	__m256 tz1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min.z), oz), iz);
+	__m256 tz2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max.z), oz), iz);
+	__m256 enter = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(tx1, tx2), _mm256_min_ps(ty1, ty2)),
+	                             _mm256_max_ps(_mm256_min_ps(tz1, tz2), _mm256_setzero_ps()));
+	__m256 leave = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(tx1, tx2), _mm256_max_ps(ty1, ty2)),
+	                             _mm256_min_ps(_mm256_max_ps(tz1, tz2), _mm256_load_ps(t_max)));
+	__m256 hit = _mm256_cmp_ps(enter, leave, _CMP_LE_OQ);
+	_mm256_store_ps(t_near, _mm256_blendv_ps(_mm256_set1_ps(F32_MAX), enter, hit));
+	return (u32)_mm256_movemask_ps(hit);
+}
+
+// The comparisons are the negated ones of the portable test, so a NaN passes the same way.
+static ZI_TARGET("avx2,fma") u32 zi_ray_packet_triangle_avx2(const ZiRayPacket* packet, const ZiBvhTriangle* tri, const f32* t_max, f32* t, f32* u,
+                                                            f32* v) {
+	__m256 dx = _mm256_load_ps(packet->dx);
+	__m256 dy = _mm256_load_ps(packet->dy);
+	__m256 dz = _mm256_load_ps(packet->dz);
+	__m256 e1x = _mm256_set1_ps(tri->e1.x);
+	__m256 e1y = _mm256_set1_ps(tri->e1.y);
+	__m256 e1z = _mm256_set1_ps(tri->e1.z);
+	__m256 e2x = _mm256_set1_ps(tri->e2.x);
+	__m256 e2y = _mm256_set1_ps(tri->e2.y);
+	__m256 e2z = _mm256_set1_ps(tri->e2.z);
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256 zero = _mm256_setzero_ps();
+
+	// h = dir x e2, a = e1 . h
+	__m256 hx = _mm256_fmsub_ps(dy, e2z, _mm256_mul_ps(dz, e2y));
+	__m256 hy = _mm256_fmsub_ps(dz, e2x, _mm256_mul_ps(dx, e2z));
+	__m256 hz = _mm256_fmsub_ps(dx, e2y, _mm256_mul_ps(dy, e2x));
+	__m256 a = _mm256_fmadd_ps(e1z, hz, _mm256_fmadd_ps(e1y, hy, _mm256_mul_ps(e1x, hx)));
+	__m256 abs_a = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+	__m256 valid = _mm256_cmp_ps(abs_a, _mm256_set1_ps(ZI_EPSILON), _CMP_NLT_UQ);
+	if (_mm256_movemask_ps(valid) == 0) return 0;
+
+	__m256 f = _mm256_div_ps(one, a);
+	__m256 sx = _mm256_sub_ps(_mm256_load_ps(packet->ox), _mm256_set1_ps(tri->v0.x));
+	__m256 sy = _mm256_sub_ps(_mm256_load_ps(packet->oy), _mm256_set1_ps(tri->v0.y));
+	__m256 sz = _mm256_sub_ps(_mm256_load_ps(packet->oz), _mm256_set1_ps(tri->v0.z));
+	__m256 lane_u = _mm256_mul_ps(f, _mm256_fmadd_ps(sz, hz, _mm256_fmadd_ps(sy, hy, _mm256_mul_ps(sx, hx))));
+	valid = _mm256_and_ps(valid, _mm256_cmp_ps(lane_u, zero, _CMP_NLT_UQ));
+	valid = _mm256_and_ps(valid, _mm256_cmp_ps(lane_u, one, _CMP_NGT_UQ));
+	if (_mm256_movemask_ps(valid) == 0) return 0;
+
+	// q = s x e1
+	__m256 qx = _mm256_fmsub_ps(sy, e1z, _mm256_mul_ps(sz, e1y));
+	__m256 qy = _mm256_fmsub_ps(sz, e1x, _mm256_mul_ps(sx, e1z));
+	__m256 qz = _mm256_fmsub_ps(sx, e1y, _mm256_mul_ps(sy, e1x));
+	__m256 lane_v = _mm256_mul_ps(f, _mm256_fmadd_ps(dz, qz, _mm256_fmadd_ps(dy, qy, _mm256_mul_ps(dx, qx))));
+	valid = _mm256_and_ps(valid, _mm256_cmp_ps(lane_v, zero, _CMP_NLT_UQ));
+	valid = _mm256_and_ps(valid, _mm256_cmp_ps(_mm256_add_ps(lane_u, lane_v), one, _CMP_NGT_UQ));
+
+	__m256 lane_t = _mm256_mul_ps(f, _mm256_fmadd_ps(e2z, qz, _mm256_fmadd_ps(e2y, qy, _mm256_mul_ps(e2x, qx))));
+	valid = _mm256_and_ps(valid, _mm256_cmp_ps(lane_t, _mm256_set1_ps(ZI_EPSILON), _CMP_NLT_UQ));
+	valid = _mm256_and_ps(valid, _mm256_cmp_ps(lane_t, _mm256_load_ps(t_max), _CMP_NGE_UQ));
+
+	u32 mask = (u32)_mm256_movemask_ps(valid);
+	if (mask) {
+		_mm256_store_ps(t, lane_t);
+		_mm256_store_ps(u, lane_u);
+		_mm256_store_ps(v, lane_v);
+	}
+	return mask;
+}
+
+#endif
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+static const ZiRayPacketKernels zi_ray_packet_kernels_portable = {zi_ray_packet_box_portable, zi_ray_packet_triangle_portable};
+
+#if ZI_ARCH_X86
+static const ZiRayPacketKernels zi_ray_packet_kernels_avx2 = {zi_ray_packet_box_avx2, zi_ray_packet_triangle_avx2};
+#define ZI_RAY_PACKET_AVX2(kernels) {ZiCpuFeature_AVX2 | ZiCpuFeature_FMA, (VoidPtr)&kernels},
+#else
+#define ZI_RAY_PACKET_AVX2(kernels)
+#endif
+
+static const ZiRayPacketKernels* zi_ray_packet_kernels = ZI_NULL;
+
+static void zi_ray_packet_reset_dispatch(void) {
+	zi_ray_packet_kernels = ZI_NULL;
+}
+
+static const ZiRayPacketKernels* zi_ray_packet_resolve(void) {
+	if (!zi_ray_packet_kernels) {
+		zi_platform_cpu_dispatch_register_reset(zi_ray_packet_reset_dispatch);
+		static const ZiCpuDispatch table[] = {ZI_RAY_PACKET_AVX2(zi_ray_packet_kernels_avx2) {0, (VoidPtr)&zi_ray_packet_kernels_portable}};
+		zi_ray_packet_kernels = (const ZiRayPacketKernels*)zi_platform_cpu_dispatch(table, sizeof(table) / sizeof(table[0]));
+	}
+	return zi_ray_packet_kernels;
+}
+
+// ============================================================================
+// Packets
+// ============================================================================
+
+void zi_ray_packet_init(ZiRayPacket* packet, const ZiRay* rays, u32 count, f32 max_t) {
+	memset(packet, 0, sizeof(*packet));
+	for (u32 lane = 0; lane < 8; ++lane) {
+		if (lane >= count) {
+			packet->t_max[lane] = -1.0f;
+			continue;
+		}
+		ZiRay ray = rays[lane];
+		packet->ox[lane] = ray.origin.x;
+		packet->oy[lane] = ray.origin.y;
+		packet->oz[lane] = ray.origin.z;
+		packet->dx[lane] = ray.direction.x;
+		packet->dy[lane] = ray.direction.y;
+		packet->dz[lane] = ray.direction.z;
+		packet->inv_dx[lane] = zi_ray_packet_safe_inverse(ray.direction.x);
+		packet->inv_dy[lane] = zi_ray_packet_safe_inverse(ray.direction.y);
+		packet->inv_dz[lane] = zi_ray_packet_safe_inverse(ray.direction.z);
+		packet->t_max[lane] = max_t;
+		packet->active |= 1u << lane;
+	}
+}
+
+u32 zi_ray_packet_intersect_aabb(const ZiRayPacket* packet, ZiAABB box, f32* t_near) {
+	ZI_ALIGN(32) f32 enter[8];
+	u32              mask = zi_ray_packet_resolve()->box(packet, box.min, box.max, packet->t_max, enter);
+	if (t_near) memcpy(t_near, enter, sizeof(enter));
+	return mask;
+}
+
+u32 zi_ray_packet_intersect_triangle(const ZiRayPacket* packet, ZiTriangle triangle, f32* t, f32* u, f32* v) {
+	ZiBvhTriangle    tri = {triangle.v0, zi_vec3_sub(triangle.v1, triangle.v0), zi_vec3_sub(triangle.v2, triangle.v0)};
+	ZI_ALIGN(32) f32 lane_t[8], lane_u[8], lane_v[8];
+	u32              mask = zi_ray_packet_resolve()->triangle(packet, &tri, packet->t_max, lane_t, lane_u, lane_v);
+	for (u32 lane = 0; lane < 8; ++lane) {
+		if (!(mask & (1u << lane))) continue;
+		if (t) t[lane] = lane_t[lane];
+		if (u) u[lane] = lane_u[lane];
+		if (v) v[lane] = lane_v[lane];
+	}
+	return mask;
+}
+
+// ============================================================================
+// Packet traversal
+// ============================================================================
+
+// The scalar traversal of zi_bvh.c with a lane mask for the ray. Both children are tested for
+// the whole packet and the one the first lane reaches first goes first. The other is stacked
+// with every lane's entry distance and skipped once no lane can still reach it before its
+// best hit. A lane done with an any query gets a negative t_max and drops out of every test.
+static u32 zi_ray_packet_traverse(const ZiBvh* bvh, const ZiRayPacket* packet, ZiBool any, ZiRayPacketHit* hits) {
+	const ZiRayPacketKernels* kernels = zi_ray_packet_resolve();
+	ZI_ALIGN(32) f32          best_t[8];
+	memcpy(best_t, packet->t_max, sizeof(best_t));
+	for (u32 lane = 0; lane < 8; ++lane) {
+		hits->t[lane] = packet->t_max[lane];
+		hits->u[lane] = 0.0f;
+		hits->v[lane] = 0.0f;
+		hits->triangle[lane] = ZI_RAY_PACKET_MISS;
+	}
+	if (bvh->node_count == 0) return 0;
+
+	ZI_ALIGN(32) f32 near_t[8], far_t[8], t[8], u[8], v[8];
+	if (!kernels->box(packet, bvh->nodes[0].min, bvh->nodes[0].max, best_t, near_t)) return 0;
+
+	u32              stack[ZI_BVH_MAX_DEPTH];
+	ZI_ALIGN(32) f32 stack_t[ZI_BVH_MAX_DEPTH][8];
+	u32              top = 0;
+	u32              index = 0;
+	u32              found = 0;
+
+	for (;;) {
+		const ZiBvhNode* node = &bvh->nodes[index];
+		if (node->count > 0) {
+			for (u32 i = node->first; i < node->first + node->count; ++i) {
+				u32 mask = kernels->triangle(packet, &bvh->triangles[i], best_t, t, u, v);
+				if (!mask) continue;
+				for (u32 lane = 0; lane < 8; ++lane) {
+					if (!(mask & (1u << lane))) continue;
+					hits->t[lane] = t[lane];
+					hits->u[lane] = u[lane];
+					hits->v[lane] = v[lane];
+					hits->triangle[lane] = bvh->indices[i];
+					best_t[lane] = any ? -1.0f : t[lane];
+				}
+				found |= mask;
+				if (any && (packet->active & ~found) == 0) return found;
+			}
+		} else {
+			u32 near = node->first;
+			u32 far = node->first + 1;
+			u32 near_mask = kernels->box(packet, bvh->nodes[near].min, bvh->nodes[near].max, best_t, near_t);
+			u32 far_mask = kernels->box(packet, bvh->nodes[far].min, bvh->nodes[far].max, best_t, far_t);
+			if (near_mask && far_mask) {
+				u32 lane = 0;
+				while (!((near_mask | far_mask) & (1u << lane))) {
+					++lane;
+				}
+				ZiBool swap = far_t[lane] < near_t[lane];
+				stack[top] = swap ? near : far;
+				memcpy(stack_t[top++], swap ? near_t : far_t, sizeof(near_t));
+				index = swap ? far : near;
+				continue;
+			}
+			if (near_mask || far_mask) {
+				index = near_mask ? near : far;
+				continue;
+			}
+		}
+
+		// next stacked node some lane still reaches before its best hit
+		for (;;) {
+			if (top == 0) return found;
+			--top;
+			ZiBool reached = ZI_FALSE;
+			for (u32 lane = 0; lane < 8; ++lane) {
+				reached |= stack_t[top][lane] < best_t[lane];
+			}
+			if (reached) break;
+		}
+		index = stack[top];
+	}
+}
+
+u32 zi_bvh_raycast_packet(const ZiBvh* bvh, const ZiRayPacket* packet, ZiRayPacketHit* hits) {
+	return zi_ray_packet_traverse(bvh, packet, ZI_FALSE, hits);
+}
+
+u32 zi_bvh_raycast_packet_any(const ZiBvh* bvh, const ZiRayPacket* packet) {
+	ZiRayPacketHit hits;
+	return zi_ray_packet_traverse(bvh, packet, ZI_TRUE, &hits);
+}
+
+u32 zi_bvh_raycast_rays(const ZiBvh* bvh, const ZiRay* rays, u32 count, f32 max_t, ZiBvhHit* hits) {
+	ZiRayPacket    packet;
+	ZiRayPacketHit packet_hits;
+	u32            hit_count = 0;
+	for (u32 base = 0; base < count; base += 8) {
+		u32 lanes = count - base < 8 ? count - base : 8;
+		zi_ray_packet_init(&packet, rays + base, lanes, max_t);
+		u32 mask = zi_bvh_raycast_packet(bvh, &packet, &packet_hits);
+		for (u32 lane = 0; lane < lanes; ++lane) {
+			ZiBvhHit* hit = &hits[base + lane];
+			hit->t = packet_hits.t[lane];
+			hit->u = packet_hits.u[lane];
+			hit->v = packet_hits.v[lane];
+			hit->triangle = packet_hits.triangle[lane];
+			hit_count += (mask >> lane) & 1;
+		}
+	}
+	return hit_count;
+}
+
+u32 zi_bvh_raycast_rays_any(const ZiBvh* bvh, const ZiRay* rays, u32 count, f32 max_t, u32* hit_bits) {
+	ZiRayPacket packet;
+	u32         hit_count = 0;
+	for (u32 base = 0; base < count; base += 8) {
+		u32 lanes = count - base < 8 ? count - base : 8;
+		zi_ray_packet_init(&packet, rays + base, lanes, max_t);
+		u32 mask = zi_bvh_raycast_packet_any(bvh, &packet);
+		// 8 lanes per packet, 4 packets to a word
+		if ((base & 31) == 0) hit_bits[base / 32] = 0;
+		hit_bits[base / 32] |= mask << (base & 31);
+		for (u32 lane = 0; lane < lanes; ++lane) {
+			hit_count += (mask >> lane) & 1;
+		}
+	}
+	return hit_count;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "zi_bvh.h"
+#include "zi_common.h"
+#include "zi_math.h"
+
+// ============================================================================
+// Ray packets
+// ============================================================================
+//
+// Eight rays side by side in structure-of-arrays form, tested against a box or a triangle
+// at once: 8 lanes per instruction with AVX2 + FMA, plain loops the compiler vectorizes
+// elsewhere, picked at the first call through zi_platform_cpu_dispatch. Per lane the answers
+// are those of zi_bvh_raycast up to rounding.
+//
+// The packet goes down a ZiBvh together, a node is visited when any lane reaches it. That pays
+// off for coherent rays, ones from about the same origin in about the same direction, like the
+// rays of one probe or one listener. Scattered rays keep most lanes idle, trace those on their own.
+
+#define ZI_RAY_PACKET_SIZE 8
+// triangle of a lane that hit nothing
+#define ZI_RAY_PACKET_MISS 0xffffffffu
+
+typedef struct ZI_ALIGN(32) ZiRayPacket {
+	f32 ox[8], oy[8], oz[8];
+	f32 dx[8], dy[8], dz[8];
+	// 1 / direction, axis-parallel components get a huge finite value like zi_bvh.c
+	f32 inv_dx[8], inv_dy[8], inv_dz[8];
+	// below 0 for unused lanes so they never hit
+	f32 t_max[8];
+	// bit per lane in use
+	u32 active;
+} ZiRayPacket;
+
+typedef struct ZI_ALIGN(32) ZiRayPacketHit {
+	f32 t[8];
+	// barycentrics, weight of v1 and v2
+	f32 u[8];
+	f32 v[8];
+	// index in the build input, ZI_RAY_PACKET_MISS for lanes without a hit
+	u32 triangle[8];
+} ZiRayPacketHit;
+
+// the first count rays (at most 8) fill the lanes from 0, the rest stay unused
+void zi_ray_packet_init(ZiRayPacket* packet, const ZiRay* rays, u32 count, f32 max_t);
+
+// Lanes entering the box in [0, t_max], as a bit mask. t_near gets the entry distance of those
+// lanes and F32_MAX for the others, it may be NULL.
+u32 zi_ray_packet_intersect_aabb(const ZiRayPacket* packet, ZiAABB box, f32* t_near);
+// Lanes hitting the triangle in (ZI_EPSILON, t_max) like zi_ray_triangle_intersect. t, u and v
+// are written for those lanes only, any of them may be NULL.
+u32 zi_ray_packet_intersect_triangle(const ZiRayPacket* packet, ZiTriangle triangle, f32* t, f32* u, f32* v);
+
+// ============================================================================
+// Packet traversal
+// ============================================================================
+
+// nearest hit per lane, returns the lanes that hit something. Lanes that missed keep t_max as t.
+u32 zi_bvh_raycast_packet(const ZiBvh* bvh, const ZiRayPacket* packet, ZiRayPacketHit* hits);
+// lanes that hit anything, each stops looking at its first triangle
+u32 zi_bvh_raycast_packet_any(const ZiBvh* bvh, const ZiRayPacket* packet);
+
+// Whole arrays, packed 8 consecutive rays at a time, so order them for coherence. hits[i] of a
+// miss gets triangle ZI_RAY_PACKET_MISS. Returns how many hit.
+u32 zi_bvh_raycast_rays(const ZiBvh* bvh, const ZiRay* rays, u32 count, f32 max_t, ZiBvhHit* hits);
+// bit i of hit_bits[i / 32] is set when ray i hits anything, bits past count are cleared
+u32 zi_bvh_raycast_rays_any(const ZiBvh* bvh, const ZiRay* rays, u32 count, f32 max_t, u32* hit_bits);
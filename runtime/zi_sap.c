@@ -0,0 +1,496 @@
+#include "zi_sap.h"
+
+#include "zi_log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ZI_SAP_INITIAL_CAPACITY 64
+
+// which swaps to look at, inserts can't end a pair
+#define ZI_SAP_TRACK_BEGIN 1u
+#define ZI_SAP_TRACK_END   2u
+#define ZI_SAP_TRACK_ALL   (ZI_SAP_TRACK_BEGIN | ZI_SAP_TRACK_END)
+
+ZI_HASHMAP(ZiSapPairIndex, u64, u32)
+
+// ============================================================================
+// Pairs
+// ============================================================================
+
+static inline u64 zi_sap_pair_key(u32 a, u32 b) {
+	return a < b ? ((u64)a << 32) | b : ((u64)b << 32) | a;
+}
+
+// which of the pair's links belong to handle's list
+static inline u32 zi_sap_pair_side(const ZiSap* sap, u32 pair, u32 handle) {
+	return sap->pairs.data[pair].a == handle ? 0 : 1;
+}
+
+// points whatever linked to the pair at from, the proxy's head included, at to instead
+static void zi_sap_relink_pair(ZiSap* sap, u32 from, u32 to) {
+	ZiSapPair      pair = sap->pairs.data[from];
+	ZiSapPairLinks links = sap->pair_links.data[from];
+	for (u32 side = 0; side < 2; ++side) {
+		u32 handle = side ? pair.b : pair.a;
+		if (links.prev[side] == ZI_SAP_NULL) {
+			sap->proxies[handle].pairs = to;
+		} else {
+			sap->pair_links.data[links.prev[side]].next[zi_sap_pair_side(sap, links.prev[side], handle)] = to;
+		}
+		if (links.next[side] != ZI_SAP_NULL) {
+			sap->pair_links.data[links.next[side]].prev[zi_sap_pair_side(sap, links.next[side], handle)] = to;
+		}
+	}
+}
+
+static void zi_sap_unlink_pair(ZiSap* sap, u32 index) {
+	ZiSapPair      pair = sap->pairs.data[index];
+	ZiSapPairLinks links = sap->pair_links.data[index];
+	for (u32 side = 0; side < 2; ++side) {
+		u32 handle = side ? pair.b : pair.a;
+		if (links.prev[side] == ZI_SAP_NULL) {
+			sap->proxies[handle].pairs = links.next[side];
+		} else {
+			sap->pair_links.data[links.prev[side]].next[zi_sap_pair_side(sap, links.prev[side], handle)] = links.next[side];
+		}
+		if (links.next[side] != ZI_SAP_NULL) {
+			sap->pair_links.data[links.next[side]].prev[zi_sap_pair_side(sap, links.next[side], handle)] = links.prev[side];
+		}
+	}
+}
+
+static void zi_sap_add_pair(ZiSap* sap, u32 a, u32 b) {
+	u64 key = zi_sap_pair_key(a, b);
+	if (ZiSapPairIndex_has(sap->pair_index, key)) return;
+
+	ZiSapPair pair = {(u32)(key >> 32), (u32)key};
+	u32       index = (u32)sap->pairs.count;
+	ZiSapPairIndex_set(sap->pair_index, key, index);
+	ZiSapPairArray_push(&sap->pairs, pair);
+	// at the front of both lists
+	ZiSapPairLinks links = {{ZI_SAP_NULL, ZI_SAP_NULL}, {sap->proxies[pair.a].pairs, sap->proxies[pair.b].pairs}};
+	ZiSapPairLinksArray_push(&sap->pair_links, links);
+	for (u32 side = 0; side < 2; ++side) {
+		u32 handle = side ? pair.b : pair.a;
+		u32 first = sap->proxies[handle].pairs;
+		if (first != ZI_SAP_NULL) {
+			sap->pair_links.data[first].prev[zi_sap_pair_side(sap, first, handle)] = index;
+		}
+		sap->proxies[handle].pairs = index;
+	}
+	ZiSapEventArray_push(&sap->events, (ZiSapEvent){pair.a, pair.b, ZI_SAP_EVENT_ADDED});
+}
+
+static void zi_sap_remove_pair(ZiSap* sap, u32 a, u32 b) {
+	u64  key = zi_sap_pair_key(a, b);
+	u32* index = ZiSapPairIndex_get(sap->pair_index, key);
+	if (!index) return;
+
+	u32 i = *index;
+	ZiSapPairIndex_remove(sap->pair_index, key);
+	zi_sap_unlink_pair(sap, i);
+	u32 last = (u32)sap->pairs.count - 1;
+	if (i != last) {
+		ZiSapPair moved = sap->pairs.data[last];
+		ZiSapPairIndex_set(sap->pair_index, zi_sap_pair_key(moved.a, moved.b), i);
+		zi_sap_relink_pair(sap, last, i);
+	}
+	ZiSapPairArray_remove_swap(&sap->pairs, i);
+	ZiSapPairLinksArray_remove_swap(&sap->pair_links, i);
+	ZiSapEventArray_push(&sap->events, (ZiSapEvent){(u32)(key >> 32), (u32)key, ZI_SAP_EVENT_REMOVED});
+
+	// removals leave deleted slots behind that every lookup has to step over, rebuild the
+	// index in place once there are a lot of them
+	if (++sap->pair_removals > sap->pair_index->capacity / 4) {
+		ZiSapPairIndex_rehash(sap->pair_index, sap->pair_index->capacity);
+		sap->pair_removals = 0;
+	}
+}
+
+// ============================================================================
+// Endpoints
+// ============================================================================
+
+// by value, a min before a max of the same value so touching boxes overlap
+static inline ZiBool zi_sap_less(ZiSapEndpoint a, ZiSapEndpoint b) {
+	return a.value < b.value || (a.value == b.value && (a.data & 1) < (b.data & 1));
+}
+
+static inline void zi_sap_place(ZiSap* sap, u32 axis, u32 index, ZiSapEndpoint e) {
+	sap->endpoints[axis][index] = e;
+	ZiSapProxy* proxy = &sap->proxies[e.data >> 1];
+	if (e.data & 1) {
+		proxy->max[axis] = index;
+	} else {
+		proxy->min[axis] = index;
+	}
+}
+
+// A min passing a max is where two boxes start to overlap on this axis, both other axes
+// decide whether they overlap for real. A max passing a min ends it whatever the other axes say.
+static inline void zi_sap_swap_event(ZiSap* sap, u32 a, u32 b, ZiBool begin, u32 track) {
+	if (begin) {
+		if ((track & ZI_SAP_TRACK_BEGIN) && zi_aabb_aabb_intersect(sap->proxies[a].aabb, sap->proxies[b].aabb)) {
+			zi_sap_add_pair(sap, a, b);
+		}
+	} else if (track & ZI_SAP_TRACK_END) {
+		zi_sap_remove_pair(sap, a, b);
+	}
+}
+
+// moves the endpoint at index left to where it belongs
+static void zi_sap_sort_down(ZiSap* sap, u32 axis, u32 index, u32 track) {
+	ZiSapEndpoint* ends = sap->endpoints[axis];
+	ZiSapEndpoint  e = ends[index];
+	u32            handle = e.data >> 1;
+	while (index > 0 && zi_sap_less(e, ends[index - 1])) {
+		ZiSapEndpoint prev = ends[index - 1];
+		if ((e.data ^ prev.data) & 1) {
+			// our min going below their max begins, our max going below their min ends
+			zi_sap_swap_event(sap, handle, prev.data >> 1, !(e.data & 1), track);
+		}
+		zi_sap_place(sap, axis, index, prev);
+		--index;
+	}
+	zi_sap_place(sap, axis, index, e);
+}
+
+// moves the endpoint at index right to where it belongs
+static void zi_sap_sort_up(ZiSap* sap, u32 axis, u32 index, u32 track) {
+	ZiSapEndpoint* ends = sap->endpoints[axis];
+	ZiSapEndpoint  e = ends[index];
+	u32            handle = e.data >> 1;
+	while (index + 1 < sap->endpoint_count && zi_sap_less(ends[index + 1], e)) {
+		ZiSapEndpoint next = ends[index + 1];
+		if ((e.data ^ next.data) & 1) {
+			// our max going above their min begins, our min going above their max ends
+			zi_sap_swap_event(sap, handle, next.data >> 1, (e.data & 1) != 0, track);
+		}
+		zi_sap_place(sap, axis, index, next);
+		++index;
+	}
+	zi_sap_place(sap, axis, index, e);
+}
+
+// Both values are written first. An endpoint never passes its own partner, so the one moving
+// up goes first when the max grows, otherwise the min goes first, or the partner would block
+// it at its old place.
+static void zi_sap_sort_proxy(ZiSap* sap, u32 handle, ZiAABB old, u32 track) {
+	ZiSapProxy* proxy = &sap->proxies[handle];
+	for (u32 axis = 0; axis < 3; ++axis) {
+		f32 old_min = (&old.min.x)[axis];
+		f32 old_max = (&old.max.x)[axis];
+		f32 new_min = (&proxy->aabb.min.x)[axis];
+		f32 new_max = (&proxy->aabb.max.x)[axis];
+		sap->endpoints[axis][proxy->min[axis]].value = new_min;
+		sap->endpoints[axis][proxy->max[axis]].value = new_max;
+
+		if (new_max > old_max) {
+			zi_sap_sort_up(sap, axis, proxy->max[axis], track);
+		}
+		if (new_min < old_min) {
+			zi_sap_sort_down(sap, axis, proxy->min[axis], track);
+		} else if (new_min > old_min) {
+			zi_sap_sort_up(sap, axis, proxy->min[axis], track);
+		}
+		if (new_max < old_max) {
+			zi_sap_sort_down(sap, axis, proxy->max[axis], track);
+		}
+	}
+}
+
+static ZiBool zi_sap_grow(ZiSap* sap) {
+	u32             capacity = sap->proxy_capacity ? sap->proxy_capacity * 2 : ZI_SAP_INITIAL_CAPACITY;
+	ZiSapProxy*     proxies = (ZiSapProxy*)zi_mem_alloc(sizeof(ZiSapProxy) * (u64)capacity);
+	ZiSapEndpoint*  endpoints[3];
+	ZiBool          ok = proxies != ZI_NULL;
+	for (u32 axis = 0; axis < 3; ++axis) {
+		endpoints[axis] = (ZiSapEndpoint*)zi_mem_alloc(sizeof(ZiSapEndpoint) * 2 * (u64)capacity);
+		ok = ok && endpoints[axis];
+	}
+	if (!ok) {
+		zi_log_error("out of memory growing a sweep and prune to %u objects", capacity);
+		zi_mem_free(proxies);
+		for (u32 axis = 0; axis < 3; ++axis) {
+			zi_mem_free(endpoints[axis]);
+		}
+		return ZI_FALSE;
+	}
+
+	if (sap->proxy_capacity) {
+		memcpy(proxies, sap->proxies, sizeof(ZiSapProxy) * sap->proxy_capacity);
+		zi_mem_free(sap->proxies);
+		for (u32 axis = 0; axis < 3; ++axis) {
+			memcpy(endpoints[axis], sap->endpoints[axis], sizeof(ZiSapEndpoint) * sap->endpoint_count);
+			zi_mem_free(sap->endpoints[axis]);
+		}
+	}
+	// the free list is empty whenever this runs
+	for (u32 i = sap->proxy_capacity; i < capacity; ++i) {
+		proxies[i].next = i + 1 < capacity ? i + 1 : ZI_SAP_NULL;
+	}
+	sap->free_list = sap->proxy_capacity;
+	sap->proxies = proxies;
+	sap->proxy_capacity = capacity;
+	for (u32 axis = 0; axis < 3; ++axis) {
+		sap->endpoints[axis] = endpoints[axis];
+	}
+	return ZI_TRUE;
+}
+
+// ============================================================================
+// Sweep and prune
+// ============================================================================
+
+ZiBool zi_sap_init(ZiSap* sap) {
+	memset(sap, 0, sizeof(*sap));
+	sap->free_list = ZI_SAP_NULL;
+	sap->retired_list = ZI_SAP_NULL;
+	sap->pair_index = (struct ZiSapPairIndex*)zi_mem_alloc(sizeof(ZiSapPairIndex));
+	if (!sap->pair_index) {
+		zi_log_error("out of memory creating a sweep and prune");
+		return ZI_FALSE;
+	}
+	ZiSapPairIndex_init(sap->pair_index, ZI_NULL);
+	ZiSapPairArray_init(&sap->pairs, ZI_NULL);
+	ZiSapPairLinksArray_init(&sap->pair_links, ZI_NULL);
+	ZiSapEventArray_init(&sap->events, ZI_NULL);
+	return ZI_TRUE;
+}
+
+void zi_sap_destroy(ZiSap* sap) {
+	if (sap->pair_index) {
+		ZiSapPairIndex_free(sap->pair_index);
+		zi_mem_free(sap->pair_index);
+	}
+	ZiSapPairArray_free(&sap->pairs);
+	ZiSapPairLinksArray_free(&sap->pair_links);
+	ZiSapEventArray_free(&sap->events);
+	zi_mem_free(sap->proxies);
+	for (u32 axis = 0; axis < 3; ++axis) {
+		zi_mem_free(sap->endpoints[axis]);
+	}
+	memset(sap, 0, sizeof(*sap));
+}
+
+u32 zi_sap_insert(ZiSap* sap, ZiAABB aabb, VoidPtr user_data) {
+	if (sap->free_list == ZI_SAP_NULL && !zi_sap_grow(sap)) return ZI_SAP_NULL;
+
+	u32         handle = sap->free_list;
+	ZiSapProxy* proxy = &sap->proxies[handle];
+	sap->free_list = proxy->next;
+	proxy->next = ZI_SAP_NULL;
+	proxy->pairs = ZI_SAP_NULL;
+	proxy->aabb = aabb;
+	proxy->user_data = user_data;
+	sap->proxy_count++;
+
+	// appended at the top of every axis, then sorted down into place
+	u32 top = sap->endpoint_count;
+	sap->endpoint_count += 2;
+	for (u32 axis = 0; axis < 3; ++axis) {
+		zi_sap_place(sap, axis, top, (ZiSapEndpoint){(&aabb.min.x)[axis], handle << 1});
+		zi_sap_place(sap, axis, top + 1, (ZiSapEndpoint){(&aabb.max.x)[axis], (handle << 1) | 1});
+		zi_sap_sort_down(sap, axis, top, ZI_SAP_TRACK_BEGIN);
+		zi_sap_sort_down(sap, axis, top + 1, ZI_SAP_TRACK_BEGIN);
+	}
+	return handle;
+}
+
+static int zi_sap_endpoint_compare(const void* a, const void* b) {
+	ZiSapEndpoint x = *(const ZiSapEndpoint*)a;
+	ZiSapEndpoint y = *(const ZiSapEndpoint*)b;
+	return zi_sap_less(x, y) ? -1 : (zi_sap_less(y, x) ? 1 : 0);
+}
+
+// One insert at a time bubbles through half the array on average, quadratic when filling a
+// level. Here the new endpoints are sorted on their own and merged in, and one sweep along x
+// finds their pairs: a box's min meets every box whose interval is still open.
+ZiBool zi_sap_insert_batch(ZiSap* sap, const ZiAABB* aabbs, VoidPtr const* user_data, u32 count, u32* handles) {
+	if (count == 0) return ZI_TRUE;
+	for (u32 i = 0; i < count; ++i) {
+		if (sap->free_list == ZI_SAP_NULL && !zi_sap_grow(sap)) {
+			// the ones taken so far go back, nothing was sorted yet
+			while (i-- > 0) {
+				sap->proxies[handles[i]].next = sap->free_list;
+				sap->free_list = handles[i];
+			}
+			return ZI_FALSE;
+		}
+		handles[i] = sap->free_list;
+		sap->free_list = sap->proxies[handles[i]].next;
+	}
+
+	u32            old_count = sap->endpoint_count;
+	u32            total = old_count + 2 * count;
+	ZiSapEndpoint* merged = (ZiSapEndpoint*)zi_mem_alloc(sizeof(ZiSapEndpoint) * (u64)total);
+	u32*           active = (u32*)zi_mem_alloc(sizeof(u32) * (u64)(total / 2));
+	u32*           active_slot = (u32*)zi_mem_alloc(sizeof(u32) * (u64)sap->proxy_capacity);
+	u8*            is_new = (u8*)zi_mem_alloc(sap->proxy_capacity);
+	if (!merged || !active || !active_slot || !is_new) {
+		zi_log_error("out of memory inserting %u objects into a sweep and prune", count);
+		zi_mem_free(merged);
+		zi_mem_free(active);
+		zi_mem_free(active_slot);
+		zi_mem_free(is_new);
+		for (u32 i = count; i-- > 0;) {
+			sap->proxies[handles[i]].next = sap->free_list;
+			sap->free_list = handles[i];
+		}
+		return ZI_FALSE;
+	}
+
+	memset(is_new, 0, sap->proxy_capacity);
+	for (u32 i = 0; i < count; ++i) {
+		ZiSapProxy* proxy = &sap->proxies[handles[i]];
+		proxy->aabb = aabbs[i];
+		proxy->user_data = user_data ? user_data[i] : ZI_NULL;
+		proxy->next = ZI_SAP_NULL;
+		proxy->pairs = ZI_SAP_NULL;
+		is_new[handles[i]] = 1;
+	}
+	sap->proxy_count += count;
+	sap->endpoint_count = total;
+
+	for (u32 axis = 0; axis < 3; ++axis) {
+		ZiSapEndpoint* ends = sap->endpoints[axis];
+		for (u32 i = 0; i < count; ++i) {
+			ends[old_count + 2 * i] = (ZiSapEndpoint){(&aabbs[i].min.x)[axis], handles[i] << 1};
+			ends[old_count + 2 * i + 1] = (ZiSapEndpoint){(&aabbs[i].max.x)[axis], (handles[i] << 1) | 1};
+		}
+		qsort(ends + old_count, 2 * count, sizeof(ZiSapEndpoint), zi_sap_endpoint_compare);
+
+		u32 a = 0;
+		u32 b = old_count;
+		for (u32 i = 0; i < total; ++i) {
+			merged[i] = b >= total || (a < old_count && !zi_sap_less(ends[b], ends[a])) ? ends[a++] : ends[b++];
+		}
+		for (u32 i = 0; i < total; ++i) {
+			zi_sap_place(sap, axis, i, merged[i]);
+		}
+	}
+
+	u32                  active_count = 0;
+	const ZiSapEndpoint* ends = sap->endpoints[0];
+	for (u32 i = 0; i < total; ++i) {
+		u32 handle = ends[i].data >> 1;
+		if (ends[i].data & 1) {
+			u32 slot = active_slot[handle];
+			active[slot] = active[--active_count];
+			active_slot[active[slot]] = slot;
+			continue;
+		}
+		for (u32 k = 0; k < active_count; ++k) {
+			u32 other = active[k];
+			if ((is_new[handle] || is_new[other]) && zi_aabb_aabb_intersect(sap->proxies[handle].aabb, sap->proxies[other].aabb)) {
+				zi_sap_add_pair(sap, handle, other);
+			}
+		}
+		active_slot[handle] = active_count;
+		active[active_count++] = handle;
+	}
+
+	zi_mem_free(merged);
+	zi_mem_free(active);
+	zi_mem_free(active_slot);
+	zi_mem_free(is_new);
+	return ZI_TRUE;
+}
+
+// Its endpoints are taken out where the proxy says they are and everything above them shifts
+// down, sorting them past the rest wouldn't work for boxes already out at F32_MAX or infinity.
+void zi_sap_remove(ZiSap* sap, u32 handle) {
+	ZiSapProxy* proxy = &sap->proxies[handle];
+	// only its own pairs, each removal unlinks the first one
+	while (proxy->pairs != ZI_SAP_NULL) {
+		ZiSapPair pair = sap->pairs.data[proxy->pairs];
+		zi_sap_remove_pair(sap, pair.a, pair.b);
+	}
+
+	for (u32 axis = 0; axis < 3; ++axis) {
+		ZiSapEndpoint* ends = sap->endpoints[axis];
+		u32            low = proxy->min[axis];
+		u32            high = proxy->max[axis];
+		for (u32 i = low + 1; i < sap->endpoint_count; ++i) {
+			if (i == high) continue;
+			zi_sap_place(sap, axis, i - (i > high ? 2 : 1), ends[i]);
+		}
+	}
+	sap->endpoint_count -= 2;
+
+	proxy->user_data = ZI_NULL;
+	proxy->next = sap->retired_list;
+	sap->retired_list = handle;
+	sap->proxy_count--;
+}
+
+void zi_sap_move(ZiSap* sap, u32 handle, ZiAABB aabb) {
+	ZiSapProxy* proxy = &sap->proxies[handle];
+	ZiAABB      old = proxy->aabb;
+	proxy->aabb = aabb;
+	zi_sap_sort_proxy(sap, handle, old, ZI_SAP_TRACK_ALL);
+}
+
+// With most objects moving, every value is written first and each axis gets one insertion
+// sort pass. An endpoint swaps with another at most once per pass, and every box already has
+// its new bounds, so a begin swap only adds pairs that overlap at the end and an end swap
+// only removes pairs that don't.
+void zi_sap_move_batch(ZiSap* sap, const u32* handles, const ZiAABB* aabbs, u32 count) {
+	if ((u64)count * ZI_SAP_BATCH_RATIO < sap->proxy_count) {
+		for (u32 i = 0; i < count; ++i) {
+			zi_sap_move(sap, handles[i], aabbs[i]);
+		}
+		return;
+	}
+
+	for (u32 i = 0; i < count; ++i) {
+		ZiSapProxy* proxy = &sap->proxies[handles[i]];
+		proxy->aabb = aabbs[i];
+		for (u32 axis = 0; axis < 3; ++axis) {
+			sap->endpoints[axis][proxy->min[axis]].value = (&aabbs[i].min.x)[axis];
+			sap->endpoints[axis][proxy->max[axis]].value = (&aabbs[i].max.x)[axis];
+		}
+	}
+	for (u32 axis = 0; axis < 3; ++axis) {
+		ZiSapEndpoint* ends = sap->endpoints[axis];
+		for (u32 i = 1; i < sap->endpoint_count; ++i) {
+			if (zi_sap_less(ends[i], ends[i - 1])) {
+				zi_sap_sort_down(sap, axis, i, ZI_SAP_TRACK_ALL);
+			}
+		}
+	}
+}
+
+VoidPtr zi_sap_user_data(const ZiSap* sap, u32 handle) {
+	return sap->proxies[handle].user_data;
+}
+
+ZiAABB zi_sap_aabb(const ZiSap* sap, u32 handle) {
+	return sap->proxies[handle].aabb;
+}
+
+ZiBool zi_sap_overlapping(const ZiSap* sap, u32 a, u32 b) {
+	return ZiSapPairIndex_has(sap->pair_index, zi_sap_pair_key(a, b)) != 0;
+}
+
+const ZiSapPair* zi_sap_pairs(const ZiSap* sap, u32* count) {
+	*count = (u32)sap->pairs.count;
+	return sap->pairs.data;
+}
+
+const ZiSapEvent* zi_sap_events(const ZiSap* sap, u32* count) {
+	*count = (u32)sap->events.count;
+	return sap->events.data;
+}
+
+void zi_sap_clear_events(ZiSap* sap) {
+	ZiSapEventArray_clear(&sap->events);
+	// nothing refers to removed handles anymore, they can be handed out again
+	while (sap->retired_list != ZI_SAP_NULL) {
+		u32 handle = sap->retired_list;
+		sap->retired_list = sap->proxies[handle].next;
+		sap->proxies[handle].next = sap->free_list;
+		sap->free_list = handle;
+	}
+}
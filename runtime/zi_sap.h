@@ -0,0 +1,114 @@
+#pragma once
+
+#include "zi_common.h"
+#include "zi_core.h"
+#include "zi_math.h"
+
+// ============================================================================
+// Sweep and prune
+// ============================================================================
+//
+// Broadphase over moving boxes that keeps the set of overlapping pairs up to date. Every axis
+// has a sorted array of box min and max endpoints. Moves re-sort them with insertion sort,
+// and from one frame to the next an endpoint passes only a few others. A pair is looked at
+// only when two of its endpoints swap, so a frame costs the number of objects plus the swaps,
+// not n^2 box tests. Touching boxes overlap, the same as zi_aabb_aabb_intersect.
+//
+// Changes to the pair set are also recorded as events until zi_sap_clear_events, in the order
+// they happened. Handles are reused, but only after the events that mention them were cleared.
+
+#define ZI_SAP_NULL 0xffffffffu
+
+// below objects / this many moves in a batch each is sorted on its own, above it all are
+// written first and each axis gets one insertion sort pass
+#define ZI_SAP_BATCH_RATIO 16
+
+enum ZiSapEventType_ {
+	ZI_SAP_EVENT_ADDED = 0,
+	ZI_SAP_EVENT_REMOVED = 1,
+};
+typedef u8 ZiSapEventType;
+
+// a < b
+typedef struct ZiSapPair {
+	u32 a;
+	u32 b;
+} ZiSapPair;
+
+typedef struct ZiSapEvent {
+	u32            a;
+	u32            b;
+	ZiSapEventType type;
+} ZiSapEvent;
+
+typedef struct ZiSapEndpoint {
+	f32 value;
+	// handle << 1, low bit set for max endpoints
+	u32 data;
+} ZiSapEndpoint;
+
+typedef struct ZiSapProxy {
+	ZiAABB  aabb;
+	// where the endpoints are in each axis array
+	u32     min[3];
+	u32     max[3];
+	VoidPtr user_data;
+	// next free or retired proxy, ZI_SAP_NULL while in use
+	u32     next;
+	// first of its pairs, ZI_SAP_NULL when it overlaps nothing
+	u32     pairs;
+} ZiSapProxy;
+
+// Every pair is in a list for a and one for b, so a removal finds its own pairs without going
+// through all of them. Index 0 links the pair in a's list, 1 in b's.
+typedef struct ZiSapPairLinks {
+	u32 prev[2];
+	u32 next[2];
+} ZiSapPairLinks;
+
+ZI_ARRAY(ZiSapPairArray, ZiSapPair)
+ZI_ARRAY(ZiSapPairLinksArray, ZiSapPairLinks)
+ZI_ARRAY(ZiSapEventArray, ZiSapEvent)
+
+typedef struct ZiSap {
+	ZiSapProxy*            proxies;
+	u32                    proxy_capacity;
+	u32                    proxy_count;
+	u32                    free_list;
+	// removed, waiting for their events to be cleared before going on the free list
+	u32                    retired_list;
+	// proxy_count * 2 on each axis, sorted by value with min before max on ties
+	ZiSapEndpoint*         endpoints[3];
+	u32                    endpoint_count;
+
+	ZiSapPairArray         pairs;
+	// parallel to pairs
+	ZiSapPairLinksArray    pair_links;
+	// pair key -> index into pairs
+	struct ZiSapPairIndex* pair_index;
+	// removals since the index was last rebuilt, its deleted slots slow down lookups
+	u32                    pair_removals;
+	ZiSapEventArray        events;
+} ZiSap;
+
+ZiBool zi_sap_init(ZiSap* sap);
+void   zi_sap_destroy(ZiSap* sap);
+
+// ZI_SAP_NULL when out of memory
+u32    zi_sap_insert(ZiSap* sap, ZiAABB aabb, VoidPtr user_data);
+// many at once, like loading a level, user_data may be NULL. Fills count handles.
+ZiBool zi_sap_insert_batch(ZiSap* sap, const ZiAABB* aabbs, VoidPtr const* user_data, u32 count, u32* handles);
+void   zi_sap_remove(ZiSap* sap, u32 handle);
+void   zi_sap_move(ZiSap* sap, u32 handle, ZiAABB aabb);
+// a frame's worth of moves, every handle at most once
+void   zi_sap_move_batch(ZiSap* sap, const u32* handles, const ZiAABB* aabbs, u32 count);
+
+VoidPtr zi_sap_user_data(const ZiSap* sap, u32 handle);
+ZiAABB  zi_sap_aabb(const ZiSap* sap, u32 handle);
+ZiBool  zi_sap_overlapping(const ZiSap* sap, u32 a, u32 b);
+
+// every overlapping pair right now, unordered, valid until the next change
+const ZiSapPair*  zi_sap_pairs(const ZiSap* sap, u32* count);
+// additions and removals since the last clear
+const ZiSapEvent* zi_sap_events(const ZiSap* sap, u32* count);
+void              zi_sap_clear_events(ZiSap* sap);
@@ -0,0 +1,547 @@
+#include "zi_spatial_hash.h"
+
+#include "zi_core.h"
+#include "zi_log.h"
+
+#include <string.h>
+
+#define ZI_SPATIAL_HASH_INITIAL_CAPACITY 256
+#define ZI_SPATIAL_HASH_BUCKET_INITIAL_CAPACITY 4
+// cell coordinates are clamped to this so far away rects can't overflow them
+#define ZI_SPATIAL_HASH_CELL_LIMIT 0x20000000
+
+typedef struct ZiSpatialHashSink {
+	ZiSpatialHashQueryFn fn;
+	ZiSpatialHashRayFn   ray_fn;
+	VoidPtr              context;
+	u32*                 handles;
+	u32                  capacity;
+	u32                  count;
+} ZiSpatialHashSink;
+
+// ============================================================================
+// Cells and buckets
+// ============================================================================
+
+static inline i32 zi_spatial_hash_cell(const ZiSpatialHash* hash, f32 v) {
+	f32 c = floorf(v * hash->inv_cell_size);
+	return (i32)zi_clamp_f32(c, (f32)-ZI_SPATIAL_HASH_CELL_LIMIT, (f32)ZI_SPATIAL_HASH_CELL_LIMIT);
+}
+
+static inline void zi_spatial_hash_cells(const ZiSpatialHash* hash, ZiRect rect, ZiIVec2* min, ZiIVec2* max) {
+	*min = zi_ivec2(zi_spatial_hash_cell(hash, rect.x), zi_spatial_hash_cell(hash, rect.y));
+	*max = zi_ivec2(zi_spatial_hash_cell(hash, rect.x + rect.width), zi_spatial_hash_cell(hash, rect.y + rect.height));
+}
+
+static inline u64 zi_spatial_hash_cell_count(ZiIVec2 min, ZiIVec2 max) {
+	return (u64)((i64)max.x - min.x + 1) * (u64)((i64)max.y - min.y + 1);
+}
+
+static inline u32 zi_spatial_hash_bucket(const ZiSpatialHash* hash, i32 x, i32 y) {
+	return ((u32)x * 73856093u ^ (u32)y * 19349663u) & hash->bucket_mask;
+}
+
+static inline ZiBool zi_spatial_hash_covers(const ZiSpatialHashEntity* entity, i32 x, i32 y) {
+	return x >= entity->cell_min.x && x <= entity->cell_max.x && y >= entity->cell_min.y && y <= entity->cell_max.y;
+}
+
+// Distinct buckets of a cell range, at most ZI_SPATIAL_HASH_MAX_CELLS of them. Cells that hash
+// together only get the entity once.
+static u32 zi_spatial_hash_range_buckets(const ZiSpatialHash* hash, ZiIVec2 min, ZiIVec2 max, u32* out) {
+	u32 count = 0;
+	for (i32 y = min.y; y <= max.y; ++y) {
+		for (i32 x = min.x; x <= max.x; ++x) {
+			u32    bucket = zi_spatial_hash_bucket(hash, x, y);
+			ZiBool seen = ZI_FALSE;
+			for (u32 i = 0; i < count && !seen; ++i) {
+				seen = out[i] == bucket;
+			}
+			if (!seen) out[count++] = bucket;
+		}
+	}
+	return count;
+}
+
+static ZiBool zi_spatial_hash_bucket_reserve(ZiSpatialHashBucket* bucket, u32 extra) {
+	if (bucket->count + extra <= bucket->capacity) return ZI_TRUE;
+
+	u32 capacity = bucket->capacity ? bucket->capacity : ZI_SPATIAL_HASH_BUCKET_INITIAL_CAPACITY;
+	while (capacity < bucket->count + extra) {
+		capacity *= 2;
+	}
+	u32* items = (u32*)zi_mem_alloc(sizeof(u32) * (u64)capacity);
+	if (!items) {
+		zi_log_error("out of memory growing a spatial hash bucket to %u entities", capacity);
+		return ZI_FALSE;
+	}
+	if (bucket->count) memcpy(items, bucket->items, sizeof(u32) * bucket->count);
+	zi_mem_free(bucket->items);
+	bucket->items = items;
+	bucket->capacity = capacity;
+	return ZI_TRUE;
+}
+
+static void zi_spatial_hash_bucket_remove(ZiSpatialHashBucket* bucket, u32 handle) {
+	for (u32 i = 0; i < bucket->count; ++i) {
+		if (bucket->items[i] == handle) {
+			bucket->items[i] = bucket->items[--bucket->count];
+			return;
+		}
+	}
+}
+
+static ZiBool zi_spatial_hash_grow(ZiSpatialHash* hash) {
+	u32                  capacity = hash->capacity ? hash->capacity * 2 : ZI_SPATIAL_HASH_INITIAL_CAPACITY;
+	ZiSpatialHashEntity* entities = (ZiSpatialHashEntity*)zi_mem_alloc(sizeof(ZiSpatialHashEntity) * (u64)capacity);
+	if (!entities) {
+		zi_log_error("out of memory growing a spatial hash to %u entities", capacity);
+		return ZI_FALSE;
+	}
+	if (hash->capacity) {
+		memcpy(entities, hash->entities, sizeof(ZiSpatialHashEntity) * hash->capacity);
+		zi_mem_free(hash->entities);
+	}
+	// the free list is empty whenever this runs
+	for (u32 i = hash->capacity; i < capacity; ++i) {
+		entities[i].next = i + 1 < capacity ? i + 1 : ZI_SPATIAL_HASH_NULL;
+	}
+	hash->free_list = hash->capacity;
+	hash->entities = entities;
+	hash->capacity = capacity;
+	return ZI_TRUE;
+}
+
+// an edge moving out starts counting again, one that stays gets another entity on it
+static inline void zi_spatial_hash_extend_edge(i32* edge, u32* count, i32 v, i32 outward) {
+	if (v * outward > *edge * outward) {
+		*edge = v;
+		*count = 1;
+	} else if (v == *edge) {
+		++*count;
+	}
+}
+
+static inline void zi_spatial_hash_extend_bounds(ZiSpatialHash* hash, ZiIVec2 min, ZiIVec2 max) {
+	zi_spatial_hash_extend_edge(&hash->bounds_min.x, &hash->edge_counts[0], min.x, -1);
+	zi_spatial_hash_extend_edge(&hash->bounds_min.y, &hash->edge_counts[1], min.y, -1);
+	zi_spatial_hash_extend_edge(&hash->bounds_max.x, &hash->edge_counts[2], max.x, 1);
+	zi_spatial_hash_extend_edge(&hash->bounds_max.y, &hash->edge_counts[3], max.y, 1);
+}
+
+static void zi_spatial_hash_reset_bounds(ZiSpatialHash* hash) {
+	hash->bounds_min = zi_ivec2(ZI_SPATIAL_HASH_CELL_LIMIT, ZI_SPATIAL_HASH_CELL_LIMIT);
+	hash->bounds_max = zi_ivec2(-ZI_SPATIAL_HASH_CELL_LIMIT, -ZI_SPATIAL_HASH_CELL_LIMIT);
+	memset(hash->edge_counts, 0, sizeof(hash->edge_counts));
+}
+
+// The cells min to max were just left. Once the last entity on an edge of the bounds is gone,
+// the bounds are rebuilt from what is still in the buckets, so one entity passing far away
+// doesn't leave rays walking empty cells out to where it was. The rebuild goes through every
+// bucket, O(buckets + entities), so a frame where the outermost movers keep stepping inward
+// pays for it each time one of them takes the last place on an edge.
+static void zi_spatial_hash_shrink_bounds(ZiSpatialHash* hash, ZiIVec2 min, ZiIVec2 max) {
+	i32    values[4] = {min.x, min.y, max.x, max.y};
+	i32    edges[4] = {hash->bounds_min.x, hash->bounds_min.y, hash->bounds_max.x, hash->bounds_max.y};
+	ZiBool emptied = ZI_FALSE;
+	for (u32 i = 0; i < 4; ++i) {
+		if (values[i] == edges[i] && --hash->edge_counts[i] == 0) emptied = ZI_TRUE;
+	}
+	if (!emptied) return;
+
+	zi_spatial_hash_reset_bounds(hash);
+	for (u32 b = 0; b <= hash->bucket_mask; ++b) {
+		const ZiSpatialHashBucket* bucket = &hash->buckets[b];
+		for (u32 i = 0; i < bucket->count; ++i) {
+			const ZiSpatialHashEntity* entity = &hash->entities[bucket->items[i]];
+			// cells that hash together put an entity in a bucket only once, its first cell's
+			// bucket counts it
+			if (zi_spatial_hash_bucket(hash, entity->cell_min.x, entity->cell_min.y) == b) {
+				zi_spatial_hash_extend_bounds(hash, entity->cell_min, entity->cell_max);
+			}
+		}
+	}
+}
+
+// Puts the entity into the buckets of its cells, or on the large list when there are too
+// many. Everything is reserved before anything is added, so failing leaves no trace. The
+// bounds are left to the caller, which knows whether the entity stays.
+static ZiBool zi_spatial_hash_link(ZiSpatialHash* hash, u32 handle, ZiIVec2 min, ZiIVec2 max) {
+	ZiSpatialHashEntity* entity = &hash->entities[handle];
+	if (zi_spatial_hash_cell_count(min, max) > ZI_SPATIAL_HASH_MAX_CELLS) {
+		if (!zi_spatial_hash_bucket_reserve(&hash->large, 1)) return ZI_FALSE;
+		entity->large = hash->large.count;
+		hash->large.items[hash->large.count++] = handle;
+	} else {
+		u32 buckets[ZI_SPATIAL_HASH_MAX_CELLS];
+		u32 count = zi_spatial_hash_range_buckets(hash, min, max, buckets);
+		for (u32 i = 0; i < count; ++i) {
+			if (!zi_spatial_hash_bucket_reserve(&hash->buckets[buckets[i]], 1)) return ZI_FALSE;
+		}
+		for (u32 i = 0; i < count; ++i) {
+			ZiSpatialHashBucket* bucket = &hash->buckets[buckets[i]];
+			bucket->items[bucket->count++] = handle;
+		}
+		entity->large = ZI_SPATIAL_HASH_NULL;
+	}
+	entity->cell_min = min;
+	entity->cell_max = max;
+	return ZI_TRUE;
+}
+
+static void zi_spatial_hash_unlink(ZiSpatialHash* hash, u32 handle) {
+	ZiSpatialHashEntity* entity = &hash->entities[handle];
+	if (entity->large != ZI_SPATIAL_HASH_NULL) {
+		u32 last = hash->large.items[--hash->large.count];
+		hash->large.items[entity->large] = last;
+		hash->entities[last].large = entity->large;
+		entity->large = ZI_SPATIAL_HASH_NULL;
+		return;
+	}
+	u32 buckets[ZI_SPATIAL_HASH_MAX_CELLS];
+	u32 count = zi_spatial_hash_range_buckets(hash, entity->cell_min, entity->cell_max, buckets);
+	for (u32 i = 0; i < count; ++i) {
+		zi_spatial_hash_bucket_remove(&hash->buckets[buckets[i]], handle);
+	}
+}
+
+// ============================================================================
+// Entities
+// ============================================================================
+
+ZiBool zi_spatial_hash_init(ZiSpatialHash* hash, f32 cell_size, u32 bucket_count) {
+	memset(hash, 0, sizeof(*hash));
+	u32 buckets = 1;
+	while (buckets < (bucket_count ? bucket_count : ZI_SPATIAL_HASH_DEFAULT_BUCKETS)) {
+		buckets <<= 1;
+	}
+	hash->buckets = (ZiSpatialHashBucket*)zi_mem_alloc(sizeof(ZiSpatialHashBucket) * (u64)buckets);
+	if (!hash->buckets) {
+		zi_log_error("out of memory creating a spatial hash with %u buckets", buckets);
+		return ZI_FALSE;
+	}
+	memset(hash->buckets, 0, sizeof(ZiSpatialHashBucket) * buckets);
+	hash->bucket_mask = buckets - 1;
+	hash->cell_size = cell_size;
+	hash->inv_cell_size = 1.0f / cell_size;
+	hash->free_list = ZI_SPATIAL_HASH_NULL;
+	zi_spatial_hash_reset_bounds(hash);
+	return ZI_TRUE;
+}
+
+void zi_spatial_hash_destroy(ZiSpatialHash* hash) {
+	if (hash->buckets) {
+		for (u32 i = 0; i <= hash->bucket_mask; ++i) {
+			zi_mem_free(hash->buckets[i].items);
+		}
+		zi_mem_free(hash->buckets);
+	}
+	zi_mem_free(hash->large.items);
+	zi_mem_free(hash->entities);
+	memset(hash, 0, sizeof(*hash));
+}
+
+u32 zi_spatial_hash_insert(ZiSpatialHash* hash, ZiRect rect, VoidPtr user_data) {
+	if (hash->free_list == ZI_SPATIAL_HASH_NULL && !zi_spatial_hash_grow(hash)) return ZI_SPATIAL_HASH_NULL;
+
+	u32     handle = hash->free_list;
+	ZiIVec2 min, max;
+	zi_spatial_hash_cells(hash, rect, &min, &max);
+	if (!zi_spatial_hash_link(hash, handle, min, max)) return ZI_SPATIAL_HASH_NULL;
+
+	ZiSpatialHashEntity* entity = &hash->entities[handle];
+	if (entity->large == ZI_SPATIAL_HASH_NULL) zi_spatial_hash_extend_bounds(hash, min, max);
+	hash->free_list = entity->next;
+	entity->next = ZI_SPATIAL_HASH_NULL;
+	entity->rect = rect;
+	entity->user_data = user_data;
+	hash->entity_count++;
+	return handle;
+}
+
+void zi_spatial_hash_remove(ZiSpatialHash* hash, u32 handle) {
+	ZiSpatialHashEntity* entity = &hash->entities[handle];
+	ZiBool               was_large = entity->large != ZI_SPATIAL_HASH_NULL;
+	zi_spatial_hash_unlink(hash, handle);
+	if (!was_large) zi_spatial_hash_shrink_bounds(hash, entity->cell_min, entity->cell_max);
+	hash->entities[handle].next = hash->free_list;
+	hash->free_list = handle;
+	hash->entity_count--;
+}
+
+ZiBool zi_spatial_hash_move(ZiSpatialHash* hash, u32 handle, ZiRect rect) {
+	ZiSpatialHashEntity* entity = &hash->entities[handle];
+	ZiIVec2              min, max;
+	zi_spatial_hash_cells(hash, rect, &min, &max);
+
+	ZiBool was_large = entity->large != ZI_SPATIAL_HASH_NULL;
+	ZiBool is_large = zi_spatial_hash_cell_count(min, max) > ZI_SPATIAL_HASH_MAX_CELLS;
+	// the common case, nothing to relink
+	if ((min.x == entity->cell_min.x && min.y == entity->cell_min.y && max.x == entity->cell_max.x && max.y == entity->cell_max.y) ||
+	    (was_large && is_large)) {
+		entity->rect = rect;
+		entity->cell_min = min;
+		entity->cell_max = max;
+		return ZI_TRUE;
+	}
+
+	if (was_large || is_large) {
+		// between the large list and the buckets, rare enough to do the simple way
+		ZiIVec2 old_min = entity->cell_min;
+		ZiIVec2 old_max = entity->cell_max;
+		zi_spatial_hash_unlink(hash, handle);
+		if (!zi_spatial_hash_link(hash, handle, min, max)) {
+			// back where it was, which never needs more room, and the bounds still count it there
+			zi_spatial_hash_link(hash, handle, old_min, old_max);
+			return ZI_FALSE;
+		}
+		entity->rect = rect;
+		if (!is_large) zi_spatial_hash_extend_bounds(hash, min, max);
+		if (!was_large) zi_spatial_hash_shrink_bounds(hash, old_min, old_max);
+		return ZI_TRUE;
+	}
+
+	// only the buckets that differ between the old and new cells change
+	u32 old_buckets[ZI_SPATIAL_HASH_MAX_CELLS];
+	u32 new_buckets[ZI_SPATIAL_HASH_MAX_CELLS];
+	u32 added[ZI_SPATIAL_HASH_MAX_CELLS];
+	u32 old_count = zi_spatial_hash_range_buckets(hash, entity->cell_min, entity->cell_max, old_buckets);
+	u32 new_count = zi_spatial_hash_range_buckets(hash, min, max, new_buckets);
+	u32 added_count = 0;
+	for (u32 i = 0; i < new_count; ++i) {
+		ZiBool kept = ZI_FALSE;
+		for (u32 k = 0; k < old_count && !kept; ++k) {
+			kept = old_buckets[k] == new_buckets[i];
+		}
+		if (kept) continue;
+		if (!zi_spatial_hash_bucket_reserve(&hash->buckets[new_buckets[i]], 1)) return ZI_FALSE;
+		added[added_count++] = new_buckets[i];
+	}
+	for (u32 i = 0; i < old_count; ++i) {
+		ZiBool kept = ZI_FALSE;
+		for (u32 k = 0; k < new_count && !kept; ++k) {
+			kept = new_buckets[k] == old_buckets[i];
+		}
+		if (!kept) zi_spatial_hash_bucket_remove(&hash->buckets[old_buckets[i]], handle);
+	}
+	for (u32 i = 0; i < added_count; ++i) {
+		ZiSpatialHashBucket* bucket = &hash->buckets[added[i]];
+		bucket->items[bucket->count++] = handle;
+	}
+	ZiIVec2 old_min = entity->cell_min;
+	ZiIVec2 old_max = entity->cell_max;
+	entity->rect = rect;
+	entity->cell_min = min;
+	entity->cell_max = max;
+	zi_spatial_hash_extend_bounds(hash, min, max);
+	zi_spatial_hash_shrink_bounds(hash, old_min, old_max);
+	return ZI_TRUE;
+}
+
+VoidPtr zi_spatial_hash_user_data(const ZiSpatialHash* hash, u32 handle) {
+	return hash->entities[handle].user_data;
+}
+
+ZiRect zi_spatial_hash_rect(const ZiSpatialHash* hash, u32 handle) {
+	return hash->entities[handle].rect;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+static inline ZiBool zi_spatial_hash_emit(ZiSpatialHashSink* sink, const ZiSpatialHash* hash, u32 handle) {
+	if (sink->fn) return sink->fn(sink->context, handle, hash->entities[handle].user_data);
+	if (sink->count < sink->capacity) {
+		sink->handles[sink->count] = handle;
+	}
+	sink->count++;
+	return ZI_TRUE;
+}
+
+static inline ZiBool zi_spatial_hash_emit_ray(ZiSpatialHashSink* sink, const ZiSpatialHash* hash, u32 handle, f32 t, f32* max_t) {
+	if (sink->ray_fn) {
+		*max_t = sink->ray_fn(sink->context, handle, hash->entities[handle].user_data, t, *max_t);
+		return *max_t > 0.0f;
+	}
+	return zi_spatial_hash_emit(sink, hash, handle);
+}
+
+// Every entity covering several cells of the query is seen from each of them, it's reported
+// from the first one: its own first cell, or the query's when it starts further in.
+static inline ZiBool zi_spatial_hash_is_first(const ZiSpatialHashEntity* entity, ZiIVec2 min, i32 x, i32 y) {
+	return x == zi_max_i32(entity->cell_min.x, min.x) && y == zi_max_i32(entity->cell_min.y, min.y);
+}
+
+static void zi_spatial_hash_walk_point(const ZiSpatialHash* hash, ZiVec2 point, ZiSpatialHashSink* sink) {
+	for (u32 i = 0; i < hash->large.count; ++i) {
+		u32 handle = hash->large.items[i];
+		if (zi_rect_contains_point(hash->entities[handle].rect, point) && !zi_spatial_hash_emit(sink, hash, handle)) return;
+	}
+
+	i32                        x = zi_spatial_hash_cell(hash, point.x);
+	i32                        y = zi_spatial_hash_cell(hash, point.y);
+	const ZiSpatialHashBucket* bucket = &hash->buckets[zi_spatial_hash_bucket(hash, x, y)];
+	for (u32 i = 0; i < bucket->count; ++i) {
+		const ZiSpatialHashEntity* entity = &hash->entities[bucket->items[i]];
+		if (zi_spatial_hash_covers(entity, x, y) && zi_rect_contains_point(entity->rect, point) &&
+		    !zi_spatial_hash_emit(sink, hash, bucket->items[i])) {
+			return;
+		}
+	}
+}
+
+static void zi_spatial_hash_walk_rect(const ZiSpatialHash* hash, ZiRect rect, ZiSpatialHashSink* sink) {
+	for (u32 i = 0; i < hash->large.count; ++i) {
+		u32 handle = hash->large.items[i];
+		if (zi_rect_intersects(hash->entities[handle].rect, rect) && !zi_spatial_hash_emit(sink, hash, handle)) return;
+	}
+
+	ZiIVec2 min, max;
+	zi_spatial_hash_cells(hash, rect, &min, &max);
+	min = zi_ivec2(zi_max_i32(min.x, hash->bounds_min.x), zi_max_i32(min.y, hash->bounds_min.y));
+	max = zi_ivec2(zi_min_i32(max.x, hash->bounds_max.x), zi_min_i32(max.y, hash->bounds_max.y));
+	if (min.x > max.x || min.y > max.y) return;
+
+	if (zi_spatial_hash_cell_count(min, max) > (u64)hash->bucket_mask + 1) {
+		// more cells than buckets, going through every bucket once is cheaper
+		for (u32 b = 0; b <= hash->bucket_mask; ++b) {
+			const ZiSpatialHashBucket* bucket = &hash->buckets[b];
+			for (u32 i = 0; i < bucket->count; ++i) {
+				const ZiSpatialHashEntity* entity = &hash->entities[bucket->items[i]];
+				if (entity->cell_max.x < min.x || entity->cell_min.x > max.x || entity->cell_max.y < min.y || entity->cell_min.y > max.y) {
+					continue;
+				}
+				i32 first_x = zi_max_i32(entity->cell_min.x, min.x);
+				i32 first_y = zi_max_i32(entity->cell_min.y, min.y);
+				if (zi_spatial_hash_bucket(hash, first_x, first_y) == b && zi_rect_intersects(entity->rect, rect) &&
+				    !zi_spatial_hash_emit(sink, hash, bucket->items[i])) {
+					return;
+				}
+			}
+		}
+		return;
+	}
+
+	for (i32 y = min.y; y <= max.y; ++y) {
+		for (i32 x = min.x; x <= max.x; ++x) {
+			const ZiSpatialHashBucket* bucket = &hash->buckets[zi_spatial_hash_bucket(hash, x, y)];
+			for (u32 i = 0; i < bucket->count; ++i) {
+				const ZiSpatialHashEntity* entity = &hash->entities[bucket->items[i]];
+				if (zi_spatial_hash_covers(entity, x, y) && zi_spatial_hash_is_first(entity, min, x, y) &&
+				    zi_rect_intersects(entity->rect, rect) && !zi_spatial_hash_emit(sink, hash, bucket->items[i])) {
+					return;
+				}
+			}
+		}
+	}
+}
+
+// axis-parallel rays get a huge finite inverse instead of infinity, see zi_bvh.c
+static inline f32 zi_spatial_hash_safe_inverse(f32 d) {
+	return zi_abs_f32(d) > 1e-30f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+}
+
+// where the ray enters the rect, F32_MAX when it misses it before t_max
+static inline f32 zi_spatial_hash_ray_rect(ZiRect rect, ZiVec2 origin, ZiVec2 inv_dir, f32 t_max) {
+	f32 tx1 = (rect.x - origin.x) * inv_dir.x;
+	f32 tx2 = (rect.x + rect.width - origin.x) * inv_dir.x;
+	f32 ty1 = (rect.y - origin.y) * inv_dir.y;
+	f32 ty2 = (rect.y + rect.height - origin.y) * inv_dir.y;
+	f32 t_near = zi_max_f32(zi_max_f32(zi_min_f32(tx1, tx2), zi_min_f32(ty1, ty2)), 0.0f);
+	f32 t_far = zi_min_f32(zi_min_f32(zi_max_f32(tx1, tx2), zi_max_f32(ty1, ty2)), t_max);
+	return t_near <= t_far ? t_near : F32_MAX;
+}
+
+// Steps through the cells along the ray (Amanatides and Woo), clipped to the cells the bucketed
+// entities cover. The cells walked are 4-connected and never turn back, so the ones an
+// entity covers come in one run, and it's reported from the first of them.
+static void zi_spatial_hash_walk_ray(const ZiSpatialHash* hash, ZiVec2 origin, ZiVec2 dir, f32 max_t, ZiSpatialHashSink* sink) {
+	ZiVec2 inv_dir = zi_vec2(zi_spatial_hash_safe_inverse(dir.x), zi_spatial_hash_safe_inverse(dir.y));
+	for (u32 i = 0; i < hash->large.count; ++i) {
+		u32 handle = hash->large.items[i];
+		f32 t = zi_spatial_hash_ray_rect(hash->entities[handle].rect, origin, inv_dir, max_t);
+		if (t != F32_MAX && !zi_spatial_hash_emit_ray(sink, hash, handle, t, &max_t)) return;
+	}
+	if (hash->bounds_min.x > hash->bounds_max.x) return;
+
+	f32    cs = hash->cell_size;
+	ZiRect bounds = zi_rect((f32)hash->bounds_min.x * cs, (f32)hash->bounds_min.y * cs, (f32)(hash->bounds_max.x - hash->bounds_min.x + 1) * cs,
+	                        (f32)(hash->bounds_max.y - hash->bounds_min.y + 1) * cs);
+	f32    t = zi_spatial_hash_ray_rect(bounds, origin, inv_dir, max_t);
+	if (t == F32_MAX) return;
+
+	ZiVec2 start = zi_vec2_add(origin, zi_vec2_scale(dir, t));
+	i32    x = zi_clamp_i32(zi_spatial_hash_cell(hash, start.x), hash->bounds_min.x, hash->bounds_max.x);
+	i32    y = zi_clamp_i32(zi_spatial_hash_cell(hash, start.y), hash->bounds_min.y, hash->bounds_max.y);
+	i32    step_x = dir.x < 0.0f ? -1 : 1;
+	i32    step_y = dir.y < 0.0f ? -1 : 1;
+	// t at the next cell border on each axis and between two of them
+	f32    next_x = dir.x != 0.0f ? ((f32)(x + (step_x > 0)) * cs - origin.x) * inv_dir.x : F32_MAX;
+	f32    next_y = dir.y != 0.0f ? ((f32)(y + (step_y > 0)) * cs - origin.y) * inv_dir.y : F32_MAX;
+	f32    delta_x = cs * zi_abs_f32(inv_dir.x);
+	f32    delta_y = cs * zi_abs_f32(inv_dir.y);
+
+	ZiBool has_prev = ZI_FALSE;
+	i32    prev_x = 0, prev_y = 0;
+	for (;;) {
+		const ZiSpatialHashBucket* bucket = &hash->buckets[zi_spatial_hash_bucket(hash, x, y)];
+		for (u32 i = 0; i < bucket->count; ++i) {
+			const ZiSpatialHashEntity* entity = &hash->entities[bucket->items[i]];
+			if (!zi_spatial_hash_covers(entity, x, y) || (has_prev && zi_spatial_hash_covers(entity, prev_x, prev_y))) continue;
+			f32 hit = zi_spatial_hash_ray_rect(entity->rect, origin, inv_dir, max_t);
+			if (hit != F32_MAX && !zi_spatial_hash_emit_ray(sink, hash, bucket->items[i], hit, &max_t)) return;
+		}
+
+		has_prev = ZI_TRUE;
+		prev_x = x;
+		prev_y = y;
+		if (next_x < next_y) {
+			t = next_x;
+			x += step_x;
+			next_x += delta_x;
+			if (x < hash->bounds_min.x || x > hash->bounds_max.x) return;
+		} else {
+			if (dir.y == 0.0f) return;
+			t = next_y;
+			y += step_y;
+			next_y += delta_y;
+			if (y < hash->bounds_min.y || y > hash->bounds_max.y) return;
+		}
+		if (t > max_t) return;
+	}
+}
+
+void zi_spatial_hash_query_point(const ZiSpatialHash* hash, ZiVec2 point, ZiSpatialHashQueryFn fn, VoidPtr context) {
+	ZiSpatialHashSink sink = {.fn = fn, .context = context};
+	zi_spatial_hash_walk_point(hash, point, &sink);
+}
+
+void zi_spatial_hash_query_rect(const ZiSpatialHash* hash, ZiRect rect, ZiSpatialHashQueryFn fn, VoidPtr context) {
+	ZiSpatialHashSink sink = {.fn = fn, .context = context};
+	zi_spatial_hash_walk_rect(hash, rect, &sink);
+}
+
+void zi_spatial_hash_raycast(const ZiSpatialHash* hash, ZiVec2 origin, ZiVec2 direction, f32 max_t, ZiSpatialHashRayFn fn,
+                             VoidPtr context) {
+	ZiSpatialHashSink sink = {.ray_fn = fn, .context = context};
+	zi_spatial_hash_walk_ray(hash, origin, direction, max_t, &sink);
+}
+
+u32 zi_spatial_hash_collect_point(const ZiSpatialHash* hash, ZiVec2 point, u32* handles, u32 capacity) {
+	ZiSpatialHashSink sink = {.handles = handles, .capacity = capacity};
+	zi_spatial_hash_walk_point(hash, point, &sink);
+	return sink.count;
+}
+
+u32 zi_spatial_hash_collect_rect(const ZiSpatialHash* hash, ZiRect rect, u32* handles, u32 capacity) {
+	ZiSpatialHashSink sink = {.handles = handles, .capacity = capacity};
+	zi_spatial_hash_walk_rect(hash, rect, &sink);
+	return sink.count;
+}
+
+u32 zi_spatial_hash_collect_ray(const ZiSpatialHash* hash, ZiVec2 origin, ZiVec2 direction, f32 max_t, u32* handles,
+                                u32 capacity) {
+	ZiSpatialHashSink sink = {.handles = handles, .capacity = capacity};
+	zi_spatial_hash_walk_ray(hash, origin, direction, max_t, &sink);
+	return sink.count;
+}
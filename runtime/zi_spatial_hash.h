@@ -0,0 +1,98 @@
+#pragma once
+
+#include "zi_common.h"
+#include "zi_math.h"
+
+// ============================================================================
+// 2D spatial hash
+// ============================================================================
+//
+// Uniform grid over ZiRect for sprites, picking and 2D collision. The world is cut into square
+// cells, and each cell maps to one of a fixed number of buckets by hashing its coordinates, so
+// the world has no bounds and memory goes with the bucket count, not the area. A bucket is a
+// compact list of entity handles, cells that hash together share it. Every entity is in each
+// bucket it touches once. A move that stays in the same cells only rewrites the rect.
+//
+// Rects covering more than ZI_SPATIAL_HASH_MAX_CELLS cells, like backgrounds or triggers over
+// the whole level, go on a separate list that every query tests on its own.
+//
+// Queries report each entity once and don't write to the hash, any number of threads can query
+// one nobody modifies. Handles stay valid until removed and get reused afterwards.
+
+#define ZI_SPATIAL_HASH_NULL            0xffffffffu
+#define ZI_SPATIAL_HASH_DEFAULT_BUCKETS 4096
+#define ZI_SPATIAL_HASH_MAX_CELLS       64
+
+typedef struct ZiSpatialHashEntity {
+	ZiRect  rect;
+	// covered cells, inclusive
+	ZiIVec2 cell_min;
+	ZiIVec2 cell_max;
+	VoidPtr user_data;
+	// index in the large list, ZI_SPATIAL_HASH_NULL while in the buckets
+	u32     large;
+	// next free entity while on the free list
+	u32     next;
+} ZiSpatialHashEntity;
+
+typedef struct ZiSpatialHashBucket {
+	u32* items;
+	u32  count;
+	u32  capacity;
+} ZiSpatialHashBucket;
+
+typedef struct ZiSpatialHash {
+	f32                  cell_size;
+	f32                  inv_cell_size;
+	ZiSpatialHashBucket* buckets;
+	// power of two
+	u32                  bucket_mask;
+	ZiSpatialHashBucket  large;
+
+	ZiSpatialHashEntity* entities;
+	u32                  capacity;
+	u32                  entity_count;
+	u32                  free_list;
+	// every cell a bucketed entity covers is inside, shrinks again when the last one on an edge leaves
+	ZiIVec2              bounds_min;
+	ZiIVec2              bounds_max;
+	// bucketed entities on each edge, min x, min y, max x, max y
+	u32                  edge_counts[4];
+} ZiSpatialHash;
+
+// return ZI_FALSE to stop the query
+typedef ZiBool (*ZiSpatialHashQueryFn)(VoidPtr context, u32 handle, VoidPtr user_data);
+// t is where the ray enters the rect, in multiples of the direction. Returns the new max_t, return
+// max_t to keep going, 0 to stop, or t to only look for closer ones.
+typedef f32 (*ZiSpatialHashRayFn)(VoidPtr context, u32 handle, VoidPtr user_data, f32 t, f32 max_t);
+
+// About the size of the typical entity makes a good cell size. bucket_count is rounded up to a
+// power of two, 0 picks ZI_SPATIAL_HASH_DEFAULT_BUCKETS. Around the number of occupied cells
+// keeps buckets short.
+ZiBool  zi_spatial_hash_init(ZiSpatialHash* hash, f32 cell_size, u32 bucket_count);
+void    zi_spatial_hash_destroy(ZiSpatialHash* hash);
+
+// ZI_SPATIAL_HASH_NULL when out of memory
+u32     zi_spatial_hash_insert(ZiSpatialHash* hash, ZiRect rect, VoidPtr user_data);
+void    zi_spatial_hash_remove(ZiSpatialHash* hash, u32 handle);
+// ZI_FALSE when out of memory, the entity stays where it was
+ZiBool  zi_spatial_hash_move(ZiSpatialHash* hash, u32 handle, ZiRect rect);
+
+VoidPtr zi_spatial_hash_user_data(const ZiSpatialHash* hash, u32 handle);
+ZiRect  zi_spatial_hash_rect(const ZiSpatialHash* hash, u32 handle);
+
+// rects containing the point, edges included like zi_rect_contains_point
+void zi_spatial_hash_query_point(const ZiSpatialHash* hash, ZiVec2 point, ZiSpatialHashQueryFn fn, VoidPtr context);
+// rects overlapping rect, same test as zi_rect_intersects
+void zi_spatial_hash_query_rect(const ZiSpatialHash* hash, ZiRect rect, ZiSpatialHashQueryFn fn, VoidPtr context);
+// Rects the ray from origin along direction enters before max_t. The large list comes first,
+// then cell by cell from the origin on, in no order inside a cell.
+void zi_spatial_hash_raycast(const ZiSpatialHash* hash, ZiVec2 origin, ZiVec2 direction, f32 max_t, ZiSpatialHashRayFn fn,
+                             VoidPtr context);
+
+// Array forms. Write at most capacity handles and return how many matched in total, a result
+// above capacity means the array was too small.
+u32 zi_spatial_hash_collect_point(const ZiSpatialHash* hash, ZiVec2 point, u32* handles, u32 capacity);
+u32 zi_spatial_hash_collect_rect(const ZiSpatialHash* hash, ZiRect rect, u32* handles, u32 capacity);
+u32 zi_spatial_hash_collect_ray(const ZiSpatialHash* hash, ZiVec2 origin, ZiVec2 direction, f32 max_t, u32* handles,
+                                u32 capacity);
@@ -0,0 +1,658 @@
+#include "zi_vfs.h"
+
+#include "zi_core.h"
+#include "zi_log.h"
+#include "zi_lz4.h"
+#include "zi_platform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ZI_VFS_ZSTD
+#include <zstd.h>
+#endif
+
+#define ZI_VFS_MAX_PATH 1024
+
+typedef char zi_pack_header_size_check[sizeof(ZiPackHeader) == 48 ? 1 : -1];
+typedef char zi_pack_entry_size_check[sizeof(ZiPackEntry) == 40 ? 1 : -1];
+
+// ============================================================================
+// Paths
+// ============================================================================
+
+#define ZI_VFS_FNV_OFFSET 0xcbf29ce484222325ull
+#define ZI_VFS_FNV_PRIME 0x100000001b3ull
+
+static u64 zi_vfs_hash_continue(u64 hash, const char* str, u64 length) {
+	for (u64 i = 0; i < length; ++i) {
+		hash ^= (u8)str[i];
+		hash *= ZI_VFS_FNV_PRIME;
+	}
+	return hash;
+}
+
+// FNV-1a, streamable so a mount point prefix is hashed once for all entries of a pack
+u64 zi_vfs_hash_path(const char* path, u64 length) {
+	return zi_vfs_hash_continue(ZI_VFS_FNV_OFFSET, path, length);
+}
+
+// '/' separators, no leading "/" or "./", no empty segments. Returns the length, or U64_MAX if it doesn't
+// fit or has a ".." segment, nothing may climb out of its mount.
+static u64 zi_vfs_normalize(const char* path, char* out, u64 capacity) {
+	u64 length = 0;
+	const char* p = path;
+
+	while (*p) {
+		while (*p == '/' || *p == '\\') p++;
+		if (p[0] == '.' && (p[1] == '/' || p[1] == '\\' || p[1] == '\0')) {
+			p++;
+			continue;
+		}
+		if (p[0] == '.' && p[1] == '.' && (p[2] == '/' || p[2] == '\\' || p[2] == '\0')) {
+			return U64_MAX;
+		}
+		if (!*p) break;
+
+		if (length > 0) {
+			if (length + 1 >= capacity) return U64_MAX;
+			out[length++] = '/';
+		}
+		while (*p && *p != '/' && *p != '\\') {
+			if (length + 1 >= capacity) return U64_MAX;
+			out[length++] = *p++;
+		}
+	}
+
+	out[length] = '\0';
+	return length;
+}
+
+// ============================================================================
+// Mounts
+// ============================================================================
+
+enum ZiVfsMountType_ {
+	ZiVfsMountType_Directory = 0,
+	ZiVfsMountType_Pack      = 1,
+};
+
+typedef u8 ZiVfsMountType;
+
+typedef struct ZiVfsMount {
+	ZiVfsMountType     type;
+	char*              source;
+	char*              mount_point;
+	u64                mount_point_length;
+	ZiMappedFile       map;
+	const ZiPackEntry* entries;
+	u32                entry_count;
+	const char*        strings;
+} ZiVfsMount;
+
+typedef struct ZiVfsLocation {
+	u32 mount;
+	u32 entry;
+} ZiVfsLocation;
+
+// path keys are already FNV hashes, no need to mix them again
+typedef u64 ZiVfsPathHash;
+
+static inline u64 hash_ZiVfsPathHash(ZiVfsPathHash key) {
+	return key;
+}
+
+static inline i8 compare_ZiVfsPathHash(ZiVfsPathHash a, ZiVfsPathHash b) {
+	return a == b;
+}
+
+ZI_HASHMAP(ZiVfsPathTable, ZiVfsPathHash, ZiVfsLocation)
+ZI_ARRAY(ZiVfsMountArray, ZiVfsMount*)
+
+static ZiVfsMountArray vfs_mounts;
+static ZiVfsPathTable  vfs_paths;
+static ZiBool          vfs_initialized = ZI_FALSE;
+
+static void zi_vfs_init(void) {
+	if (vfs_initialized) return;
+	ZiVfsMountArray_init(&vfs_mounts, ZI_NULL);
+	ZiVfsPathTable_init(&vfs_paths, ZI_NULL);
+	vfs_initialized = ZI_TRUE;
+}
+
+static char* zi_vfs_strdup(const char* str, u64 length) {
+	char* copy = zi_mem_alloc(length + 1);
+	memcpy(copy, str, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+static void zi_vfs_index_pack(u32 mount_index) {
+	ZiVfsMount* mount = vfs_mounts.data[mount_index];
+	u64 prefix_hash = zi_vfs_hash_path(mount->mount_point, mount->mount_point_length);
+
+	for (u32 i = 0; i < mount->entry_count; ++i) {
+		const ZiPackEntry* entry = &mount->entries[i];
+		u64 hash = mount->mount_point_length == 0
+			? entry->path_hash
+			: zi_vfs_hash_continue(prefix_hash, mount->strings + entry->path_offset, entry->path_length);
+		ZiVfsPathTable_set(&vfs_paths, hash, (ZiVfsLocation){.mount = mount_index, .entry = i});
+	}
+}
+
+static void zi_vfs_rebuild_index(void) {
+	ZiVfsPathTable_clear(&vfs_paths);
+	for (u32 i = 0; i < vfs_mounts.count; ++i) {
+		if (vfs_mounts.data[i]->type == ZiVfsMountType_Pack) {
+			zi_vfs_index_pack(i);
+		}
+	}
+}
+
+static ZiVfsMount* zi_vfs_create_mount(ZiVfsMountType type, const char* source, const char* mount_point) {
+	char normalized[ZI_VFS_MAX_PATH];
+	u64 length = zi_vfs_normalize(mount_point ? mount_point : "", normalized, sizeof(normalized) - 1);
+	if (length == U64_MAX) {
+		zi_log_error("invalid mount point %s", mount_point);
+		return ZI_NULL;
+	}
+	if (length > 0) {
+		normalized[length++] = '/';
+		normalized[length] = '\0';
+	}
+
+	ZiVfsMount* mount = zi_mem_alloc(sizeof(ZiVfsMount));
+	memset(mount, 0, sizeof(ZiVfsMount));
+	mount->type = type;
+	mount->source = zi_vfs_strdup(source, strlen(source));
+	mount->mount_point = zi_vfs_strdup(normalized, length);
+	mount->mount_point_length = length;
+	return mount;
+}
+
+static void zi_vfs_destroy_mount(ZiVfsMount* mount) {
+	if (mount->type == ZiVfsMountType_Pack) {
+		zi_platform_unmap_file(&mount->map);
+	}
+	zi_mem_free(mount->source);
+	zi_mem_free(mount->mount_point);
+	zi_mem_free(mount);
+}
+
+ZiBool zi_vfs_mount_dir(const char* directory, const char* mount_point) {
+	zi_vfs_init();
+
+	ZiVfsMount* mount = zi_vfs_create_mount(ZiVfsMountType_Directory, directory, mount_point);
+	if (!mount) return ZI_FALSE;
+
+	ZiVfsMountArray_push(&vfs_mounts, mount);
+	zi_log_debug("mounted directory %s at /%s", directory, mount->mount_point);
+	return ZI_TRUE;
+}
+
+static ZiBool zi_vfs_validate_pack(const char* pack_path, const ZiMappedFile* map) {
+	if (map->size < sizeof(ZiPackHeader)) {
+		zi_log_error("%s is not a pack", pack_path);
+		return ZI_FALSE;
+	}
+
+	const ZiPackHeader* header = (const ZiPackHeader*)map->data;
+	if (memcmp(header->magic, ZI_PACK_MAGIC, sizeof(header->magic)) != 0) {
+		zi_log_error("%s is not a pack", pack_path);
+		return ZI_FALSE;
+	}
+	if (header->version != ZI_PACK_VERSION) {
+		zi_log_error("%s has pack version %u, expected %u", pack_path, header->version, ZI_PACK_VERSION);
+		return ZI_FALSE;
+	}
+
+	u64 toc_size = (u64)header->entry_count * sizeof(ZiPackEntry);
+	if (header->toc_offset > map->size || toc_size > map->size - header->toc_offset ||
+	    header->strings_offset > map->size || header->strings_size > map->size - header->strings_offset) {
+		zi_log_error("%s has a truncated table of contents", pack_path);
+		return ZI_FALSE;
+	}
+
+	const ZiPackEntry* entries = (const ZiPackEntry*)(map->data + header->toc_offset);
+	for (u32 i = 0; i < header->entry_count; ++i) {
+		const ZiPackEntry* entry = &entries[i];
+		if (entry->offset > map->size || entry->stored_size > map->size - entry->offset ||
+		    (u64)entry->path_offset + entry->path_length > header->strings_size) {
+			zi_log_error("%s has an entry outside the file", pack_path);
+			return ZI_FALSE;
+		}
+		// uncompressed entries are handed out as views of the map, size is what callers read
+		if (entry->compression == ZiPackCompression_None && entry->size != entry->stored_size) {
+			zi_log_error("%s has an uncompressed entry with size %llu but %llu stored bytes", pack_path,
+			             (unsigned long long)entry->size, (unsigned long long)entry->stored_size);
+			return ZI_FALSE;
+		}
+	}
+
+	return ZI_TRUE;
+}
+
+ZiBool zi_vfs_mount_pack(const char* pack_path, const char* mount_point) {
+	zi_vfs_init();
+
+	ZiMappedFile map;
+	if (!zi_platform_map_file(pack_path, ZiFileMapFlags_Random, &map)) {
+		return ZI_FALSE;
+	}
+
+	if (!zi_vfs_validate_pack(pack_path, &map)) {
+		zi_platform_unmap_file(&map);
+		return ZI_FALSE;
+	}
+
+	ZiVfsMount* mount = zi_vfs_create_mount(ZiVfsMountType_Pack, pack_path, mount_point);
+	if (!mount) {
+		zi_platform_unmap_file(&map);
+		return ZI_FALSE;
+	}
+
+	const ZiPackHeader* header = (const ZiPackHeader*)map.data;
+	mount->map = map;
+	mount->entries = (const ZiPackEntry*)(map.data + header->toc_offset);
+	mount->entry_count = header->entry_count;
+	mount->strings = (const char*)(map.data + header->strings_offset);
+
+	ZiVfsMountArray_push(&vfs_mounts, mount);
+	zi_vfs_index_pack((u32)vfs_mounts.count - 1);
+
+	zi_log_debug("mounted pack %s at /%s, %u entries", pack_path, mount->mount_point, mount->entry_count);
+	return ZI_TRUE;
+}
+
+ZiBool zi_vfs_unmount(const char* source) {
+	if (!vfs_initialized) return ZI_FALSE;
+
+	for (u64 i = vfs_mounts.count; i-- > 0;) {
+		ZiVfsMount* mount = vfs_mounts.data[i];
+		if (strcmp(mount->source, source) == 0) {
+			ZiVfsMountArray_remove(&vfs_mounts, i);
+			zi_vfs_destroy_mount(mount);
+			zi_vfs_rebuild_index();
+			return ZI_TRUE;
+		}
+	}
+	return ZI_FALSE;
+}
+
+void zi_vfs_unmount_all(void) {
+	if (!vfs_initialized) return;
+
+	for (u64 i = 0; i < vfs_mounts.count; ++i) {
+		zi_vfs_destroy_mount(vfs_mounts.data[i]);
+	}
+	ZiVfsMountArray_free(&vfs_mounts);
+	ZiVfsPathTable_free(&vfs_paths);
+	vfs_initialized = ZI_FALSE;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+typedef struct ZiVfsResolved {
+	const ZiVfsMount*  mount;
+	const ZiPackEntry* entry;
+	FILE*              file;
+} ZiVfsResolved;
+
+static ZiBool zi_vfs_entry_matches(const ZiVfsMount* mount, const ZiPackEntry* entry, const char* path, u64 length) {
+	return length == mount->mount_point_length + entry->path_length &&
+	       memcmp(path, mount->mount_point, mount->mount_point_length) == 0 &&
+	       memcmp(path + mount->mount_point_length, mount->strings + entry->path_offset, entry->path_length) == 0;
+}
+
+static ZiBool zi_vfs_resolve(const char* path, ZiVfsResolved* resolved) {
+	memset(resolved, 0, sizeof(ZiVfsResolved));
+	if (!vfs_initialized) return ZI_FALSE;
+
+	char normalized[ZI_VFS_MAX_PATH];
+	u64 length = zi_vfs_normalize(path, normalized, sizeof(normalized));
+	if (length == U64_MAX || length == 0) return ZI_FALSE;
+
+	u64 first_dir = 0;
+	ZiVfsLocation* location = ZiVfsPathTable_get(&vfs_paths, zi_vfs_hash_path(normalized, length));
+	if (location) {
+		const ZiVfsMount*  mount = vfs_mounts.data[location->mount];
+		const ZiPackEntry* entry = &mount->entries[location->entry];
+		// a 64 bit collision is unlikely but a wrong file would be much worse than a miss
+		if (zi_vfs_entry_matches(mount, entry, normalized, length)) {
+			resolved->mount = mount;
+			resolved->entry = entry;
+			first_dir = location->mount + 1;
+		}
+	}
+
+	// only directories mounted after the winning pack can override it, shipping builds usually have none
+	for (u64 i = vfs_mounts.count; i-- > first_dir;) {
+		const ZiVfsMount* mount = vfs_mounts.data[i];
+		if (mount->type != ZiVfsMountType_Directory) continue;
+		if (length <= mount->mount_point_length || memcmp(normalized, mount->mount_point, mount->mount_point_length) != 0) continue;
+
+		char os_path[ZI_VFS_MAX_PATH * 2];
+		snprintf(os_path, sizeof(os_path), "%s/%s", mount->source, normalized + mount->mount_point_length);
+
+		FILE* file = fopen(os_path, "rb");
+		if (file) {
+			resolved->mount = mount;
+			resolved->entry = ZI_NULL;
+			resolved->file = file;
+			return ZI_TRUE;
+		}
+	}
+
+	return resolved->entry != ZI_NULL;
+}
+
+static u64 zi_vfs_file_size(FILE* file) {
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	return size > 0 ? (u64)size : 0;
+}
+
+static ZiBool zi_vfs_decode(const ZiVfsMount* mount, const ZiPackEntry* entry, u8* dst, u64 dst_size) {
+	const u8* src = mount->map.data + entry->offset;
+
+	switch (entry->compression) {
+		case ZiPackCompression_None:
+			memcpy(dst, src, entry->size);
+			return ZI_TRUE;
+		case ZiPackCompression_LZ4:
+			return zi_lz4_decompress(src, entry->stored_size, dst, dst_size);
+		case ZiPackCompression_Zstd:
+#ifdef ZI_VFS_ZSTD
+		{
+			size_t result = ZSTD_decompress(dst, dst_size, src, entry->stored_size);
+			return !ZSTD_isError(result) && result == dst_size;
+		}
+#else
+			zi_log_error("pack entry in %s is zstd compressed, the runtime was built without zstd", mount->source);
+			return ZI_FALSE;
+#endif
+		default:
+			zi_log_error("unknown compression %u in %s", entry->compression, mount->source);
+			return ZI_FALSE;
+	}
+}
+
+ZiBool zi_vfs_exists(const char* path) {
+	ZiVfsResolved resolved;
+	if (!zi_vfs_resolve(path, &resolved)) return ZI_FALSE;
+	if (resolved.file) fclose(resolved.file);
+	return ZI_TRUE;
+}
+
+ZiBool zi_vfs_stat(const char* path, ZiVfsStat* stat) {
+	ZiVfsResolved resolved;
+	if (!zi_vfs_resolve(path, &resolved)) return ZI_FALSE;
+
+	if (resolved.file) {
+		stat->size = zi_vfs_file_size(resolved.file);
+		stat->stored_size = stat->size;
+		stat->compression = ZiPackCompression_None;
+		stat->mapped = ZI_FALSE;
+		fclose(resolved.file);
+	} else {
+		stat->size = resolved.entry->size;
+		stat->stored_size = resolved.entry->stored_size;
+		stat->compression = resolved.entry->compression;
+		stat->mapped = resolved.entry->compression == ZiPackCompression_None;
+	}
+	return ZI_TRUE;
+}
+
+ZiBool zi_vfs_read(const char* path, ZiVfsFile* file) {
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->allocation = ZI_NULL;
+
+	ZiVfsResolved resolved;
+	if (!zi_vfs_resolve(path, &resolved)) return ZI_FALSE;
+
+	if (resolved.entry && resolved.entry->compression == ZiPackCompression_None) {
+		file->data = resolved.mount->map.data + resolved.entry->offset;
+		file->size = resolved.entry->size;
+		return ZI_TRUE;
+	}
+
+	u64 size = resolved.file ? zi_vfs_file_size(resolved.file) : resolved.entry->size;
+	u8* data = size > 0 ? zi_mem_alloc(size) : ZI_NULL;
+
+	ZiBool ok;
+	if (resolved.file) {
+		ok = fread(data, 1, size, resolved.file) == size;
+		fclose(resolved.file);
+	} else {
+		ok = zi_vfs_decode(resolved.mount, resolved.entry, data, size);
+	}
+
+	if (!ok) {
+		zi_log_error("failed to read %s", path);
+		if (data) zi_mem_free(data);
+		return ZI_FALSE;
+	}
+
+	file->data = data;
+	file->size = size;
+	file->allocation = data;
+	return ZI_TRUE;
+}
+
+ZiBool zi_vfs_read_into(const char* path, VoidPtr dst, u64 dst_size) {
+	ZiVfsResolved resolved;
+	if (!zi_vfs_resolve(path, &resolved)) return ZI_FALSE;
+
+	ZiBool ok;
+	if (resolved.file) {
+		ok = zi_vfs_file_size(resolved.file) == dst_size && fread(dst, 1, dst_size, resolved.file) == dst_size;
+		fclose(resolved.file);
+	} else {
+		ok = resolved.entry->size == dst_size && zi_vfs_decode(resolved.mount, resolved.entry, dst, dst_size);
+	}
+
+	if (!ok) {
+		zi_log_error("failed to read %s into a %llu byte buffer", path, (unsigned long long)dst_size);
+	}
+	return ok;
+}
+
+void zi_vfs_release(ZiVfsFile* file) {
+	if (file->allocation) {
+		zi_mem_free(file->allocation);
+	}
+	file->data = ZI_NULL;
+	file->size = 0;
+	file->allocation = ZI_NULL;
+}
+
+void zi_vfs_prefetch(const char* path) {
+	ZiVfsResolved resolved;
+	if (!zi_vfs_resolve(path, &resolved)) return;
+
+	if (resolved.file) {
+		fclose(resolved.file);
+		return;
+	}
+	zi_platform_prefetch_mapped_range(&resolved.mount->map, resolved.entry->offset, resolved.entry->stored_size);
+}
+
+// ============================================================================
+// Pack writer
+// ============================================================================
+
+ZI_ARRAY(ZiPackEntryArray, ZiPackEntry)
+ZI_ARRAY(ZiPackStringArray, char)
+
+static const u8 zi_pack_padding[4096] = {0};
+
+static ZiBool zi_pack_writer_pad(ZiPackWriter* writer, u64 alignment) {
+	u64 padding = (alignment - (writer->offset & (alignment - 1))) & (alignment - 1);
+	while (padding > 0) {
+		u64 chunk = padding < sizeof(zi_pack_padding) ? padding : sizeof(zi_pack_padding);
+		if (fwrite(zi_pack_padding, 1, chunk, writer->file) != chunk) return ZI_FALSE;
+		writer->offset += chunk;
+		padding -= chunk;
+	}
+	return ZI_TRUE;
+}
+
+ZiBool zi_pack_writer_open(ZiPackWriter* writer, const char* path, u32 alignment) {
+	memset(writer, 0, sizeof(ZiPackWriter));
+
+	if (alignment == 0) alignment = ZI_PACK_DEFAULT_ALIGNMENT;
+	if (alignment & (alignment - 1)) {
+		zi_log_error("pack alignment %u is not a power of two", alignment);
+		return ZI_FALSE;
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (!file) {
+		zi_log_error("failed to create pack %s", path);
+		return ZI_FALSE;
+	}
+
+	// rewritten once the table of contents is known
+	ZiPackHeader header = {0};
+	if (fwrite(&header, sizeof(header), 1, file) != 1) {
+		fclose(file);
+		return ZI_FALSE;
+	}
+
+	writer->file = file;
+	writer->alignment = alignment;
+	writer->offset = sizeof(header);
+	writer->entries = zi_mem_alloc(sizeof(ZiPackEntryArray));
+	writer->strings = zi_mem_alloc(sizeof(ZiPackStringArray));
+	ZiPackEntryArray_init(writer->entries, ZI_NULL);
+	ZiPackStringArray_init(writer->strings, ZI_NULL);
+	return ZI_TRUE;
+}
+
+ZiBool zi_pack_writer_add(ZiPackWriter* writer, const char* path, ConstPtr data, u64 size, ZiPackCompression compression) {
+	char normalized[ZI_VFS_MAX_PATH];
+	u64 length = zi_vfs_normalize(path, normalized, sizeof(normalized));
+	if (length == U64_MAX || length == 0 || length > U16_MAX) {
+		zi_log_error("invalid pack path %s", path);
+		return ZI_FALSE;
+	}
+
+	const u8* stored = data;
+	u64       stored_size = size;
+	u8*       compressed = ZI_NULL;
+
+	if (compression == ZiPackCompression_LZ4 && size > 0) {
+		u64 bound = zi_lz4_compress_bound(size);
+		compressed = zi_mem_alloc(bound);
+		stored_size = zi_lz4_compress(data, size, compressed, bound);
+		stored = compressed;
+	} else if (compression == ZiPackCompression_Zstd && size > 0) {
+#ifdef ZI_VFS_ZSTD
+		u64 bound = ZSTD_compressBound(size);
+		compressed = zi_mem_alloc(bound);
+		size_t result = ZSTD_compress(compressed, bound, data, size, 19);
+		stored_size = ZSTD_isError(result) ? 0 : result;
+		stored = compressed;
+#else
+		zi_log_warn("zstd is not available, storing %s uncompressed", normalized);
+		stored_size = 0;
+#endif
+	}
+
+	if (compression != ZiPackCompression_None && (stored_size == 0 || stored_size >= size)) {
+		compression = ZiPackCompression_None;
+		stored = data;
+		stored_size = size;
+	}
+
+	ZiBool ok = zi_pack_writer_pad(writer, writer->alignment) &&
+	            (stored_size == 0 || fwrite(stored, 1, stored_size, writer->file) == stored_size);
+
+	if (compressed) {
+		zi_mem_free(compressed);
+	}
+	if (!ok) {
+		zi_log_error("failed to write %s to the pack", normalized);
+		return ZI_FALSE;
+	}
+
+	ZiPackStringArray* strings = writer->strings;
+	ZiPackEntry entry = {0};
+	entry.path_hash = zi_vfs_hash_path(normalized, length);
+	entry.offset = writer->offset;
+	entry.stored_size = stored_size;
+	entry.size = size;
+	entry.path_offset = (u32)strings->count;
+	entry.path_length = (u16)length;
+	entry.compression = compression;
+	ZiPackEntryArray_push(writer->entries, entry);
+
+	// zero terminated so the strings block is readable in a hex dump, the terminator isn't part of the path
+	u64 required = strings->count + length + 1;
+	if (required > strings->capacity) {
+		ZiPackStringArray_reserve(strings, required > strings->capacity * 2 ? required : strings->capacity * 2);
+	}
+	memcpy(strings->data + strings->count, normalized, length + 1);
+	strings->count += length + 1;
+
+	writer->offset += stored_size;
+	return ZI_TRUE;
+}
+
+static int zi_pack_entry_compare(const void* a, const void* b) {
+	u64 x = ((const ZiPackEntry*)a)->path_hash;
+	u64 y = ((const ZiPackEntry*)b)->path_hash;
+	return (x > y) - (x < y);
+}
+
+ZiBool zi_pack_writer_close(ZiPackWriter* writer) {
+	ZiPackEntryArray*  entries = writer->entries;
+	ZiPackStringArray* strings = writer->strings;
+	ZiBool ok = ZI_TRUE;
+
+	qsort(entries->data, entries->count, sizeof(ZiPackEntry), zi_pack_entry_compare);
+
+	for (u64 i = 1; i < entries->count; ++i) {
+		const ZiPackEntry* a = &entries->data[i - 1];
+		const ZiPackEntry* b = &entries->data[i];
+		if (a->path_hash == b->path_hash) {
+			zi_log_error("pack paths %s and %s have the same hash", strings->data + a->path_offset, strings->data + b->path_offset);
+			ok = ZI_FALSE;
+		}
+	}
+
+	ZiPackHeader header = {0};
+	memcpy(header.magic, ZI_PACK_MAGIC, sizeof(header.magic));
+	header.version = ZI_PACK_VERSION;
+	header.entry_count = (u32)entries->count;
+	header.alignment = writer->alignment;
+
+	ok = ok && zi_pack_writer_pad(writer, 8);
+	header.strings_offset = writer->offset;
+	header.strings_size = strings->count;
+	ok = ok && (strings->count == 0 || fwrite(strings->data, 1, strings->count, writer->file) == strings->count);
+	writer->offset += strings->count;
+
+	ok = ok && zi_pack_writer_pad(writer, 8);
+	header.toc_offset = writer->offset;
+	ok = ok && (entries->count == 0 || fwrite(entries->data, sizeof(ZiPackEntry), entries->count, writer->file) == entries->count);
+
+	ok = ok && fseek(writer->file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, writer->file) == 1;
+	ok = (fclose(writer->file) == 0) && ok;
+
+	ZiPackEntryArray_free(entries);
+	ZiPackStringArray_free(strings);
+	zi_mem_free(entries);
+	zi_mem_free(strings);
+	memset(writer, 0, sizeof(ZiPackWriter));
+
+	if (!ok) {
+		zi_log_error("failed to write pack");
+	}
+	return ok;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "zi_common.h"
+
+// ============================================================================
+// Virtual file system
+// ============================================================================
+//
+// Directories and pack archives are mounted under a virtual prefix. Paths use '/' and are
+// relative to the virtual root ("textures/ground.ktx2"). Pack entries are resolved through one
+// hash table keyed by the full virtual path, so opening a packed file is a lookup plus an offset
+// into the mapped pack. Later mounts override earlier ones.
+//
+// Mounting and unmounting are not thread safe, reads are once the mounts are set up.
+
+#define ZI_PACK_MAGIC "ZIPACK\0\0"
+#define ZI_PACK_VERSION 1
+#define ZI_PACK_DEFAULT_ALIGNMENT 16
+
+enum ZiPackCompression_ {
+	ZiPackCompression_None = 0,
+	ZiPackCompression_LZ4  = 1,
+	// only available when the runtime was built with zstd (ZI_VFS_ZSTD)
+	ZiPackCompression_Zstd = 2,
+};
+
+typedef u8 ZiPackCompression;
+
+// Pack layout, little endian:
+// header | entry data, each aligned to header.alignment | path strings | toc sorted by path_hash
+typedef struct ZiPackHeader {
+	char magic[8];
+	u32  version;
+	u32  entry_count;
+	u32  alignment;
+	u32  reserved;
+	u64  toc_offset;
+	u64  strings_offset;
+	u64  strings_size;
+} ZiPackHeader;
+
+typedef struct ZiPackEntry {
+	u64               path_hash;
+	u64               offset;
+	u64               stored_size;
+	u64               size;
+	u32               path_offset;
+	u16               path_length;
+	ZiPackCompression compression;
+	u8                reserved;
+} ZiPackEntry;
+
+typedef struct ZiVfsStat {
+	u64               size;
+	u64               stored_size;
+	ZiPackCompression compression;
+	// data can be read straight from the mapped pack without a copy
+	ZiBool            mapped;
+} ZiVfsStat;
+
+typedef struct ZiVfsFile {
+	const u8* data;
+	u64       size;
+	VoidPtr   allocation;
+} ZiVfsFile;
+
+u64    zi_vfs_hash_path(const char* path, u64 length);
+
+ZiBool zi_vfs_mount_dir(const char* directory, const char* mount_point);
+ZiBool zi_vfs_mount_pack(const char* pack_path, const char* mount_point);
+// source is the directory or pack path given to the mount call
+ZiBool zi_vfs_unmount(const char* source);
+void   zi_vfs_unmount_all(void);
+
+ZiBool zi_vfs_exists(const char* path);
+ZiBool zi_vfs_stat(const char* path, ZiVfsStat* stat);
+// Uncompressed pack entries point straight into the mapping, everything else is read or
+// decompressed into an allocation. Either way the file has to be released.
+ZiBool zi_vfs_read(const char* path, ZiVfsFile* file);
+// reads or decompresses into caller memory, e.g. a mapped staging buffer, dst_size must be the file size
+ZiBool zi_vfs_read_into(const char* path, VoidPtr dst, u64 dst_size);
+void   zi_vfs_release(ZiVfsFile* file);
+// starts paging a packed file in so a later read doesn't stall on a cold cache
+void   zi_vfs_prefetch(const char* path);
+
+// ============================================================================
+// Pack writer
+// ============================================================================
+
+typedef struct ZiPackWriter {
+	VoidPtr file;
+	u32     alignment;
+	u64     offset;
+	VoidPtr entries;
+	VoidPtr strings;
+} ZiPackWriter;
+
+// alignment is a power of two, use the page size for entries that get mapped directly
+ZiBool zi_pack_writer_open(ZiPackWriter* writer, const char* path, u32 alignment);
+// entries that don't get smaller are stored uncompressed
+ZiBool zi_pack_writer_add(ZiPackWriter* writer, const char* path, ConstPtr data, u64 size, ZiPackCompression compression);
+ZiBool zi_pack_writer_close(ZiPackWriter* writer);
@@ -0,0 +1,322 @@
+#include "unity.h"
+#include "zi_aabb_tree.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_AABB_TREE_BOXES   3000
+#define TEST_AABB_TREE_QUERIES 200
+
+static ZiAABB tree_boxes[TEST_AABB_TREE_BOXES];
+static u32    tree_proxies[TEST_AABB_TREE_BOXES];
+static u32    tree_found[TEST_AABB_TREE_BOXES];
+static u8     tree_expected[TEST_AABB_TREE_BOXES];
+
+static ZiAABB tree_random_box(f32 range) {
+    ZiVec3 c = zi_vec3(zi_random_range_f32(-range, range), zi_random_range_f32(-range, range), zi_random_range_f32(-range, range));
+    ZiVec3 e = zi_vec3(zi_random_range_f32(0.1f, 2.0f), zi_random_range_f32(0.1f, 2.0f), zi_random_range_f32(0.1f, 2.0f));
+    return zi_aabb(zi_vec3_sub(c, e), zi_vec3_add(c, e));
+}
+
+static ZiBool tree_box_inside(ZiAABB outer, ZiAABB inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z && outer.max.x >= inner.max.x &&
+           outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+// links both ways, parents around children, heights right
+static u32 assert_tree_node(const ZiAabbTree* tree, u32 index, u32 parent) {
+    const ZiAabbTreeNode* node = &tree->nodes[index];
+    TEST_ASSERT_EQUAL_UINT32(parent, node->parent);
+    if (node->child1 == ZI_AABB_TREE_NULL) {
+        TEST_ASSERT_EQUAL_INT32(0, node->height);
+        return 1;
+    }
+
+    const ZiAabbTreeNode* child1 = &tree->nodes[node->child1];
+    const ZiAabbTreeNode* child2 = &tree->nodes[node->child2];
+    TEST_ASSERT_TRUE(tree_box_inside(node->aabb, child1->aabb));
+    TEST_ASSERT_TRUE(tree_box_inside(node->aabb, child2->aabb));
+    TEST_ASSERT_EQUAL_INT32(1 + (child1->height > child2->height ? child1->height : child2->height), node->height);
+    return assert_tree_node(tree, node->child1, index) + assert_tree_node(tree, node->child2, index);
+}
+
+static void assert_tree_valid(const ZiAabbTree* tree) {
+    if (tree->proxy_count == 0) {
+        TEST_ASSERT_EQUAL_UINT32(ZI_AABB_TREE_NULL, tree->root);
+        TEST_ASSERT_EQUAL_UINT32(0, tree->node_count);
+        return;
+    }
+    TEST_ASSERT_EQUAL_UINT32(tree->proxy_count, assert_tree_node(tree, tree->root, ZI_AABB_TREE_NULL));
+    TEST_ASSERT_EQUAL_UINT32(2 * tree->proxy_count - 1, tree->node_count);
+}
+
+// found matches expected exactly, each proxy once
+static void assert_same_set(const ZiAabbTree* tree, u32 found_count) {
+    u32 expected_count = 0;
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+        expected_count += tree_expected[i];
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected_count, found_count);
+    for (u32 i = 0; i < found_count; ++i) {
+        uintptr_t box = (uintptr_t)zi_aabb_tree_user_data(tree, tree_found[i]);
+        TEST_ASSERT_EQUAL_UINT32(tree_proxies[box], tree_found[i]);
+        TEST_ASSERT_EQUAL_UINT8(1, tree_expected[box]);
+        tree_expected[box] = 2;
+    }
+}
+
+static ZiAabbTree tree_build(u32 count) {
+    ZiAabbTree tree;
+    zi_aabb_tree_init(&tree, 0.2f);
+    for (u32 i = 0; i < count; ++i) {
+        tree_boxes[i] = tree_random_box(100.0f);
+        tree_proxies[i] = zi_aabb_tree_insert(&tree, tree_boxes[i], (VoidPtr)(uintptr_t)i);
+    }
+    return tree;
+}
+
+// ============================================================================
+// Structure Tests
+// ============================================================================
+
+void test_aabb_tree_insert_remove(void) {
+    zi_random_seed(470);
+    ZiAabbTree tree = tree_build(TEST_AABB_TREE_BOXES);
+    TEST_ASSERT_EQUAL_UINT32(TEST_AABB_TREE_BOXES, tree.proxy_count);
+    assert_tree_valid(&tree);
+    // about what a balanced tree gets, the rotations keep it from degrading
+    TEST_ASSERT_TRUE(zi_aabb_tree_height(&tree) <= 20);
+
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+        TEST_ASSERT_EQUAL_PTR((VoidPtr)(uintptr_t)i, zi_aabb_tree_user_data(&tree, tree_proxies[i]));
+        TEST_ASSERT_TRUE(tree_box_inside(zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]), tree_boxes[i]));
+    }
+
+    // every other one out, then back in, freed nodes get reused
+    u32 capacity = tree.capacity;
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; i += 2) {
+        zi_aabb_tree_remove(&tree, tree_proxies[i]);
+    }
+    assert_tree_valid(&tree);
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; i += 2) {
+        tree_proxies[i] = zi_aabb_tree_insert(&tree, tree_boxes[i], (VoidPtr)(uintptr_t)i);
+    }
+    assert_tree_valid(&tree);
+    TEST_ASSERT_EQUAL_UINT32(capacity, tree.capacity);
+
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+        zi_aabb_tree_remove(&tree, tree_proxies[i]);
+    }
+    assert_tree_valid(&tree);
+    TEST_ASSERT_EQUAL_INT32(0, zi_aabb_tree_height(&tree));
+
+    zi_aabb_tree_destroy(&tree);
+    TEST_ASSERT_NULL(tree.nodes);
+}
+
+// everything inserted along a line, the worst order for an unbalanced tree
+void test_aabb_tree_sorted_insert_stays_balanced(void) {
+    ZiAabbTree tree;
+    zi_aabb_tree_init(&tree, -1.0f);
+    TEST_ASSERT_EQUAL_FLOAT(ZI_AABB_TREE_DEFAULT_MARGIN, tree.margin);
+    for (u32 i = 0; i < 1024; ++i) {
+        zi_aabb_tree_insert(&tree, zi_aabb(zi_vec3((f32)i, 0.0f, 0.0f), zi_vec3((f32)i + 0.5f, 1.0f, 1.0f)), ZI_NULL);
+    }
+    assert_tree_valid(&tree);
+    TEST_ASSERT_TRUE(zi_aabb_tree_height(&tree) <= 15);
+    zi_aabb_tree_destroy(&tree);
+}
+
+void test_aabb_tree_move(void) {
+    zi_random_seed(471);
+    ZiAabbTree tree = tree_build(500);
+
+    // inside the margin nothing changes
+    ZiAABB nudged = tree_boxes[7];
+    nudged.min.x += 0.1f;
+    nudged.max.x += 0.1f;
+    TEST_ASSERT_FALSE(zi_aabb_tree_move(&tree, tree_proxies[7], nudged, zi_vec3(0.1f, 0.0f, 0.0f)));
+
+    // a fast mover gets a box stretched ahead of it
+    ZiVec3 step = zi_vec3(0.0f, 0.0f, -2.0f);
+    ZiAABB moved = zi_aabb(zi_vec3_add(nudged.min, step), zi_vec3_add(nudged.max, step));
+    TEST_ASSERT_TRUE(zi_aabb_tree_move(&tree, tree_proxies[7], moved, step));
+    ZiAABB fat = zi_aabb_tree_fat_aabb(&tree, tree_proxies[7]);
+    TEST_ASSERT_TRUE(tree_box_inside(fat, moved));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, moved.min.z - 0.2f - 8.0f, fat.min.z);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, moved.max.z + 0.2f, fat.max.z);
+    // stopped, the stretched box is too big now and shrinks back
+    TEST_ASSERT_TRUE(zi_aabb_tree_move(&tree, tree_proxies[7], moved, zi_vec3(0.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, moved.min.z - 0.2f, zi_aabb_tree_fat_aabb(&tree, tree_proxies[7]).min.z);
+
+    // random walks, the proxies stay put
+    for (u32 frame = 0; frame < 20; ++frame) {
+        for (u32 i = 0; i < 500; ++i) {
+            ZiVec3 d = zi_vec3(zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f));
+            tree_boxes[i] = zi_aabb(zi_vec3_add(tree_boxes[i].min, d), zi_vec3_add(tree_boxes[i].max, d));
+            zi_aabb_tree_move(&tree, tree_proxies[i], tree_boxes[i], d);
+        }
+        assert_tree_valid(&tree);
+    }
+    for (u32 i = 0; i < 500; ++i) {
+        TEST_ASSERT_TRUE(tree_box_inside(zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]), tree_boxes[i]));
+        TEST_ASSERT_EQUAL_PTR((VoidPtr)(uintptr_t)i, zi_aabb_tree_user_data(&tree, tree_proxies[i]));
+    }
+    zi_aabb_tree_destroy(&tree);
+}
+
+void test_aabb_tree_refit(void) {
+    zi_random_seed(472);
+    ZiAabbTree tree = tree_build(TEST_AABB_TREE_BOXES);
+
+    // everything drifts the same way, like a moving platform full of props
+    for (u32 frame = 0; frame < 3; ++frame) {
+        for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+            ZiVec3 d = zi_vec3(1.5f + zi_random_range_f32(-0.5f, 0.5f), 0.0f, zi_random_range_f32(-0.5f, 0.5f));
+            tree_boxes[i] = zi_aabb(zi_vec3_add(tree_boxes[i].min, d), zi_vec3_add(tree_boxes[i].max, d));
+            zi_aabb_tree_update(&tree, tree_proxies[i], tree_boxes[i]);
+        }
+        zi_aabb_tree_refit(&tree);
+        assert_tree_valid(&tree);
+    }
+
+    ZiAABB query = zi_aabb(zi_vec3(-20.0f, -20.0f, -20.0f), zi_vec3(30.0f, 20.0f, 20.0f));
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+        TEST_ASSERT_TRUE(tree_box_inside(zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]), tree_boxes[i]));
+        tree_expected[i] = (u8)zi_aabb_aabb_intersect(zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]), query);
+    }
+    assert_same_set(&tree, zi_aabb_tree_collect_aabb(&tree, query, tree_found, TEST_AABB_TREE_BOXES));
+    zi_aabb_tree_destroy(&tree);
+}
+
+// ============================================================================
+// Query Tests
+// ============================================================================
+
+typedef struct TreeQueryCount {
+    u32 count;
+    u32 limit;
+} TreeQueryCount;
+
+static ZiBool tree_count_fn(VoidPtr context, u32 proxy, VoidPtr user_data) {
+    TreeQueryCount* counter = (TreeQueryCount*)context;
+    TEST_ASSERT_EQUAL_UINT32(tree_proxies[(uintptr_t)user_data], proxy);
+    return ++counter->count < counter->limit;
+}
+
+// 60 degrees both ways down -z from the origin, out to 80
+static ZiFrustum tree_frustum(void) {
+    ZiMat4 projection = zi_mat4_perspective(zi_radians(60.0f), 1.0f, 0.1f, 80.0f);
+    ZiMat4 view = zi_mat4_look_at(zi_vec3_zero(), zi_vec3(0.0f, 0.0f, -1.0f), zi_vec3_up());
+    ZiMat4 view_projection = zi_mat4_mul(&projection, &view);
+    return zi_frustum_from_mat4(&view_projection);
+}
+
+void test_aabb_tree_queries_match_brute_force(void) {
+    zi_random_seed(473);
+    ZiAabbTree tree = tree_build(TEST_AABB_TREE_BOXES);
+
+    for (u32 q = 0; q < TEST_AABB_TREE_QUERIES; ++q) {
+        ZiAABB query = tree_random_box(100.0f);
+        query.max = zi_vec3_add(query.max, zi_vec3(10.0f, 10.0f, 10.0f));
+        for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+            tree_expected[i] = (u8)zi_aabb_aabb_intersect(zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]), query);
+        }
+        assert_same_set(&tree, zi_aabb_tree_collect_aabb(&tree, query, tree_found, TEST_AABB_TREE_BOXES));
+
+        ZiSphere sphere = zi_sphere(zi_aabb_center(tree_random_box(100.0f)), zi_random_range_f32(1.0f, 20.0f));
+        for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+            ZiAABB fat = zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]);
+            ZiVec3 closest = zi_vec3(zi_clamp_f32(sphere.center.x, fat.min.x, fat.max.x), zi_clamp_f32(sphere.center.y, fat.min.y, fat.max.y),
+                                     zi_clamp_f32(sphere.center.z, fat.min.z, fat.max.z));
+            tree_expected[i] = zi_vec3_length_sq(zi_vec3_sub(closest, sphere.center)) <= sphere.radius * sphere.radius;
+        }
+        assert_same_set(&tree, zi_aabb_tree_collect_sphere(&tree, sphere, tree_found, TEST_AABB_TREE_BOXES));
+    }
+
+    ZiFrustum frustum = tree_frustum();
+    for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+        tree_expected[i] = (u8)zi_frustum_contains_aabb(frustum, zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]));
+    }
+    u32 visible = zi_aabb_tree_collect_frustum(&tree, &frustum, tree_found, TEST_AABB_TREE_BOXES);
+    TEST_ASSERT_TRUE(visible > 20 && visible < TEST_AABB_TREE_BOXES / 2);
+    assert_same_set(&tree, visible);
+
+    // too small an array still counts everything, the callback form stops when told
+    TEST_ASSERT_EQUAL_UINT32(visible, zi_aabb_tree_collect_frustum(&tree, &frustum, tree_found, 5));
+    TreeQueryCount counter = {0, U32_MAX};
+    zi_aabb_tree_query_frustum(&tree, &frustum, tree_count_fn, &counter);
+    TEST_ASSERT_EQUAL_UINT32(visible, counter.count);
+    counter = (TreeQueryCount){0, 3};
+    zi_aabb_tree_query_frustum(&tree, &frustum, tree_count_fn, &counter);
+    TEST_ASSERT_EQUAL_UINT32(3, counter.count);
+    counter = (TreeQueryCount){0, 1};
+    zi_aabb_tree_query_aabb(&tree, zi_aabb(zi_vec3(-100.0f, -100.0f, -100.0f), zi_vec3(100.0f, 100.0f, 100.0f)), tree_count_fn, &counter);
+    TEST_ASSERT_EQUAL_UINT32(1, counter.count);
+    counter = (TreeQueryCount){0, U32_MAX};
+    zi_aabb_tree_query_sphere(&tree, zi_sphere(zi_vec3(0.0f, 0.0f, 0.0f), 1000.0f), tree_count_fn, &counter);
+    TEST_ASSERT_EQUAL_UINT32(TEST_AABB_TREE_BOXES, counter.count);
+
+    zi_aabb_tree_destroy(&tree);
+}
+
+// nearest real box along the ray, the tree only knows the fat ones
+static f32 tree_nearest_fn(VoidPtr context, u32 proxy, VoidPtr user_data, ZiRay ray, f32 max_t) {
+    u32* nearest = (u32*)context;
+    f32  t;
+    if (zi_ray_aabb_intersect(ray, tree_boxes[(uintptr_t)user_data], &t) && t < max_t) {
+        *nearest = (u32)(uintptr_t)user_data;
+        return t;
+    }
+    return max_t;
+}
+
+void test_aabb_tree_raycast(void) {
+    zi_random_seed(474);
+    ZiAabbTree tree = tree_build(TEST_AABB_TREE_BOXES);
+
+    u32 hits = 0;
+    for (u32 r = 0; r < TEST_AABB_TREE_QUERIES; ++r) {
+        ZiVec3 origin = zi_vec3(zi_random_range_f32(-120.0f, 120.0f), zi_random_range_f32(-120.0f, 120.0f), zi_random_range_f32(-120.0f, 120.0f));
+        // aimed at a box, the segments don't always reach
+        ZiVec3 target = zi_aabb_center(tree_boxes[zi_random_range_i32(0, TEST_AABB_TREE_BOXES - 1)]);
+        ZiRay  ray = zi_ray(origin, zi_vec3_sub(target, origin));
+        f32    max_t = (r & 1) ? 60.0f : F32_MAX;
+
+        u32 expected = TEST_AABB_TREE_BOXES;
+        f32 best = max_t;
+        for (u32 i = 0; i < TEST_AABB_TREE_BOXES; ++i) {
+            f32 t;
+            if (zi_ray_aabb_intersect(ray, tree_boxes[i], &t) && t < best) {
+                best = t;
+                expected = i;
+            }
+            tree_expected[i] = zi_ray_aabb_intersect(ray, zi_aabb_tree_fat_aabb(&tree, tree_proxies[i]), &t) && t <= max_t;
+        }
+
+        u32 nearest = TEST_AABB_TREE_BOXES;
+        zi_aabb_tree_raycast(&tree, ray, max_t, tree_nearest_fn, &nearest);
+        TEST_ASSERT_EQUAL_UINT32(expected, nearest);
+        hits += expected != TEST_AABB_TREE_BOXES;
+
+        assert_same_set(&tree, zi_aabb_tree_collect_ray(&tree, ray, max_t, tree_found, TEST_AABB_TREE_BOXES));
+        // no callback walks the same leaves and reports nothing
+        zi_aabb_tree_raycast(&tree, ray, max_t, ZI_NULL, ZI_NULL);
+    }
+    TEST_ASSERT_TRUE(hits > TEST_AABB_TREE_QUERIES / 4);
+
+    zi_aabb_tree_destroy(&tree);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_aabb_tree_tests(void) {
+    RUN_TEST(test_aabb_tree_insert_remove);
+    RUN_TEST(test_aabb_tree_sorted_insert_stays_balanced);
+    RUN_TEST(test_aabb_tree_move);
+    RUN_TEST(test_aabb_tree_refit);
+    RUN_TEST(test_aabb_tree_queries_match_brute_force);
+    RUN_TEST(test_aabb_tree_raycast);
+}
@@ -0,0 +1,130 @@
+#include "unity.h"
+#include "zi_app.h"
+#include "zi_platform.h"
+
+// ============================================================================
+// Fixed Timestep Tests
+// ============================================================================
+
+#define STEP (1.0 / 60.0)
+
+void test_fixed_timestep_accumulates_partial_frames(void) {
+    ZiFixedTimestep timestep;
+    zi_fixed_timestep_init(&timestep, STEP);
+
+    TEST_ASSERT_EQUAL_UINT32(0, zi_fixed_timestep_advance(&timestep, STEP * 0.5));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, (f32)zi_fixed_timestep_alpha(&timestep));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, (f32)(STEP * 0.5), (f32)zi_fixed_timestep_remaining(&timestep));
+
+    TEST_ASSERT_EQUAL_UINT32(1, zi_fixed_timestep_advance(&timestep, STEP * 0.75));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.25f, (f32)zi_fixed_timestep_alpha(&timestep));
+}
+
+void test_fixed_timestep_multiple_steps_per_frame(void) {
+    ZiFixedTimestep timestep;
+    zi_fixed_timestep_init(&timestep, STEP);
+
+    // a 30 fps frame runs the 60 Hz simulation twice
+    TEST_ASSERT_EQUAL_UINT32(2, zi_fixed_timestep_advance(&timestep, 2.0 * STEP + 1e-9));
+    TEST_ASSERT_TRUE(zi_fixed_timestep_alpha(&timestep) < 0.001);
+}
+
+void test_fixed_timestep_total_steps_match_time(void) {
+    ZiFixedTimestep timestep;
+    zi_fixed_timestep_init(&timestep, STEP);
+
+    // uneven render rate, the simulation still advances exactly once per step of real time
+    u32 total = 0;
+    f64 elapsed = 0.0;
+    for (u32 i = 0; i < 1000; ++i) {
+        f64 frame_time = (i % 3 + 1) * 0.005;
+        total += zi_fixed_timestep_advance(&timestep, frame_time);
+        elapsed += frame_time;
+    }
+    f64 simulated = total * STEP + timestep.accumulator;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (f32)elapsed, (f32)simulated);
+}
+
+void test_fixed_timestep_clamps_long_frames(void) {
+    ZiFixedTimestep timestep;
+    zi_fixed_timestep_init(&timestep, STEP);
+
+    // a multi second hitch must not turn into hundreds of catch-up steps
+    TEST_ASSERT_EQUAL_UINT32(ZI_FIXED_TIMESTEP_MAX_STEPS, zi_fixed_timestep_advance(&timestep, 5.0));
+    TEST_ASSERT_TRUE(timestep.accumulator < STEP);
+    TEST_ASSERT_EQUAL_UINT32(0, zi_fixed_timestep_advance(&timestep, -1.0));
+}
+
+// ============================================================================
+// Frame Pacer Tests
+// ============================================================================
+
+void test_frame_pacer_stats(void) {
+    ZiFramePacer pacer;
+    zi_frame_pacer_init(&pacer, 0.0);
+
+    // alternating 10 ms and 20 ms frames, synthetic ticks so the test doesn't depend on the clock
+    u64 ms = pacer.frequency / 1000;
+    u64 now = 1;
+    zi_frame_pacer_record(&pacer, now);
+    for (u32 i = 0; i < 10; ++i) {
+        now += (i % 2 == 0 ? 10 : 20) * ms;
+        zi_frame_pacer_record(&pacer, now);
+    }
+
+    ZiFrameTimingStats stats;
+    zi_frame_pacer_get_stats(&pacer, &stats);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.sample_count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 15.0f, (f32)stats.average_ms);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 10.0f, (f32)stats.min_ms);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 20.0f, (f32)stats.max_ms);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 5.0f, (f32)stats.std_dev_ms);
+}
+
+void test_frame_pacer_history_wraps(void) {
+    ZiFramePacer pacer;
+    zi_frame_pacer_init(&pacer, 0.0);
+
+    u64 ms = pacer.frequency / 1000;
+    u64 now = 1;
+    zi_frame_pacer_record(&pacer, now);
+    for (u32 i = 0; i < ZI_FRAME_PACER_HISTORY * 2; ++i) {
+        now += (i < ZI_FRAME_PACER_HISTORY ? 50 : 5) * ms;
+        zi_frame_pacer_record(&pacer, now);
+    }
+
+    // only the most recent frames are kept
+    ZiFrameTimingStats stats;
+    zi_frame_pacer_get_stats(&pacer, &stats);
+    TEST_ASSERT_EQUAL_UINT32(ZI_FRAME_PACER_HISTORY, stats.sample_count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 5.0f, (f32)stats.max_ms);
+}
+
+void test_frame_pacer_waits_for_target(void) {
+    ZiFramePacer pacer;
+    zi_frame_pacer_init(&pacer, 200.0);
+
+    u64 start = zi_platform_get_ticks();
+    for (u32 i = 0; i < 5; ++i) {
+        zi_frame_pacer_wait(&pacer);
+    }
+    f64 elapsed = (f64)(zi_platform_get_ticks() - start) / (f64)pacer.frequency;
+
+    // first wait sets the deadline, the remaining four are 5 ms apart
+    TEST_ASSERT_TRUE(elapsed >= 0.0195);
+    TEST_ASSERT_TRUE(zi_frame_pacer_get_remaining(&pacer) <= 0.005);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_app_tests(void) {
+    RUN_TEST(test_fixed_timestep_accumulates_partial_frames);
+    RUN_TEST(test_fixed_timestep_multiple_steps_per_frame);
+    RUN_TEST(test_fixed_timestep_total_steps_match_time);
+    RUN_TEST(test_fixed_timestep_clamps_long_frames);
+    RUN_TEST(test_frame_pacer_stats);
+    RUN_TEST(test_frame_pacer_history_wraps);
+    RUN_TEST(test_frame_pacer_waits_for_target);
+}
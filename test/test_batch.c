@@ -0,0 +1,411 @@
+#include "unity.h"
+#include "zi_batch.h"
+#include "zi_platform.h"
+
+#include <string.h>
+
+// not a multiple of 8, the tail goes through the portable path
+#define TEST_BATCH_COUNT 37
+
+typedef struct TestBatchVectors {
+    f32       x[TEST_BATCH_COUNT];
+    f32       y[TEST_BATCH_COUNT];
+    f32       z[TEST_BATCH_COUNT];
+    ZiVec3SoA soa;
+} TestBatchVectors;
+
+static void batch_vectors_random(TestBatchVectors* v, f32 range) {
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        v->x[i] = zi_random_range_f32(-range, range);
+        v->y[i] = zi_random_range_f32(-range, range);
+        v->z[i] = zi_random_range_f32(-range, range);
+    }
+    v->soa = (ZiVec3SoA){v->x, v->y, v->z};
+}
+
+static void batch_vectors_empty(TestBatchVectors* v) {
+    v->soa = (ZiVec3SoA){v->x, v->y, v->z};
+}
+
+static ZiVec3 batch_vector_at(const TestBatchVectors* v, u32 i) {
+    return zi_vec3(v->x[i], v->y[i], v->z[i]);
+}
+
+static ZiQuat batch_random_quat(void) {
+    ZiVec3 axis = zi_vec3_normalize(zi_vec3(zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f), 1.0f));
+    return zi_quat_from_axis_angle(axis, zi_random_range_f32(-ZI_PI, ZI_PI));
+}
+
+static ZiMat34 batch_random_transform(void) {
+    ZiVec3 t = zi_vec3(zi_random_range_f32(-50.0f, 50.0f), zi_random_range_f32(-50.0f, 50.0f), zi_random_range_f32(-50.0f, 50.0f));
+    ZiVec3 s = zi_vec3(zi_random_range_f32(0.5f, 2.0f), zi_random_range_f32(0.5f, 2.0f), zi_random_range_f32(0.5f, 2.0f));
+    return zi_mat34_compose(t, batch_random_quat(), s);
+}
+
+static void assert_vec3_within(f32 delta, ZiVec3 expected, ZiVec3 actual) {
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+// ============================================================================
+// Transform Tests
+// ============================================================================
+
+void test_batch_transform_points_and_vectors(void) {
+    zi_random_seed(420);
+    ZiMat34 m = batch_random_transform();
+    TestBatchVectors in, points, vectors;
+    batch_vectors_random(&in, 10.0f);
+    batch_vectors_empty(&points);
+    batch_vectors_empty(&vectors);
+
+    zi_batch_transform_points(&m, in.soa, points.soa, TEST_BATCH_COUNT);
+    zi_batch_transform_vectors(&m, in.soa, vectors.soa, TEST_BATCH_COUNT);
+
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        assert_vec3_within(1e-4f, zi_mat34_transform_point(&m, batch_vector_at(&in, i)), batch_vector_at(&points, i));
+        assert_vec3_within(1e-4f, zi_mat34_transform_vector(&m, batch_vector_at(&in, i)), batch_vector_at(&vectors, i));
+    }
+
+    // in place
+    zi_batch_transform_points(&m, in.soa, in.soa, TEST_BATCH_COUNT);
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        assert_vec3_within(0.0f, batch_vector_at(&points, i), batch_vector_at(&in, i));
+    }
+}
+
+void test_batch_transform_normals(void) {
+    zi_random_seed(421);
+    // non-uniform scale, plain vector transforms would bend normals off their surface
+    ZiMat34 m = zi_mat34_compose(zi_vec3(5.0f, 0.0f, 0.0f), batch_random_quat(), zi_vec3(1.0f, 4.0f, 0.5f));
+    TestBatchVectors tangents, normals, out;
+    batch_vectors_random(&tangents, 1.0f);
+    batch_vectors_empty(&normals);
+    batch_vectors_empty(&out);
+
+    // any vector perpendicular to the tangent
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        ZiVec3 n = zi_vec3_normalize(zi_vec3_cross(batch_vector_at(&tangents, i), zi_vec3(0.3f, 1.0f, -0.2f)));
+        normals.x[i] = n.x;
+        normals.y[i] = n.y;
+        normals.z[i] = n.z;
+    }
+    normals.x[3] = normals.y[3] = normals.z[3] = 0.0f;
+
+    zi_batch_transform_normals(&m, normals.soa, out.soa, TEST_BATCH_COUNT);
+
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        ZiVec3 n = batch_vector_at(&out, i);
+        if (i == 3) {
+            assert_vec3_within(0.0f, zi_vec3_zero(), n);
+            continue;
+        }
+        ZiVec3 t = zi_mat34_transform_vector(&m, batch_vector_at(&tangents, i));
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, zi_vec3_length(n));
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, zi_vec3_dot(n, t));
+    }
+}
+
+void test_batch_transform_points_mat4(void) {
+    zi_random_seed(422);
+    ZiMat4 view = zi_mat4_look_at(zi_vec3(0.0f, 5.0f, -30.0f), zi_vec3_zero(), zi_vec3(0.0f, 1.0f, 0.0f));
+    ZiMat4 projection = zi_mat4_perspective(zi_radians(60.0f), 1.5f, 0.1f, 100.0f);
+    ZiMat4 m = zi_mat4_mul(&projection, &view);
+    TestBatchVectors in, out;
+    batch_vectors_random(&in, 10.0f);
+    batch_vectors_empty(&out);
+    // on the camera plane, w is 0 and the point passes through undivided
+    in.x[2] = 0.0f;
+    in.y[2] = 5.0f;
+    in.z[2] = -30.0f;
+
+    zi_batch_transform_points_mat4(&m, in.soa, out.soa, TEST_BATCH_COUNT);
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        assert_vec3_within(1e-4f, zi_mat4_transform_point(&m, batch_vector_at(&in, i)), batch_vector_at(&out, i));
+    }
+}
+
+// ============================================================================
+// Matrix Tests
+// ============================================================================
+
+void test_batch_mat_mul(void) {
+    zi_random_seed(423);
+    ZiMat4 a4[TEST_BATCH_COUNT], b4[TEST_BATCH_COUNT], out4[TEST_BATCH_COUNT];
+    ZiMat34 a34[TEST_BATCH_COUNT], b34[TEST_BATCH_COUNT], out34[TEST_BATCH_COUNT];
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        for (u32 k = 0; k < 16; ++k) {
+            a4[i].m[k] = zi_random_range_f32(-2.0f, 2.0f);
+            b4[i].m[k] = zi_random_range_f32(-2.0f, 2.0f);
+        }
+        a34[i] = batch_random_transform();
+        b34[i] = batch_random_transform();
+    }
+
+    zi_batch_mat4_mul(a4, b4, out4, TEST_BATCH_COUNT);
+    zi_batch_mat34_mul(a34, b34, out34, TEST_BATCH_COUNT);
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        ZiMat4 expected4 = zi_mat4_mul_scalar(&a4[i], &b4[i]);
+        ZiMat34 expected34 = zi_mat34_mul(&a34[i], &b34[i]);
+        for (u32 k = 0; k < 16; ++k) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, expected4.m[k], out4[i].m[k]);
+        }
+        for (u32 k = 0; k < 12; ++k) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected34.m[k], out34[i].m[k]);
+        }
+    }
+
+    // into the right operand, each product reads its inputs before writing
+    zi_batch_mat34_mul(a34, b34, b34, TEST_BATCH_COUNT);
+    zi_batch_mat4_mul(a4, b4, b4, TEST_BATCH_COUNT);
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        for (u32 k = 0; k < 12; ++k) {
+            TEST_ASSERT_FLOAT_WITHIN(0.0f, out34[i].m[k], b34[i].m[k]);
+        }
+        for (u32 k = 0; k < 16; ++k) {
+            TEST_ASSERT_FLOAT_WITHIN(0.0f, out4[i].m[k], b4[i].m[k]);
+        }
+    }
+}
+
+void test_batch_compose_trs(void) {
+    zi_random_seed(424);
+    TestBatchVectors translations, scales;
+    f32 qx[TEST_BATCH_COUNT], qy[TEST_BATCH_COUNT], qz[TEST_BATCH_COUNT], qw[TEST_BATCH_COUNT];
+    batch_vectors_random(&translations, 100.0f);
+    batch_vectors_random(&scales, 3.0f);
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        ZiQuat q = batch_random_quat();
+        qx[i] = q.x;
+        qy[i] = q.y;
+        qz[i] = q.z;
+        qw[i] = q.w;
+    }
+
+    ZiMat34 out[TEST_BATCH_COUNT];
+    zi_batch_compose_trs(translations.soa, (ZiQuatSoA){qx, qy, qz, qw}, scales.soa, out, TEST_BATCH_COUNT);
+
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        ZiQuat q = zi_quat(qx[i], qy[i], qz[i], qw[i]);
+        ZiMat4 expected = zi_mat4_compose(batch_vector_at(&translations, i), q, batch_vector_at(&scales, i));
+        for (i32 col = 0; col < 4; ++col) {
+            for (i32 row = 0; row < 3; ++row) {
+                TEST_ASSERT_FLOAT_WITHIN(1e-4f, zi_mat4_at(&expected, row, col), zi_mat34_at(&out[i], row, col));
+            }
+        }
+    }
+}
+
+void test_batch_quat_slerp(void) {
+    zi_random_seed(427);
+    f32 ax[TEST_BATCH_COUNT], ay[TEST_BATCH_COUNT], az[TEST_BATCH_COUNT], aw[TEST_BATCH_COUNT];
+    f32 bx[TEST_BATCH_COUNT], by[TEST_BATCH_COUNT], bz[TEST_BATCH_COUNT], bw[TEST_BATCH_COUNT];
+    f32 t[TEST_BATCH_COUNT];
+    ZiQuat expected[TEST_BATCH_COUNT];
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        ZiQuat a = batch_random_quat();
+        ZiQuat b = batch_random_quat();
+        ax[i] = a.x, ay[i] = a.y, az[i] = a.z, aw[i] = a.w;
+        bx[i] = b.x, by[i] = b.y, bz[i] = b.z, bw[i] = b.w;
+        t[i] = zi_random_f32();
+        expected[i] = zi_fast_quat_slerp(a, b, t[i]);
+    }
+
+    // in place over a
+    ZiQuatSoA a = {ax, ay, az, aw};
+    zi_batch_quat_slerp(a, (ZiQuatSoA){bx, by, bz, bw}, t, a, TEST_BATCH_COUNT);
+    for (u32 i = 0; i < TEST_BATCH_COUNT; ++i) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected[i].x, ax[i]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected[i].y, ay[i]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected[i].z, az[i]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected[i].w, aw[i]);
+    }
+}
+
+// ============================================================================
+// Culling Tests
+// ============================================================================
+
+// several index chunks with a partial word at the end
+#define TEST_BATCH_CULL_COUNT 2085
+
+static f32 cull_cx[TEST_BATCH_CULL_COUNT], cull_cy[TEST_BATCH_CULL_COUNT], cull_cz[TEST_BATCH_CULL_COUNT];
+static f32 cull_ex[TEST_BATCH_CULL_COUNT], cull_ey[TEST_BATCH_CULL_COUNT], cull_ez[TEST_BATCH_CULL_COUNT];
+static f32 cull_radii[TEST_BATCH_CULL_COUNT];
+static u32 cull_bits[(TEST_BATCH_CULL_COUNT + 31) / 32];
+static u32 cull_indices[TEST_BATCH_CULL_COUNT];
+
+static ZiFrustum batch_cull_setup(void) {
+    for (u32 i = 0; i < TEST_BATCH_CULL_COUNT; ++i) {
+        cull_cx[i] = zi_random_range_f32(-60.0f, 60.0f);
+        cull_cy[i] = zi_random_range_f32(-60.0f, 60.0f);
+        cull_cz[i] = zi_random_range_f32(-120.0f, 10.0f);
+        cull_ex[i] = zi_random_range_f32(0.1f, 8.0f);
+        cull_ey[i] = zi_random_range_f32(0.1f, 8.0f);
+        cull_ez[i] = zi_random_range_f32(0.1f, 8.0f);
+        cull_radii[i] = zi_random_range_f32(0.1f, 8.0f);
+    }
+    ZiMat4 proj = zi_mat4_perspective(ZI_PI / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    ZiMat4 view = zi_mat4_look_at(zi_vec3(0.0f, 0.0f, 0.0f), zi_vec3(0.2f, 0.1f, -1.0f), zi_vec3(0.0f, 1.0f, 0.0f));
+    ZiMat4 view_proj = zi_mat4_mul(&proj, &view);
+    return zi_frustum_from_mat4(&view_proj);
+}
+
+// objects touching a plane within rounding may go either way
+static ZiBool batch_cull_borderline(const ZiFrustum* f, ZiVec3 center, ZiVec3 extent, f32 radius) {
+    for (u32 p = 0; p < 6; ++p) {
+        ZiPlane plane = f->planes[p];
+        f32 reach = radius + zi_abs_f32(plane.normal.x) * extent.x + zi_abs_f32(plane.normal.y) * extent.y +
+                    zi_abs_f32(plane.normal.z) * extent.z;
+        if (zi_abs_f32(zi_plane_distance_to_point(plane, center) + reach) < 1e-3f) return ZI_TRUE;
+    }
+    return ZI_FALSE;
+}
+
+static void assert_cull_indices(const u32* bits, const u32* indices, u32 written, u32 first_index, u32 count) {
+    u32 expected = 0;
+    for (u32 i = 0; i < count; ++i) {
+        if (bits[i / 32] & (1u << (i & 31))) {
+            TEST_ASSERT_TRUE(expected < written);
+            TEST_ASSERT_EQUAL_UINT32(first_index + i, indices[expected++]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected, written);
+}
+
+void test_batch_cull_aabbs(void) {
+    zi_random_seed(425);
+    ZiFrustum frustum = batch_cull_setup();
+    ZiBatchFrustum batch;
+    zi_batch_frustum_init(&batch, &frustum);
+    ZiVec3SoA centers = {cull_cx, cull_cy, cull_cz};
+    ZiVec3SoA extents = {cull_ex, cull_ey, cull_ez};
+
+    memset(cull_bits, 0xff, sizeof(cull_bits));
+    zi_batch_cull_aabbs(&batch, centers, extents, TEST_BATCH_CULL_COUNT, cull_bits);
+
+    u32 visible = 0;
+    for (u32 i = 0; i < TEST_BATCH_CULL_COUNT; ++i) {
+        ZiVec3 c = zi_vec3(cull_cx[i], cull_cy[i], cull_cz[i]);
+        ZiVec3 e = zi_vec3(cull_ex[i], cull_ey[i], cull_ez[i]);
+        u32    bit = (cull_bits[i / 32] >> (i & 31)) & 1;
+        visible += bit;
+        if (batch_cull_borderline(&frustum, c, e, 0.0f)) continue;
+        ZiAABB box = {zi_vec3_sub(c, e), zi_vec3_add(c, e)};
+        TEST_ASSERT_EQUAL_UINT32(zi_frustum_contains_aabb(frustum, box) ? 1 : 0, bit);
+    }
+    // both outcomes are covered
+    TEST_ASSERT_TRUE(visible > 0 && visible < TEST_BATCH_CULL_COUNT);
+    TEST_ASSERT_EQUAL_UINT32(0, cull_bits[TEST_BATCH_CULL_COUNT / 32] >> (TEST_BATCH_CULL_COUNT & 31));
+
+    u32 written = zi_batch_cull_aabbs_indices(&batch, centers, extents, TEST_BATCH_CULL_COUNT, 0, cull_indices);
+    TEST_ASSERT_EQUAL_UINT32(visible, written);
+    assert_cull_indices(cull_bits, cull_indices, written, 0, TEST_BATCH_CULL_COUNT);
+
+    // a worker's range from 64 on writes its own words and indices
+    u32 words[(TEST_BATCH_CULL_COUNT + 31) / 32];
+    ZiVec3SoA range_centers = {cull_cx + 64, cull_cy + 64, cull_cz + 64};
+    ZiVec3SoA range_extents = {cull_ex + 64, cull_ey + 64, cull_ez + 64};
+    zi_batch_cull_aabbs(&batch, range_centers, range_extents, TEST_BATCH_CULL_COUNT - 64, words + 2);
+    for (u32 w = 2; w < (TEST_BATCH_CULL_COUNT + 31) / 32; ++w) {
+        TEST_ASSERT_EQUAL_UINT32(cull_bits[w], words[w]);
+    }
+    written = zi_batch_cull_aabbs_indices(&batch, range_centers, range_extents, TEST_BATCH_CULL_COUNT - 64, 64, cull_indices);
+    assert_cull_indices(words + 2, cull_indices, written, 64, TEST_BATCH_CULL_COUNT - 64);
+}
+
+void test_batch_cull_spheres(void) {
+    zi_random_seed(426);
+    ZiFrustum frustum = batch_cull_setup();
+    ZiBatchFrustum batch;
+    zi_batch_frustum_init(&batch, &frustum);
+    ZiVec3SoA centers = {cull_cx, cull_cy, cull_cz};
+
+    zi_batch_cull_spheres(&batch, centers, cull_radii, TEST_BATCH_CULL_COUNT, cull_bits);
+
+    u32 visible = 0;
+    for (u32 i = 0; i < TEST_BATCH_CULL_COUNT; ++i) {
+        ZiVec3 c = zi_vec3(cull_cx[i], cull_cy[i], cull_cz[i]);
+        u32    bit = (cull_bits[i / 32] >> (i & 31)) & 1;
+        visible += bit;
+        if (batch_cull_borderline(&frustum, c, zi_vec3(0.0f, 0.0f, 0.0f), cull_radii[i])) continue;
+        TEST_ASSERT_EQUAL_UINT32(zi_frustum_contains_sphere(frustum, zi_sphere(c, cull_radii[i])) ? 1 : 0, bit);
+    }
+    TEST_ASSERT_TRUE(visible > 0 && visible < TEST_BATCH_CULL_COUNT);
+
+    u32 written = zi_batch_cull_spheres_indices(&batch, centers, cull_radii, TEST_BATCH_CULL_COUNT, 100, cull_indices);
+    assert_cull_indices(cull_bits, cull_indices, written, 100, TEST_BATCH_CULL_COUNT);
+}
+
+// a real camera, what is in front is kept and what is behind, past the far plane or off to the side is not
+void test_batch_cull_camera(void) {
+    ZiVec3 eye = zi_vec3(10.0f, 5.0f, 30.0f);
+    ZiMat4 projection = zi_mat4_perspective(ZI_PI / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    ZiMat4 view = zi_mat4_look_at(eye, zi_vec3_zero(), zi_vec3_up());
+    ZiMat4 view_projection = zi_mat4_mul(&projection, &view);
+    ZiFrustum frustum = zi_frustum_from_mat4(&view_projection);
+    ZiBatchFrustum batch;
+    zi_batch_frustum_init(&batch, &frustum);
+
+    ZiVec3 forward = zi_vec3_normalize(zi_vec3_sub(zi_vec3_zero(), eye));
+    ZiVec3 right = zi_vec3_normalize(zi_vec3_cross(forward, zi_vec3_up()));
+    ZiVec3 points[4] = {
+        zi_vec3_add(eye, zi_vec3_scale(forward, 20.0f)),
+        zi_vec3_sub(eye, zi_vec3_scale(forward, 20.0f)),
+        zi_vec3_add(eye, zi_vec3_scale(forward, 150.0f)),
+        zi_vec3_add(zi_vec3_add(eye, zi_vec3_scale(forward, 5.0f)), zi_vec3_scale(right, 50.0f)),
+    };
+    // repeated past 8 so the wide kernels see them too
+    f32 x[9], y[9], z[9], radii[9];
+    for (u32 i = 0; i < 9; ++i) {
+        x[i] = points[i % 4].x;
+        y[i] = points[i % 4].y;
+        z[i] = points[i % 4].z;
+        radii[i] = 0.5f;
+    }
+    ZiVec3SoA centers = {x, y, z};
+    ZiVec3SoA extents = {radii, radii, radii};
+
+    u32 bits = 0;
+    zi_batch_cull_spheres(&batch, centers, radii, 9, &bits);
+    TEST_ASSERT_EQUAL_HEX32(0x111, bits);
+    zi_batch_cull_aabbs(&batch, centers, extents, 9, &bits);
+    TEST_ASSERT_EQUAL_HEX32(0x111, bits);
+}
+
+// ============================================================================
+// Dispatch Tests
+// ============================================================================
+
+// the tests above ran on whatever the CPU picked, masking the features resolves the kernels again
+void test_batch_portable_kernels(void) {
+    zi_platform_set_cpu_features_mask(0);
+    test_batch_transform_points_and_vectors();
+    test_batch_transform_normals();
+    test_batch_transform_points_mat4();
+    test_batch_mat_mul();
+    test_batch_compose_trs();
+    test_batch_quat_slerp();
+    test_batch_cull_aabbs();
+    test_batch_cull_spheres();
+    test_batch_cull_camera();
+    zi_platform_set_cpu_features_mask(0xffffffffu);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_batch_tests(void) {
+    RUN_TEST(test_batch_transform_points_and_vectors);
+    RUN_TEST(test_batch_transform_normals);
+    RUN_TEST(test_batch_transform_points_mat4);
+    RUN_TEST(test_batch_mat_mul);
+    RUN_TEST(test_batch_compose_trs);
+    RUN_TEST(test_batch_quat_slerp);
+    RUN_TEST(test_batch_cull_aabbs);
+    RUN_TEST(test_batch_cull_spheres);
+    RUN_TEST(test_batch_cull_camera);
+    RUN_TEST(test_batch_portable_kernels);
+}
@@ -0,0 +1,193 @@
+#include "unity.h"
+#include "zi_bvh.h"
+
+#include <string.h>
+
+// above two build tasks, the threaded build splits it
+#define TEST_BVH_TRIANGLES 6000
+#define TEST_BVH_RAYS      400
+
+static ZiTriangle bvh_triangles[TEST_BVH_TRIANGLES];
+static u8         bvh_seen[TEST_BVH_TRIANGLES];
+
+// small triangles scattered through a 100 unit cube plus a ground grid, like props on a level
+static void bvh_make_scene(void) {
+    zi_random_seed(460);
+    u32 ground = 40;
+    u32 count = 0;
+    for (u32 z = 0; z < ground; ++z) {
+        for (u32 x = 0; x < ground; ++x) {
+            ZiVec3 p = zi_vec3(-50.0f + 2.5f * x, -50.0f, -50.0f + 2.5f * z);
+            bvh_triangles[count++] = zi_triangle(p, zi_vec3(p.x + 2.5f, p.y, p.z), zi_vec3(p.x, p.y, p.z + 2.5f));
+        }
+    }
+    while (count < TEST_BVH_TRIANGLES) {
+        ZiVec3 c = zi_vec3(zi_random_range_f32(-50.0f, 50.0f), zi_random_range_f32(-50.0f, 50.0f), zi_random_range_f32(-50.0f, 50.0f));
+        ZiVec3 a = zi_vec3_add(c, zi_vec3_scale(zi_vec3_random_on_sphere(), zi_random_range_f32(0.2f, 3.0f)));
+        ZiVec3 b = zi_vec3_add(c, zi_vec3_scale(zi_vec3_random_on_sphere(), zi_random_range_f32(0.2f, 3.0f)));
+        bvh_triangles[count++] = zi_triangle(c, a, b);
+    }
+}
+
+static ZiRay bvh_random_ray(void) {
+    ZiVec3 origin = zi_vec3(zi_random_range_f32(-70.0f, 70.0f), zi_random_range_f32(-70.0f, 70.0f), zi_random_range_f32(-70.0f, 70.0f));
+    // aimed into the scene, some axis aligned, their slab tests divide by zero
+    ZiVec3 target = zi_vec3(zi_random_range_f32(-45.0f, 45.0f), zi_random_range_f32(-60.0f, 40.0f), zi_random_range_f32(-45.0f, 45.0f));
+    ZiVec3 dir = zi_random_range_i32(0, 7) == 0 ? zi_vec3(0.0f, -1.0f, 0.0f) : zi_vec3_normalize(zi_vec3_sub(target, origin));
+    return (ZiRay){origin, dir};
+}
+
+static ZiBool bvh_brute_force(ZiRay ray, u32 count, f32 max_t, f32* t_out) {
+    ZiBool found = ZI_FALSE;
+    f32    best = max_t;
+    for (u32 i = 0; i < count; ++i) {
+        f32 t, u, v;
+        if (zi_ray_triangle_intersect(ray, bvh_triangles[i], &t, &u, &v) && t < best) {
+            best = t;
+            found = ZI_TRUE;
+        }
+    }
+    *t_out = best;
+    return found;
+}
+
+static ZiBool aabb_contains(ZiVec3 outer_min, ZiVec3 outer_max, ZiVec3 p, f32 slack) {
+    return p.x >= outer_min.x - slack && p.y >= outer_min.y - slack && p.z >= outer_min.z - slack && p.x <= outer_max.x + slack &&
+           p.y <= outer_max.y + slack && p.z <= outer_max.z + slack;
+}
+
+// children inside parents, triangles inside leaves, every triangle in exactly one leaf
+static void assert_bvh_valid(const ZiBvh* bvh, u32 max_leaf_size) {
+    memset(bvh_seen, 0, sizeof(bvh_seen));
+    u32 leaf_triangles = 0;
+    for (u32 n = 0; n < bvh->node_count; ++n) {
+        const ZiBvhNode* node = &bvh->nodes[n];
+        if (node->count == 0) {
+            TEST_ASSERT_TRUE(node->first > n && node->first + 1 < bvh->node_count);
+            for (u32 c = 0; c < 2; ++c) {
+                const ZiBvhNode* child = &bvh->nodes[node->first + c];
+                TEST_ASSERT_TRUE(aabb_contains(node->min, node->max, child->min, 0.0f));
+                TEST_ASSERT_TRUE(aabb_contains(node->min, node->max, child->max, 0.0f));
+            }
+            continue;
+        }
+
+        TEST_ASSERT_TRUE(node->count <= max_leaf_size);
+        leaf_triangles += node->count;
+        for (u32 i = node->first; i < node->first + node->count; ++i) {
+            const ZiBvhTriangle* tri = &bvh->triangles[i];
+            // v0 + e1 rounds, it isn't exactly v1 anymore
+            TEST_ASSERT_TRUE(aabb_contains(node->min, node->max, tri->v0, 0.0f));
+            TEST_ASSERT_TRUE(aabb_contains(node->min, node->max, zi_vec3_add(tri->v0, tri->e1), 1e-4f));
+            TEST_ASSERT_TRUE(aabb_contains(node->min, node->max, zi_vec3_add(tri->v0, tri->e2), 1e-4f));
+            TEST_ASSERT_EQUAL_UINT8(0, bvh_seen[bvh->indices[i]]);
+            bvh_seen[bvh->indices[i]] = 1;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(bvh->triangle_count, leaf_triangles);
+}
+
+// ============================================================================
+// Build Tests
+// ============================================================================
+
+void test_bvh_build(void) {
+    bvh_make_scene();
+
+    ZiBvh          single, threaded;
+    ZiBvhBuildDesc desc = {bvh_triangles, TEST_BVH_TRIANGLES, 0, 1};
+    TEST_ASSERT_TRUE(zi_bvh_build(&single, &desc));
+    desc.thread_count = 4;
+    TEST_ASSERT_TRUE(zi_bvh_build(&threaded, &desc));
+
+    assert_bvh_valid(&single, ZI_BVH_DEFAULT_LEAF_SIZE);
+    assert_bvh_valid(&threaded, ZI_BVH_DEFAULT_LEAF_SIZE);
+    // same tree, different node order
+    TEST_ASSERT_EQUAL_UINT32(single.node_count, threaded.node_count);
+    TEST_ASSERT_TRUE(single.node_count < 2 * TEST_BVH_TRIANGLES);
+
+    ZiAABB bounds = zi_bvh_bounds(&threaded);
+    TEST_ASSERT_TRUE(bounds.min.y <= -50.0f && bounds.max.x >= 50.0f);
+
+    zi_bvh_destroy(&threaded);
+    zi_bvh_destroy(&single);
+    TEST_ASSERT_NULL(single.nodes);
+}
+
+void test_bvh_build_degenerate(void) {
+    ZiBvh          bvh;
+    ZiBvhBuildDesc desc = {bvh_triangles, 0, 0, 4};
+    ZiRay          down = {zi_vec3(0.0f, 10.0f, 0.0f), zi_vec3(0.0f, -1.0f, 0.0f)};
+
+    // empty
+    TEST_ASSERT_TRUE(zi_bvh_build(&bvh, &desc));
+    TEST_ASSERT_EQUAL_UINT32(0, bvh.node_count);
+    TEST_ASSERT_FALSE(zi_bvh_raycast_any(&bvh, down, F32_MAX));
+    zi_bvh_destroy(&bvh);
+
+    // one spot repeated, nothing for SAH to split on
+    for (u32 i = 0; i < 100; ++i) {
+        bvh_triangles[i] = zi_triangle(zi_vec3(-1.0f, 0.0f, -1.0f), zi_vec3(1.0f, 0.0f, -1.0f), zi_vec3(0.0f, 0.0f, 1.0f));
+    }
+    desc.triangle_count = 100;
+    desc.max_leaf_size = 3;
+    TEST_ASSERT_TRUE(zi_bvh_build(&bvh, &desc));
+    assert_bvh_valid(&bvh, 3);
+
+    ZiBvhHit hit;
+    TEST_ASSERT_TRUE(zi_bvh_raycast(&bvh, down, F32_MAX, &hit));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 10.0f, hit.t);
+    TEST_ASSERT_TRUE(hit.triangle < 100);
+    // max_t is exclusive
+    TEST_ASSERT_FALSE(zi_bvh_raycast(&bvh, down, 10.0f, &hit));
+    zi_bvh_destroy(&bvh);
+}
+
+// ============================================================================
+// Traversal Tests
+// ============================================================================
+
+void test_bvh_raycast_matches_brute_force(void) {
+    bvh_make_scene();
+
+    ZiBvh          bvh;
+    ZiBvhBuildDesc desc = {bvh_triangles, TEST_BVH_TRIANGLES, 0, 4};
+    TEST_ASSERT_TRUE(zi_bvh_build(&bvh, &desc));
+
+    u32 hits = 0;
+    for (u32 r = 0; r < TEST_BVH_RAYS; ++r) {
+        ZiRay ray = bvh_random_ray();
+        // every fourth one is a segment, like a line of sight check
+        f32 max_t = (r & 3) == 0 ? zi_random_range_f32(5.0f, 60.0f) : F32_MAX;
+
+        f32      expected_t;
+        ZiBool   expected = bvh_brute_force(ray, TEST_BVH_TRIANGLES, max_t, &expected_t);
+        ZiBvhHit hit;
+        TEST_ASSERT_EQUAL(expected, zi_bvh_raycast(&bvh, ray, max_t, &hit));
+        TEST_ASSERT_EQUAL(expected, zi_bvh_raycast_any(&bvh, ray, max_t));
+        if (!expected) continue;
+
+        ++hits;
+        TEST_ASSERT_EQUAL_FLOAT(expected_t, hit.t);
+        // the reported triangle is the one at that distance
+        f32 t, u, v;
+        TEST_ASSERT_TRUE(zi_ray_triangle_intersect(ray, bvh_triangles[hit.triangle], &t, &u, &v));
+        TEST_ASSERT_EQUAL_FLOAT(hit.t, t);
+        TEST_ASSERT_EQUAL_FLOAT(u, hit.u);
+        TEST_ASSERT_EQUAL_FLOAT(v, hit.v);
+    }
+    // both outcomes are covered
+    TEST_ASSERT_TRUE(hits > TEST_BVH_RAYS / 10 && hits < TEST_BVH_RAYS);
+
+    zi_bvh_destroy(&bvh);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_bvh_tests(void) {
+    RUN_TEST(test_bvh_build);
+    RUN_TEST(test_bvh_build_degenerate);
+    RUN_TEST(test_bvh_raycast_matches_brute_force);
+}
@@ -52,20 +52,6 @@ static inline i8 compare_i32(i32 a, i32 b) {
     return a == b;
 }
 
-// u64 key type
-static inline u64 hash_u64(u64 key) {
-    key ^= key >> 33;
-    key *= 0xff51afd7ed558ccdULL;
-    key ^= key >> 33;
-    key *= 0xc4ceb9fe1a85ec53ULL;
-    key ^= key >> 33;
-    return key;
-}
-
-static inline i8 compare_u64(u64 a, u64 b) {
-    return a == b;
-}
-
 // String key type (ConstChr)
 static inline u64 hash_ConstChr(ConstChr key) {
     u64 hash = 5381;
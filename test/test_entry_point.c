@@ -3,6 +3,18 @@
 // Forward declarations for test runner functions
 void run_math_tests(void);
 void run_core_tests(void);
+void run_log_tests(void);
+void run_app_tests(void);
+void run_platform_tests(void);
+void run_vfs_tests(void);
+void run_profiler_tests(void);
+void run_graphics_tests(void);
+void run_batch_tests(void);
+void run_bvh_tests(void);
+void run_aabb_tree_tests(void);
+void run_sap_tests(void);
+void run_spatial_hash_tests(void);
+void run_ray_packet_tests(void);
 
 // Global setUp/tearDown for Unity (called between tests)
 void setUp(void) {
@@ -18,6 +30,18 @@ int main(void) {
 
     run_math_tests();
     run_core_tests();
+    run_log_tests();
+    run_app_tests();
+    run_platform_tests();
+    run_vfs_tests();
+    run_profiler_tests();
+    run_graphics_tests();
+    run_batch_tests();
+    run_bvh_tests();
+    run_aabb_tree_tests();
+    run_sap_tests();
+    run_spatial_hash_tests();
+    run_ray_packet_tests();
 
     return UNITY_END();
 }
@@ -0,0 +1,88 @@
+#include "unity.h"
+#include "zi_app.h"
+#include "zi_graphics.h"
+
+void zi_graphics_init(ZiGraphicsBackend backend);
+void zi_graphics_terminate();
+
+// the backends pull in the platform layer, which calls into the runner's entry point
+void zi_bootstrap(ZiAppSettings* settings) {}
+
+// ============================================================================
+// Frame Stats Tests
+// ============================================================================
+
+void test_graphics_frame_stats(void) {
+    zi_graphics_init(ZiGraphicsBackend_Null);
+
+    ZiRenderFrameStats frames[4];
+    TEST_ASSERT_EQUAL_UINT32(0, zi_graphics_get_frame_stats(frames, 4));
+
+    ZiCommandBufferHandle cmd = {0};
+    u8 data[64] = {0};
+
+    zi_cmd_set_pipeline(cmd, (ZiPipelineHandle){0});
+    zi_cmd_set_bind_group(cmd, 0, (ZiBindGroupHandle){0});
+    zi_cmd_push_constants(cmd, ZiShaderStage_Vertex, 0, 16, data);
+    zi_cmd_draw(cmd, 3, 10, 0, 0);
+    zi_cmd_draw_indexed(cmd, 6, 2, 0, 0, 0);
+    zi_cmd_draw_indirect(cmd, (ZiBufferHandle){0}, 0, 5, 16);
+    zi_cmd_dispatch(cmd, 1, 1, 1);
+    zi_buffer_write((ZiBufferHandle){0}, 0, data, sizeof(data));
+    // the null device hands out null handles, nothing was created
+    zi_buffer_destroy(zi_buffer_create(&(ZiBufferDesc){.size = 64}));
+    zi_graphics_end_frame();
+
+    zi_cmd_draw(cmd, 3, 1, 0, 0);
+    zi_graphics_end_frame();
+
+    TEST_ASSERT_EQUAL_UINT32(2, zi_graphics_get_frame_stats(frames, 4));
+
+    // newest first
+    TEST_ASSERT_TRUE(frames[0].frame == 1);
+    TEST_ASSERT_EQUAL_UINT32(1, frames[0].draw_calls);
+    TEST_ASSERT_TRUE(frames[0].instances == 1);
+    TEST_ASSERT_EQUAL_UINT32(0, frames[0].pipeline_binds);
+
+    TEST_ASSERT_TRUE(frames[1].frame == 0);
+    TEST_ASSERT_EQUAL_UINT32(7, frames[1].draw_calls);
+    TEST_ASSERT_TRUE(frames[1].instances == 12);
+    TEST_ASSERT_EQUAL_UINT32(1, frames[1].dispatches);
+    TEST_ASSERT_EQUAL_UINT32(1, frames[1].pipeline_binds);
+    TEST_ASSERT_EQUAL_UINT32(1, frames[1].bind_group_binds);
+    TEST_ASSERT_TRUE(frames[1].push_constant_bytes == 16);
+    TEST_ASSERT_EQUAL_UINT32(1, frames[1].buffer_writes);
+    TEST_ASSERT_TRUE(frames[1].uploaded_bytes == 64);
+    TEST_ASSERT_EQUAL_UINT32(0, frames[1].resources_created);
+    TEST_ASSERT_EQUAL_UINT32(0, frames[1].resources_destroyed);
+
+    zi_graphics_terminate();
+}
+
+void test_graphics_frame_stats_history_wraps(void) {
+    zi_graphics_init(ZiGraphicsBackend_Null);
+
+    for (u32 i = 0; i < ZI_GRAPHICS_STATS_HISTORY + 10; ++i) {
+        for (u32 d = 0; d < i; ++d) {
+            zi_cmd_dispatch((ZiCommandBufferHandle){0}, 1, 1, 1);
+        }
+        zi_graphics_end_frame();
+    }
+
+    ZiRenderFrameStats frames[ZI_GRAPHICS_STATS_HISTORY + 1];
+    TEST_ASSERT_EQUAL_UINT32(ZI_GRAPHICS_STATS_HISTORY, zi_graphics_get_frame_stats(frames, ZI_GRAPHICS_STATS_HISTORY + 1));
+    TEST_ASSERT_EQUAL_UINT32(ZI_GRAPHICS_STATS_HISTORY + 9, frames[0].dispatches);
+    TEST_ASSERT_EQUAL_UINT32(10, frames[ZI_GRAPHICS_STATS_HISTORY - 1].dispatches);
+    TEST_ASSERT_TRUE(frames[ZI_GRAPHICS_STATS_HISTORY - 1].frame == 10);
+
+    zi_graphics_terminate();
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_graphics_tests(void) {
+    RUN_TEST(test_graphics_frame_stats);
+    RUN_TEST(test_graphics_frame_stats_history_wraps);
+}
@@ -0,0 +1,543 @@
+// compile out everything below warn for the filtering tests
+#define ZI_LOG_MIN_LEVEL ZI_LOG_LEVEL_WARN
+#define ZI_LOG_CATEGORY ZiLogCategory_App
+
+#include "unity.h"
+#include "zi_log.h"
+#include "zi_log_binary.h"
+#include "zi_platform.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define test_log_mkdir(path) _mkdir(path)
+#define test_log_rmdir(path) _rmdir(path)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define test_log_mkdir(path) mkdir(path, 0755)
+#define test_log_rmdir(path) rmdir(path)
+#endif
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static u8   g_record[1024];
+static u32  g_record_size = 0;
+static char g_decoded[1024];
+static char g_expected[1024];
+
+// encodes, decodes and formats the same arguments with vsnprintf for comparison
+static void roundtrip(const char* fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    g_record_size = zi_log_binary_encode(fmt, args, g_record, sizeof(g_record));
+    va_end(args);
+
+    va_start(args, fmt);
+    vsnprintf(g_expected, sizeof(g_expected), fmt, args);
+    va_end(args);
+
+    zi_log_binary_format(fmt, g_record, g_record_size, g_decoded, sizeof(g_decoded));
+}
+
+// ============================================================================
+// Binary Log Tests
+// ============================================================================
+
+void test_log_binary_plain_text(void) {
+    roundtrip("no arguments here, 100%% literal");
+    TEST_ASSERT_EQUAL_UINT32(0, g_record_size);
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+}
+
+void test_log_binary_integers(void) {
+    roundtrip("%d %i %u %x %X %o %5d|%-5d|%05d", -42, 7, 4000000000u, 0xbeef, 0xCAFE, 8, 12, 34, 56);
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+
+    roundtrip("%hhd %hd %ld %lld %zu %llu", (signed char)-3, (short)-300, -123456789L, -1234567890123LL, (size_t)99, 18446744073709551615ULL);
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+}
+
+void test_log_binary_floats(void) {
+    roundtrip("%f %.2f %e %g %8.3f", 3.14159, 2.71828, 12345.678, 0.0001, -1.5);
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+}
+
+void test_log_binary_strings_and_chars(void) {
+    char temp[16];
+    strcpy(temp, "transient");
+
+    roundtrip("%s [%c] %.3s %10s|%-10s|", temp, 'z', "truncate", "right", "left");
+    // the string is copied into the record, so changing it afterwards must not matter
+    strcpy(temp, "changed!!");
+    zi_log_binary_format("%s [%c] %.3s %10s|%-10s|", g_record, g_record_size, g_decoded, sizeof(g_decoded));
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+
+    roundtrip("%s", (const char*)0);
+    TEST_ASSERT_EQUAL_STRING("(null)", g_decoded);
+}
+
+void test_log_binary_star_width_precision(void) {
+    roundtrip("[%*d] [%.*f] [%*.*s]", 6, 42, 3, 1.23456, 8, 2, "abcdef");
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+}
+
+void test_log_binary_pointer(void) {
+    int value = 0;
+    roundtrip("%p", (void*)&value);
+    TEST_ASSERT_EQUAL_STRING(g_expected, g_decoded);
+}
+
+void test_log_binary_truncated_args(void) {
+    char out[64];
+
+    // only the first integer survives, formatting stops where the arguments run out
+    roundtrip("%d and %d", 1, 2);
+    TEST_ASSERT_EQUAL_UINT32(16, g_record_size);
+    zi_log_binary_format("%d and %d", g_record, 8, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("1 and ", out);
+}
+
+void test_log_binary_output_capacity(void) {
+    char out[8];
+    roundtrip("%s", "a long string that doesn't fit");
+    i32 len = zi_log_binary_format("%s", g_record, g_record_size, out, sizeof(out));
+    TEST_ASSERT_EQUAL_INT32(7, len);
+    TEST_ASSERT_EQUAL_STRING("a long ", out);
+}
+
+// ============================================================================
+// Filtering Tests
+// ============================================================================
+
+static i32 g_evaluations = 0;
+
+static i32 count_evaluation(void) {
+    return ++g_evaluations;
+}
+
+void test_log_compiled_out_sites_skip_arguments(void) {
+    g_evaluations = 0;
+    zi_log_trace("%d", count_evaluation());
+    zi_log_debug("%d", count_evaluation());
+    zi_log_info("%d", count_evaluation());
+    zi_log_deferred_info("%d", count_evaluation());
+    TEST_ASSERT_EQUAL_INT32(0, g_evaluations);
+}
+
+void test_log_runtime_level_skips_arguments(void) {
+    zi_log_set_level(ZiLogCategory_App, ZiLogLevel_Off);
+    g_evaluations = 0;
+    zi_log_warn("%d", count_evaluation());
+    zi_log_critical("%d", count_evaluation());
+    TEST_ASSERT_EQUAL_INT32(0, g_evaluations);
+
+    // other categories keep their own level
+    TEST_ASSERT_TRUE(zi_log_enabled(ZiLogCategory_Vulkan, ZiLogLevel_Warn));
+    TEST_ASSERT_FALSE(zi_log_enabled(ZiLogCategory_App, ZiLogLevel_Critical));
+
+    zi_log_set_level(ZiLogCategory_App, ZiLogLevel_Debug);
+}
+
+void test_log_set_all_levels(void) {
+    zi_log_set_all_levels(ZiLogLevel_Error);
+    for (u32 i = 0; i < ZiLogCategory_Count; ++i) {
+        TEST_ASSERT_FALSE(zi_log_enabled((ZiLogCategory)i, ZiLogLevel_Warn));
+        TEST_ASSERT_TRUE(zi_log_enabled((ZiLogCategory)i, ZiLogLevel_Error));
+    }
+    zi_log_set_all_levels(ZiLogLevel_Debug);
+}
+
+void test_log_names(void) {
+    TEST_ASSERT_EQUAL_STRING("vulkan", zi_log_category_name(ZiLogCategory_Vulkan));
+    TEST_ASSERT_EQUAL_STRING("platform", zi_log_category_name(ZiLogCategory_Platform));
+    TEST_ASSERT_EQUAL_STRING("critical", zi_log_level_name(ZiLogLevel_Critical));
+    TEST_ASSERT_EQUAL_STRING("unknown", zi_log_category_name(ZiLogCategory_Count));
+}
+
+// ============================================================================
+// Sink Tests
+// ============================================================================
+
+void test_log_memory_sink_keeps_recent_lines(void) {
+    char recent[256];
+
+    zi_log_set_sinks(ZiLogSink_Memory);
+    for (i32 i = 0; i < 2000; ++i) {
+        zi_log_warn("memory sink line %d", i);
+    }
+    zi_log_set_sinks(ZiLogSink_Console);
+
+    u32 len = zi_log_copy_recent(recent, sizeof(recent));
+    TEST_ASSERT_EQUAL_UINT32((u32)strlen(recent), len);
+    TEST_ASSERT_TRUE(len > 0 && len < sizeof(recent));
+
+    // only whole lines, newest last
+    TEST_ASSERT_EQUAL_CHAR('[', recent[0]);
+    TEST_ASSERT_EQUAL_CHAR('\n', recent[len - 1]);
+    TEST_ASSERT_NOT_NULL(strstr(recent, "[warn] [app] memory sink line 1999\n"));
+}
+
+void test_log_sinks_are_selectable(void) {
+    char recent[64];
+
+    zi_log_set_sinks(ZiLogSink_Memory);
+    zi_log_warn("marker");
+    zi_log_set_sinks(ZiLogSink_Console | ZiLogSink_File);
+    TEST_ASSERT_EQUAL_UINT32(ZiLogSink_Console | ZiLogSink_File, zi_log_get_sinks());
+
+    // the memory sink is off now, so this must not show up
+    zi_log_set_sinks(0);
+    zi_log_warn("hidden");
+    zi_log_set_sinks(ZiLogSink_Console);
+
+    zi_log_copy_recent(recent, sizeof(recent));
+    TEST_ASSERT_NOT_NULL(strstr(recent, "marker"));
+    TEST_ASSERT_NULL(strstr(recent, "hidden"));
+}
+
+#define TEST_LOG_ROTATE_DIR   "zi_test_log_rotate"
+#define TEST_LOG_ROTATE_FILE  TEST_LOG_ROTATE_DIR "/game.log"
+#define TEST_LOG_ROTATE_SIZE  4096
+#define TEST_LOG_ROTATE_LINES 200
+
+// Checks one file of the rotation: whole lines only, no bigger than the rotation size, line
+// numbers counting up from first_line (any start when it is negative). Returns the last one.
+static i32 check_rotated_file(const char* path, i32 first_line) {
+    ZiMappedFile file;
+    TEST_ASSERT_TRUE(zi_platform_map_file(path, ZiFileMapFlags_None, &file));
+    TEST_ASSERT_TRUE(file.size > 0 && file.size <= TEST_LOG_ROTATE_SIZE);
+    TEST_ASSERT_EQUAL_CHAR('\n', file.data[file.size - 1]);
+
+    i32         expected = first_line;
+    const char* cursor = (const char*)file.data;
+    const char* end = cursor + file.size;
+    while (cursor < end) {
+        const char* newline = memchr(cursor, '\n', (size_t)(end - cursor));
+        const char* text = strstr(cursor, "rotate line ");
+        TEST_ASSERT_TRUE(text && text < newline);
+        i32 line = atoi(text + 12);
+        if (expected >= 0) TEST_ASSERT_EQUAL_INT32(expected, line);
+        expected = line + 1;
+        cursor = newline + 1;
+    }
+    zi_platform_unmap_file(&file);
+    return expected - 1;
+}
+
+void test_log_file_rotates_by_size(void) {
+    test_log_mkdir(TEST_LOG_ROTATE_DIR);
+    TEST_ASSERT_TRUE(zi_log_open_file(TEST_LOG_ROTATE_FILE, TEST_LOG_ROTATE_SIZE, 2));
+    zi_log_set_sinks(ZiLogSink_File);
+    // about 100 bytes a line, five files worth
+    for (u32 i = 0; i < TEST_LOG_ROTATE_LINES; ++i) {
+        zi_log_warn("rotate line %u ..........................................................", i);
+    }
+    zi_log_close_file();
+    zi_log_set_sinks(ZiLogSink_Console);
+
+    // newest in game.log, the two before it in game.log.1 and game.log.2, older ones overwritten
+    FILE* oldest = fopen(TEST_LOG_ROTATE_FILE ".3", "rb");
+    TEST_ASSERT_NULL(oldest);
+    i32 last = check_rotated_file(TEST_LOG_ROTATE_FILE ".2", -1);
+    TEST_ASSERT_TRUE(last > 0);
+    last = check_rotated_file(TEST_LOG_ROTATE_FILE ".1", last + 1);
+    last = check_rotated_file(TEST_LOG_ROTATE_FILE, last + 1);
+    TEST_ASSERT_EQUAL_INT32(TEST_LOG_ROTATE_LINES - 1, last);
+
+    remove(TEST_LOG_ROTATE_FILE);
+    remove(TEST_LOG_ROTATE_FILE ".1");
+    remove(TEST_LOG_ROTATE_FILE ".2");
+    test_log_rmdir(TEST_LOG_ROTATE_DIR);
+}
+
+// ============================================================================
+// Async Tests
+// ============================================================================
+
+#define TEST_LOG_FILE            "zi_test_log_async.log"
+#define TEST_LOG_PRODUCERS       4
+#define TEST_LOG_PRODUCER_WRITES 3000
+#define TEST_LOG_WRAP_WRITES     5000
+#define TEST_LOG_DROP_WRITES     4096
+
+static char g_padding[1024];
+
+typedef void (*LogLineFn)(const char* text, u32 length, VoidPtr context);
+
+// calls fn with the text after "[timestamp] [level] [category] " of every line, returns the line count
+static u32 read_log_lines(const char* path, LogLineFn fn, VoidPtr context) {
+    ZiMappedFile file;
+    TEST_ASSERT_TRUE(zi_platform_map_file(path, ZiFileMapFlags_Sequential, &file));
+
+    u32         lines = 0;
+    const char* cursor = (const char*)file.data;
+    const char* end = cursor + file.size;
+    while (cursor < end) {
+        const char* newline = memchr(cursor, '\n', (size_t)(end - cursor));
+        TEST_ASSERT_NOT_NULL(newline);
+        const char* text = cursor;
+        for (u32 tags = 0; tags < 3; ++tags) {
+            text = strstr(text, "] ");
+            TEST_ASSERT_TRUE(text && text < newline);
+            text += 2;
+        }
+        fn(text, (u32)(newline - text), context);
+        cursor = newline + 1;
+        lines++;
+    }
+    zi_platform_unmap_file(&file);
+    return lines;
+}
+
+static void start_async_file_log(void) {
+    zi_log_init();
+    TEST_ASSERT_TRUE(zi_log_open_file(TEST_LOG_FILE, 64ull * 1024 * 1024, 1));
+    zi_log_set_sinks(ZiLogSink_File);
+}
+
+// shutting down writes out whatever is still queued before the file closes
+static void stop_async_file_log(void) {
+    zi_log_shutdown();
+    zi_log_set_sinks(ZiLogSink_Console);
+}
+
+// "log ring full, N messages dropped" lines the consumer writes itself
+static u32 parse_dropped(const char* text, u32 length) {
+    static const char prefix[] = "log ring full, ";
+    if (length < sizeof(prefix) - 1 || memcmp(text, prefix, sizeof(prefix) - 1) != 0) return 0;
+    return (u32)strtoul(text + sizeof(prefix) - 1, ZI_NULL, 10);
+}
+
+// no threads on the web
+#if !defined(ZI_EMSCRIPTEN)
+typedef struct LogProducerLines {
+    i64 last[TEST_LOG_PRODUCERS];
+    u32 delivered;
+    u32 dropped;
+} LogProducerLines;
+
+static void log_producer_main(VoidPtr user_data) {
+    u32 producer = (u32)(uintptr_t)user_data;
+    for (u32 i = 0; i < TEST_LOG_PRODUCER_WRITES; ++i) {
+        // errors wait for room instead of being dropped straight away
+        zi_log_error("producer %u message %u", producer, i);
+    }
+}
+
+static void check_producer_line(const char* text, u32 length, VoidPtr context) {
+    LogProducerLines* lines = (LogProducerLines*)context;
+    u32               producer, index;
+    if (sscanf(text, "producer %u message %u", &producer, &index) == 2) {
+        TEST_ASSERT_TRUE(producer < TEST_LOG_PRODUCERS);
+        // each producer's messages come out in the order it wrote them
+        TEST_ASSERT_TRUE((i64)index > lines->last[producer]);
+        lines->last[producer] = index;
+        lines->delivered++;
+        return;
+    }
+    u32 dropped = parse_dropped(text, length);
+    TEST_ASSERT_TRUE(dropped > 0);
+    lines->dropped += dropped;
+}
+
+void test_log_async_multiple_producers(void) {
+    start_async_file_log();
+
+    ZiThreadHandle threads[TEST_LOG_PRODUCERS];
+    for (u32 i = 0; i < TEST_LOG_PRODUCERS; ++i) {
+        threads[i] = zi_platform_thread_create(log_producer_main, (VoidPtr)(uintptr_t)i, "zi-test-log");
+        TEST_ASSERT_NOT_NULL(threads[i].handler);
+    }
+    for (u32 i = 0; i < TEST_LOG_PRODUCERS; ++i) {
+        zi_platform_thread_join(threads[i]);
+    }
+    stop_async_file_log();
+
+    LogProducerLines lines;
+    memset(&lines, 0, sizeof(lines));
+    for (u32 i = 0; i < TEST_LOG_PRODUCERS; ++i) {
+        lines.last[i] = -1;
+    }
+    read_log_lines(TEST_LOG_FILE, check_producer_line, &lines);
+    TEST_ASSERT_EQUAL_UINT32(TEST_LOG_PRODUCERS * TEST_LOG_PRODUCER_WRITES, lines.delivered + lines.dropped);
+    remove(TEST_LOG_FILE);
+}
+#endif
+
+// up to three slots per message, so spans straddle the end of the ring
+static i32 wrap_padding(u32 index) {
+    return (i32)(index * 37 % 300);
+}
+
+static void check_wrap_line(const char* text, u32 length, VoidPtr context) {
+    u32* next = (u32*)context;
+    char expected[512];
+    i32  expected_length = snprintf(expected, sizeof(expected), "wrap %u %.*s", *next, wrap_padding(*next), g_padding);
+    TEST_ASSERT_EQUAL_UINT32((u32)expected_length, length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, text, length);
+    ++*next;
+}
+
+void test_log_async_ring_wraparound(void) {
+    memset(g_padding, '#', sizeof(g_padding) - 1);
+    start_async_file_log();
+
+    // several times around the ring, flushed often enough that nothing is dropped
+    for (u32 i = 0; i < TEST_LOG_WRAP_WRITES; ++i) {
+        zi_log_warn("wrap %u %.*s", i, wrap_padding(i), g_padding);
+        if (i % 1000 == 999) zi_log_flush();
+    }
+    stop_async_file_log();
+
+    u32 next = 0;
+    TEST_ASSERT_EQUAL_UINT32(TEST_LOG_WRAP_WRITES, read_log_lines(TEST_LOG_FILE, check_wrap_line, &next));
+    TEST_ASSERT_EQUAL_UINT32(TEST_LOG_WRAP_WRITES, next);
+    remove(TEST_LOG_FILE);
+}
+
+static void check_drop_line(const char* text, u32 length, VoidPtr context) {
+    LogProducerLines* lines = (LogProducerLines*)context;
+    u32               index;
+    if (sscanf(text, "drop %u", &index) == 1) {
+        TEST_ASSERT_TRUE((i64)index > lines->last[0]);
+        lines->last[0] = index;
+        lines->delivered++;
+        return;
+    }
+    u32 dropped = parse_dropped(text, length);
+    TEST_ASSERT_TRUE(dropped > 0);
+    lines->dropped += dropped;
+}
+
+void test_log_async_counts_dropped_messages(void) {
+    memset(g_padding, 'x', 1000);
+    g_padding[1000] = 0;
+    start_async_file_log();
+
+    // ten slots each and no flushing, the ring fills long before the consumer wakes up again
+    u32 written = 0;
+    for (u32 round = 0; round < 3; ++round) {
+        for (u32 i = 0; i < TEST_LOG_DROP_WRITES; ++i) {
+            zi_log_warn("drop %u %s", written++, g_padding);
+        }
+        zi_log_flush();
+    }
+    stop_async_file_log();
+
+    LogProducerLines lines;
+    memset(&lines, 0, sizeof(lines));
+    lines.last[0] = -1;
+    read_log_lines(TEST_LOG_FILE, check_drop_line, &lines);
+    TEST_ASSERT_TRUE(lines.dropped > 0);
+    TEST_ASSERT_TRUE(lines.delivered > 0);
+    TEST_ASSERT_EQUAL_UINT32(written, lines.delivered + lines.dropped);
+    remove(TEST_LOG_FILE);
+}
+
+#define TEST_LOG_BINARY_FILE     "zi_test_log_binary.zilog"
+#define TEST_LOG_BINARY_MESSAGES 300
+
+static const char* g_asset_names[] = {"ground.mesh", "sky.ktx", "", "music/theme_long_name.ogg"};
+
+// the message logged as index i, formatted the way the decoder should print it
+static ZiLogLevel binary_expected(u32 i, char* out, u32 capacity) {
+    switch (i % 3) {
+        case 0:
+            snprintf(out, capacity, "frame %u took %.3f ms", i, i * 0.25);
+            return ZiLogLevel_Warn;
+        case 1:
+            snprintf(out, capacity, "asset %s missing (%d tries)", g_asset_names[i % 4], -(i32)i);
+            return ZiLogLevel_Error;
+        default:
+            snprintf(out, capacity, "%llx %c", (unsigned long long)i * 0x9e3779b97f4a7c15ull, 'a' + i % 26);
+            return ZiLogLevel_Critical;
+    }
+}
+
+static void check_binary_message(const ZiLogDecodedMessage* message, VoidPtr user_data) {
+    u32*       next = (u32*)user_data;
+    char       expected[128];
+    ZiLogLevel level = binary_expected(*next, expected, sizeof(expected));
+    TEST_ASSERT_EQUAL_UINT8(level, message->level);
+    TEST_ASSERT_EQUAL_UINT8(ZiLogCategory_App, message->category);
+    TEST_ASSERT_EQUAL_INT32((i32)strlen(expected), message->length);
+    TEST_ASSERT_EQUAL_STRING(expected, message->text);
+    ++*next;
+}
+
+void test_log_binary_file_round_trip(void) {
+    zi_log_init();
+    zi_log_set_sinks(0);
+    TEST_ASSERT_TRUE(zi_log_open_binary_file(TEST_LOG_BINARY_FILE));
+    for (u32 i = 0; i < TEST_LOG_BINARY_MESSAGES; ++i) {
+        if (i % 3 == 0) {
+            zi_log_deferred_warn("frame %u took %.3f ms", i, i * 0.25);
+        } else if (i % 3 == 1) {
+            zi_log_deferred_error("asset %s missing (%d tries)", g_asset_names[i % 4], -(i32)i);
+        } else {
+            zi_log_deferred_critical("%llx %c", (unsigned long long)i * 0x9e3779b97f4a7c15ull, 'a' + i % 26);
+        }
+    }
+    stop_async_file_log();
+
+    ZiMappedFile file;
+    TEST_ASSERT_TRUE(zi_platform_map_file(TEST_LOG_BINARY_FILE, ZiFileMapFlags_None, &file));
+    u32               next = 0;
+    ZiLogDecodeResult result = zi_log_binary_decode(file.data, file.size, check_binary_message, &next);
+    TEST_ASSERT_EQUAL_UINT8(ZiLogDecodeStatus_Ok, result.status);
+    TEST_ASSERT_EQUAL_UINT64(TEST_LOG_BINARY_MESSAGES, result.messages);
+    TEST_ASSERT_EQUAL_UINT32(TEST_LOG_BINARY_MESSAGES, next);
+    TEST_ASSERT_EQUAL_UINT64(file.size, result.offset);
+
+    // cut off inside the last record, everything before it still decodes
+    next = 0;
+    result = zi_log_binary_decode(file.data, file.size - 3, check_binary_message, &next);
+    TEST_ASSERT_EQUAL_UINT8(ZiLogDecodeStatus_Truncated, result.status);
+    TEST_ASSERT_EQUAL_UINT64(TEST_LOG_BINARY_MESSAGES - 1, result.messages);
+    TEST_ASSERT_TRUE(result.offset < file.size - 3);
+
+    result = zi_log_binary_decode(file.data + 1, file.size - 1, check_binary_message, &next);
+    TEST_ASSERT_EQUAL_UINT8(ZiLogDecodeStatus_NotBinary, result.status);
+    zi_platform_unmap_file(&file);
+    remove(TEST_LOG_BINARY_FILE);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_log_tests(void) {
+    RUN_TEST(test_log_binary_plain_text);
+    RUN_TEST(test_log_binary_integers);
+    RUN_TEST(test_log_binary_floats);
+    RUN_TEST(test_log_binary_strings_and_chars);
+    RUN_TEST(test_log_binary_star_width_precision);
+    RUN_TEST(test_log_binary_pointer);
+    RUN_TEST(test_log_binary_truncated_args);
+    RUN_TEST(test_log_binary_output_capacity);
+
+    RUN_TEST(test_log_compiled_out_sites_skip_arguments);
+    RUN_TEST(test_log_runtime_level_skips_arguments);
+    RUN_TEST(test_log_set_all_levels);
+    RUN_TEST(test_log_names);
+
+    RUN_TEST(test_log_memory_sink_keeps_recent_lines);
+    RUN_TEST(test_log_sinks_are_selectable);
+    RUN_TEST(test_log_file_rotates_by_size);
+
+#if !defined(ZI_EMSCRIPTEN)
+    RUN_TEST(test_log_async_multiple_producers);
+#endif
+    RUN_TEST(test_log_async_ring_wraparound);
+    RUN_TEST(test_log_async_counts_dropped_messages);
+    RUN_TEST(test_log_binary_file_round_trip);
+}
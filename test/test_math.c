@@ -1,5 +1,9 @@
 #include "unity.h"
 #include "zi_math.h"
+#include "zi_platform.h"
+
+#include <stdint.h>
+#include <string.h>
 
 // ============================================================================
 // Utility Functions Tests
@@ -143,6 +147,449 @@ void test_zi_vec2_normalize_zero(void) {
     TEST_ASSERT_FLOAT_WITHIN(ZI_EPSILON, 0.0f, result.y);
 }
 
+// ============================================================================
+// SIMD Tests
+// ============================================================================
+
+static ZiMat4 random_mat4(void) {
+    ZiMat4 m;
+    for (i32 i = 0; i < 16; i++) {
+        m.m[i] = zi_random_range_f32(-4.0f, 4.0f);
+    }
+    return m;
+}
+
+static void assert_mat4_within(f32 delta, const ZiMat4* expected, const ZiMat4* actual) {
+    for (i32 i = 0; i < 16; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected->m[i], actual->m[i]);
+    }
+}
+
+void test_zi_mat4_simd_matches_scalar(void) {
+#if ZI_MATH_HAS_SIMD
+    zi_random_seed(41);
+    for (i32 i = 0; i < 64; i++) {
+        ZiMat4 a = random_mat4();
+        ZiMat4 b = random_mat4();
+        ZiVec4 v = zi_vec4(zi_random_f32(), zi_random_f32(), zi_random_f32(), 1.0f);
+
+        ZiMat4 mul_scalar = zi_mat4_mul_scalar(&a, &b);
+        ZiMat4 mul_simd = zi_mat4_mul_simd(&a, &b);
+        assert_mat4_within(1e-4f, &mul_scalar, &mul_simd);
+
+        ZiMat4 transpose_scalar = zi_mat4_transpose_scalar(&a);
+        ZiMat4 transpose_simd = zi_mat4_transpose_simd(&a);
+        assert_mat4_within(0.0f, &transpose_scalar, &transpose_simd);
+
+        ZiVec4 mv_scalar = zi_mat4_mul_vec4_scalar(&a, v);
+        ZiVec4 mv_simd = zi_mat4_mul_vec4_simd(&a, v);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, mv_scalar.x, mv_simd.x);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, mv_scalar.y, mv_simd.y);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, mv_scalar.z, mv_simd.z);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, mv_scalar.w, mv_simd.w);
+
+        // random matrices can be badly conditioned, check against the product instead of the scalar inverse
+        ZiMat4 inverse = zi_mat4_inverse_simd(&a);
+        ZiMat4 product = zi_mat4_mul_scalar(&a, &inverse);
+        ZiMat4 identity = zi_mat4_identity();
+        assert_mat4_within(1e-3f, &identity, &product);
+    }
+
+    ZiMat4 rotation = zi_quat_to_mat4(zi_quat_from_euler(0.3f, -1.2f, 0.7f));
+    ZiMat4 translation = zi_mat4_translate(zi_vec3(3.0f, -7.0f, 12.0f));
+    ZiMat4 transform = zi_mat4_mul_scalar(&translation, &rotation);
+    ZiMat4 inverse_scalar = zi_mat4_inverse_scalar(&transform);
+    ZiMat4 inverse_simd = zi_mat4_inverse_simd(&transform);
+    assert_mat4_within(1e-5f, &inverse_scalar, &inverse_simd);
+
+    // singular falls back to identity like the scalar path
+    ZiMat4 singular = zi_mat4_zero();
+    ZiMat4 identity = zi_mat4_identity();
+    ZiMat4 singular_inverse = zi_mat4_inverse_simd(&singular);
+    assert_mat4_within(0.0f, &identity, &singular_inverse);
+#endif
+}
+
+void test_zi_quat_simd_matches_scalar(void) {
+#if ZI_MATH_HAS_SIMD
+    zi_random_seed(42);
+    for (i32 i = 0; i < 64; i++) {
+        ZiQuat a = zi_quat(zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f));
+        ZiQuat b = zi_quat(zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f));
+        ZiQuat expected = zi_quat_mul_scalar(a, b);
+        ZiQuat actual = zi_quat_mul_simd(a, b);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.x, actual.x);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.y, actual.y);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.z, actual.z);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.w, actual.w);
+    }
+#endif
+}
+
+// the planes have to agree with -w <= x, y, z <= w on the clip space position
+static void assert_frustum_matches_clip_space(const ZiMat4* view_projection, ZiFrustum frustum, ZiVec3 eye) {
+    u32 inside = 0;
+    for (i32 i = 0; i < 4096; i++) {
+        ZiVec3 p = zi_vec3_add(eye, zi_vec3(zi_random_range_f32(-60.0f, 60.0f), zi_random_range_f32(-60.0f, 60.0f), zi_random_range_f32(-60.0f, 60.0f)));
+        ZiVec4 clip = zi_mat4_mul_vec4_scalar(view_projection, zi_vec4(p.x, p.y, p.z, 1.0f));
+        f32 margin = zi_min_f32(zi_min_f32(clip.w - fabsf(clip.x), clip.w - fabsf(clip.y)), clip.w - fabsf(clip.z));
+        // too close to a plane for rounding to decide
+        if (fabsf(margin) < 1e-3f * (fabsf(clip.w) + 1.0f)) continue;
+
+        i32 expected = margin > 0.0f;
+        TEST_ASSERT_EQUAL_INT(expected, zi_frustum_contains_point(frustum, p));
+        inside += expected;
+    }
+    // the box straddles the frustum, both answers come up
+    TEST_ASSERT_TRUE(inside > 100 && inside < 4000);
+}
+
+void test_zi_frustum_from_mat4(void) {
+    zi_random_seed(43);
+    ZiVec3 eye = zi_vec3(4.0f, 3.0f, -20.0f);
+    ZiMat4 view = zi_mat4_look_at(eye, zi_vec3_zero(), zi_vec3(0.0f, 1.0f, 0.0f));
+    ZiMat4 projection = zi_mat4_perspective(zi_radians(70.0f), 16.0f / 9.0f, 0.1f, 50.0f);
+    ZiMat4 view_projection = zi_mat4_mul_scalar(&projection, &view);
+
+    ZiFrustum expected = zi_frustum_from_mat4_scalar(&view_projection);
+    assert_frustum_matches_clip_space(&view_projection, expected, eye);
+
+    // in front of the camera and behind it
+    ZiVec3 forward = zi_vec3_normalize(zi_vec3_sub(zi_vec3_zero(), eye));
+    TEST_ASSERT_TRUE(zi_frustum_contains_point(expected, zi_vec3_add(eye, zi_vec3_scale(forward, 10.0f))));
+    TEST_ASSERT_FALSE(zi_frustum_contains_point(expected, zi_vec3_sub(eye, zi_vec3_scale(forward, 10.0f))));
+
+#if ZI_MATH_HAS_SIMD
+    ZiFrustum actual = zi_frustum_from_mat4_simd(&view_projection);
+    for (i32 i = 0; i < 6; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.planes[i].normal.x, actual.planes[i].normal.x);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.planes[i].normal.y, actual.planes[i].normal.y);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected.planes[i].normal.z, actual.planes[i].normal.z);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected.planes[i].distance, actual.planes[i].distance);
+    }
+    assert_frustum_matches_clip_space(&view_projection, actual, eye);
+#endif
+}
+
+void test_zi_aligned_types(void) {
+    ZiMat4A matrices[3];
+    ZiVec4A vectors[3];
+    ZiQuatA quats[3];
+    for (i32 i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT64(0, (u64)(uintptr_t)&matrices[i] & 15);
+        TEST_ASSERT_EQUAL_UINT64(0, (u64)(uintptr_t)&vectors[i] & 15);
+        TEST_ASSERT_EQUAL_UINT64(0, (u64)(uintptr_t)&quats[i] & 15);
+    }
+
+    ZiMat4 a = zi_mat4_translate(zi_vec3(1.0f, 2.0f, 3.0f));
+    ZiMat4 b = zi_quat_to_mat4(zi_quat_from_axis_angle(zi_vec3(0.0f, 1.0f, 0.0f), 0.5f));
+    matrices[0] = zi_mat4a_from_mat4(&a);
+    matrices[1] = zi_mat4a_from_mat4(&b);
+    matrices[2] = zi_mat4a_mul(&matrices[0], &matrices[1]);
+
+    ZiMat4 expected = zi_mat4_mul_scalar(&a, &b);
+    ZiMat4 actual = zi_mat4a_to_mat4(&matrices[2]);
+    assert_mat4_within(1e-5f, &expected, &actual);
+
+    ZiMat4A inverse = zi_mat4a_inverse(&matrices[2]);
+    ZiMat4A product = zi_mat4a_mul(&matrices[2], &inverse);
+    ZiMat4 identity = zi_mat4_identity();
+    actual = zi_mat4a_to_mat4(&product);
+    assert_mat4_within(1e-5f, &identity, &actual);
+
+    vectors[0] = zi_mat4a_mul_vec4a(&matrices[0], zi_vec4a_from_vec4(zi_vec4(1.0f, 1.0f, 1.0f, 1.0f)));
+    TEST_ASSERT_FLOAT_WITHIN(ZI_EPSILON, 2.0f, vectors[0].x);
+    TEST_ASSERT_FLOAT_WITHIN(ZI_EPSILON, 3.0f, vectors[0].y);
+    TEST_ASSERT_FLOAT_WITHIN(ZI_EPSILON, 4.0f, vectors[0].z);
+
+    quats[0] = zi_quata_from_quat(zi_quat_from_axis_angle(zi_vec3(0.0f, 0.0f, 1.0f), 0.25f));
+    quats[1] = zi_quata_mul(quats[0], quats[0]);
+    ZiQuat twice = zi_quat_from_axis_angle(zi_vec3(0.0f, 0.0f, 1.0f), 0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, twice.z, quats[1].z);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, twice.w, quats[1].w);
+}
+
+// ============================================================================
+// Random Tests
+// ============================================================================
+
+void test_zi_random_reference(void) {
+    // pcg32-global-demo output for seed 42, stream 54
+    static const u32 expected[] = {0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e};
+    ZiRandom rng = zi_random_create(42, 54);
+    for (u32 i = 0; i < 6; ++i) {
+        TEST_ASSERT_EQUAL_HEX32(expected[i], zi_random_next_u32(&rng));
+    }
+
+    // another stream from the same seed is another sequence
+    ZiRandom other = zi_random_create(42, 55);
+    TEST_ASSERT_NOT_EQUAL(0xa15c02b7, zi_random_next_u32(&other));
+}
+
+void test_zi_random_advance_split(void) {
+    ZiRandom rng = zi_random_create(7, 3);
+    ZiRandom stepped = rng;
+    for (u32 i = 0; i < 1000; ++i) {
+        zi_random_next_u32(&stepped);
+    }
+    ZiRandom jumped = rng;
+    zi_random_advance(&jumped, 1000);
+    TEST_ASSERT_TRUE(jumped.state == stepped.state);
+
+    // and back
+    zi_random_advance(&jumped, (u64)-1000);
+    TEST_ASSERT_TRUE(jumped.state == rng.state);
+
+    // splits are deterministic, differ from each other and move the parent on
+    ZiRandom parent_a = zi_random_create(9, 0);
+    ZiRandom parent_b = parent_a;
+    ZiRandom child_a = zi_random_split(&parent_a);
+    ZiRandom child_b = zi_random_split(&parent_b);
+    ZiRandom sibling = zi_random_split(&parent_a);
+    TEST_ASSERT_TRUE(child_a.state == child_b.state && child_a.inc == child_b.inc);
+    TEST_ASSERT_TRUE(sibling.inc != child_a.inc);
+
+    u32 same = 0;
+    for (u32 i = 0; i < 256; ++i) {
+        same += zi_random_next_u32(&child_a) == zi_random_next_u32(&sibling);
+    }
+    TEST_ASSERT_TRUE(same < 2);
+}
+
+void test_zi_random_ranges(void) {
+    ZiRandom rng = zi_random_create(11, 0);
+    f64 sum = 0.0;
+    u32 hits[7] = {0};
+    for (u32 i = 0; i < 70000; ++i) {
+        f32 f = zi_random_next_f32(&rng);
+        TEST_ASSERT_TRUE(f >= 0.0f && f < 1.0f);
+        sum += f;
+
+        i32 v = zi_random_next_range_i32(&rng, -3, 3);
+        TEST_ASSERT_TRUE(v >= -3 && v <= 3);
+        hits[v + 3]++;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, (f32)(sum / 70000.0));
+    for (u32 i = 0; i < 7; ++i) {
+        TEST_ASSERT_UINT32_WITHIN(600, 10000, hits[i]);
+    }
+
+    // max - min is one ulp of min, half the products round up to max without the clamp
+    f32 clamped[64];
+    zi_random_fill_f32(&rng, clamped, 64, 1e8f, 1e8f + 8.0f);
+    for (u32 i = 0; i < 64; ++i) {
+        TEST_ASSERT_TRUE(zi_random_next_range_f32(&rng, 1e8f, 1e8f + 8.0f) < 1e8f + 8.0f);
+        TEST_ASSERT_TRUE(clamped[i] >= 1e8f && clamped[i] < 1e8f + 8.0f);
+    }
+
+    // the full i32 range doesn't overflow
+    TEST_ASSERT_EQUAL_INT32(5, zi_random_next_range_i32(&rng, 5, 5));
+    zi_random_next_range_i32(&rng, INT32_MIN, INT32_MAX);
+}
+
+static void random_fill_matches_serial(void) {
+    // odd count to cover the tail after the 8 wide part
+    static u32 bits[1003];
+    static f32 values[1003];
+
+    ZiRandom rng = zi_random_create(5, 17);
+    ZiRandom reference = rng;
+    zi_random_fill_u32(&rng, bits, 1003);
+    for (u32 i = 0; i < 1003; ++i) {
+        TEST_ASSERT_EQUAL_HEX32(zi_random_next_u32(&reference), bits[i]);
+    }
+    TEST_ASSERT_TRUE(rng.state == reference.state);
+
+    zi_random_fill_f32(&rng, values, 1003, -2.0f, 6.0f);
+    for (u32 i = 0; i < 1003; ++i) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, zi_random_next_range_f32(&reference, -2.0f, 6.0f), values[i]);
+        TEST_ASSERT_TRUE(values[i] >= -2.0f && values[i] < 6.0f);
+    }
+    TEST_ASSERT_TRUE(rng.state == reference.state);
+
+    // a slice of the sequence per job, put back together it is the serial fill
+    ZiRandom job = zi_random_create(5, 17);
+    zi_random_advance(&job, 500);
+    zi_random_fill_u32(&job, bits + 500, 503);
+    job = zi_random_create(5, 17);
+    zi_random_fill_u32(&job, bits, 500);
+    reference = zi_random_create(5, 17);
+    for (u32 i = 0; i < 1003; ++i) {
+        TEST_ASSERT_EQUAL_HEX32(zi_random_next_u32(&reference), bits[i]);
+    }
+}
+
+void test_zi_random_fill(void) {
+    random_fill_matches_serial();
+
+    // and the portable kernel the features mask falls back to
+    zi_platform_set_cpu_features_mask(0);
+    random_fill_matches_serial();
+    zi_platform_set_cpu_features_mask(0xffffffffu);
+}
+
+// no threads on the web
+#if !defined(ZI_EMSCRIPTEN)
+typedef struct RandomThreadResult {
+    u32 unseeded[4];
+    u32 seeded[4];
+} RandomThreadResult;
+
+static void random_thread_draw(VoidPtr user_data) {
+    RandomThreadResult* result = (RandomThreadResult*)user_data;
+    for (u32 i = 0; i < 4; ++i) {
+        result->unseeded[i] = zi_random_u32();
+    }
+    zi_random_seed(123);
+    for (u32 i = 0; i < 4; ++i) {
+        result->seeded[i] = zi_random_u32();
+    }
+}
+
+void test_zi_random_thread_streams(void) {
+    RandomThreadResult results[2];
+    for (u32 t = 0; t < 2; ++t) {
+        ZiThreadHandle thread = zi_platform_thread_create(random_thread_draw, &results[t], "zi-random-test");
+        TEST_ASSERT_NOT_NULL(thread.handler);
+        zi_platform_thread_join(thread);
+    }
+
+    // fresh threads get their own streams, seeding makes them agree
+    TEST_ASSERT_FALSE(memcmp(results[0].unseeded, results[1].unseeded, sizeof(results[0].unseeded)) == 0);
+    TEST_ASSERT_EQUAL_HEX32_ARRAY(results[0].seeded, results[1].seeded, 4);
+
+    // and this thread's seeded stream is the same one
+    zi_random_seed(123);
+    for (u32 i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL_HEX32(results[0].seeded[i], zi_random_u32());
+    }
+}
+#endif
+
+// ============================================================================
+// Fast Approximation Tests
+// ============================================================================
+
+typedef struct FastMathCase {
+    const char* name;
+    f32         (*fast)(f32 x);
+    double      (*reference)(double x);
+    f32         lo, hi;
+    // the documented bound, relative error when relative is set
+    f32         max_error;
+    ZiBool      relative;
+} FastMathCase;
+
+static f32 fast_sin(f32 x) { return zi_fast_sin(x); }
+static f32 fast_cos(f32 x) { return zi_fast_cos(x); }
+static f32 fast_srgb_pow(f32 x) { return zi_fast_pow(x, 1.0f / 2.4f); }
+static double ref_rsqrt(double x) { return 1.0 / sqrt(x); }
+static double ref_srgb_pow(double x) { return pow(x, (double)(1.0f / 2.4f)); }
+static double ref_linear_to_srgb(double x) { return x <= 0.0031308 ? x * 12.92 : 1.055 * pow(x, 1.0 / 2.4) - 0.055; }
+static double ref_srgb_to_linear(double x) { return x <= 0.04045 ? x / 12.92 : pow((x + 0.055) / 1.055, 2.4); }
+
+static const FastMathCase fast_math_cases[] = {
+    {"rsqrt",          zi_fast_rsqrt,          ref_rsqrt,          1e-20f,   1e20f,   5e-6f,   ZI_TRUE},
+    {"sqrt",           zi_fast_sqrt,           sqrt,               1e-20f,   1e20f,   5e-6f,   ZI_TRUE},
+    {"sin",            fast_sin,               sin,                -8192.0f, 8192.0f, 1.5e-7f, ZI_FALSE},
+    {"cos",            fast_cos,               cos,                -8192.0f, 8192.0f, 1.5e-7f, ZI_FALSE},
+    {"exp2",           zi_fast_exp2,           exp2,               -126.0f,  127.0f,  3e-7f,   ZI_TRUE},
+    {"exp",            zi_fast_exp,            exp,                -80.0f,   80.0f,   4e-6f,   ZI_TRUE},
+    {"log2",           zi_fast_log2,           log2,               1.0f / 256.0f, 256.0f, 7e-7f, ZI_FALSE},
+    {"log2 small",     zi_fast_log2,           log2,               1e-30f,   1.0f / 256.0f, 1e-7f, ZI_TRUE},
+    {"log2 large",     zi_fast_log2,           log2,               256.0f,   1e30f,   1e-7f,   ZI_TRUE},
+    {"pow",            fast_srgb_pow,          ref_srgb_pow,       1e-3f,    16.0f,   1e-6f,   ZI_TRUE},
+    {"linear_to_srgb", zi_fast_linear_to_srgb, ref_linear_to_srgb, 0.0f,     1.0f,    1e-6f,   ZI_FALSE},
+    {"srgb_to_linear", zi_fast_srgb_to_linear, ref_srgb_to_linear, 0.0f,     1.0f,    1e-6f,   ZI_FALSE},
+};
+
+// sweeps every case and checks the worst error against its documented bound
+void test_zi_fast_accuracy_table(void) {
+    const u32 samples = 200000;
+    for (u32 c = 0; c < sizeof(fast_math_cases) / sizeof(fast_math_cases[0]); c++) {
+        const FastMathCase* fc = &fast_math_cases[c];
+        // wide positive ranges are swept in log space so every exponent gets samples
+        ZiBool logarithmic = fc->lo > 0.0f && fc->hi / fc->lo > 1e6f;
+        double worst = 0.0;
+
+        for (u32 i = 0; i <= samples; i++) {
+            double u = (double)i / samples;
+            f32 x = logarithmic ? (f32)(fc->lo * pow((double)fc->hi / fc->lo, u)) : (f32)(fc->lo + (fc->hi - fc->lo) * u);
+            double expected = fc->reference(x);
+            double error = fabs((double)fc->fast(x) - expected);
+            if (fc->relative) {
+                error /= fabs(expected);
+            }
+            worst = error > worst ? error : worst;
+        }
+        TEST_ASSERT_LESS_OR_EQUAL_FLOAT_MESSAGE(fc->max_error, (f32)worst, fc->name);
+    }
+}
+
+void test_zi_fast_atan2(void) {
+    double worst = 0.0;
+    for (i32 i = -200; i <= 200; i++) {
+        for (i32 j = -200; j <= 200; j++) {
+            f32 y = (f32)i * 0.05f;
+            f32 x = (f32)j * 0.05f;
+            double error = fabs((double)zi_fast_atan2(y, x) - atan2((double)y, (double)x));
+            worst = error > worst ? error : worst;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(2.5e-6f, (f32)worst);
+
+    // signed zeros land where atan2f puts them
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, zi_fast_atan2(0.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(2.5e-6f, ZI_PI, zi_fast_atan2(0.0f, -1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(2.5e-6f, -ZI_PI, zi_fast_atan2(-0.0f, -1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(2.5e-6f, ZI_HALF_PI, zi_fast_atan2(1.0f, 0.0f));
+    TEST_ASSERT_FLOAT_WITHIN(2.5e-6f, -ZI_HALF_PI, zi_fast_atan2(-1.0f, -0.0f));
+}
+
+void test_zi_fast_vec3_normalize(void) {
+    ZiVec3 v = zi_fast_vec3_normalize(zi_vec3(3.0f, -4.0f, 12.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 3.0f / 13.0f, v.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -4.0f / 13.0f, v.y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 12.0f / 13.0f, v.z);
+
+    v = zi_fast_vec3_normalize(zi_vec3_zero());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, v.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, v.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, v.z);
+}
+
+void test_zi_fast_quat_slerp(void) {
+    zi_random_seed(44);
+    double worst = 0.0;
+    for (i32 i = 0; i < 20000; i++) {
+        ZiQuat a = zi_quat_from_axis_angle(zi_vec3_random_on_sphere(), zi_random_range_f32(-ZI_PI, ZI_PI));
+        ZiQuat b = zi_quat_from_axis_angle(zi_vec3_random_on_sphere(), zi_random_range_f32(-ZI_PI, ZI_PI));
+        f32 t = zi_random_f32();
+        ZiQuat expected = zi_quat_slerp(a, b, t);
+        ZiQuat actual = zi_fast_quat_slerp(a, b, t);
+
+        // rotation angle between the two, lengths divided out so rsqrt's error doesn't count as angle
+        double dot = (double)expected.x * actual.x + (double)expected.y * actual.y +
+                     (double)expected.z * actual.z + (double)expected.w * actual.w;
+        double cosine = fabs(dot) / ((double)zi_quat_length(expected) * zi_quat_length(actual));
+        double angle = 2.0 * acos(cosine < 1.0 ? cosine : 1.0);
+        worst = angle > worst ? angle : worst;
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, zi_quat_length(actual));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.2e-3f, (f32)worst);
+
+    // exact at the ends, a negated target gets flipped back to take the shorter way
+    ZiQuat a = zi_quat_from_axis_angle(zi_vec3(0.0f, 1.0f, 0.0f), 0.5f);
+    ZiQuat b = zi_quat_from_axis_angle(zi_vec3(0.0f, 1.0f, 0.0f), 2.0f);
+    ZiQuat negated = { -b.x, -b.y, -b.z, -b.w };
+    ZiQuat end = zi_fast_quat_slerp(a, negated, 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, b.y, end.y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, b.w, end.w);
+    ZiQuat start = zi_fast_quat_slerp(a, b, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, a.y, start.y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, a.w, start.w);
+}
+
 // ============================================================================
 // Test Runner
 // ============================================================================
@@ -174,4 +621,25 @@ void run_math_tests(void) {
     RUN_TEST(test_zi_vec2_length);
     RUN_TEST(test_zi_vec2_normalize);
     RUN_TEST(test_zi_vec2_normalize_zero);
+
+    // SIMD
+    RUN_TEST(test_zi_mat4_simd_matches_scalar);
+    RUN_TEST(test_zi_quat_simd_matches_scalar);
+    RUN_TEST(test_zi_frustum_from_mat4);
+    RUN_TEST(test_zi_aligned_types);
+
+    // Random
+    RUN_TEST(test_zi_random_reference);
+    RUN_TEST(test_zi_random_advance_split);
+    RUN_TEST(test_zi_random_ranges);
+    RUN_TEST(test_zi_random_fill);
+#if !defined(ZI_EMSCRIPTEN)
+    RUN_TEST(test_zi_random_thread_streams);
+#endif
+
+    // Fast approximations
+    RUN_TEST(test_zi_fast_accuracy_table);
+    RUN_TEST(test_zi_fast_atan2);
+    RUN_TEST(test_zi_fast_vec3_normalize);
+    RUN_TEST(test_zi_fast_quat_slerp);
 }
@@ -0,0 +1,220 @@
+#include "unity.h"
+#include "zi_platform.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// CPU Feature Tests
+// ============================================================================
+
+static int dispatch_scalar(void) { return 1; }
+static int dispatch_avx2(void) { return 2; }
+static int dispatch_neon(void) { return 3; }
+
+typedef int (*DispatchFn)(void);
+
+static const ZiCpuDispatch dispatch_table[] = {
+    {ZiCpuFeature_AVX2 | ZiCpuFeature_FMA, (VoidPtr)dispatch_avx2},
+    {ZiCpuFeature_NEON, (VoidPtr)dispatch_neon},
+    {0, (VoidPtr)dispatch_scalar},
+};
+
+void test_cpu_features_are_consistent(void) {
+    ZiCpuFeatures features = zi_platform_cpu_features();
+
+    // every level implies the ones below it
+    if (features & ZiCpuFeature_AVX2) TEST_ASSERT_TRUE(features & ZiCpuFeature_AVX);
+    if (features & ZiCpuFeature_AVX512F) TEST_ASSERT_TRUE(features & ZiCpuFeature_AVX);
+    if (features & ZiCpuFeature_SSE42) TEST_ASSERT_TRUE(features & ZiCpuFeature_SSE2);
+
+#if ZI_ARCH_X86 && (defined(__x86_64__) || defined(_M_X64))
+    TEST_ASSERT_TRUE(features & ZiCpuFeature_SSE2);
+#endif
+#if ZI_ARCH_ARM64
+    TEST_ASSERT_TRUE(features & ZiCpuFeature_NEON);
+#endif
+}
+
+void test_cpu_features_mask(void) {
+    ZiCpuFeatures features = zi_platform_cpu_features();
+
+    zi_platform_set_cpu_features_mask(ZiCpuFeature_SSE2);
+    TEST_ASSERT_EQUAL_UINT32(features & ZiCpuFeature_SSE2, zi_platform_cpu_features());
+
+    zi_platform_set_cpu_features_mask(0);
+    DispatchFn fn = (DispatchFn)zi_platform_cpu_dispatch(dispatch_table, 3);
+    TEST_ASSERT_EQUAL_INT(1, fn());
+
+    zi_platform_set_cpu_features_mask(0xffffffffu);
+    TEST_ASSERT_EQUAL_UINT32(features, zi_platform_cpu_features());
+}
+
+void test_cpu_dispatch_picks_best(void) {
+    ZiCpuFeatures features = zi_platform_cpu_features();
+    DispatchFn fn = (DispatchFn)zi_platform_cpu_dispatch(dispatch_table, 3);
+
+    int expected = 1;
+    if ((features & (ZiCpuFeature_AVX2 | ZiCpuFeature_FMA)) == (ZiCpuFeature_AVX2 | ZiCpuFeature_FMA)) {
+        expected = 2;
+    } else if (features & ZiCpuFeature_NEON) {
+        expected = 3;
+    }
+    TEST_ASSERT_EQUAL_INT(expected, fn());
+
+    // nothing matches without a fallback entry
+    TEST_ASSERT_NULL(zi_platform_cpu_dispatch(dispatch_table, 0));
+}
+
+void test_cpu_features_format(void) {
+    char buf[256];
+    TEST_ASSERT_EQUAL_INT(0, zi_platform_format_cpu_features(0, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+
+    i32 len = zi_platform_format_cpu_features(ZiCpuFeature_SSE42 | ZiCpuFeature_AVX2, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("sse4.2 avx2", buf);
+    TEST_ASSERT_EQUAL_INT((i32)strlen(buf), len);
+
+    // truncation stops at a whole name
+    zi_platform_format_cpu_features(ZiCpuFeature_SSE42 | ZiCpuFeature_AVX2, buf, 8);
+    TEST_ASSERT_EQUAL_STRING("sse4.2", buf);
+}
+
+// ============================================================================
+// File Watch Tests
+// ============================================================================
+
+#ifdef ZI_LINUX
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEST_WATCH_DIR "zi_test_watch"
+
+static void write_watch_file(const char* path, const char* contents) {
+    FILE* fp = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fputs(contents, fp);
+    fclose(fp);
+}
+
+// polls until every expected path showed up and nothing came for two settle periods. Gives up after
+// a few seconds, a loaded machine can split what would be one change into several.
+static u32 collect_watch_events(ZiFileWatchHandle watch, ZiFileChangeEvent* events, u32 max, const char* const* expected,
+                                u32 expected_count) {
+    u64 frequency = zi_platform_get_tick_frequency();
+    u64 quiet_since = zi_platform_get_ticks();
+    u64 deadline = quiet_since + frequency * 5;
+    u32 count = 0;
+    while (zi_platform_get_ticks() < deadline) {
+        u32 before = count;
+        while (count < max && zi_platform_file_watch_poll(watch, &events[count])) {
+            count++;
+        }
+        u64 now = zi_platform_get_ticks();
+        if (count != before) quiet_since = now;
+
+        u32 seen = 0;
+        for (u32 i = 0; i < expected_count; ++i) {
+            for (u32 j = 0; j < count; ++j) {
+                if (strcmp(events[j].path, expected[i]) == 0) {
+                    seen++;
+                    break;
+                }
+            }
+        }
+        if (seen == expected_count && now - quiet_since > frequency * (ZI_FILE_WATCH_SETTLE_MS * 2) / 1000) break;
+        usleep(5000);
+    }
+    return count;
+}
+
+// the first event for path, or the last one, null when there is none
+static const ZiFileChangeEvent* find_watch_event(const ZiFileChangeEvent* events, u32 count, const char* path, ZiBool last) {
+    const ZiFileChangeEvent* found = ZI_NULL;
+    for (u32 i = 0; i < count; ++i) {
+        if (strcmp(events[i].path, path) != 0) continue;
+        found = &events[i];
+        if (!last) break;
+    }
+    return found;
+}
+
+static u32 count_watch_events(const ZiFileChangeEvent* events, u32 count, const char* path) {
+    u32 matches = 0;
+    for (u32 i = 0; i < count; ++i) {
+        matches += strcmp(events[i].path, path) == 0;
+    }
+    return matches;
+}
+
+void test_file_watch_coalesces_changes(void) {
+    mkdir(TEST_WATCH_DIR, 0755);
+    write_watch_file(TEST_WATCH_DIR "/existing.txt", "a");
+
+    ZiFileWatchHandle watch = zi_platform_file_watch_create(TEST_WATCH_DIR, ZI_TRUE);
+    TEST_ASSERT_NOT_NULL(watch.handler);
+
+    // several writes to one file end up as a single change
+    write_watch_file(TEST_WATCH_DIR "/existing.txt", "b");
+    write_watch_file(TEST_WATCH_DIR "/existing.txt", "c");
+    write_watch_file(TEST_WATCH_DIR "/new.txt", "d");
+    write_watch_file(TEST_WATCH_DIR "/new.txt", "e");
+    // gone again before it settles
+    write_watch_file(TEST_WATCH_DIR "/temp.txt", "f");
+    remove(TEST_WATCH_DIR "/temp.txt");
+    // new directories are watched too
+    mkdir(TEST_WATCH_DIR "/sub", 0755);
+    write_watch_file(TEST_WATCH_DIR "/sub/nested.txt", "g");
+
+    static const char* const changed[] = {"existing.txt", "new.txt", "sub/nested.txt"};
+    ZiFileChangeEvent events[32];
+    u32 count = collect_watch_events(watch, events, 32, changed, 3);
+
+    // usually one event each, never more than one per write
+    TEST_ASSERT_TRUE(count >= 3);
+    TEST_ASSERT_TRUE(count_watch_events(events, count, "existing.txt") <= 2);
+    TEST_ASSERT_TRUE(count_watch_events(events, count, "new.txt") <= 2);
+    TEST_ASSERT_TRUE(count_watch_events(events, count, "sub/nested.txt") == 1);
+
+    for (u32 i = 0; i < count; ++i) {
+        if (strcmp(events[i].path, "existing.txt") == 0) TEST_ASSERT_EQUAL_UINT8(ZiFileChange_Modified, events[i].change);
+    }
+    const ZiFileChangeEvent* event = find_watch_event(events, count, "new.txt", ZI_FALSE);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_UINT8(ZiFileChange_Created, event->change);
+    event = find_watch_event(events, count, "sub/nested.txt", ZI_FALSE);
+    TEST_ASSERT_NOT_NULL(event);
+    TEST_ASSERT_EQUAL_UINT8(ZiFileChange_Created, event->change);
+    // only split up when the machine stalled between the two calls, it still ends deleted
+    event = find_watch_event(events, count, "temp.txt", ZI_TRUE);
+    if (event) TEST_ASSERT_EQUAL_UINT8(ZiFileChange_Deleted, event->change);
+
+    remove(TEST_WATCH_DIR "/existing.txt");
+    static const char* const deleted[] = {"existing.txt"};
+    count = collect_watch_events(watch, events, 32, deleted, 1);
+    TEST_ASSERT_EQUAL_UINT32(1, count);
+    TEST_ASSERT_EQUAL_STRING("existing.txt", events[0].path);
+    TEST_ASSERT_EQUAL_UINT8(ZiFileChange_Deleted, events[0].change);
+
+    zi_platform_file_watch_destroy(watch);
+
+    remove(TEST_WATCH_DIR "/new.txt");
+    remove(TEST_WATCH_DIR "/sub/nested.txt");
+    rmdir(TEST_WATCH_DIR "/sub");
+    rmdir(TEST_WATCH_DIR);
+}
+#endif
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_platform_tests(void) {
+    RUN_TEST(test_cpu_features_are_consistent);
+    RUN_TEST(test_cpu_features_mask);
+    RUN_TEST(test_cpu_dispatch_picks_best);
+    RUN_TEST(test_cpu_features_format);
+#ifdef ZI_LINUX
+    RUN_TEST(test_file_watch_coalesces_changes);
+#endif
+}
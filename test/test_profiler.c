@@ -0,0 +1,352 @@
+#include "unity.h"
+#include "zi_platform.h"
+#include "zi_profiler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_PROFILE_BINARY "zi_test_profile.zprof"
+#define TEST_PROFILE_JSON   "zi_test_profile.json"
+
+static void profiler_reset(void) {
+    zi_profiler_shutdown();
+    zi_profiler_init();
+}
+
+static const ZiProfileCaptureThread* find_capture_thread(const ZiProfileCapture* capture, const char* name) {
+    for (u32 i = 0; i < capture->thread_count; ++i) {
+        if (strcmp(capture->threads[i].name, name) == 0) return &capture->threads[i];
+    }
+    return ZI_NULL;
+}
+
+// every end closes the innermost begin and time never goes backwards
+static void assert_balanced(const ZiProfileCaptureThread* thread) {
+    const char* stack[64];
+    u32         depth = 0;
+    u64         last_time = 0;
+
+    for (u32 i = 0; i < thread->event_count; ++i) {
+        const ZiProfileEvent* event = &thread->events[i];
+        TEST_ASSERT_TRUE(event->time >= last_time);
+        last_time = event->time;
+
+        if (event->type == ZiProfileEventType_Begin) {
+            TEST_ASSERT_TRUE(depth < 64);
+            stack[depth++] = event->name;
+        } else if (event->type == ZiProfileEventType_End) {
+            TEST_ASSERT_TRUE(depth > 0);
+            TEST_ASSERT_EQUAL_STRING(stack[--depth], event->name);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, depth);
+}
+
+// ZI_PROFILER_MAX_DEPTH in zi_profiler.c, zones below it are dropped from captures
+#define TEST_PROFILE_MAX_DEPTH 256
+
+#if ZI_PROFILE_SCOPED_ZONES
+static u32 profiled_early_return(u32 value) {
+    ZI_PROFILE_FUNCTION();
+    if (value > 1) {
+        return value;
+    }
+    ZI_PROFILE_ZONE("never reached");
+    return 0;
+}
+#endif
+
+// ============================================================================
+// Zone Tests
+// ============================================================================
+
+// scoped zones, early returns included. The other tests use explicit pairs so they run on MSVC too.
+#if ZI_PROFILE_SCOPED_ZONES
+void test_profiler_nested_zones(void) {
+    profiler_reset();
+
+    ZI_PROFILE_FRAME();
+    {
+        ZI_PROFILE_ZONE("outer");
+        {
+            ZI_PROFILE_ZONE("inner");
+        }
+        TEST_ASSERT_EQUAL_UINT32(5, profiled_early_return(5));
+    }
+    ZI_PROFILE_BEGIN(manual);
+    ZI_PROFILE_END(manual);
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+
+    const ZiProfileCaptureThread* thread = find_capture_thread(&capture, "main");
+    TEST_ASSERT_NOT_NULL(thread);
+    TEST_ASSERT_EQUAL_UINT32(9, thread->event_count);
+    assert_balanced(thread);
+
+    TEST_ASSERT_EQUAL_UINT8(ZiProfileEventType_Frame, thread->events[0].type);
+    TEST_ASSERT_EQUAL_UINT32(0, thread->events[0].data);
+    TEST_ASSERT_EQUAL_STRING("outer", thread->events[1].name);
+    TEST_ASSERT_EQUAL_STRING("inner", thread->events[2].name);
+    TEST_ASSERT_EQUAL_STRING("profiled_early_return", thread->events[4].name);
+    TEST_ASSERT_EQUAL_STRING("manual", thread->events[7].name);
+
+    zi_profiler_capture_free(&capture);
+}
+#endif
+
+void test_profiler_deeper_than_the_stack(void) {
+    profiler_reset();
+
+    zi_profiler_record(ZiProfileEventType_Begin, "outer", 0);
+    for (u32 i = 0; i < TEST_PROFILE_MAX_DEPTH + 9; ++i) {
+        zi_profiler_record(ZiProfileEventType_Begin, "deep", 0);
+    }
+    for (u32 i = 0; i < TEST_PROFILE_MAX_DEPTH + 9; ++i) {
+        zi_profiler_record(ZiProfileEventType_End, "deep", 0);
+    }
+    // a gap that shows which end closed outer
+    zi_platform_sleep_until(zi_platform_get_ticks() + zi_platform_get_tick_frequency() / 200);
+    zi_profiler_record(ZiProfileEventType_End, "outer", 0);
+    ZI_PROFILE_BEGIN(after);
+    ZI_PROFILE_END(after);
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    const ZiProfileCaptureThread* thread = find_capture_thread(&capture, "main");
+    TEST_ASSERT_NOT_NULL(thread);
+
+    // the dropped begins take their ends with them, outer still closes last
+    TEST_ASSERT_EQUAL_UINT32(2 * TEST_PROFILE_MAX_DEPTH + 2, thread->event_count);
+    const ZiProfileEvent* outer_end = &thread->events[2 * TEST_PROFILE_MAX_DEPTH - 1];
+    TEST_ASSERT_EQUAL_UINT8(ZiProfileEventType_End, outer_end->type);
+    TEST_ASSERT_EQUAL_STRING("outer", outer_end->name);
+    TEST_ASSERT_TRUE(outer_end->time - (outer_end - 1)->time >= 1000000);
+    TEST_ASSERT_EQUAL_STRING("after", thread->events[2 * TEST_PROFILE_MAX_DEPTH].name);
+    zi_profiler_capture_free(&capture);
+}
+
+void test_profiler_not_recording(void) {
+    profiler_reset();
+    zi_profiler_set_recording(ZI_FALSE);
+
+    ZI_PROFILE_BEGIN(skipped);
+    ZI_PROFILE_END(skipped);
+    ZI_PROFILE_FRAME();
+
+    zi_profiler_set_recording(ZI_TRUE);
+    ZI_PROFILE_BEGIN(recorded);
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    const ZiProfileCaptureThread* thread = find_capture_thread(&capture, "main");
+    TEST_ASSERT_NOT_NULL(thread);
+    // still open while capturing, the capture closes it
+    TEST_ASSERT_EQUAL_UINT32(2, thread->event_count);
+    TEST_ASSERT_EQUAL_STRING("recorded", thread->events[0].name);
+    assert_balanced(thread);
+    zi_profiler_capture_free(&capture);
+    ZI_PROFILE_END(recorded);
+}
+
+void test_profiler_ring_wraps(void) {
+    profiler_reset();
+
+    ZI_PROFILE_BEGIN(long_zone);
+    for (u32 i = 0; i < ZI_PROFILER_RING_EVENTS; ++i) {
+        ZI_PROFILE_BEGIN(short_zone);
+        ZI_PROFILE_END(short_zone);
+    }
+    ZI_PROFILE_END(long_zone);
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    const ZiProfileCaptureThread* thread = find_capture_thread(&capture, "main");
+    TEST_ASSERT_NOT_NULL(thread);
+
+    // the begin of long_zone got overwritten, its end has nothing to pair with
+    TEST_ASSERT_TRUE(thread->event_count <= ZI_PROFILER_RING_EVENTS);
+    TEST_ASSERT_TRUE(thread->event_count >= ZI_PROFILER_RING_EVENTS - 2);
+    assert_balanced(thread);
+    zi_profiler_capture_free(&capture);
+}
+
+// no threads on the web
+#if !defined(ZI_EMSCRIPTEN)
+static void profiler_worker(VoidPtr user_data) {
+    u32 zones = *(u32*)user_data;
+    for (u32 i = 0; i < zones; ++i) {
+        ZI_PROFILE_BEGIN(work);
+        ZI_PROFILE_END(work);
+    }
+}
+
+void test_profiler_threads(void) {
+    profiler_reset();
+
+    u32            zones = 1000;
+    ZiThreadHandle thread = zi_platform_thread_create(profiler_worker, &zones, "zi-profile-test");
+    TEST_ASSERT_NOT_NULL(thread.handler);
+    zi_platform_thread_join(thread);
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    const ZiProfileCaptureThread* worker = find_capture_thread(&capture, "zi-profile-test");
+    TEST_ASSERT_NOT_NULL(worker);
+    TEST_ASSERT_EQUAL_UINT32(zones * 2, worker->event_count);
+    assert_balanced(worker);
+    zi_profiler_capture_free(&capture);
+}
+
+// every exited thread hands its slot on, more threads than slots still all get recorded
+void test_profiler_reuses_thread_slots(void) {
+    profiler_reset();
+
+    u32 zones[ZI_PROFILER_MAX_THREADS + 8];
+    for (u32 i = 0; i < ZI_PROFILER_MAX_THREADS + 8; ++i) {
+        zones[i] = i + 1;
+        ZiThreadHandle thread = zi_platform_thread_create(profiler_worker, &zones[i], "zi-profile-test");
+        TEST_ASSERT_NOT_NULL(thread.handler);
+        zi_platform_thread_join(thread);
+    }
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    TEST_ASSERT_TRUE(capture.thread_count <= ZI_PROFILER_MAX_THREADS + 1);
+
+    // a reused slot only shows the events of its latest thread
+    ZiBool found_last = ZI_FALSE;
+    for (u32 i = 0; i < capture.thread_count; ++i) {
+        const ZiProfileCaptureThread* worker = &capture.threads[i];
+        if (strcmp(worker->name, "zi-profile-test") != 0) continue;
+        TEST_ASSERT_TRUE(worker->event_count <= 2 * (ZI_PROFILER_MAX_THREADS + 8));
+        assert_balanced(worker);
+        found_last |= worker->event_count == 2 * (ZI_PROFILER_MAX_THREADS + 8);
+    }
+    TEST_ASSERT_TRUE(found_last);
+    zi_profiler_capture_free(&capture);
+}
+#endif
+
+void test_profiler_gpu_track(void) {
+    profiler_reset();
+
+    char label[16];
+    snprintf(label, sizeof(label), "shadow pass");
+    const char* interned = zi_profiler_intern(label);
+    TEST_ASSERT_TRUE(interned != label);
+    TEST_ASSERT_EQUAL_STRING("shadow pass", interned);
+    TEST_ASSERT_TRUE(zi_profiler_intern("shadow pass") == interned);
+    label[0] = 'S';
+    TEST_ASSERT_EQUAL_STRING("shadow pass", interned);
+
+    // a resolved timestamp pair with a nested zone, 1 ms and 0.5 ms long
+    u64 start = zi_platform_get_ticks();
+    u64 ms = zi_platform_get_tick_frequency() / 1000;
+    zi_profiler_record_gpu(ZiProfileEventType_Begin, interned, start);
+    zi_profiler_record_gpu(ZiProfileEventType_Begin, "opaque", start + ms / 4);
+    zi_profiler_record_gpu(ZiProfileEventType_End, "opaque", start + ms / 4 + ms / 2);
+    zi_profiler_record_gpu(ZiProfileEventType_End, interned, start + ms);
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    const ZiProfileCaptureThread* gpu = find_capture_thread(&capture, "GPU");
+    TEST_ASSERT_NOT_NULL(gpu);
+    TEST_ASSERT_EQUAL_UINT32(ZI_PROFILER_GPU_THREAD_ID, gpu->id);
+    TEST_ASSERT_EQUAL_UINT32(4, gpu->event_count);
+    assert_balanced(gpu);
+    TEST_ASSERT_EQUAL_STRING("shadow pass", gpu->events[0].name);
+    TEST_ASSERT_EQUAL_STRING("opaque", gpu->events[1].name);
+    TEST_ASSERT_UINT64_WITHIN(1000, 1000000, gpu->events[3].time - gpu->events[0].time);
+    TEST_ASSERT_UINT64_WITHIN(1000, 500000, gpu->events[2].time - gpu->events[1].time);
+    zi_profiler_capture_free(&capture);
+
+    // nothing lands on the track while paused
+    zi_profiler_set_recording(ZI_FALSE);
+    zi_profiler_record_gpu(ZiProfileEventType_Begin, "paused", start);
+    zi_profiler_set_recording(ZI_TRUE);
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    TEST_ASSERT_EQUAL_UINT32(4, find_capture_thread(&capture, "GPU")->event_count);
+    zi_profiler_capture_free(&capture);
+}
+
+// ============================================================================
+// Export Tests
+// ============================================================================
+
+void test_profiler_binary_round_trip(void) {
+    profiler_reset();
+
+    ZI_PROFILE_FRAME();
+    ZiProfileZone quoted = zi_profile_zone_begin("a \"quoted\" zone");
+    ZI_PROFILE_BEGIN(b);
+    ZI_PROFILE_END(b);
+    zi_profile_zone_end(&quoted);
+    ZI_PROFILE_FRAME();
+
+    ZiProfileCapture capture;
+    TEST_ASSERT_TRUE(zi_profiler_capture(&capture));
+    TEST_ASSERT_TRUE(zi_profiler_write_binary(&capture, TEST_PROFILE_BINARY));
+
+    ZiProfileCapture loaded;
+    TEST_ASSERT_TRUE(zi_profiler_load_binary(TEST_PROFILE_BINARY, &loaded));
+    TEST_ASSERT_EQUAL_UINT32(capture.thread_count, loaded.thread_count);
+
+    const ZiProfileCaptureThread* a = find_capture_thread(&capture, "main");
+    const ZiProfileCaptureThread* b = find_capture_thread(&loaded, "main");
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_UINT32(a->event_count, b->event_count);
+    for (u32 i = 0; i < a->event_count; ++i) {
+        TEST_ASSERT_EQUAL_UINT8(a->events[i].type, b->events[i].type);
+        TEST_ASSERT_TRUE(a->events[i].time == b->events[i].time);
+        TEST_ASSERT_EQUAL_STRING(a->events[i].name, b->events[i].name);
+        TEST_ASSERT_EQUAL_UINT32(a->events[i].data, b->events[i].data);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, b->events[b->event_count - 1].data);
+
+    TEST_ASSERT_TRUE(zi_profiler_write_chrome_trace(&loaded, TEST_PROFILE_JSON));
+
+    char  json[4096];
+    FILE* fp = fopen(TEST_PROFILE_JSON, "rb");
+    TEST_ASSERT_NOT_NULL(fp);
+    u64 size = fread(json, 1, sizeof(json) - 1, fp);
+    json[size] = '\0';
+    fclose(fp);
+
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"traceEvents\""));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"args\":{\"name\":\"main\"}"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"name\":\"a \\\"quoted\\\" zone\",\"ph\":\"B\""));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"ph\":\"i\",\"s\":\"g\""));
+
+    zi_profiler_capture_free(&loaded);
+    zi_profiler_capture_free(&capture);
+
+    // truncated files are rejected
+    fp = fopen(TEST_PROFILE_BINARY, "wb");
+    fwrite(ZI_PROFILE_MAGIC, 1, 8, fp);
+    fclose(fp);
+    TEST_ASSERT_FALSE(zi_profiler_load_binary(TEST_PROFILE_BINARY, &loaded));
+
+    remove(TEST_PROFILE_BINARY);
+    remove(TEST_PROFILE_JSON);
+    zi_profiler_shutdown();
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_profiler_tests(void) {
+#if ZI_PROFILE_SCOPED_ZONES
+    RUN_TEST(test_profiler_nested_zones);
+#endif
+    RUN_TEST(test_profiler_deeper_than_the_stack);
+    RUN_TEST(test_profiler_not_recording);
+    RUN_TEST(test_profiler_ring_wraps);
+#if !defined(ZI_EMSCRIPTEN)
+    RUN_TEST(test_profiler_threads);
+    RUN_TEST(test_profiler_reuses_thread_slots);
+#endif
+    RUN_TEST(test_profiler_gpu_track);
+    RUN_TEST(test_profiler_binary_round_trip);
+}
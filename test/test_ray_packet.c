@@ -0,0 +1,190 @@
+#include "unity.h"
+#include "zi_platform.h"
+#include "zi_ray_packet.h"
+
+#include <string.h>
+
+#define TEST_RAY_PACKET_TRIANGLES 4000
+#define TEST_RAY_PACKET_PACKETS   120
+// not a multiple of 8 or 32, the last packet and word are partial
+#define TEST_RAY_PACKET_RAYS      203
+
+static ZiTriangle packet_triangles[TEST_RAY_PACKET_TRIANGLES];
+
+// props scattered through a 100 unit cube over a ground grid
+static void packet_make_scene(void) {
+    zi_random_seed(500);
+    u32 count = 0;
+    for (u32 z = 0; z < 40; ++z) {
+        for (u32 x = 0; x < 40; ++x) {
+            ZiVec3 p = zi_vec3(-50.0f + 2.5f * x, -50.0f, -50.0f + 2.5f * z);
+            packet_triangles[count++] = zi_triangle(p, zi_vec3(p.x + 2.5f, p.y, p.z), zi_vec3(p.x, p.y, p.z + 2.5f));
+        }
+    }
+    while (count < TEST_RAY_PACKET_TRIANGLES) {
+        ZiVec3 c = zi_vec3(zi_random_range_f32(-50.0f, 50.0f), zi_random_range_f32(-50.0f, 50.0f), zi_random_range_f32(-50.0f, 50.0f));
+        ZiVec3 a = zi_vec3_add(c, zi_vec3_scale(zi_vec3_random_on_sphere(), zi_random_range_f32(0.5f, 4.0f)));
+        ZiVec3 b = zi_vec3_add(c, zi_vec3_scale(zi_vec3_random_on_sphere(), zi_random_range_f32(0.5f, 4.0f)));
+        packet_triangles[count++] = zi_triangle(c, a, b);
+    }
+}
+
+// Eight rays from one probe in about the same direction, or every fourth packet scattered all
+// over. Some lanes are axis aligned.
+static void packet_random_rays(ZiRay* rays, u32 count, u32 packet) {
+    ZiVec3 probe = zi_vec3(zi_random_range_f32(-45.0f, 45.0f), zi_random_range_f32(-40.0f, 45.0f), zi_random_range_f32(-45.0f, 45.0f));
+    ZiVec3 dir = zi_vec3_random_on_sphere();
+    for (u32 i = 0; i < count; ++i) {
+        ZiVec3 origin = probe;
+        ZiVec3 d = zi_vec3_normalize(zi_vec3_add(dir, zi_vec3_scale(zi_vec3_random_on_sphere(), 0.2f)));
+        if (packet % 4 == 3) {
+            origin = zi_vec3(zi_random_range_f32(-70.0f, 70.0f), zi_random_range_f32(-70.0f, 70.0f), zi_random_range_f32(-70.0f, 70.0f));
+            d = zi_vec3_random_on_sphere();
+        }
+        if (zi_random_range_i32(0, 9) == 0) d = zi_vec3(0.0f, -1.0f, 0.0f);
+        rays[i] = (ZiRay){origin, d};
+    }
+}
+
+// ============================================================================
+// Kernel Tests
+// ============================================================================
+
+void test_ray_packet_kernels(void) {
+    zi_random_seed(501);
+    for (u32 p = 0; p < TEST_RAY_PACKET_PACKETS; ++p) {
+        ZiRay rays[8];
+        u32   lanes = p % 5 == 0 ? 5 : 8;
+        f32   max_t = p % 2 ? F32_MAX : 40.0f;
+        packet_random_rays(rays, lanes, p);
+        // aimed at the box and the triangle, so plenty of lanes hit
+        ZiVec3 c = zi_vec3_add(rays[0].origin, zi_vec3_scale(rays[0].direction, zi_random_range_f32(5.0f, 60.0f)));
+        ZiVec3 e = zi_vec3(zi_random_range_f32(1.0f, 8.0f), zi_random_range_f32(1.0f, 8.0f), zi_random_range_f32(1.0f, 8.0f));
+        ZiAABB box = zi_aabb(zi_vec3_sub(c, e), zi_vec3_add(c, e));
+        ZiTriangle tri = zi_triangle(zi_vec3_add(c, zi_vec3(-9.0f, -8.0f, 1.0f)), zi_vec3_add(c, zi_vec3(9.0f, -7.0f, -2.0f)),
+                                     zi_vec3_add(c, zi_vec3(0.0f, 9.0f, 3.0f)));
+
+        ZiRayPacket packet;
+        zi_ray_packet_init(&packet, rays, lanes, max_t);
+        TEST_ASSERT_EQUAL_UINT32((1u << lanes) - 1, packet.active);
+
+        f32 t_near[8];
+        u32 box_mask = zi_ray_packet_intersect_aabb(&packet, box, t_near);
+        f32 t[8], u[8], v[8];
+        u32 tri_mask = zi_ray_packet_intersect_triangle(&packet, tri, t, u, v);
+        TEST_ASSERT_EQUAL_UINT32(0, (box_mask | tri_mask) & ~packet.active);
+        for (u32 lane = 0; lane < lanes; ++lane) {
+            f32    expected_t;
+            ZiBool expected = zi_ray_aabb_intersect(rays[lane], box, &expected_t) && expected_t <= max_t;
+            TEST_ASSERT_EQUAL(expected, (box_mask >> lane) & 1);
+            if (expected) TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected_t, t_near[lane]);
+            if (!expected) TEST_ASSERT_EQUAL_FLOAT(F32_MAX, t_near[lane]);
+
+            f32 eu, ev;
+            expected = zi_ray_triangle_intersect(rays[lane], tri, &expected_t, &eu, &ev) && expected_t < max_t;
+            TEST_ASSERT_EQUAL(expected, (tri_mask >> lane) & 1);
+            if (!expected) continue;
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected_t, t[lane]);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, eu, u[lane]);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, ev, v[lane]);
+        }
+    }
+}
+
+// ============================================================================
+// Traversal Tests
+// ============================================================================
+
+void test_ray_packet_bvh_matches_single_rays(void) {
+    packet_make_scene();
+    ZiBvh          bvh;
+    ZiBvhBuildDesc desc = {packet_triangles, TEST_RAY_PACKET_TRIANGLES, 0, 1};
+    TEST_ASSERT_TRUE(zi_bvh_build(&bvh, &desc));
+
+    u32 hits = 0;
+    for (u32 p = 0; p < TEST_RAY_PACKET_PACKETS; ++p) {
+        ZiRay rays[8];
+        u32   lanes = p % 7 == 0 ? 3 : 8;
+        f32   max_t = p % 3 == 0 ? zi_random_range_f32(10.0f, 60.0f) : F32_MAX;
+        packet_random_rays(rays, lanes, p);
+
+        ZiRayPacket    packet;
+        ZiRayPacketHit packet_hits;
+        zi_ray_packet_init(&packet, rays, lanes, max_t);
+        u32 mask = zi_bvh_raycast_packet(&bvh, &packet, &packet_hits);
+        u32 any_mask = zi_bvh_raycast_packet_any(&bvh, &packet);
+        TEST_ASSERT_EQUAL_UINT32(mask, any_mask);
+        for (u32 lane = 0; lane < 8; ++lane) {
+            ZiBvhHit hit;
+            ZiBool   expected = lane < lanes && zi_bvh_raycast(&bvh, rays[lane], max_t, &hit);
+            TEST_ASSERT_EQUAL(expected, (mask >> lane) & 1);
+            if (!expected) {
+                TEST_ASSERT_EQUAL_UINT32(ZI_RAY_PACKET_MISS, packet_hits.triangle[lane]);
+                continue;
+            }
+            ++hits;
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, hit.t, packet_hits.t[lane]);
+            // the same triangle unless two were hit at practically the same distance
+            if (hit.triangle != packet_hits.triangle[lane]) {
+                f32 t, u, v;
+                TEST_ASSERT_TRUE(zi_ray_triangle_intersect(rays[lane], packet_triangles[packet_hits.triangle[lane]], &t, &u, &v));
+                TEST_ASSERT_FLOAT_WITHIN(1e-3f, hit.t, t);
+            }
+        }
+    }
+    // coherent and scattered packets both hit and miss
+    TEST_ASSERT_TRUE(hits > TEST_RAY_PACKET_PACKETS && hits < TEST_RAY_PACKET_PACKETS * 7);
+
+    // the array forms
+    static ZiRay    rays[TEST_RAY_PACKET_RAYS];
+    static ZiBvhHit ray_hits[TEST_RAY_PACKET_RAYS];
+    u32             hit_bits[(TEST_RAY_PACKET_RAYS + 31) / 32];
+    for (u32 i = 0; i < TEST_RAY_PACKET_RAYS; i += 8) {
+        packet_random_rays(rays + i, TEST_RAY_PACKET_RAYS - i < 8 ? TEST_RAY_PACKET_RAYS - i : 8, i / 8);
+    }
+    memset(hit_bits, 0xff, sizeof(hit_bits));
+    u32 count = zi_bvh_raycast_rays(&bvh, rays, TEST_RAY_PACKET_RAYS, 80.0f, ray_hits);
+    TEST_ASSERT_EQUAL_UINT32(count, zi_bvh_raycast_rays_any(&bvh, rays, TEST_RAY_PACKET_RAYS, 80.0f, hit_bits));
+    u32 expected_count = 0;
+    for (u32 i = 0; i < TEST_RAY_PACKET_RAYS; ++i) {
+        ZiBool expected = zi_bvh_raycast_any(&bvh, rays[i], 80.0f);
+        expected_count += expected;
+        TEST_ASSERT_EQUAL(expected, (hit_bits[i / 32] >> (i & 31)) & 1);
+        TEST_ASSERT_EQUAL(expected, ray_hits[i].triangle != ZI_RAY_PACKET_MISS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected_count, count);
+    TEST_ASSERT_EQUAL_UINT32(0, hit_bits[TEST_RAY_PACKET_RAYS / 32] >> (TEST_RAY_PACKET_RAYS & 31));
+    zi_bvh_destroy(&bvh);
+
+    // nothing to hit
+    ZiBvh          empty;
+    ZiBvhBuildDesc empty_desc = {ZI_NULL, 0, 0, 1};
+    TEST_ASSERT_TRUE(zi_bvh_build(&empty, &empty_desc));
+    ZiRayPacket    packet;
+    ZiRayPacketHit packet_hits;
+    zi_ray_packet_init(&packet, rays, 8, F32_MAX);
+    TEST_ASSERT_EQUAL_UINT32(0, zi_bvh_raycast_packet(&empty, &packet, &packet_hits));
+    TEST_ASSERT_EQUAL_UINT32(ZI_RAY_PACKET_MISS, packet_hits.triangle[0]);
+    zi_bvh_destroy(&empty);
+}
+
+// ============================================================================
+// Dispatch Tests
+// ============================================================================
+
+void test_ray_packet_portable_kernels(void) {
+    zi_platform_set_cpu_features_mask(0);
+    test_ray_packet_kernels();
+    test_ray_packet_bvh_matches_single_rays();
+    zi_platform_set_cpu_features_mask(0xffffffffu);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_ray_packet_tests(void) {
+    RUN_TEST(test_ray_packet_kernels);
+    RUN_TEST(test_ray_packet_bvh_matches_single_rays);
+    RUN_TEST(test_ray_packet_portable_kernels);
+}
@@ -0,0 +1,262 @@
+#include "unity.h"
+#include "zi_sap.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_SAP_BOXES  300
+#define TEST_SAP_FRAMES 40
+
+static ZiAABB sap_boxes[TEST_SAP_BOXES];
+static u32    sap_handles[TEST_SAP_BOXES];
+static u8     sap_alive[TEST_SAP_BOXES];
+// pair state as the events tell it, by handle
+static u8     sap_replayed[TEST_SAP_BOXES][TEST_SAP_BOXES];
+
+static ZiAABB sap_random_box(void) {
+    ZiVec3 c = zi_vec3(zi_random_range_f32(-40.0f, 40.0f), zi_random_range_f32(-10.0f, 10.0f), zi_random_range_f32(-40.0f, 40.0f));
+    ZiVec3 e = zi_vec3(zi_random_range_f32(0.5f, 3.0f), zi_random_range_f32(0.5f, 3.0f), zi_random_range_f32(0.5f, 3.0f));
+    return zi_aabb(zi_vec3_sub(c, e), zi_vec3_add(c, e));
+}
+
+static ZiAABB sap_offset(ZiAABB box, ZiVec3 d) {
+    return zi_aabb(zi_vec3_add(box.min, d), zi_vec3_add(box.max, d));
+}
+
+// endpoints sorted with min before max on ties, and where the proxies say they are
+static void assert_sap_sorted(const ZiSap* sap) {
+    TEST_ASSERT_EQUAL_UINT32(sap->proxy_count * 2, sap->endpoint_count);
+    for (u32 axis = 0; axis < 3; ++axis) {
+        const ZiSapEndpoint* ends = sap->endpoints[axis];
+        for (u32 i = 0; i < sap->endpoint_count; ++i) {
+            if (i > 0) {
+                TEST_ASSERT_TRUE(ends[i - 1].value < ends[i].value || (ends[i - 1].value == ends[i].value && (ends[i - 1].data & 1) <= (ends[i].data & 1)));
+            }
+            const ZiSapProxy* proxy = &sap->proxies[ends[i].data >> 1];
+            TEST_ASSERT_EQUAL_UINT32(i, (ends[i].data & 1) ? proxy->max[axis] : proxy->min[axis]);
+        }
+    }
+}
+
+// The pair set is exactly what testing every pair gives, and replaying the events on top of
+// the last frame's state gets there too
+static void assert_sap_pairs(ZiSap* sap) {
+    assert_sap_sorted(sap);
+
+    u32               event_count;
+    const ZiSapEvent* events = zi_sap_events(sap, &event_count);
+    for (u32 i = 0; i < event_count; ++i) {
+        TEST_ASSERT_TRUE(events[i].a < events[i].b);
+        u8* state = &sap_replayed[events[i].a][events[i].b];
+        TEST_ASSERT_EQUAL_UINT8(events[i].type == ZI_SAP_EVENT_ADDED ? 0 : 1, *state);
+        *state = events[i].type == ZI_SAP_EVENT_ADDED;
+    }
+    zi_sap_clear_events(sap);
+
+    u32 expected = 0;
+    for (u32 i = 0; i < TEST_SAP_BOXES; ++i) {
+        if (!sap_alive[i]) continue;
+        for (u32 k = i + 1; k < TEST_SAP_BOXES; ++k) {
+            if (!sap_alive[k]) continue;
+            ZiBool overlap = zi_aabb_aabb_intersect(sap_boxes[i], sap_boxes[k]) != 0;
+            u32    a = sap_handles[i] < sap_handles[k] ? sap_handles[i] : sap_handles[k];
+            u32    b = sap_handles[i] < sap_handles[k] ? sap_handles[k] : sap_handles[i];
+            TEST_ASSERT_EQUAL(overlap, zi_sap_overlapping(sap, a, b));
+            TEST_ASSERT_EQUAL_UINT8(overlap, sap_replayed[a][b]);
+            expected += overlap;
+        }
+    }
+    u32              pair_count;
+    const ZiSapPair* pairs = zi_sap_pairs(sap, &pair_count);
+    TEST_ASSERT_EQUAL_UINT32(expected, pair_count);
+    for (u32 i = 0; i < pair_count; ++i) {
+        TEST_ASSERT_TRUE(pairs[i].a < pairs[i].b);
+        TEST_ASSERT_TRUE(zi_aabb_aabb_intersect(zi_sap_aabb(sap, pairs[i].a), zi_sap_aabb(sap, pairs[i].b)));
+    }
+
+    // every pair is on the lists of both its proxies
+    u32 listed = 0;
+    for (u32 i = 0; i < TEST_SAP_BOXES; ++i) {
+        if (!sap_alive[i]) continue;
+        u32 prev = ZI_SAP_NULL;
+        for (u32 p = sap->proxies[sap_handles[i]].pairs; p != ZI_SAP_NULL;) {
+            TEST_ASSERT_TRUE(p < pair_count);
+            u32 side = pairs[p].a == sap_handles[i] ? 0 : 1;
+            TEST_ASSERT_EQUAL_UINT32(sap_handles[i], side ? pairs[p].b : pairs[p].a);
+            TEST_ASSERT_EQUAL_UINT32(prev, sap->pair_links.data[p].prev[side]);
+            prev = p;
+            p = sap->pair_links.data[p].next[side];
+            listed++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(2 * pair_count, listed);
+}
+
+// ============================================================================
+// Sweep and Prune Tests
+// ============================================================================
+
+void test_sap_matches_brute_force(void) {
+    zi_random_seed(480);
+    memset(sap_replayed, 0, sizeof(sap_replayed));
+    memset(sap_alive, 0, sizeof(sap_alive));
+
+    ZiSap sap;
+    TEST_ASSERT_TRUE(zi_sap_init(&sap));
+    // a third one by one, the rest in a batch that has to find pairs with the first ones too
+    static VoidPtr user_data[TEST_SAP_BOXES];
+    for (u32 i = 0; i < TEST_SAP_BOXES; ++i) {
+        sap_boxes[i] = sap_random_box();
+        user_data[i] = (VoidPtr)(uintptr_t)i;
+        sap_alive[i] = 1;
+        if (i < TEST_SAP_BOXES / 3) {
+            sap_handles[i] = zi_sap_insert(&sap, sap_boxes[i], user_data[i]);
+        }
+    }
+    u32 first = TEST_SAP_BOXES / 3;
+    TEST_ASSERT_TRUE(zi_sap_insert_batch(&sap, sap_boxes + first, user_data + first, TEST_SAP_BOXES - first, sap_handles + first));
+    assert_sap_pairs(&sap);
+
+    static u32    moved[TEST_SAP_BOXES];
+    static ZiAABB moved_boxes[TEST_SAP_BOXES];
+    for (u32 frame = 0; frame < TEST_SAP_FRAMES; ++frame) {
+        // all, a ninth or a handful walk a bit, batched or one at a time. The handful is below
+        // ZI_SAP_BATCH_RATIO, the batch sorts those one by one too.
+        u32 count = 0;
+        u32 every = frame % 3 == 0 ? 1 : (frame % 3 == 1 ? 9 : 40);
+        for (u32 i = frame % every; i < TEST_SAP_BOXES; i += every) {
+            if (!sap_alive[i]) continue;
+            ZiVec3 d = zi_vec3(zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-0.3f, 0.3f), zi_random_range_f32(-1.0f, 1.0f));
+            sap_boxes[i] = sap_offset(sap_boxes[i], d);
+            moved[count] = sap_handles[i];
+            moved_boxes[count++] = sap_boxes[i];
+        }
+        if (frame % 2 == 0) {
+            zi_sap_move_batch(&sap, moved, moved_boxes, count);
+        } else {
+            for (u32 i = 0; i < count; ++i) {
+                zi_sap_move(&sap, moved[i], moved_boxes[i]);
+            }
+        }
+
+        // some leave, some come back, an odd one grows or jumps across the level
+        u32 k = (u32)zi_random_range_i32(0, TEST_SAP_BOXES - 1);
+        if (sap_alive[k]) {
+            zi_sap_remove(&sap, sap_handles[k]);
+            sap_alive[k] = 0;
+        } else {
+            sap_boxes[k] = sap_random_box();
+            sap_handles[k] = zi_sap_insert(&sap, sap_boxes[k], (VoidPtr)(uintptr_t)k);
+            TEST_ASSERT_TRUE(sap_handles[k] < TEST_SAP_BOXES);
+            sap_alive[k] = 1;
+        }
+        k = (u32)zi_random_range_i32(0, TEST_SAP_BOXES - 1);
+        if (sap_alive[k]) {
+            sap_boxes[k] = frame & 1 ? sap_random_box() : zi_aabb(zi_vec3_sub(sap_boxes[k].min, zi_vec3_one()), sap_boxes[k].max);
+            zi_sap_move(&sap, sap_handles[k], sap_boxes[k]);
+        }
+        assert_sap_pairs(&sap);
+    }
+
+    for (u32 i = 0; i < TEST_SAP_BOXES; ++i) {
+        if (sap_alive[i]) {
+            TEST_ASSERT_EQUAL_PTR((VoidPtr)(uintptr_t)i, zi_sap_user_data(&sap, sap_handles[i]));
+        }
+    }
+    zi_sap_destroy(&sap);
+}
+
+void test_sap_events_and_handles(void) {
+    ZiSap sap;
+    TEST_ASSERT_TRUE(zi_sap_init(&sap));
+
+    // touching counts, like zi_aabb_aabb_intersect
+    u32 a = zi_sap_insert(&sap, zi_aabb(zi_vec3(0.0f, 0.0f, 0.0f), zi_vec3(1.0f, 1.0f, 1.0f)), ZI_NULL);
+    u32 b = zi_sap_insert(&sap, zi_aabb(zi_vec3(1.0f, 0.0f, 0.0f), zi_vec3(2.0f, 1.0f, 1.0f)), ZI_NULL);
+    u32 c = zi_sap_insert(&sap, zi_aabb(zi_vec3(5.0f, 0.0f, 0.0f), zi_vec3(6.0f, 1.0f, 1.0f)), ZI_NULL);
+    TEST_ASSERT_TRUE(zi_sap_overlapping(&sap, a, b));
+    TEST_ASSERT_FALSE(zi_sap_overlapping(&sap, b, c));
+
+    u32               count;
+    const ZiSapEvent* events = zi_sap_events(&sap, &count);
+    TEST_ASSERT_EQUAL_UINT32(1, count);
+    TEST_ASSERT_EQUAL_UINT8(ZI_SAP_EVENT_ADDED, events[0].type);
+    zi_sap_clear_events(&sap);
+
+    // c sweeps through b and out the other side in one move, nothing in between was seen
+    zi_sap_move(&sap, c, zi_aabb(zi_vec3(-5.0f, 0.0f, 0.0f), zi_vec3(-4.0f, 1.0f, 1.0f)));
+    zi_sap_events(&sap, &count);
+    TEST_ASSERT_EQUAL_UINT32(0, count);
+    // onto a, then off it again before anyone looked, both are reported in order
+    zi_sap_move(&sap, c, zi_aabb(zi_vec3(-0.5f, 0.5f, 0.5f), zi_vec3(0.5f, 1.5f, 1.5f)));
+    zi_sap_move(&sap, c, zi_aabb(zi_vec3(-0.5f, 2.5f, 0.5f), zi_vec3(0.5f, 3.5f, 1.5f)));
+    events = zi_sap_events(&sap, &count);
+    TEST_ASSERT_EQUAL_UINT32(2, count);
+    TEST_ASSERT_EQUAL_UINT8(ZI_SAP_EVENT_ADDED, events[0].type);
+    TEST_ASSERT_EQUAL_UINT8(ZI_SAP_EVENT_REMOVED, events[1].type);
+    TEST_ASSERT_EQUAL_UINT32(a < c ? a : c, events[1].a);
+    zi_sap_clear_events(&sap);
+
+    // removing ends its pairs, the handle waits for the events to be cleared
+    zi_sap_remove(&sap, b);
+    events = zi_sap_events(&sap, &count);
+    TEST_ASSERT_EQUAL_UINT32(1, count);
+    TEST_ASSERT_EQUAL_UINT8(ZI_SAP_EVENT_REMOVED, events[0].type);
+    TEST_ASSERT_FALSE(zi_sap_overlapping(&sap, a, b));
+    u32 d = zi_sap_insert(&sap, zi_aabb(zi_vec3(10.0f, 0.0f, 0.0f), zi_vec3(11.0f, 1.0f, 1.0f)), ZI_NULL);
+    TEST_ASSERT_NOT_EQUAL(b, d);
+    zi_sap_clear_events(&sap);
+    u32 e = zi_sap_insert(&sap, zi_aabb(zi_vec3(20.0f, 0.0f, 0.0f), zi_vec3(21.0f, 1.0f, 1.0f)), ZI_NULL);
+    TEST_ASSERT_EQUAL_UINT32(b, e);
+    assert_sap_sorted(&sap);
+
+    zi_sap_destroy(&sap);
+    TEST_ASSERT_NULL(sap.proxies);
+}
+
+// A ground plane out to infinity and a pillar up to F32_MAX share the top endpoints with
+// anything else pushed there, removals still take out the right ones
+void test_sap_remove_unbounded(void) {
+    memset(sap_replayed, 0, sizeof(sap_replayed));
+    memset(sap_alive, 0, sizeof(sap_alive));
+
+    ZiSap sap;
+    TEST_ASSERT_TRUE(zi_sap_init(&sap));
+    sap_boxes[0] = zi_aabb(zi_vec3(-INFINITY, -1.0f, -INFINITY), zi_vec3(INFINITY, 0.0f, INFINITY));
+    sap_boxes[1] = zi_aabb(zi_vec3(0.0f, -F32_MAX, 0.0f), zi_vec3(F32_MAX, F32_MAX, F32_MAX));
+    sap_boxes[2] = zi_aabb(zi_vec3(-2.0f, -0.5f, -2.0f), zi_vec3(-1.0f, 0.5f, -1.0f));
+    sap_boxes[3] = zi_aabb(zi_vec3(1.0f, 0.5f, 1.0f), zi_vec3(2.0f, 1.5f, 2.0f));
+    sap_boxes[4] = zi_aabb(zi_vec3(-3.0f, 2.0f, 1.0f), zi_vec3(-2.0f, 3.0f, 2.0f));
+    for (u32 i = 0; i < 5; ++i) {
+        sap_handles[i] = zi_sap_insert(&sap, sap_boxes[i], ZI_NULL);
+        sap_alive[i] = 1;
+    }
+    assert_sap_pairs(&sap);
+
+    // each goes in turn, the ones still there keep moving
+    u32 order[5] = {3, 0, 4, 1, 2};
+    for (u32 i = 0; i < 5; ++i) {
+        zi_sap_remove(&sap, sap_handles[order[i]]);
+        sap_alive[order[i]] = 0;
+        assert_sap_pairs(&sap);
+        for (u32 k = 2; k < 5; ++k) {
+            if (!sap_alive[k]) continue;
+            sap_boxes[k] = sap_offset(sap_boxes[k], zi_vec3(1.5f, -1.0f, 1.5f));
+            zi_sap_move(&sap, sap_handles[k], sap_boxes[k]);
+        }
+        assert_sap_pairs(&sap);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sap.endpoint_count);
+    zi_sap_destroy(&sap);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_sap_tests(void) {
+    RUN_TEST(test_sap_matches_brute_force);
+    RUN_TEST(test_sap_events_and_handles);
+    RUN_TEST(test_sap_remove_unbounded);
+}
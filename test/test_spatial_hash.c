@@ -0,0 +1,305 @@
+#include "unity.h"
+#include "zi_core.h"
+#include "zi_spatial_hash.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define TEST_SPATIAL_HASH_RECTS   1500
+#define TEST_SPATIAL_HASH_FRAMES  20
+#define TEST_SPATIAL_HASH_QUERIES 30
+
+static ZiRect hash_rects[TEST_SPATIAL_HASH_RECTS];
+static u32    hash_handles[TEST_SPATIAL_HASH_RECTS];
+static u8     hash_alive[TEST_SPATIAL_HASH_RECTS];
+static u8     hash_expected[TEST_SPATIAL_HASH_RECTS];
+static u32    hash_found[TEST_SPATIAL_HASH_RECTS];
+
+// mostly sprites a cell or two wide, some snapped to the cell borders, a few covering whole rooms
+static ZiRect hash_random_rect(void) {
+    f32 x = zi_random_range_f32(-100.0f, 100.0f);
+    f32 y = zi_random_range_f32(-100.0f, 100.0f);
+    i32 kind = zi_random_range_i32(0, 19);
+    if (kind == 0) return zi_rect(x, y, zi_random_range_f32(40.0f, 80.0f), zi_random_range_f32(40.0f, 80.0f));
+    if (kind == 1) return zi_rect(floorf(x / 4.0f) * 4.0f, floorf(y / 4.0f) * 4.0f, 4.0f, 8.0f);
+    return zi_rect(x, y, zi_random_range_f32(0.5f, 6.0f), zi_random_range_f32(0.5f, 6.0f));
+}
+
+static f32 hash_safe_inverse(f32 d) {
+    return zi_abs_f32(d) > 1e-30f ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+}
+
+static ZiBool hash_ray_hits(ZiRect r, ZiVec2 origin, ZiVec2 dir, f32 max_t) {
+    ZiVec2 inv = zi_vec2(hash_safe_inverse(dir.x), hash_safe_inverse(dir.y));
+    f32    tx1 = (r.x - origin.x) * inv.x;
+    f32    tx2 = (r.x + r.width - origin.x) * inv.x;
+    f32    ty1 = (r.y - origin.y) * inv.y;
+    f32    ty2 = (r.y + r.height - origin.y) * inv.y;
+    f32    t_near = zi_max_f32(zi_max_f32(zi_min_f32(tx1, tx2), zi_min_f32(ty1, ty2)), 0.0f);
+    f32    t_far = zi_min_f32(zi_min_f32(zi_max_f32(tx1, tx2), zi_max_f32(ty1, ty2)), max_t);
+    return t_near <= t_far;
+}
+
+// found is hash_expected exactly, each rect once
+static void assert_hash_found(const ZiSpatialHash* hash, u32 found_count) {
+    u32 expected_count = 0;
+    for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+        expected_count += hash_expected[i];
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected_count, found_count);
+    for (u32 i = 0; i < found_count; ++i) {
+        u32 index = (u32)(uintptr_t)zi_spatial_hash_user_data(hash, hash_found[i]);
+        TEST_ASSERT_EQUAL_UINT32(hash_handles[index], hash_found[i]);
+        TEST_ASSERT_EQUAL_UINT8(1, hash_expected[index]);
+        hash_expected[index] = 2;
+    }
+}
+
+// the bounds are exactly the cells the bucketed rects cover, and their edges know how many sit on them
+static void assert_hash_bounds(const ZiSpatialHash* hash) {
+    i32 edges[4] = {INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+    u32 counts[4] = {0};
+    for (u32 pass = 0; pass < 2; ++pass) {
+        for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+            const ZiSpatialHashEntity* entity = &hash->entities[hash_handles[i]];
+            if (!hash_alive[i] || entity->large != ZI_SPATIAL_HASH_NULL) continue;
+            i32 values[4] = {entity->cell_min.x, entity->cell_min.y, entity->cell_max.x, entity->cell_max.y};
+            for (u32 e = 0; e < 4; ++e) {
+                if (pass == 0) {
+                    edges[e] = e < 2 ? zi_min_i32(edges[e], values[e]) : zi_max_i32(edges[e], values[e]);
+                } else {
+                    counts[e] += values[e] == edges[e];
+                }
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT32(edges[0], hash->bounds_min.x);
+    TEST_ASSERT_EQUAL_INT32(edges[1], hash->bounds_min.y);
+    TEST_ASSERT_EQUAL_INT32(edges[2], hash->bounds_max.x);
+    TEST_ASSERT_EQUAL_INT32(edges[3], hash->bounds_max.y);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(counts, hash->edge_counts, 4);
+}
+
+static void assert_hash_queries(const ZiSpatialHash* hash) {
+    assert_hash_bounds(hash);
+    for (u32 q = 0; q < TEST_SPATIAL_HASH_QUERIES; ++q) {
+        ZiVec2 p = zi_vec2(zi_random_range_f32(-110.0f, 110.0f), zi_random_range_f32(-110.0f, 110.0f));
+        for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+            hash_expected[i] = hash_alive[i] && zi_rect_contains_point(hash_rects[i], p);
+        }
+        assert_hash_found(hash, zi_spatial_hash_collect_point(hash, p, hash_found, TEST_SPATIAL_HASH_RECTS));
+
+        // every fifth one is wide enough that going through the buckets is cheaper than the cells
+        f32    size = q % 5 == 0 ? 150.0f : 20.0f;
+        ZiRect area = zi_rect(p.x - size * 0.5f, p.y - size * 0.3f, zi_random_range_f32(1.0f, size), zi_random_range_f32(1.0f, size));
+        for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+            hash_expected[i] = hash_alive[i] && zi_rect_intersects(hash_rects[i], area);
+        }
+        assert_hash_found(hash, zi_spatial_hash_collect_rect(hash, area, hash_found, TEST_SPATIAL_HASH_RECTS));
+
+        // diagonal, along an axis both ways, and from outside everything
+        ZiVec2 dir = zi_vec2(zi_random_range_f32(-1.0f, 1.0f), zi_random_range_f32(-1.0f, 1.0f));
+        if (q % 4 == 1) dir = zi_vec2(q % 8 == 1 ? 1.0f : -1.0f, 0.0f);
+        if (q % 4 == 2) dir = zi_vec2(0.0f, q % 8 == 2 ? 1.0f : -1.0f);
+        ZiVec2 origin = q % 3 == 0 ? zi_vec2_sub(p, zi_vec2_scale(dir, 300.0f)) : p;
+        f32    max_t = q % 2 ? F32_MAX : zi_random_range_f32(10.0f, 200.0f);
+        for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+            hash_expected[i] = hash_alive[i] && hash_ray_hits(hash_rects[i], origin, dir, max_t);
+        }
+        assert_hash_found(hash, zi_spatial_hash_collect_ray(hash, origin, dir, max_t, hash_found, TEST_SPATIAL_HASH_RECTS));
+    }
+}
+
+// ============================================================================
+// Spatial Hash Tests
+// ============================================================================
+
+void test_spatial_hash_matches_brute_force(void) {
+    zi_random_seed(490);
+    memset(hash_alive, 0, sizeof(hash_alive));
+
+    // few buckets, so plenty of cells share one
+    ZiSpatialHash hash;
+    TEST_ASSERT_TRUE(zi_spatial_hash_init(&hash, 4.0f, 50));
+    TEST_ASSERT_EQUAL_UINT32(63, hash.bucket_mask);
+    for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+        hash_rects[i] = hash_random_rect();
+        hash_handles[i] = zi_spatial_hash_insert(&hash, hash_rects[i], (VoidPtr)(uintptr_t)i);
+        TEST_ASSERT_EQUAL_UINT32(i, hash_handles[i]);
+        hash_alive[i] = 1;
+    }
+    assert_hash_queries(&hash);
+
+    for (u32 frame = 0; frame < TEST_SPATIAL_HASH_FRAMES; ++frame) {
+        for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+            if (!hash_alive[i]) continue;
+            i32 kind = zi_random_range_i32(0, 49);
+            if (kind == 0) {
+                // jumps anywhere, maybe onto or off the large list
+                hash_rects[i] = hash_random_rect();
+            } else if (kind == 1) {
+                // grows over a whole room and back
+                hash_rects[i].width = hash_rects[i].width > 30.0f ? 2.0f : 60.0f;
+            } else {
+                hash_rects[i] = zi_rect_translate(hash_rects[i], zi_vec2(zi_random_range_f32(-1.5f, 1.5f), zi_random_range_f32(-1.5f, 1.5f)));
+            }
+            TEST_ASSERT_TRUE(zi_spatial_hash_move(&hash, hash_handles[i], hash_rects[i]));
+        }
+        for (u32 n = 0; n < 20; ++n) {
+            u32 k = (u32)zi_random_range_i32(0, TEST_SPATIAL_HASH_RECTS - 1);
+            if (hash_alive[k]) {
+                zi_spatial_hash_remove(&hash, hash_handles[k]);
+                hash_alive[k] = 0;
+            } else {
+                hash_rects[k] = hash_random_rect();
+                hash_handles[k] = zi_spatial_hash_insert(&hash, hash_rects[k], (VoidPtr)(uintptr_t)k);
+                TEST_ASSERT_NOT_EQUAL(ZI_SPATIAL_HASH_NULL, hash_handles[k]);
+                hash_alive[k] = 1;
+            }
+        }
+        assert_hash_queries(&hash);
+    }
+
+    u32 alive = 0;
+    for (u32 i = 0; i < TEST_SPATIAL_HASH_RECTS; ++i) {
+        alive += hash_alive[i];
+        if (hash_alive[i]) {
+            ZiRect r = zi_spatial_hash_rect(&hash, hash_handles[i]);
+            TEST_ASSERT_EQUAL_MEMORY(&hash_rects[i], &r, sizeof(ZiRect));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(alive, hash.entity_count);
+    zi_spatial_hash_destroy(&hash);
+}
+
+static f32 hash_nearest_hit(VoidPtr context, u32 handle, VoidPtr user_data, f32 t, f32 max_t) {
+    u32* nearest = (u32*)context;
+    *nearest = handle;
+    return t;
+}
+
+static f32 hash_first_hit(VoidPtr context, u32 handle, VoidPtr user_data, f32 t, f32 max_t) {
+    ++*(u32*)context;
+    return 0.0f;
+}
+
+static ZiBool hash_count_hits(VoidPtr context, u32 handle, VoidPtr user_data) {
+    ++*(u32*)context;
+    return ZI_TRUE;
+}
+
+void test_spatial_hash_queries_and_handles(void) {
+    ZiSpatialHash hash;
+    TEST_ASSERT_TRUE(zi_spatial_hash_init(&hash, 10.0f, 0));
+    TEST_ASSERT_EQUAL_UINT32(ZI_SPATIAL_HASH_DEFAULT_BUCKETS - 1, hash.bucket_mask);
+
+    // a row of crates along x, a floor under all of them on the large list
+    u32 crates[8];
+    for (u32 i = 0; i < 8; ++i) {
+        crates[i] = zi_spatial_hash_insert(&hash, zi_rect(20.0f + 30.0f * (f32)i, 0.0f, 8.0f, 8.0f), (VoidPtr)(uintptr_t)(i + 1));
+    }
+    u32 ground = zi_spatial_hash_insert(&hash, zi_rect(-1000.0f, -20.0f, 2000.0f, 10.0f), ZI_NULL);
+
+    // the nearest crate from the right, whatever order the cells give them in
+    u32 nearest = ZI_SPATIAL_HASH_NULL;
+    zi_spatial_hash_raycast(&hash, zi_vec2(500.0f, 4.0f), zi_vec2(-1.0f, 0.0f), F32_MAX, hash_nearest_hit, &nearest);
+    TEST_ASSERT_EQUAL_UINT32(crates[7], nearest);
+    TEST_ASSERT_EQUAL_UINT32(8, zi_spatial_hash_collect_ray(&hash, zi_vec2(500.0f, 4.0f), zi_vec2(-1.0f, 0.0f), F32_MAX, ZI_NULL, 0));
+    // stops where it's told to, and stays short of crates past max_t
+    u32 calls = 0;
+    zi_spatial_hash_raycast(&hash, zi_vec2(0.0f, 4.0f), zi_vec2(1.0f, 0.0f), F32_MAX, hash_first_hit, &calls);
+    TEST_ASSERT_EQUAL_UINT32(1, calls);
+    TEST_ASSERT_EQUAL_UINT32(2, zi_spatial_hash_collect_ray(&hash, zi_vec2(0.0f, 4.0f), zi_vec2(1.0f, 0.0f), 55.0f, ZI_NULL, 0));
+    // straight down hits the crate and the floor
+    u32 hits[4];
+    TEST_ASSERT_EQUAL_UINT32(2, zi_spatial_hash_collect_ray(&hash, zi_vec2(24.0f, 100.0f), zi_vec2(0.0f, -1.0f), F32_MAX, hits, 4));
+    TEST_ASSERT_EQUAL_UINT32(ground, hits[0]);
+    TEST_ASSERT_EQUAL_UINT32(crates[0], hits[1]);
+
+    // edges count for points, touching doesn't for rects
+    TEST_ASSERT_EQUAL_UINT32(1, zi_spatial_hash_collect_point(&hash, zi_vec2(28.0f, 8.0f), hits, 4));
+    TEST_ASSERT_EQUAL_UINT32(crates[0], hits[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, zi_spatial_hash_collect_rect(&hash, zi_rect(28.0f, 0.0f, 22.0f, 8.0f), hits, 4));
+    // too small an array still gets the total
+    TEST_ASSERT_EQUAL_UINT32(9, zi_spatial_hash_collect_rect(&hash, zi_rect(0.0f, -50.0f, 300.0f, 100.0f), hits, 4));
+    u32 count = 0;
+    zi_spatial_hash_query_rect(&hash, zi_rect(0.0f, 0.0f, 300.0f, 8.0f), hash_count_hits, &count);
+    TEST_ASSERT_EQUAL_UINT32(8, count);
+
+    // moving inside the same cell keeps the rect up to date, and handles are reused after removal
+    TEST_ASSERT_TRUE(zi_spatial_hash_move(&hash, crates[0], zi_rect(21.0f, 1.0f, 8.0f, 8.0f)));
+    TEST_ASSERT_EQUAL_UINT32(1, zi_spatial_hash_collect_point(&hash, zi_vec2(28.5f, 8.5f), ZI_NULL, 0));
+    zi_spatial_hash_remove(&hash, crates[3]);
+    TEST_ASSERT_EQUAL_UINT32(0, zi_spatial_hash_collect_point(&hash, zi_vec2(114.0f, 4.0f), ZI_NULL, 0));
+    u32 again = zi_spatial_hash_insert(&hash, zi_rect(0.0f, 0.0f, 1.0f, 1.0f), ZI_NULL);
+    TEST_ASSERT_EQUAL_UINT32(crates[3], again);
+    TEST_ASSERT_EQUAL_PTR((VoidPtr)(uintptr_t)3, zi_spatial_hash_user_data(&hash, crates[2]));
+
+    zi_spatial_hash_destroy(&hash);
+    TEST_ASSERT_NULL(hash.buckets);
+}
+
+// One entity far out and back again doesn't leave the bounds there, rays would walk the empty
+// cells all the way out to it
+void test_spatial_hash_bounds_shrink(void) {
+    ZiSpatialHash hash;
+    TEST_ASSERT_TRUE(zi_spatial_hash_init(&hash, 1.0f, 64));
+    u32 near = zi_spatial_hash_insert(&hash, zi_rect(0.5f, 0.5f, 2.0f, 2.0f), ZI_NULL);
+    u32 far = zi_spatial_hash_insert(&hash, zi_rect(1e7f, 0.5f, 2.0f, 2.0f), ZI_NULL);
+    TEST_ASSERT_EQUAL_INT32(10000002, hash.bounds_max.x);
+    TEST_ASSERT_EQUAL_UINT32(2, zi_spatial_hash_collect_ray(&hash, zi_vec2(-5.0f, 1.0f), zi_vec2(1.0f, 0.0f), F32_MAX, ZI_NULL, 0));
+
+    // moving back in and going away both bring the bounds back to what is left
+    TEST_ASSERT_TRUE(zi_spatial_hash_move(&hash, far, zi_rect(4.5f, 0.5f, 1.0f, 1.0f)));
+    TEST_ASSERT_EQUAL_INT32(5, hash.bounds_max.x);
+    TEST_ASSERT_TRUE(zi_spatial_hash_move(&hash, far, zi_rect(-1e7f, 0.5f, 1.0f, 1.0f)));
+    TEST_ASSERT_EQUAL_INT32(-10000000, hash.bounds_min.x);
+    zi_spatial_hash_remove(&hash, far);
+    TEST_ASSERT_EQUAL_INT32(0, hash.bounds_min.x);
+    TEST_ASSERT_EQUAL_INT32(2, hash.bounds_max.x);
+    TEST_ASSERT_EQUAL_UINT32(1, zi_spatial_hash_collect_ray(&hash, zi_vec2(-5.0f, 1.0f), zi_vec2(1.0f, 0.0f), F32_MAX, ZI_NULL, 0));
+
+    // and an empty hash has none left to walk
+    zi_spatial_hash_remove(&hash, near);
+    TEST_ASSERT_TRUE(hash.bounds_min.x > hash.bounds_max.x);
+    TEST_ASSERT_EQUAL_UINT32(0, zi_spatial_hash_collect_ray(&hash, zi_vec2(-5.0f, 1.0f), zi_vec2(1.0f, 0.0f), F32_MAX, ZI_NULL, 0));
+    zi_spatial_hash_destroy(&hash);
+}
+
+static VoidPtr hash_failing_alloc(u64 size, VoidPtr user_data) {
+    return ZI_NULL;
+}
+
+// a move that runs out of memory stays where it was without counting the entity twice, so the
+// bounds still go away with it
+void test_spatial_hash_failed_move_keeps_bounds(void) {
+    ZiSpatialHash hash;
+    TEST_ASSERT_TRUE(zi_spatial_hash_init(&hash, 1.0f, 64));
+    u32 handle = zi_spatial_hash_insert(&hash, zi_rect(0.5f, 0.5f, 2.0f, 2.0f), ZI_NULL);
+
+    // growing over the whole level needs the large list, which has no room yet
+    ZiAllocator* allocator = zi_get_default_allocator();
+    ZiAllocFn    alloc = allocator->alloc;
+    allocator->alloc = hash_failing_alloc;
+    ZiBool moved = zi_spatial_hash_move(&hash, handle, zi_rect(0.0f, 0.0f, 100.0f, 100.0f));
+    allocator->alloc = alloc;
+    TEST_ASSERT_FALSE(moved);
+    u32 counts[4] = {1, 1, 1, 1};
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(counts, hash.edge_counts, 4);
+    TEST_ASSERT_EQUAL_UINT32(1, zi_spatial_hash_collect_point(&hash, zi_vec2(1.0f, 1.0f), ZI_NULL, 0));
+
+    zi_spatial_hash_remove(&hash, handle);
+    TEST_ASSERT_TRUE(hash.bounds_min.x > hash.bounds_max.x);
+    zi_spatial_hash_destroy(&hash);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_spatial_hash_tests(void) {
+    RUN_TEST(test_spatial_hash_matches_brute_force);
+    RUN_TEST(test_spatial_hash_queries_and_handles);
+    RUN_TEST(test_spatial_hash_bounds_shrink);
+    RUN_TEST(test_spatial_hash_failed_move_keeps_bounds);
+}
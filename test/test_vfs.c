@@ -0,0 +1,250 @@
+#include "unity.h"
+#include "zi_lz4.h"
+#include "zi_vfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_PACK "zi_test_vfs.zpk"
+#define TEST_PATCH_PACK "zi_test_vfs_patch.zpk"
+#define TEST_LOOSE_FILE "zi_test_vfs_game.ini"
+
+// ============================================================================
+// LZ4 Tests
+// ============================================================================
+
+void test_lz4_round_trip(void) {
+    static u8 src[64 * 1024];
+    static u8 compressed[64 * 1024 + 1024];
+    static u8 decompressed[64 * 1024];
+
+    // mix of runs, repeats and noise
+    u32 seed = 1;
+    for (u32 i = 0; i < sizeof(src); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        src[i] = (i / 1024) % 2 == 0 ? (u8)(i % 13) : (u8)(seed >> 24);
+    }
+
+    u64 size = zi_lz4_compress(src, sizeof(src), compressed, sizeof(compressed));
+    TEST_ASSERT_TRUE(size > 0);
+    TEST_ASSERT_TRUE(size < sizeof(src));
+    TEST_ASSERT_TRUE(zi_lz4_decompress(compressed, size, decompressed, sizeof(decompressed)));
+    TEST_ASSERT_EQUAL_MEMORY(src, decompressed, sizeof(src));
+
+    // truncated input and a wrong output size are rejected
+    TEST_ASSERT_FALSE(zi_lz4_decompress(compressed, size - 1, decompressed, sizeof(decompressed)));
+    TEST_ASSERT_FALSE(zi_lz4_decompress(compressed, size, decompressed, sizeof(decompressed) - 1));
+}
+
+void test_lz4_small_inputs(void) {
+    u8 compressed[32];
+    u8 decompressed[8];
+
+    u64 size = zi_lz4_compress((const u8*)"", 0, compressed, sizeof(compressed));
+    TEST_ASSERT_EQUAL_UINT64(1, size);
+    TEST_ASSERT_TRUE(zi_lz4_decompress(compressed, size, decompressed, 0));
+
+    size = zi_lz4_compress((const u8*)"abcdefg", 7, compressed, sizeof(compressed));
+    TEST_ASSERT_TRUE(zi_lz4_decompress(compressed, size, decompressed, 7));
+    TEST_ASSERT_EQUAL_MEMORY("abcdefg", decompressed, 7);
+}
+
+// ============================================================================
+// VFS Tests
+// ============================================================================
+
+static char big_text[16 * 1024];
+
+static void write_test_pack(void) {
+    for (u32 i = 0; i < sizeof(big_text); ++i) {
+        big_text[i] = "zircon engine "[i % 14];
+    }
+
+    ZiPackWriter writer;
+    TEST_ASSERT_TRUE(zi_pack_writer_open(&writer, TEST_PACK, 256));
+    TEST_ASSERT_TRUE(zi_pack_writer_add(&writer, "config/game.ini", "fullscreen=1", 12, ZiPackCompression_None));
+    TEST_ASSERT_TRUE(zi_pack_writer_add(&writer, "/text/big.txt", big_text, sizeof(big_text), ZiPackCompression_LZ4));
+    TEST_ASSERT_TRUE(zi_pack_writer_add(&writer, "./empty.bin", "", 0, ZiPackCompression_LZ4));
+    TEST_ASSERT_TRUE(zi_pack_writer_close(&writer));
+}
+
+void test_vfs_pack_read(void) {
+    write_test_pack();
+    TEST_ASSERT_TRUE(zi_vfs_mount_pack(TEST_PACK, ""));
+
+    ZiVfsStat stat;
+    TEST_ASSERT_TRUE(zi_vfs_stat("config/game.ini", &stat));
+    TEST_ASSERT_TRUE(stat.mapped);
+    TEST_ASSERT_EQUAL_UINT64(12, stat.size);
+
+    // stored entries are a view into the mapping, aligned for direct upload
+    ZiVfsFile file;
+    TEST_ASSERT_TRUE(zi_vfs_read("config\\game.ini", &file));
+    TEST_ASSERT_NULL(file.allocation);
+    TEST_ASSERT_EQUAL_UINT64(0, (u64)(file.data) % 256);
+    TEST_ASSERT_EQUAL_MEMORY("fullscreen=1", file.data, 12);
+    zi_vfs_release(&file);
+
+    TEST_ASSERT_TRUE(zi_vfs_stat("text/big.txt", &stat));
+    TEST_ASSERT_EQUAL_UINT8(ZiPackCompression_LZ4, stat.compression);
+    TEST_ASSERT_TRUE(stat.stored_size < stat.size);
+
+    TEST_ASSERT_TRUE(zi_vfs_read("/text/big.txt", &file));
+    TEST_ASSERT_EQUAL_UINT64(sizeof(big_text), file.size);
+    TEST_ASSERT_EQUAL_MEMORY(big_text, file.data, sizeof(big_text));
+    zi_vfs_release(&file);
+
+    static char buffer[sizeof(big_text)];
+    TEST_ASSERT_TRUE(zi_vfs_read_into("text/big.txt", buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_MEMORY(big_text, buffer, sizeof(big_text));
+    TEST_ASSERT_FALSE(zi_vfs_read_into("text/big.txt", buffer, sizeof(buffer) - 1));
+
+    TEST_ASSERT_TRUE(zi_vfs_read("empty.bin", &file));
+    TEST_ASSERT_EQUAL_UINT64(0, file.size);
+    zi_vfs_release(&file);
+
+    TEST_ASSERT_FALSE(zi_vfs_exists("config/missing.ini"));
+    TEST_ASSERT_FALSE(zi_vfs_exists("game.ini"));
+
+    zi_vfs_unmount_all();
+    TEST_ASSERT_FALSE(zi_vfs_exists("config/game.ini"));
+    remove(TEST_PACK);
+}
+
+void test_vfs_mount_points_and_overrides(void) {
+    write_test_pack();
+
+    ZiPackWriter writer;
+    TEST_ASSERT_TRUE(zi_pack_writer_open(&writer, TEST_PATCH_PACK, 0));
+    TEST_ASSERT_TRUE(zi_pack_writer_add(&writer, "config/game.ini", "fullscreen=0", 12, ZiPackCompression_None));
+    TEST_ASSERT_TRUE(zi_pack_writer_close(&writer));
+
+    TEST_ASSERT_TRUE(zi_vfs_mount_pack(TEST_PACK, "data"));
+    TEST_ASSERT_TRUE(zi_vfs_exists("data/config/game.ini"));
+    TEST_ASSERT_FALSE(zi_vfs_exists("config/game.ini"));
+
+    // later mounts win
+    TEST_ASSERT_TRUE(zi_vfs_mount_pack(TEST_PATCH_PACK, "/data/"));
+    ZiVfsFile file;
+    TEST_ASSERT_TRUE(zi_vfs_read("data/config/game.ini", &file));
+    TEST_ASSERT_EQUAL_MEMORY("fullscreen=0", file.data, 12);
+    zi_vfs_release(&file);
+    TEST_ASSERT_TRUE(zi_vfs_exists("data/text/big.txt"));
+
+    TEST_ASSERT_TRUE(zi_vfs_unmount(TEST_PATCH_PACK));
+    TEST_ASSERT_TRUE(zi_vfs_read("data/config/game.ini", &file));
+    TEST_ASSERT_EQUAL_MEMORY("fullscreen=1", file.data, 12);
+    zi_vfs_release(&file);
+
+    zi_vfs_unmount_all();
+    remove(TEST_PACK);
+    remove(TEST_PATCH_PACK);
+}
+
+void test_vfs_directory_mount(void) {
+    write_test_pack();
+
+    // the working directory is mounted, creating a subdirectory isn't portable C
+    FILE* fp = fopen(TEST_LOOSE_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fwrite("fullscreen=2", 1, 12, fp);
+    fclose(fp);
+
+    TEST_ASSERT_TRUE(zi_vfs_mount_pack(TEST_PACK, ""));
+    TEST_ASSERT_TRUE(zi_vfs_mount_dir(".", "loose"));
+
+    ZiVfsFile file;
+    TEST_ASSERT_TRUE(zi_vfs_read("loose/" TEST_LOOSE_FILE, &file));
+    TEST_ASSERT_NOT_NULL(file.allocation);
+    TEST_ASSERT_EQUAL_MEMORY("fullscreen=2", file.data, 12);
+    zi_vfs_release(&file);
+
+    // packed files still resolve while a directory is mounted after them
+    TEST_ASSERT_TRUE(zi_vfs_read("config/game.ini", &file));
+    TEST_ASSERT_EQUAL_MEMORY("fullscreen=1", file.data, 12);
+    zi_vfs_release(&file);
+
+    zi_vfs_unmount_all();
+    remove(TEST_PACK);
+    remove(TEST_LOOSE_FILE);
+}
+
+void test_vfs_rejects_corrupt_pack(void) {
+    FILE* fp = fopen(TEST_PACK, "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fwrite("ZIPACK\0\0garbage", 1, 15, fp);
+    fclose(fp);
+
+    TEST_ASSERT_FALSE(zi_vfs_mount_pack(TEST_PACK, ""));
+    zi_vfs_unmount_all();
+    remove(TEST_PACK);
+}
+
+void test_vfs_rejects_uncompressed_size_mismatch(void) {
+    write_test_pack();
+
+    // grow the size of every stored entry past what is in the file
+    FILE* fp = fopen(TEST_PACK, "r+b");
+    TEST_ASSERT_NOT_NULL(fp);
+    ZiPackHeader header;
+    TEST_ASSERT_EQUAL(1, fread(&header, sizeof(header), 1, fp));
+    for (u32 i = 0; i < header.entry_count; ++i) {
+        ZiPackEntry entry;
+        fseek(fp, (long)(header.toc_offset + i * sizeof(ZiPackEntry)), SEEK_SET);
+        TEST_ASSERT_EQUAL(1, fread(&entry, sizeof(entry), 1, fp));
+        if (entry.compression != ZiPackCompression_None) continue;
+        entry.size = entry.stored_size + 4096;
+        fseek(fp, (long)(header.toc_offset + i * sizeof(ZiPackEntry)), SEEK_SET);
+        TEST_ASSERT_EQUAL(1, fwrite(&entry, sizeof(entry), 1, fp));
+    }
+    fclose(fp);
+
+    TEST_ASSERT_FALSE(zi_vfs_mount_pack(TEST_PACK, ""));
+    zi_vfs_unmount_all();
+    remove(TEST_PACK);
+}
+
+void test_vfs_rejects_parent_segments(void) {
+    FILE* fp = fopen(TEST_LOOSE_FILE, "wb");
+    TEST_ASSERT_NOT_NULL(fp);
+    fwrite("fullscreen=2", 1, 12, fp);
+    fclose(fp);
+
+    TEST_ASSERT_FALSE(zi_vfs_mount_dir(".", "../loose"));
+    TEST_ASSERT_TRUE(zi_vfs_mount_dir(".", "loose/inner"));
+    TEST_ASSERT_TRUE(zi_vfs_exists("loose/inner/" TEST_LOOSE_FILE));
+    // would leave the mounted directory
+    TEST_ASSERT_FALSE(zi_vfs_exists("loose/inner/../" TEST_LOOSE_FILE));
+    TEST_ASSERT_FALSE(zi_vfs_exists("loose/inner/.."));
+    // names that only start with dots are fine
+    TEST_ASSERT_FALSE(zi_vfs_exists("loose/inner/..missing"));
+
+    ZiPackWriter writer;
+    TEST_ASSERT_TRUE(zi_pack_writer_open(&writer, TEST_PATCH_PACK, 0));
+    TEST_ASSERT_FALSE(zi_pack_writer_add(&writer, "config/../../game.ini", "fullscreen=0", 12, ZiPackCompression_None));
+    TEST_ASSERT_TRUE(zi_pack_writer_add(&writer, "config/..game.ini", "fullscreen=0", 12, ZiPackCompression_None));
+    TEST_ASSERT_TRUE(zi_pack_writer_close(&writer));
+
+    TEST_ASSERT_TRUE(zi_vfs_mount_pack(TEST_PATCH_PACK, ""));
+    TEST_ASSERT_TRUE(zi_vfs_exists("config/..game.ini"));
+
+    zi_vfs_unmount_all();
+    remove(TEST_PATCH_PACK);
+    remove(TEST_LOOSE_FILE);
+}
+
+// ============================================================================
+// Test Runner
+// ============================================================================
+
+void run_vfs_tests(void) {
+    RUN_TEST(test_lz4_round_trip);
+    RUN_TEST(test_lz4_small_inputs);
+    RUN_TEST(test_vfs_pack_read);
+    RUN_TEST(test_vfs_mount_points_and_overrides);
+    RUN_TEST(test_vfs_directory_mount);
+    RUN_TEST(test_vfs_rejects_corrupt_pack);
+    RUN_TEST(test_vfs_rejects_uncompressed_size_mismatch);
+    RUN_TEST(test_vfs_rejects_parent_segments);
+}
@@ -0,0 +1,67 @@
+#include "zi_log.h"
+#include "zi_log_binary.h"
+#include "zi_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Turns a log written with zi_log_open_binary_file back into text
+// usage: zi-log-decoder <file.zilog> [output.txt]
+
+static void zi_log_print_message(const ZiLogDecodedMessage* message, VoidPtr user_data) {
+	char timestamp[64];
+	zi_platform_format_timestamp(message->wall_clock_us, timestamp, sizeof(timestamp));
+	fprintf((FILE*)user_data, "[%s] [%s] [%s] %.*s\n", timestamp, zi_log_level_name(message->level),
+	        zi_log_category_name(message->category), message->length, message->text);
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <file.zilog> [output.txt]\n", argv[0]);
+		return 1;
+	}
+
+	ZiMappedFile file;
+	if (!zi_platform_map_file(argv[1], ZiFileMapFlags_Sequential, &file)) {
+		return 1;
+	}
+
+	FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+	if (!out) {
+		fprintf(stderr, "failed to open %s\n", argv[2]);
+		zi_platform_unmap_file(&file);
+		return 1;
+	}
+
+	ZiLogDecodeResult result = zi_log_binary_decode(file.data, file.size, zi_log_print_message, out);
+	int               exit_code = 0;
+	switch (result.status) {
+		case ZiLogDecodeStatus_NotBinary:
+			fprintf(stderr, "%s is not a binary log\n", argv[1]);
+			exit_code = 1;
+			break;
+		case ZiLogDecodeStatus_BadVersion:
+			fprintf(stderr, "unsupported binary log version %u\n", result.version);
+			exit_code = 1;
+			break;
+		case ZiLogDecodeStatus_Corrupted:
+			fprintf(stderr, "corrupted record at offset %llu\n", (unsigned long long)result.offset);
+			exit_code = 1;
+			break;
+		case ZiLogDecodeStatus_Truncated:
+			fprintf(stderr, "truncated record at offset %llu\n", (unsigned long long)result.offset);
+			break;
+		default:
+			break;
+	}
+	if (result.status != ZiLogDecodeStatus_NotBinary && result.status != ZiLogDecodeStatus_BadVersion) {
+		fprintf(stderr, "decoded %llu messages\n", (unsigned long long)result.messages);
+	}
+
+	if (out != stdout) {
+		fclose(out);
+	}
+	zi_platform_unmap_file(&file);
+	return exit_code;
+}
@@ -0,0 +1,139 @@
+#include "zi_core.h"
+#include "zi_log.h"
+#include "zi_platform.h"
+#include "zi_vfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ZI_WIN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// Packs a directory tree into a single archive for zi_vfs_mount_pack
+// usage: zi-pack <input dir> <output.zpk> [--lz4 | --zstd] [--align N]
+
+typedef struct ZiPackTool {
+	ZiPackWriter      writer;
+	ZiPackCompression compression;
+	u64               files;
+	u64               bytes;
+	ZiBool            failed;
+} ZiPackTool;
+
+static void zi_pack_file(ZiPackTool* tool, const char* os_path, const char* pack_path) {
+	ZiMappedFile file;
+	if (!zi_platform_map_file(os_path, ZiFileMapFlags_Sequential, &file)) {
+		tool->failed = ZI_TRUE;
+		return;
+	}
+
+	if (!zi_pack_writer_add(&tool->writer, pack_path, file.data, file.size, tool->compression)) {
+		tool->failed = ZI_TRUE;
+	}
+
+	tool->files++;
+	tool->bytes += file.size;
+	zi_platform_unmap_file(&file);
+}
+
+static void zi_pack_directory(ZiPackTool* tool, const char* os_dir, const char* pack_dir) {
+	char os_path[4096];
+	char pack_path[4096];
+
+#ifdef ZI_WIN
+	char pattern[4096];
+	snprintf(pattern, sizeof(pattern), "%s\\*", os_dir);
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA(pattern, &data);
+	if (find == INVALID_HANDLE_VALUE) {
+		zi_log_error("failed to open directory %s", os_dir);
+		tool->failed = ZI_TRUE;
+		return;
+	}
+
+	do {
+		const char* name = data.cFileName;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		snprintf(os_path, sizeof(os_path), "%s\\%s", os_dir, name);
+		snprintf(pack_path, sizeof(pack_path), "%s%s%s", pack_dir, pack_dir[0] ? "/" : "", name);
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			zi_pack_directory(tool, os_path, pack_path);
+		} else {
+			zi_pack_file(tool, os_path, pack_path);
+		}
+	} while (FindNextFileA(find, &data));
+
+	FindClose(find);
+#else
+	DIR* dir = opendir(os_dir);
+	if (!dir) {
+		zi_log_error("failed to open directory %s", os_dir);
+		tool->failed = ZI_TRUE;
+		return;
+	}
+
+	struct dirent* item;
+	while ((item = readdir(dir)) != ZI_NULL) {
+		const char* name = item->d_name;
+		if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+
+		snprintf(os_path, sizeof(os_path), "%s/%s", os_dir, name);
+		snprintf(pack_path, sizeof(pack_path), "%s%s%s", pack_dir, pack_dir[0] ? "/" : "", name);
+
+		struct stat st;
+		if (stat(os_path, &st) != 0) continue;
+
+		if (S_ISDIR(st.st_mode)) {
+			zi_pack_directory(tool, os_path, pack_path);
+		} else if (S_ISREG(st.st_mode)) {
+			zi_pack_file(tool, os_path, pack_path);
+		}
+	}
+
+	closedir(dir);
+#endif
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: zi-pack <input dir> <output.zpk> [--lz4 | --zstd] [--align N]\n");
+		return 1;
+	}
+
+	ZiPackTool tool = {0};
+	u32 alignment = ZI_PACK_DEFAULT_ALIGNMENT;
+
+	for (int i = 3; i < argc; ++i) {
+		if (strcmp(argv[i], "--lz4") == 0) {
+			tool.compression = ZiPackCompression_LZ4;
+		} else if (strcmp(argv[i], "--zstd") == 0) {
+			tool.compression = ZiPackCompression_Zstd;
+		} else if (strcmp(argv[i], "--align") == 0 && i + 1 < argc) {
+			alignment = (u32)strtoul(argv[++i], ZI_NULL, 10);
+		} else {
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	if (!zi_pack_writer_open(&tool.writer, argv[2], alignment)) {
+		return 1;
+	}
+
+	zi_pack_directory(&tool, argv[1], "");
+
+	if (!zi_pack_writer_close(&tool.writer) || tool.failed) {
+		return 1;
+	}
+
+	printf("packed %llu files, %llu bytes\n", (unsigned long long)tool.files, (unsigned long long)tool.bytes);
+	return 0;
+}
@@ -0,0 +1,34 @@
+#include "zi_core.h"
+#include "zi_profiler.h"
+
+#include <stdio.h>
+
+// Turns a binary profiler capture into a Chrome trace
+// usage: zi-profile-convert <capture.zprof> <trace.json>
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: zi-profile-convert <capture.zprof> <trace.json>\n");
+		return 1;
+	}
+
+	ZiProfileCapture capture;
+	if (!zi_profiler_load_binary(argv[1], &capture)) {
+		return 1;
+	}
+
+	u32 threads = capture.thread_count;
+	u64 events = 0;
+	for (u32 i = 0; i < capture.thread_count; ++i) {
+		events += capture.threads[i].event_count;
+	}
+
+	ZiBool ok = zi_profiler_write_chrome_trace(&capture, argv[2]);
+	zi_profiler_capture_free(&capture);
+	if (!ok) {
+		return 1;
+	}
+
+	printf("converted %llu events from %u threads\n", (unsigned long long)events, threads);
+	return 0;
+}